@@ -164,6 +164,7 @@ if (downloadRaylib) then
     
         includedirs { "../src" }
         includedirs { "../include" }
+        forceincludes { path.getabsolute("../src/alloc_hook.h") }   -- counts RL_MALLOC & co., see alloc_hook.h
 
         links {"raylib"}
 
@@ -197,6 +198,248 @@ if (downloadRaylib) then
         filter{}
 		
 
+    project "levelc"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h" },
+            ["Source Files/*"] = { "../tools/levelc.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c" },
+        }
+        files {"../tools/levelc.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c", "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h"}
+
+        includedirs { "../src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m"}
+
+        filter{}
+
+    project "levelgen"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h" },
+            ["Source Files/*"] = { "../tools/levelgen.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c" },
+        }
+        files {"../tools/levelgen.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c", "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h"}
+
+        includedirs { "../src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m"}
+
+        filter{}
+
+    project "parsonbench"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/parson.h", "../src/timing.h" },
+            ["Source Files/*"] = { "../tools/parsonbench.c", "../src/parson.c", "../src/timing.c" },
+        }
+        files {"../tools/parsonbench.c", "../src/parson.c", "../src/timing.c", "../src/parson.h", "../src/timing.h"}
+
+        includedirs { "../src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m"}
+
+        filter{}
+
+    project "parsonbench_scalar"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+        defines { "PARSON_DISABLE_SIMD" }   -- the same benchmark on the scalar scanners
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/parson.h", "../src/timing.h" },
+            ["Source Files/*"] = { "../tools/parsonbench.c", "../src/parson.c", "../src/timing.c" },
+        }
+        files {"../tools/parsonbench.c", "../src/parson.c", "../src/timing.c", "../src/parson.h", "../src/timing.h"}
+
+        includedirs { "../src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m"}
+
+        filter{}
+
+    project "parsonthreads"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/parson.h" },
+            ["Source Files/*"] = { "../tools/parsonthreads.c", "../src/parson.c" },
+        }
+        files {"../tools/parsonthreads.c", "../src/parson.c", "../src/parson.h"}
+
+        includedirs { "../src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m", "pthread"}
+
+        filter{}
+
+    project "staticbatchtest"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/static_batch.h", "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h" },
+            ["Source Files/*"] = { "../tools/staticbatchtest.c", "../src/static_batch.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c" },
+        }
+        files {"../tools/staticbatchtest.c", "../src/static_batch.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c", "../src/static_batch.h", "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h"}
+
+        -- static_batch.c only needs raylib's types, nothing is linked
+        includedirs { "../src", raylib_dir .. "/src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m"}
+
+        filter{}
+
+    project "occlusiontest"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/occlusion.h", "../src/jobs.h", "../src/timing.h", "../src/heap.h" },
+            ["Source Files/*"] = { "../tools/occlusiontest.c", "../src/occlusion.c", "../src/jobs.c", "../src/timing.c" },
+        }
+        files {"../tools/occlusiontest.c", "../src/occlusion.c", "../src/jobs.c", "../src/timing.c", "../src/occlusion.h", "../src/jobs.h", "../src/timing.h", "../src/heap.h"}
+
+        -- occlusion.c only needs raylib's types, nothing is linked
+        includedirs { "../src", raylib_dir .. "/src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m", "pthread"}
+
+        filter{}
+
+    project "occlusiontest_scalar"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+        defines { "OCCLUSION_DISABLE_SIMD" }   -- the same checks on the scalar rasterizer
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/occlusion.h", "../src/jobs.h", "../src/timing.h", "../src/heap.h" },
+            ["Source Files/*"] = { "../tools/occlusiontest.c", "../src/occlusion.c", "../src/jobs.c", "../src/timing.c" },
+        }
+        files {"../tools/occlusiontest.c", "../src/occlusion.c", "../src/jobs.c", "../src/timing.c", "../src/occlusion.h", "../src/jobs.h", "../src/timing.h", "../src/heap.h"}
+
+        -- occlusion.c only needs raylib's types, nothing is linked
+        includedirs { "../src", raylib_dir .. "/src" }
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m", "pthread"}
+
+        filter{}
+
+    project "renderlisttest"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/render_list.h", "../src/render_queue.h", "../src/instancing.h", "../src/line_mesh.h", "../src/frustum.h", "../src/occlusion.h", "../src/jobs.h", "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h" },
+            ["Source Files/*"] = { "../tools/renderlisttest.c", "../src/render_list.c", "../src/render_queue.c", "../src/instancing.c", "../src/line_mesh.c", "../src/frustum.c", "../src/occlusion.c", "../src/jobs.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c" },
+        }
+        files {"../tools/renderlisttest.c", "../src/render_list.c", "../src/render_queue.c", "../src/instancing.c", "../src/line_mesh.c", "../src/frustum.c", "../src/occlusion.c", "../src/jobs.c", "../src/level.c", "../src/level_build.c", "../src/intern.c", "../src/parson.c", "../src/timing.c", "../src/render_list.h", "../src/render_queue.h", "../src/instancing.h", "../src/line_mesh.h", "../src/frustum.h", "../src/occlusion.h", "../src/jobs.h", "../src/level.h", "../src/intern.h", "../src/parson.h", "../src/timing.h", "../src/heap.h"}
+
+        -- headless, but frustum.c and instancing.c call into raylib
+        includedirs { "../src", raylib_dir .. "/src", raylib_dir .. "/src/external" }
+        links {"raylib"}
+        platform_defines()
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+            dependson {"raylib"}
+            links {"raylib.lib"}
+
+        filter "system:windows"
+            links {"winmm", "gdi32", "opengl32"}
+            libdirs {"../bin/%{cfg.buildcfg}"}
+
+        filter "system:linux"
+            links {"pthread", "m", "dl", "rt", "X11"}
+
+        filter "system:macosx"
+            links {"OpenGL.framework", "Cocoa.framework", "IOKit.framework", "CoreFoundation.framework", "CoreAudio.framework", "CoreVideo.framework", "AudioToolbox.framework"}
+
+        filter{}
+
     project "raylib"
         kind "StaticLib"
     
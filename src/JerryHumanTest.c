@@ -7,10 +7,19 @@
 #include "raylib.h"
 #include "rcamera.h"
 #include "raymath.h"
+#include "line_mesh.h"
+#include "frustum.h"
+#include "frame_arena.h"
+#include "hud.h"
+#include "crowd.h"
+#include "assets.h"
+#include "scene.h"
 
 #define MAX_COLUMNS   20
 #define PLAYER_SIZE   1.0f            // Cube side length (1×1×1)
 #define PLAYER_EYE_Y  (PLAYER_SIZE*0.5f)
+#define CROWD_SIZE    1000            // [C] benchmark
+#define HUMAN_SCALE   0.1f
 
 static BoundingBox MakeCubeBox(Vector3 centre, float w, float h, float d)
 {
@@ -20,120 +29,221 @@ static BoundingBox MakeCubeBox(Vector3 centre, float w, float h, float d)
     };
 }
 
-int main(void)
-{
-    const int screenW = 1920, screenH = 1080;
-    InitWindow(screenW, screenH, "raylib – player cube with collisions");
-
-    /* --- Camera & player -------------------------------------------------------------- */
-    Camera camera = { 0 };
-    camera.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
-    camera.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
-    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-    camera.fovy = 60.0f;
-    camera.projection = CAMERA_PERSPECTIVE;
+/* --- Scene state ------------------------------------------------------------------------- */
+static struct {
+    Hud hud;
+    int hudMode, hudCrowd;
 
-    int cameraMode = CAMERA_FIRST_PERSON;       // Start in FPS view
-    Vector3 playerPos = camera.position;        // Player cube centre
-    Vector3 prevPlayerPos, prevCamPos, prevCamTarget;
+    Camera camera;
+    int cameraMode;
+    Vector3 playerPos;                          // Player cube centre
 
-    /* --- World geometry (random columns) --------------------------------------------- */
     float    colHeights[MAX_COLUMNS];
     Vector3  colPos[MAX_COLUMNS];
     Color    colColor[MAX_COLUMNS];
+    BoundingBox *colBoxes;                      // this frame's, collided with and culled
+    FrameArena frameArena;                      // per frame scratch
+
+    // Shared with the other scenes, see assets.h
+    Model *model;
+    LineMesh *modelWires;                       // unique edges, one draw call
+    Shader wireShader;
+    CrowdRenderer *crowd;                       // mesh uploaded once, coarser copies for distant humans
+
+    /* --- Crowd benchmark: humans standing around a 100 m square ------------------ */
+    Vector3 crowdPos[CROWD_SIZE];
+    float   crowdYaw[CROWD_SIZE];
+    Color   crowdColor[CROWD_SIZE];
+    bool showCrowd;
+    bool crowdInstanced;                        // [L] compares with DrawModelEx() per human
+    double drawMs, frameMs;                     // CPU, smoothed
+    double frameStart;
+} jerry;
+
+static bool InitCrowdScene(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    jerry.hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    SetHudLine(&jerry.hud, AddHudLine(&jerry.hud, 10, 10, 10, BLACK), "Modes: [1] Free  [2] First‑person  [3] Third‑person");
+    jerry.hudMode = AddHudLine(&jerry.hud, 10, 25, 10, BLACK);
+    jerry.hudCrowd = AddHudLine(&jerry.hud, 10, 40, 10, BLACK);
+
+    /* --- Camera & player -------------------------------------------------------------- */
+    jerry.camera = (Camera){ 0 };
+    jerry.camera.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
+    jerry.camera.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
+    jerry.camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    jerry.camera.fovy = 60.0f;
+    jerry.camera.projection = CAMERA_PERSPECTIVE;
+
+    jerry.cameraMode = CAMERA_FIRST_PERSON;     // Start in FPS view
+    jerry.playerPos = jerry.camera.position;
 
+    /* --- World geometry (random columns) --------------------------------------------- */
     for (int i = 0; i < MAX_COLUMNS; i++)
     {
-        colHeights[i] = (float)GetRandomValue(1, 12);
-        colPos[i] = (Vector3){ GetRandomValue(-15, 15), colHeights[i] * 0.5f, GetRandomValue(-15, 15) };
-        colColor[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        jerry.colHeights[i] = (float)GetRandomValue(1, 12);
+        jerry.colPos[i] = (Vector3){ GetRandomValue(-15, 15), jerry.colHeights[i] * 0.5f, GetRandomValue(-15, 15) };
+        jerry.colColor[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
     }
 
     DisableCursor();
     SetTargetFPS(60);
-    
-    // TRY TO IMPORT MODEL HERE
-    Model model = LoadModel("Resources/human.obj");
-    //bool valid = isModelValid(model);
-    //printf("The value of valid is: %s\n", valid ? "true" : "false");
 
+    // TRY TO IMPORT MODEL HERE
+    jerry.model = GetSharedModel("human.obj");
+    jerry.modelWires = GetSharedModelWires("human.obj");
+    jerry.wireShader = GetSharedLineShader();
+    jerry.crowd = GetSharedCrowdRenderer("human.obj");
 
-    /* ------------------------------ GAME LOOP ----------------------------------------- */
-    while (!WindowShouldClose())
+    for (int i = 0; i < CROWD_SIZE; i++)
     {
-        /* --- Save state for collision rollback --------------------------------------- */
-        prevPlayerPos = playerPos;
-        prevCamPos = camera.position;
-        prevCamTarget = camera.target;
+        jerry.crowdPos[i] = (Vector3){ GetRandomValue(-500, 500)/10.0f, 0.1f, GetRandomValue(-500, 500)/10.0f };   // feet on the floor
+        jerry.crowdYaw[i] = (float)GetRandomValue(0, 359);
+        jerry.crowdColor[i] = (Color){ GetRandomValue(60, 200), GetRandomValue(60, 200), GetRandomValue(60, 200), 255 };
+    }
+    jerry.showCrowd = false;
+    jerry.crowdInstanced = true;
+    jerry.drawMs = jerry.frameMs = 0.0;
+    jerry.frameArena = LoadFrameArena(4 * 1024);
+    jerry.colBoxes = NULL;
 
-        /* --- Mode switching ---------------------------------------------------------- */
-        if (IsKeyPressed(KEY_ONE))   cameraMode = CAMERA_FREE;
-        if (IsKeyPressed(KEY_TWO))   cameraMode = CAMERA_FIRST_PERSON;
-        if (IsKeyPressed(KEY_THREE)) cameraMode = CAMERA_THIRD_PERSON;
+    if (!jerry.model || !jerry.modelWires || !jerry.crowd)
+    {
+        UnloadFrameArena(&jerry.frameArena);
+        UnloadHud(&jerry.hud);
+        return false;
+    }
+    return true;
+}
 
-        /* --- Update camera via raylib helper ---------------------------------------- */
-        UpdateCamera(&camera, cameraMode);
+/* ------------------------------ GAME LOOP ------------------------------------------------ */
+static void UpdateCrowdScene(void)
+{
+    jerry.frameStart = GetTime();
+    EndFrameArena(&jerry.frameArena);
+
+    /* --- Save state for collision rollback --------------------------------------- */
+    Vector3 prevPlayerPos = jerry.playerPos;
+    Vector3 prevCamPos = jerry.camera.position;
+    Vector3 prevCamTarget = jerry.camera.target;
+
+    /* --- Mode switching ---------------------------------------------------------- */
+    if (IsKeyPressed(KEY_ONE))   jerry.cameraMode = CAMERA_FREE;
+    if (IsKeyPressed(KEY_TWO))   jerry.cameraMode = CAMERA_FIRST_PERSON;
+    if (IsKeyPressed(KEY_THREE)) jerry.cameraMode = CAMERA_THIRD_PERSON;
+    if (IsKeyPressed(KEY_C))     jerry.showCrowd = !jerry.showCrowd;
+    if (IsKeyPressed(KEY_L))     jerry.crowdInstanced = !jerry.crowdInstanced;
+
+    /* --- Update camera via raylib helper ---------------------------------------- */
+    UpdateCamera(&jerry.camera, jerry.cameraMode);
+
+    /* --- Sync player ↔ camera --------------------------------------------------- */
+    if (jerry.cameraMode == CAMERA_FIRST_PERSON)
+    {
+        jerry.playerPos = jerry.camera.position;         // cube is invisible but collides
+    }
+    else if (jerry.cameraMode == CAMERA_THIRD_PERSON)
+    {
+        jerry.playerPos = jerry.camera.target;           // cube visible at target
+        jerry.camera.target = jerry.playerPos;           // keep looking at player
+    }
 
-        /* --- Sync player ↔ camera --------------------------------------------------- */
-        if (cameraMode == CAMERA_FIRST_PERSON)
-        {
-            playerPos = camera.position;                     // cube is invisible but collides
-        }
-        else if (cameraMode == CAMERA_THIRD_PERSON)
-        {
-            playerPos = camera.target;                       // cube visible at target
-            camera.target = playerPos;                           // keep looking at player
-        }
+    /* --- Collision test, the column boxes stay for culling them when drawn ------ */
+    BoundingBox playerBox = MakeCubeBox(jerry.playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE);
 
-        /* --- Collision test --------------------------------------------------------- */
-        BoundingBox playerBox = MakeCubeBox(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE);
+    bool hit = false;
+    jerry.colBoxes = FrameAllocArray(&jerry.frameArena, BoundingBox, MAX_COLUMNS);
+    for (int i = 0; jerry.colBoxes && i < MAX_COLUMNS; i++)
+    {
+        jerry.colBoxes[i] = MakeCubeBox(jerry.colPos[i], 2.0f, jerry.colHeights[i], 2.0f);
+        if (CheckCollisionBoxes(playerBox, jerry.colBoxes[i])) hit = true;
+    }
 
-        bool hit = false;
-        for (int i = 0; i < MAX_COLUMNS && !hit; i++)
-        {
-            BoundingBox colBox = MakeCubeBox(colPos[i], 2.0f, colHeights[i], 2.0f);
-            if (CheckCollisionBoxes(playerBox, colBox)) hit = true;
-        }
+    if (hit)
+    {
+        /* Roll back everything */
+        jerry.playerPos = prevPlayerPos;
+        jerry.camera.position = prevCamPos;
+        jerry.camera.target = prevCamTarget;
+    }
+}
 
-        if (hit)
-        {
-            /* Roll back everything */
-            playerPos = prevPlayerPos;
-            camera.position = prevCamPos;
-            camera.target = prevCamTarget;
-        }
+static void DrawCrowdScene(void)
+{
+    ClearBackground(RAYWHITE);
 
-        /* --- DRAW ------------------------------------------------------------------- */
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+    double drawStart = GetTime();
+    float floorSize = jerry.showCrowd ? 110.0f : 32.0f;
+    BeginMode3D(jerry.camera);
+    DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { floorSize, floorSize }, LIGHTGRAY);
 
-        BeginMode3D(camera);
-        DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
+    /* World columns, those in view */
+    Frustum frustum = GetCameraFrustum(jerry.camera, (float)GetScreenWidth() / (float)GetScreenHeight());
+    if (jerry.colBoxes) CheckFrameAlloc(&jerry.frameArena, jerry.colBoxes);
+    for (int i = 0; i < MAX_COLUMNS; i++)
+    {
+        if (jerry.colBoxes && !IsBoxInFrustum(&frustum, jerry.colBoxes[i])) continue;
+        DrawCube(jerry.colPos[i], 2, jerry.colHeights[i], 2, jerry.colColor[i]);
+        DrawCubeWires(jerry.colPos[i], 2, jerry.colHeights[i], 2, MAROON);
+    }
 
-        /* World columns */
-        for (int i = 0; i < MAX_COLUMNS; i++)
-        {
-            DrawCube(colPos[i], 2, colHeights[i], 2, colColor[i]);
-            DrawCubeWires(colPos[i], 2, colHeights[i], 2, MAROON);
-        }
+    /* Player cube (only in 3rd‑person) */
+    if (jerry.cameraMode == CAMERA_THIRD_PERSON)
+    {
+        //DrawCube(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, PURPLE);
+        //DrawCubeWires(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, DARKPURPLE);
+        DrawLineMeshModel(*jerry.modelWires, jerry.wireShader, *jerry.model, jerry.playerPos, HUMAN_SCALE, DARKPURPLE);
+    }
 
-        /* Player cube (only in 3rd‑person) */
-        if (cameraMode == CAMERA_THIRD_PERSON)
+    /* Humans: the player in 3rd-person and the crowd, culled and instanced per LOD */
+    CrowdRenderer *crowd = jerry.crowd;
+    SetCrowdCamera(crowd, jerry.camera, GetScreenWidth(), GetScreenHeight());
+    if (jerry.cameraMode == CAMERA_THIRD_PERSON) AddCrowdInstance(crowd, jerry.playerPos, HUMAN_SCALE, 0.0f, WHITE);
+    int modelDrawn = 0, modelCulled = 0;
+    for (int i = 0; jerry.showCrowd && i < CROWD_SIZE; i++)
+    {
+        if (jerry.crowdInstanced) AddCrowdInstance(crowd, jerry.crowdPos[i], HUMAN_SCALE, jerry.crowdYaw[i], jerry.crowdColor[i]);
+        else if (IsSphereInFrustum(&crowd->frustum, Vector3Add(jerry.crowdPos[i], Vector3Scale(crowd->center, HUMAN_SCALE)), crowd->radius*HUMAN_SCALE))
         {
-            //DrawCube(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, PURPLE);
-            //DrawCubeWires(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, DARKPURPLE);
-			DrawModel(model, playerPos, 0.1f, WHITE);
-			DrawModelWires(model, playerPos, 0.1f, DARKPURPLE);
+            DrawModelEx(*jerry.model, jerry.crowdPos[i], (Vector3){ 0.0f, 1.0f, 0.0f }, jerry.crowdYaw[i], (Vector3){ HUMAN_SCALE, HUMAN_SCALE, HUMAN_SCALE }, jerry.crowdColor[i]);
+            modelDrawn++;
         }
-        EndMode3D();
+        else modelCulled++;
+    }
+    CrowdStats crowdStats = DrawCrowdInstances(crowd);
 
-        DrawText("Modes: [1] Free  [2] First‑person  [3] Third‑person", 10, 10, 10, BLACK);
-        DrawText(TextFormat("Current: %s",
-            cameraMode == CAMERA_FREE ? "FREE" :
-            cameraMode == CAMERA_FIRST_PERSON ? "FIRST PERSON" : "THIRD PERSON"), 10, 25, 10, BLACK);
-        EndDrawing();
+    /* DrawModelEx draws the full model, a call per mesh: count it as LOD 0 */
+    crowdStats.characters += modelDrawn + modelCulled;
+    crowdStats.culled += modelCulled;
+    crowdStats.lodCounts[0] += modelDrawn;
+    for (int m = 0; m < jerry.model->meshCount; m++)
+    {
+        crowdStats.drawCalls += modelDrawn;
+        crowdStats.triangles += (int64_t)jerry.model->meshes[m].triangleCount*modelDrawn;
     }
+    EndMode3D();
+    jerry.drawMs = jerry.drawMs*0.95 + (GetTime() - drawStart)*1000.0*0.05;
+
+    SetHudLine(&jerry.hud, jerry.hudMode, jerry.cameraMode == CAMERA_FREE ? "Current: FREE" :
+        jerry.cameraMode == CAMERA_FIRST_PERSON ? "Current: FIRST PERSON" : "Current: THIRD PERSON");
+    if (jerry.showCrowd)
+        SetHudLineF(&jerry.hud, jerry.hudCrowd, "Crowd [C]: %d humans %s [L], %d visible, LOD 0/1/2/3: %d/%d/%d/%d, %d draws, %.1fM tris, 3D %.2f ms, frame %.2f ms CPU",
+            CROWD_SIZE, jerry.crowdInstanced ? "instanced" : "DrawModelEx", crowdStats.characters - crowdStats.culled,
+            crowdStats.lodCounts[0], crowdStats.lodCounts[1], crowdStats.lodCounts[2], crowdStats.lodCounts[3],
+            crowdStats.drawCalls, crowdStats.triangles/1e6, jerry.drawMs, jerry.frameMs);
+    else SetHudLine(&jerry.hud, jerry.hudCrowd, "Crowd [C]: off");
+    DrawHud(&jerry.hud);
+    jerry.frameMs = jerry.frameMs*0.95 + (GetTime() - jerry.frameStart)*1000.0*0.05;    // before the swap, which waits on vsync
+}
 
-    CloseWindow();
-    return 0;
+static void UnloadCrowdScene(void)
+{
+    UnloadFrameArena(&jerry.frameArena);
+    UnloadHud(&jerry.hud);
 }
+
+const Scene CrowdScene = {
+    .name = "crowd", .title = "raylib – player cube with collisions", .width = 1920, .height = 1080,
+    .init = InitCrowdScene, .update = UpdateCrowdScene, .draw = DrawCrowdScene, .unload = UnloadCrowdScene
+};
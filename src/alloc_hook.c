@@ -0,0 +1,47 @@
+// alloc_hook.c - counts heap allocations (see alloc_hook.h)
+#include "alloc_hook.h"
+
+#include <stdlib.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define AtomicAdd(p, v)  _InterlockedExchangeAdd64((volatile long long *)(p), (long long)(v))
+    #define AtomicLoad(p)    ((uint64_t)_InterlockedOr64((volatile long long *)(p), 0))
+#else
+    #define AtomicAdd(p, v)  __atomic_fetch_add((p), (uint64_t)(v), __ATOMIC_RELAXED)
+    #define AtomicLoad(p)    __atomic_load_n((p), __ATOMIC_RELAXED)
+#endif
+
+static AllocCounts counts = { 0 };
+
+AllocCounts GetAllocCounts(void)
+{
+    return (AllocCounts){ AtomicLoad(&counts.allocations), AtomicLoad(&counts.frees), AtomicLoad(&counts.bytes) };
+}
+
+void *CountedMalloc(size_t size)
+{
+    AtomicAdd(&counts.allocations, 1);
+    AtomicAdd(&counts.bytes, size);
+    return malloc(size);
+}
+
+void *CountedCalloc(size_t count, size_t size)
+{
+    AtomicAdd(&counts.allocations, 1);
+    AtomicAdd(&counts.bytes, count*size);
+    return calloc(count, size);
+}
+
+void *CountedRealloc(void *ptr, size_t size)
+{
+    AtomicAdd(&counts.allocations, 1);
+    AtomicAdd(&counts.bytes, size);
+    return realloc(ptr, size);
+}
+
+void CountedFree(void *ptr)
+{
+    if (ptr != NULL) AtomicAdd(&counts.frees, 1);
+    free(ptr);
+}
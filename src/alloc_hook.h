@@ -0,0 +1,40 @@
+// alloc_hook.h - counts heap allocations
+//
+// Force included ahead of every source file of the demo (see
+// build/premake5.lua), so RL_MALLOC, RL_CALLOC, RL_REALLOC and RL_FREE in
+// our code go through counting wrappers before raylib.h defines its own.
+// The counters are atomic, workers allocate too. Modules that don't depend
+// on raylib (level.c, intern.c, ecs.c, jobs.c, file_watch.c) use the same
+// macros through heap.h, which falls back to malloc() when built without
+// this header, as the tools are. raylib's library and parson (its own
+// allocator) aren't counted.
+//
+// Snapshot the counts at the top of the main loop and compare at the end
+// to see what a frame allocated; in steady state it should be nothing.
+#ifndef ALLOC_HOOK_H
+#define ALLOC_HOOK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct AllocCounts {
+    uint64_t allocations;        // malloc, calloc and realloc
+    uint64_t frees;
+    uint64_t bytes;              // requested, in total
+} AllocCounts;
+
+AllocCounts GetAllocCounts(void);
+
+void *CountedMalloc(size_t size);
+void *CountedCalloc(size_t count, size_t size);
+void *CountedRealloc(void *ptr, size_t size);
+void CountedFree(void *ptr);
+
+#ifndef RL_MALLOC
+    #define RL_MALLOC(sz)     CountedMalloc(sz)
+    #define RL_CALLOC(n,sz)   CountedCalloc(n,sz)
+    #define RL_REALLOC(ptr,sz) CountedRealloc(ptr,sz)
+    #define RL_FREE(ptr)      CountedFree(ptr)
+#endif
+
+#endif // ALLOC_HOOK_H
@@ -0,0 +1,167 @@
+// assets.c - models and renderers shared by every scene (see assets.h)
+#include "assets.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Assets are found by a "kind:file" key. There are a few dozen at most, a
+// scan is enough. The keys are the cache's own copies: in the global name
+// interner they'd take ids next to the level's box names.
+typedef void (*AssetUnloadFunc)(void *asset);
+
+typedef struct Asset {
+    char *key;                   // own copy
+    void *data;                  // own allocation, so pointers survive the table growing
+    AssetUnloadFunc unload;
+} Asset;
+
+static struct {
+    Asset *assets;
+    int count;
+    int capacity;
+    AssetStats stats;
+} cache = { 0 };
+
+static void *FindAsset(const char *key)
+{
+    for (int i = 0; i < cache.count; i++)
+        if (strcmp(cache.assets[i].key, key) == 0)
+        {
+            cache.stats.reuses++;
+            return cache.assets[i].data;
+        }
+    return NULL;
+}
+
+// Zeroed storage for a new asset, NULL when out of memory
+static void *AddAsset(const char *key, size_t size, AssetUnloadFunc unload)
+{
+    if (cache.count == cache.capacity)
+    {
+        int capacity = (cache.capacity > 0) ? 2*cache.capacity : 16;
+        Asset *assets = RL_REALLOC(cache.assets, (size_t)capacity*sizeof(Asset));
+        if (!assets) return NULL;
+        cache.assets = assets;
+        cache.capacity = capacity;
+    }
+    size_t keyLength = strlen(key);
+    char *keyCopy = RL_MALLOC(keyLength + 1);
+    void *data = RL_CALLOC(1, size);
+    if (!keyCopy || !data) { RL_FREE(keyCopy); RL_FREE(data); return NULL; }
+    memcpy(keyCopy, key, keyLength + 1);
+    cache.assets[cache.count++] = (Asset){ keyCopy, data, unload };
+    cache.stats.resident = cache.count;
+    cache.stats.loads++;
+    return data;
+}
+
+// For the asset AddAsset() made last
+static void EndAssetLoad(double start)
+{
+    double ms = (GetTime() - start)*1000.0;
+    cache.stats.loadMs += ms;
+    TraceLog(LOG_INFO, "ASSETS: Loaded %s in %.2f ms", cache.assets[cache.count - 1].key, ms);
+}
+
+/* ── kinds ─────────────────────────────────────────────────────────── */
+static void UnloadModelAsset(void *asset) { UnloadModel(*(Model *)asset); }
+static void UnloadLineMeshAsset(void *asset) { UnloadLineMesh(*(LineMesh *)asset); }
+static void UnloadCrowdAsset(void *asset) { UnloadCrowdRenderer(asset); }
+static void UnloadCylinderAsset(void *asset) { UnloadCylinderRenderer(asset); }
+static void UnloadShaderAsset(void *asset) { UnloadShader(*(Shader *)asset); }
+
+Model *GetSharedModel(const char *fileName)
+{
+    const char *key = TextFormat("model:%s", fileName);
+    Model *model = FindAsset(key);
+    if (model) return model;
+
+    double start = GetTime();
+    model = AddAsset(key, sizeof(Model), UnloadModelAsset);     // copies key, loading uses TextFormat() too
+    if (!model) return NULL;
+    *model = LoadModel(fileName);
+    EndAssetLoad(start);
+    return model;
+}
+
+LineMesh *GetSharedModelWires(const char *fileName)
+{
+    const char *key = TextFormat("wires:%s", fileName);
+    LineMesh *wires = FindAsset(key);
+    if (wires) return wires;
+    Model *model = GetSharedModel(fileName);
+    if (!model) return NULL;
+    key = TextFormat("wires:%s", fileName);            // TextFormat()'s buffers rotate
+
+    double start = GetTime();
+    wires = AddAsset(key, sizeof(LineMesh), UnloadLineMeshAsset);
+    if (!wires) return NULL;
+    *wires = GenLineMeshFromModel(*model);
+    EndAssetLoad(start);
+    return wires;
+}
+
+CrowdRenderer *GetSharedCrowdRenderer(const char *fileName)
+{
+    const char *key = TextFormat("crowd:%s", fileName);
+    CrowdRenderer *crowd = FindAsset(key);
+    if (crowd) return crowd;
+    Model *model = GetSharedModel(fileName);
+    if (!model) return NULL;
+    key = TextFormat("crowd:%s", fileName);            // TextFormat()'s buffers rotate
+
+    double start = GetTime();
+    crowd = AddAsset(key, sizeof(CrowdRenderer), UnloadCrowdAsset);
+    if (!crowd) return NULL;
+    *crowd = LoadCrowdRenderer(*model);                  // the model is resident as long as the renderer
+    EndAssetLoad(start);
+    return crowd;
+}
+
+CylinderRenderer *GetSharedCylinderRenderer(void)
+{
+    CylinderRenderer *cylinders = FindAsset("cylinders");
+    if (cylinders) return cylinders;
+
+    double start = GetTime();
+    CylinderRenderer built = LoadCylinderRenderer();
+    cylinders = AddAsset("cylinders", sizeof(CylinderRenderer), UnloadCylinderAsset);
+    if (!cylinders) { UnloadCylinderRenderer(&built); return NULL; }
+    *cylinders = built;
+    EndAssetLoad(start);
+    return cylinders;
+}
+
+Shader GetSharedLineShader(void)
+{
+    Shader *shader = FindAsset("shader:lines");
+    if (shader) return *shader;
+
+    double start = GetTime();
+    Shader built = LoadLineShader();
+    shader = AddAsset("shader:lines", sizeof(Shader), UnloadShaderAsset);
+    if (!shader) return built;                           // works, but isn't shared
+    *shader = built;
+    EndAssetLoad(start);
+    return built;
+}
+
+AssetStats GetAssetStats(void)
+{
+    return cache.stats;
+}
+
+void UnloadAssets(void)
+{
+    // Newest first, what's built from a model goes before the model
+    for (int i = cache.count - 1; i >= 0; i--)
+    {
+        cache.assets[i].unload(cache.assets[i].data);
+        RL_FREE(cache.assets[i].data);
+        RL_FREE(cache.assets[i].key);
+    }
+    RL_FREE(cache.assets);
+    cache.assets = NULL;
+    cache.count = cache.capacity = 0;
+    cache.stats.resident = 0;
+}
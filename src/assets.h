@@ -0,0 +1,39 @@
+// assets.h - models and renderers shared by every scene
+//
+// Scenes ask for models, and the things built from them at load (unique
+// edge wireframes, crowd LODs, the cylinder meshes), here instead of
+// loading them. The first request loads; later ones, from any scene, get
+// the copy already resident. Nothing is unloaded before UnloadAssets() at
+// exit, so switching back and forth between scenes loads each asset once.
+//
+// Returned pointers stay valid until UnloadAssets(), NULL only when out of
+// memory. Assets are shared: scenes don't unload them, and what a scene
+// changes in one (a model's transform, a material's shader) every scene
+// sees. Renderers are left empty by their draw calls, so one scene's
+// instances never reach another.
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stddef.h>
+#include "raylib.h"
+#include "line_mesh.h"
+#include "instancing.h"
+#include "crowd.h"
+
+typedef struct AssetStats {
+    int resident;
+    int loads;                   // since the start, each one an asset built
+    int reuses;                  // requests answered by a resident asset
+    double loadMs;               // spent loading, all loads
+} AssetStats;
+
+Model *GetSharedModel(const char *fileName);
+LineMesh *GetSharedModelWires(const char *fileName);            // GenLineMeshFromModel() of the shared model
+CrowdRenderer *GetSharedCrowdRenderer(const char *fileName);    // LoadCrowdRenderer() of the shared model
+CylinderRenderer *GetSharedCylinderRenderer(void);
+Shader GetSharedLineShader(void);
+
+AssetStats GetAssetStats(void);
+void UnloadAssets(void);                                        // Before CloseWindow()
+
+#endif // ASSETS_H
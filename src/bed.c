@@ -1,6 +1,14 @@
 ﻿#include "raylib.h"
 #include "rcamera.h"
 #include "raymath.h"
+#include "frustum.h"
+#include "line_mesh.h"
+#include "hud.h"
+#include "instancing.h"
+#include "obstacles.h"
+#include "assets.h"
+#include "scene.h"
+#include "frame_arena.h"
 
 #define MAX_CYL_COLS   12
 #define MAX_BOX_COLS   12
@@ -17,175 +25,237 @@ static BoundingBox MakeCubeBox(Vector3 centre, float w, float h, float d)
     };
 }
 
-/* -------------------------------------------------------------------------------------- */
-int main(void)
+/* bounds of every column and box obstacle into bounds, which has room for them all; returns how many */
+static int GetObstacleBoxes(const Obstacles *obstacles, BoundingBox *bounds)
 {
-    const int screenW = 1280, screenH = 720;
-    InitWindow(screenW, screenH, "raylib – FINAL: scaled models + perfect bounding boxes");
+    int count = 0;
+    EcsQuery columns = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->cylinder), 0);
+    while (NextQueryChunk(&columns))
+    {
+        const Vector3 *pos = GetQueryColumn(&columns, obstacles->position);
+        const CylinderShape *shape = GetQueryColumn(&columns, obstacles->cylinder);
+        for (int i = 0; i < columns.count; i++)
+            bounds[count++] = MakeCubeBox(pos[i], shape[i].radius * 2.0f, shape[i].height, shape[i].radius * 2.0f);
+    }
+
+    EcsQuery boxes = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->box), 0);
+    while (NextQueryChunk(&boxes))
+    {
+        const Vector3 *pos = GetQueryColumn(&boxes, obstacles->position);
+        const BoxShape *shape = GetQueryColumn(&boxes, obstacles->box);
+        for (int i = 0; i < boxes.count; i++)
+            bounds[count++] = MakeCubeBox(pos[i], shape[i].size.x, shape[i].size.y, shape[i].size.z);
+    }
+    return count;
+}
+
+/* ---------- Scene state --------------------------------------------------------------- */
+static struct {
+    Hud hud;
+    int hudMode, hudDrawn;
+    CylinderRenderer *cylinders;
+
+    Camera camera;
+    int cameraMode;
+    Vector3 playerPos;
+
+    /* shared with the other scenes, scaled here when drawn */
+    Model *humanModel, *bedModel;
+    LineMesh *humanWires, *bedWires;     // wireframe overlays, every edge once, drawn in one call each
+    Shader wireShader;
+    float humanScale;
+    BoundingBox humanBounds;
+    float bedScale;
+    Vector3 bedPos;
+    BoundingBox bedBox;                  // real bounding box, collided with and culled
+
+    Obstacles obstacles;                 // entities with a position, a shape and a color
+    FrameArena frameArena;               // per frame scratch, the bounds collided with
+} bed;
+
+static bool InitBedScene(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    bed.hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    SetHudLine(&bed.hud, AddHudLine(&bed.hud, 10, 10, 10, BLACK), "Modes: [1] Free  [2] First‑person  [3] Third‑person");
+    bed.hudMode = AddHudLine(&bed.hud, 10, 25, 10, BLACK);
+    bed.hudDrawn = AddHudLine(&bed.hud, 10, 40, 10, BLACK);
+    bed.cylinders = GetSharedCylinderRenderer();
 
     /* camera + player setup ---------------------------------------------------------- */
-    Camera camera = { 0 };
-    camera.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
-    camera.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
-    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-    camera.fovy = 60.0f;
-    camera.projection = CAMERA_PERSPECTIVE;
-    int cameraMode = CAMERA_FIRST_PERSON;
-
-    Vector3 playerPos = camera.target;
-    Vector3 prevPlayerPos, prevCamPos, prevCamTarget;
-
-    /* Load human model */
-    Model humanModel = LoadModel("Resources/human.obj");
-    float humanScale = 0.1f;    // smaller
-
-    /* Load bed model */
-    Model bedModel = LoadModel("Resources/bed_fixed.obj");
-    float bedScale = 1.5f;        // bigger
-    Vector3 bedPos = (Vector3){ 5.0f, 0.5f * bedScale, 5.0f };  // center based on bed scale
+    bed.camera = (Camera){ 0 };
+    bed.camera.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
+    bed.camera.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
+    bed.camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    bed.camera.fovy = 60.0f;
+    bed.camera.projection = CAMERA_PERSPECTIVE;
+    bed.cameraMode = CAMERA_FIRST_PERSON;
+
+    bed.playerPos = bed.camera.target;
+
+    /* human and bed models */
+    bed.humanModel = GetSharedModel("human.obj");
+    bed.bedModel = GetSharedModel("bed_fixed.obj");
+    bed.humanWires = GetSharedModelWires("human.obj");
+    bed.bedWires = GetSharedModelWires("bed_fixed.obj");
+    bed.wireShader = GetSharedLineShader();
+    bed.obstacles = LoadObstacles();
+    bed.frameArena = LoadFrameArena(16 * 1024);
+    if (!bed.humanModel || !bed.bedModel || !bed.humanWires || !bed.bedWires || !bed.cylinders || !bed.obstacles.world)
+    {
+        UnloadFrameArena(&bed.frameArena);
+        UnloadObstacles(&bed.obstacles);
+        UnloadHud(&bed.hud);
+        return false;
+    }
 
-    /* cylinder obstacles */
-    float cylR[MAX_CYL_COLS], cylH[MAX_CYL_COLS];
-    Vector3 cylPos[MAX_CYL_COLS];
-    Color cylClr[MAX_CYL_COLS];
+    bed.humanScale = 0.1f;    // smaller
+    bed.humanBounds = GetModelBoundingBox(*bed.humanModel);
+    bed.bedScale = 1.5f;      // bigger
+    bed.bedPos = (Vector3){ 5.0f, 0.5f * bed.bedScale, 5.0f };  // center based on bed scale
+
+    bed.bedBox = GetMeshBoundingBox(bed.bedModel->meshes[0]);
+    bed.bedBox.min = Vector3Add(Vector3Scale(bed.bedBox.min, bed.bedScale), bed.bedPos);
+    bed.bedBox.max = Vector3Add(Vector3Scale(bed.bedBox.max, bed.bedScale), bed.bedPos);
 
+    /* cylinder obstacles */
     for (int i = 0; i < MAX_CYL_COLS; i++)
     {
-        cylR[i] = (float)GetRandomValue(5, 15) / 10.0f;
-        cylH[i] = (float)GetRandomValue(2, 8);
-        cylPos[i] = (Vector3){
+        float radius = (float)GetRandomValue(5, 15) / 10.0f;
+        float height = (float)GetRandomValue(2, 8);
+        Vector3 pos = (Vector3){
             GetRandomValue(-15,15),
-            cylH[i] * 0.5f,
+            height * 0.5f,
             GetRandomValue(-15,15)
         };
-        cylClr[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        AddCylinderObstacle(&bed.obstacles, pos, radius, height, (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 }, 0);
     }
 
     /* box obstacles */
-    float boxW[MAX_BOX_COLS], boxD[MAX_BOX_COLS], boxH[MAX_BOX_COLS];
-    Vector3 boxPos[MAX_BOX_COLS];
-    Color boxClr[MAX_BOX_COLS];
-
     for (int i = 0; i < MAX_BOX_COLS; i++)
     {
-        boxW[i] = (float)GetRandomValue(10, 30) / 10.0f;
-        boxD[i] = (float)GetRandomValue(10, 30) / 10.0f;
-        boxH[i] = (float)GetRandomValue(2, 8);
-        boxPos[i] = (Vector3){
+        Vector3 size;
+        size.x = (float)GetRandomValue(10, 30) / 10.0f;
+        size.z = (float)GetRandomValue(10, 30) / 10.0f;
+        size.y = (float)GetRandomValue(2, 8);
+        Vector3 pos = (Vector3){
             GetRandomValue(-15,15),
-            boxH[i] * 0.5f,
+            size.y * 0.5f,
             GetRandomValue(-15,15)
         };
-        boxClr[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        AddBoxObstacle(&bed.obstacles, pos, size, (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 }, 0);
     }
 
     DisableCursor();
     SetTargetFPS(60);
+    return true;
+}
+
+/* ------------------------------------- MAIN LOOP --------------------------------- */
+static void UpdateBedScene(void)
+{
+    EndFrameArena(&bed.frameArena);
+    Vector3 prevPlayerPos = bed.playerPos;
+    Vector3 prevCamPos = bed.camera.position;
+    Vector3 prevCamTarget = bed.camera.target;
+
+    if (IsKeyPressed(KEY_ONE)) bed.cameraMode = CAMERA_FREE;
+    if (IsKeyPressed(KEY_TWO)) bed.cameraMode = CAMERA_FIRST_PERSON;
+    if (IsKeyPressed(KEY_THREE)) bed.cameraMode = CAMERA_THIRD_PERSON;
 
-    /* ------------------------------------- MAIN LOOP --------------------------------- */
-    while (!WindowShouldClose())
+    UpdateCamera(&bed.camera, bed.cameraMode);
+
+    if (bed.cameraMode == CAMERA_FIRST_PERSON)
+    {
+        bed.playerPos = bed.camera.position;
+    }
+    else if (bed.cameraMode == CAMERA_THIRD_PERSON)
     {
-        prevPlayerPos = playerPos;
-        prevCamPos = camera.position;
-        prevCamTarget = camera.target;
-
-        if (IsKeyPressed(KEY_ONE)) cameraMode = CAMERA_FREE;
-        if (IsKeyPressed(KEY_TWO)) cameraMode = CAMERA_FIRST_PERSON;
-        if (IsKeyPressed(KEY_THREE)) cameraMode = CAMERA_THIRD_PERSON;
-
-        UpdateCamera(&camera, cameraMode);
-
-        if (cameraMode == CAMERA_FIRST_PERSON)
-        {
-            playerPos = camera.position;
-        }
-        else if (cameraMode == CAMERA_THIRD_PERSON)
-        {
-            playerPos = camera.target;
-            camera.target = playerPos;
-        }
-
-        /* --- collision check --- */
-        bool hit = false;
-
-        /* Make bounding box for player */
-        BoundingBox playerBox = MakeCubeBox(playerPos,
-            PLAYER_WIDTH * humanScale,
-            PLAYER_HEIGHT * humanScale,
-            PLAYER_DEPTH * humanScale
-        );
-
-
-        /* Check cylinders */
-        for (int i = 0; i < MAX_CYL_COLS && !hit; i++)
-        {
-            BoundingBox cylBox = MakeCubeBox(cylPos[i], cylR[i] * 2.0f, cylH[i], cylR[i] * 2.0f);
-            if (CheckCollisionBoxes(playerBox, cylBox)) hit = true;
-        }
-
-        /* Check boxes */
-        for (int i = 0; i < MAX_BOX_COLS && !hit; i++)
-        {
-            BoundingBox box = MakeCubeBox(boxPos[i], boxW[i], boxH[i], boxD[i]);
-            if (CheckCollisionBoxes(playerBox, box)) hit = true;
-        }
-
-        /* Check bed model using real bounding box */
-        BoundingBox bedBox = GetMeshBoundingBox(bedModel.meshes[0]);
-        bedBox.min = Vector3Scale(bedBox.min, bedScale);
-        bedBox.max = Vector3Scale(bedBox.max, bedScale);
-        bedBox.min = Vector3Add(bedBox.min, bedPos);
-        bedBox.max = Vector3Add(bedBox.max, bedPos);
-
-        if (!hit && CheckCollisionBoxes(playerBox, bedBox)) hit = true;
-
-        if (hit)
-        {
-            playerPos = prevPlayerPos;
-            camera.position = prevCamPos;
-            camera.target = prevCamTarget;
-        }
-
-        /* ---------------- DRAW ---------------- */
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        BeginMode3D(camera);
-        DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
-
-        for (int i = 0; i < MAX_CYL_COLS; i++)
-        {
-            DrawCylinder(cylPos[i], cylR[i], cylR[i], cylH[i], 16, cylClr[i]);
-            DrawCylinderWires(cylPos[i], cylR[i], cylR[i], cylH[i], 16, MAROON);
-        }
-
-        for (int i = 0; i < MAX_BOX_COLS; i++)
-        {
-            DrawCube(boxPos[i], boxW[i], boxH[i], boxD[i], boxClr[i]);
-            DrawCubeWires(boxPos[i], boxW[i], boxH[i], boxD[i], DARKBLUE);
-        }
-
-        /* draw the bed */
-        DrawModel(bedModel, bedPos, bedScale, WHITE);
-        DrawModelWires(bedModel, bedPos, bedScale, DARKPURPLE);
-
-        /* draw the human */
-        if (cameraMode == CAMERA_THIRD_PERSON)
-        {
-            DrawModel(humanModel, playerPos, humanScale, WHITE);
-            DrawModelWires(humanModel, playerPos, humanScale, DARKPURPLE);
-        }
-        EndMode3D();
-
-        DrawText("Modes: [1] Free  [2] First‑person  [3] Third‑person", 10, 10, 10, BLACK);
-        DrawText(TextFormat("Current: %s",
-            cameraMode == CAMERA_FREE ? "FREE" :
-            cameraMode == CAMERA_FIRST_PERSON ? "FIRST PERSON" : "THIRD PERSON"), 10, 25, 10, BLACK);
-        EndDrawing();
+        bed.playerPos = bed.camera.target;
+        bed.camera.target = bed.playerPos;
     }
 
-    UnloadModel(humanModel);
-    UnloadModel(bedModel);
-    CloseWindow();
-    return 0;
+    /* --- collision check --- */
+
+    /* Make bounding box for player */
+    BoundingBox playerBox = MakeCubeBox(bed.playerPos,
+        PLAYER_WIDTH * bed.humanScale,
+        PLAYER_HEIGHT * bed.humanScale,
+        PLAYER_DEPTH * bed.humanScale
+    );
+
+    /* Check cylinders and boxes, then the bed */
+    BoundingBox *boxes = FrameAllocArray(&bed.frameArena, BoundingBox, GetEntityCount(bed.obstacles.world) + 1);
+    int boxCount = 0;
+    if (boxes)
+    {
+        boxCount = GetObstacleBoxes(&bed.obstacles, boxes);
+        boxes[boxCount++] = bed.bedBox;
+    }
+    bool hit = false;
+    for (int i = 0; i < boxCount && !hit; i++) hit = CheckCollisionBoxes(playerBox, boxes[i]);
+
+    if (hit)
+    {
+        bed.playerPos = prevPlayerPos;
+        bed.camera.position = prevCamPos;
+        bed.camera.target = prevCamTarget;
+    }
 }
+
+static void DrawBedScene(void)
+{
+    /* frustum culling: only objects in view are submitted */
+    Frustum frustum = GetCameraFrustum(bed.camera, (float)GetScreenWidth() / (float)GetScreenHeight());
+    int drawnObjects = 0;
+    int totalObjects = GetEntityCount(bed.obstacles.world) + 1 + (bed.cameraMode == CAMERA_THIRD_PERSON ? 1 : 0);
+
+    ClearBackground(RAYWHITE);
+
+    BeginMode3D(bed.camera);
+    DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
+
+    SetCylinderCamera(bed.cylinders, bed.camera, GetScreenHeight());
+    drawnObjects += AddCylinderObstacleInstances(&bed.obstacles, bed.cylinders, &frustum, 0);
+    DrawCylinderInstances(bed.cylinders, MAROON);
+
+    drawnObjects += DrawBoxObstacles(&bed.obstacles, &frustum, DARKBLUE, 0);
+
+    /* draw the bed */
+    if (IsBoxInFrustum(&frustum, bed.bedBox))
+    {
+        drawnObjects++;
+        DrawModel(*bed.bedModel, bed.bedPos, bed.bedScale, WHITE);
+        DrawLineMeshModel(*bed.bedWires, bed.wireShader, *bed.bedModel, bed.bedPos, bed.bedScale, DARKPURPLE);
+    }
+
+    /* draw the human */
+    BoundingBox humanBox = {
+        Vector3Add(Vector3Scale(bed.humanBounds.min, bed.humanScale), bed.playerPos),
+        Vector3Add(Vector3Scale(bed.humanBounds.max, bed.humanScale), bed.playerPos)
+    };
+    if (bed.cameraMode == CAMERA_THIRD_PERSON && IsBoxInFrustum(&frustum, humanBox))
+    {
+        drawnObjects++;
+        DrawModel(*bed.humanModel, bed.playerPos, bed.humanScale, WHITE);
+        DrawLineMeshModel(*bed.humanWires, bed.wireShader, *bed.humanModel, bed.playerPos, bed.humanScale, DARKPURPLE);
+    }
+    EndMode3D();
+
+    SetHudLine(&bed.hud, bed.hudMode, bed.cameraMode == CAMERA_FREE ? "Current: FREE" :
+        bed.cameraMode == CAMERA_FIRST_PERSON ? "Current: FIRST PERSON" : "Current: THIRD PERSON");
+    SetHudLineF(&bed.hud, bed.hudDrawn, "Drawn: %d / %d objects", drawnObjects, totalObjects);
+    DrawHud(&bed.hud);
+}
+
+static void UnloadBedScene(void)
+{
+    UnloadFrameArena(&bed.frameArena);
+    UnloadObstacles(&bed.obstacles);
+    UnloadHud(&bed.hud);
+}
+
+const Scene BedScene = {
+    .name = "bed", .title = "raylib – FINAL: scaled models + perfect bounding boxes", .width = 1280, .height = 720,
+    .init = InitBedScene, .update = UpdateBedScene, .draw = DrawBedScene, .unload = UnloadBedScene
+};
@@ -7,6 +7,8 @@
 #include "raylib.h"
 #include "rcamera.h"
 #include "raymath.h"
+#include "hud.h"
+#include "scene.h"
 
 #define MAX_COLUMNS   20
 #define PLAYER_SIZE   1.0f            // Cube side length (1×1×1)
@@ -20,112 +22,130 @@ static BoundingBox MakeCubeBox(Vector3 centre, float w, float h, float d)
     };
 }
 
-int main(void)
-{
-    const int screenW = 1920, screenH = 1080;
-    InitWindow(screenW, screenH, "raylib – player cube with collisions");
-
-    /* --- Camera & player -------------------------------------------------------------- */
-    Camera camera = { 0 };
-    camera.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
-    camera.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
-    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-    camera.fovy = 60.0f;
-    camera.projection = CAMERA_PERSPECTIVE;
+/* ------------------------------ SCENE STATE --------------------------------------------- */
+static struct {
+    Hud hud;
+    int hudMode;
 
-    int cameraMode = CAMERA_FIRST_PERSON;       // Start in FPS view
-    Vector3 playerPos = camera.position;        // Player cube centre
-    Vector3 prevPlayerPos, prevCamPos, prevCamTarget;
+    Camera camera;
+    int cameraMode;
+    Vector3 playerPos;                          // Player cube centre
 
-    /* --- World geometry (random columns) --------------------------------------------- */
     float    colHeights[MAX_COLUMNS];
     Vector3  colPos[MAX_COLUMNS];
     Color    colColor[MAX_COLUMNS];
+} cube;
+
+static bool InitCubeScene(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    cube.hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    SetHudLine(&cube.hud, AddHudLine(&cube.hud, 10, 10, 10, BLACK), "Modes: [1] Free  [2] First‑person  [3] Third‑person");
+    cube.hudMode = AddHudLine(&cube.hud, 10, 25, 10, BLACK);
+
+    /* --- Camera & player -------------------------------------------------------------- */
+    cube.camera = (Camera){ 0 };
+    cube.camera.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
+    cube.camera.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
+    cube.camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    cube.camera.fovy = 60.0f;
+    cube.camera.projection = CAMERA_PERSPECTIVE;
 
+    cube.cameraMode = CAMERA_FIRST_PERSON;      // Start in FPS view
+    cube.playerPos = cube.camera.position;
+
+    /* --- World geometry (random columns) --------------------------------------------- */
     for (int i = 0; i < MAX_COLUMNS; i++)
     {
-        colHeights[i] = (float)GetRandomValue(1, 12);
-        colPos[i] = (Vector3){ GetRandomValue(-15, 15), colHeights[i] * 0.5f, GetRandomValue(-15, 15) };
-        colColor[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        cube.colHeights[i] = (float)GetRandomValue(1, 12);
+        cube.colPos[i] = (Vector3){ GetRandomValue(-15, 15), cube.colHeights[i] * 0.5f, GetRandomValue(-15, 15) };
+        cube.colColor[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
     }
 
     DisableCursor();
     SetTargetFPS(60);
+    return true;
+}
+
+/* ------------------------------ GAME LOOP ------------------------------------------------ */
+static void UpdateCubeScene(void)
+{
+    /* --- Save state for collision rollback --------------------------------------- */
+    Vector3 prevPlayerPos = cube.playerPos;
+    Vector3 prevCamPos = cube.camera.position;
+    Vector3 prevCamTarget = cube.camera.target;
+
+    /* --- Mode switching ---------------------------------------------------------- */
+    if (IsKeyPressed(KEY_ONE))   cube.cameraMode = CAMERA_FREE;
+    if (IsKeyPressed(KEY_TWO))   cube.cameraMode = CAMERA_FIRST_PERSON;
+    if (IsKeyPressed(KEY_THREE)) cube.cameraMode = CAMERA_THIRD_PERSON;
+
+    /* --- Update camera via raylib helper ---------------------------------------- */
+    UpdateCamera(&cube.camera, cube.cameraMode);
 
-    /* ------------------------------ GAME LOOP ----------------------------------------- */
-    while (!WindowShouldClose())
+    /* --- Sync player ↔ camera --------------------------------------------------- */
+    if (cube.cameraMode == CAMERA_FIRST_PERSON)
     {
-        /* --- Save state for collision rollback --------------------------------------- */
-        prevPlayerPos = playerPos;
-        prevCamPos = camera.position;
-        prevCamTarget = camera.target;
-
-        /* --- Mode switching ---------------------------------------------------------- */
-        if (IsKeyPressed(KEY_ONE))   cameraMode = CAMERA_FREE;
-        if (IsKeyPressed(KEY_TWO))   cameraMode = CAMERA_FIRST_PERSON;
-        if (IsKeyPressed(KEY_THREE)) cameraMode = CAMERA_THIRD_PERSON;
-
-        /* --- Update camera via raylib helper ---------------------------------------- */
-        UpdateCamera(&camera, cameraMode);
-
-        /* --- Sync player ↔ camera --------------------------------------------------- */
-        if (cameraMode == CAMERA_FIRST_PERSON)
-        {
-            playerPos = camera.position;                     // cube is invisible but collides
-        }
-        else if (cameraMode == CAMERA_THIRD_PERSON)
-        {
-            playerPos = camera.target;                       // cube visible at target
-            camera.target = playerPos;                           // keep looking at player
-        }
-
-        /* --- Collision test --------------------------------------------------------- */
-        BoundingBox playerBox = MakeCubeBox(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE);
-
-        bool hit = false;
-        for (int i = 0; i < MAX_COLUMNS && !hit; i++)
-        {
-            BoundingBox colBox = MakeCubeBox(colPos[i], 2.0f, colHeights[i], 2.0f);
-            if (CheckCollisionBoxes(playerBox, colBox)) hit = true;
-        }
-
-        if (hit)
-        {
-            /* Roll back everything */
-            playerPos = prevPlayerPos;
-            camera.position = prevCamPos;
-            camera.target = prevCamTarget;
-        }
-
-        /* --- DRAW ------------------------------------------------------------------- */
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        BeginMode3D(camera);
-        DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
-
-        /* World columns */
-        for (int i = 0; i < MAX_COLUMNS; i++)
-        {
-            DrawCube(colPos[i], 2, colHeights[i], 2, colColor[i]);
-            DrawCubeWires(colPos[i], 2, colHeights[i], 2, MAROON);
-        }
-
-        /* Player cube (only in 3rd‑person) */
-        if (cameraMode == CAMERA_THIRD_PERSON)
-        {
-            DrawCube(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, PURPLE);
-            DrawCubeWires(playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, DARKPURPLE);
-        }
-        EndMode3D();
-
-        DrawText("Modes: [1] Free  [2] First‑person  [3] Third‑person", 10, 10, 10, BLACK);
-        DrawText(TextFormat("Current: %s",
-            cameraMode == CAMERA_FREE ? "FREE" :
-            cameraMode == CAMERA_FIRST_PERSON ? "FIRST PERSON" : "THIRD PERSON"), 10, 25, 10, BLACK);
-        EndDrawing();
+        cube.playerPos = cube.camera.position;           // cube is invisible but collides
     }
+    else if (cube.cameraMode == CAMERA_THIRD_PERSON)
+    {
+        cube.playerPos = cube.camera.target;             // cube visible at target
+        cube.camera.target = cube.playerPos;             // keep looking at player
+    }
+
+    /* --- Collision test --------------------------------------------------------- */
+    BoundingBox playerBox = MakeCubeBox(cube.playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE);
 
-    CloseWindow();
-    return 0;
+    bool hit = false;
+    for (int i = 0; i < MAX_COLUMNS && !hit; i++)
+    {
+        BoundingBox colBox = MakeCubeBox(cube.colPos[i], 2.0f, cube.colHeights[i], 2.0f);
+        if (CheckCollisionBoxes(playerBox, colBox)) hit = true;
+    }
+
+    if (hit)
+    {
+        /* Roll back everything */
+        cube.playerPos = prevPlayerPos;
+        cube.camera.position = prevCamPos;
+        cube.camera.target = prevCamTarget;
+    }
 }
+
+static void DrawCubeScene(void)
+{
+    ClearBackground(RAYWHITE);
+
+    BeginMode3D(cube.camera);
+    DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
+
+    /* World columns */
+    for (int i = 0; i < MAX_COLUMNS; i++)
+    {
+        DrawCube(cube.colPos[i], 2, cube.colHeights[i], 2, cube.colColor[i]);
+        DrawCubeWires(cube.colPos[i], 2, cube.colHeights[i], 2, MAROON);
+    }
+
+    /* Player cube (only in 3rd‑person) */
+    if (cube.cameraMode == CAMERA_THIRD_PERSON)
+    {
+        DrawCube(cube.playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, PURPLE);
+        DrawCubeWires(cube.playerPos, PLAYER_SIZE, PLAYER_SIZE, PLAYER_SIZE, DARKPURPLE);
+    }
+    EndMode3D();
+
+    SetHudLine(&cube.hud, cube.hudMode, cube.cameraMode == CAMERA_FREE ? "Current: FREE" :
+        cube.cameraMode == CAMERA_FIRST_PERSON ? "Current: FIRST PERSON" : "Current: THIRD PERSON");
+    DrawHud(&cube.hud);
+}
+
+static void UnloadCubeScene(void)
+{
+    UnloadHud(&cube.hud);
+}
+
+const Scene CubeScene = {
+    .name = "cube", .title = "raylib – player cube with collisions", .width = 1920, .height = 1080,
+    .init = InitCubeScene, .update = UpdateCubeScene, .draw = DrawCubeScene, .unload = UnloadCubeScene
+};
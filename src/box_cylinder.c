@@ -1,12 +1,23 @@
 /*******************************************************************************************
 *   raylib – cylinder player with cylinder & box obstacles, flat ground
 ********************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
 #include "raylib.h"
 #include "rcamera.h"
 #include "raymath.h"
+#include "hud.h"
+#include "instancing.h"
+#include "obstacles.h"
+#include "assets.h"
+#include "scene.h"
+#include "frame_arena.h"
 
 #define MAX_CYL_COLS   12
+#define STRESS_CYL_COLS 10000     // [C], spread over a bigger floor
 #define MAX_BOX_COLS   12
+#define BENCH_MAX_COLS 1000000    // -bench goes up to this many columns
 #define PLAYER_R       0.5f
 #define PLAYER_H       1.0f
 #define PLAYER_EYE_Y   (PLAYER_H*0.5f)
@@ -43,120 +54,353 @@ static bool CheckCollisionCylinderBox(Vector3 cPos, float cR, float cH,
     return cornerDistSq <= cR * cR;
 }
 
-/* -------------------------------------------------------------------------------------- */
-int main(void)
+/* ---------- Systems ------------------------------------------------------------------- */
+/* the player against every column then every box, obstacles with any of the none tags skipped */
+static bool CheckCollisionObstacles(const Obstacles *obstacles, Vector3 playerPos, ComponentMask none)
 {
-    const int scrW = 1280, scrH = 720;
-    InitWindow(scrW, scrH, "raylib – flat world with mixed columns");
+    EcsQuery columns = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->cylinder), none);
+    while (NextQueryChunk(&columns))
+    {
+        const Vector3 *pos = GetQueryColumn(&columns, obstacles->position);
+        const CylinderShape *shape = GetQueryColumn(&columns, obstacles->cylinder);
+        for (int i = 0; i < columns.count; i++)
+            if (CheckCollisionCylinders(playerPos, PLAYER_R, PLAYER_H, pos[i], shape[i].radius, shape[i].height)) return true;
+    }
 
-    /* camera + player --------------------------------------------------------------- */
+    EcsQuery boxes = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->box), none);
+    while (NextQueryChunk(&boxes))
+    {
+        const Vector3 *pos = GetQueryColumn(&boxes, obstacles->position);
+        const BoxShape *shape = GetQueryColumn(&boxes, obstacles->box);
+        for (int i = 0; i < boxes.count; i++)
+            if (CheckCollisionCylinderBox(playerPos, PLAYER_R, PLAYER_H, pos[i], shape[i].size.x, shape[i].size.y, shape[i].size.z)) return true;
+    }
+    return false;
+}
+
+/* columns in view, the test a culling pass makes before submitting */
+static int CountVisibleColumns(const Obstacles *obstacles, const Frustum *frustum)
+{
+    int visible = 0;
+    EcsQuery columns = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->cylinder), 0);
+    while (NextQueryChunk(&columns))
+    {
+        const Vector3 *pos = GetQueryColumn(&columns, obstacles->position);
+        const CylinderShape *shape = GetQueryColumn(&columns, obstacles->cylinder);
+        for (int i = 0; i < columns.count; i++)
+        {
+            float halfH = shape[i].height * 0.5f;
+            visible += IsSphereInFrustum(frustum, pos[i], sqrtf(shape[i].radius * shape[i].radius + halfH * halfH));
+        }
+    }
+    return visible;
+}
+
+static Vector3 RandomColumn(int extent, float *r, float *h)
+{
+    *r = (float)GetRandomValue(5, 15) / 10.0f;      // 0.5–1.5 m
+    *h = (float)GetRandomValue(2, 8);             // 2–8 m
+    return (Vector3){ GetRandomValue(-extent,extent), *h * 0.5f, GetRandomValue(-extent,extent) };
+}
+
+/* ---------- Benchmark (-bench) -------------------------------------------------------- */
+/* GetTime() needs the window, the headless run times with the CPU clock */
+static double BenchMs(clock_t start)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/* Collision and culling passes over 1k to 1M columns, through the ECS and
+   through parallel arrays laid out like the obstacles used to be, then half
+   the columns destroyed by handle and the collision pass run again. The
+   player stands below the floor so no pass stops at a hit. */
+static void BenchObstacles(int passes)
+{
     Camera cam = { 0 };
-    cam.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
-    cam.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
+    cam.position = (Vector3){ 0.0f, 10.0f, 0.0f };
+    cam.target = (Vector3){ 50.0f, 0.0f, 50.0f };
     cam.up = (Vector3){ 0.0f, 1.0f, 0.0f };
     cam.fovy = 60.0f;
     cam.projection = CAMERA_PERSPECTIVE;
-    int camMode = CAMERA_FIRST_PERSON;
+    Frustum frustum = GetCameraFrustum(cam, 16.0f / 9.0f);
+    Vector3 below = { 0.0f, -100.0f, 0.0f };
+
+    printf("%d passes, ms per pass\n", passes);
+    printf("columns  spawn ms  collide  ns/column   arrays     cull   arrays  destroy ms  collide half\n");
+    for (int count = 1000; count <= BENCH_MAX_COLS; count *= 10)
+    {
+        Obstacles obstacles = LoadObstacles();
+        Entity  *handles = RL_MALLOC((size_t)count * sizeof(Entity));
+        float   *cylR = RL_MALLOC((size_t)count * sizeof(float)), *cylH = RL_MALLOC((size_t)count * sizeof(float));
+        Vector3 *cylPos = RL_MALLOC((size_t)count * sizeof(Vector3));
+        if (!obstacles.world || !handles || !cylR || !cylH || !cylPos)
+        {
+            printf("%7d  out of memory\n", count);
+            RL_FREE(handles); RL_FREE(cylR); RL_FREE(cylH); RL_FREE(cylPos);
+            UnloadObstacles(&obstacles);
+            break;
+        }
+
+        SetRandomSeed(1);
+        int extent = (int)(150.0f * sqrtf((float)count / (float)STRESS_CYL_COLS));    // same density as [C]
+        for (int i = 0; i < count; i++) cylPos[i] = RandomColumn(extent, &cylR[i], &cylH[i]);
+
+        clock_t start = clock();
+        for (int i = 0; i < count; i++)
+            handles[i] = AddCylinderObstacle(&obstacles, cylPos[i], cylR[i], cylH[i], MAROON, 0);
+        double spawnMs = BenchMs(start);
+
+        int hits = 0, visible = 0;
+        start = clock();
+        for (int p = 0; p < passes; p++) hits += CheckCollisionObstacles(&obstacles, below, 0);
+        double collideMs = BenchMs(start) / passes;
+
+        start = clock();
+        for (int p = 0; p < passes; p++)
+            for (int i = 0; i < count; i++)
+                if (CheckCollisionCylinders(below, PLAYER_R, PLAYER_H, cylPos[i], cylR[i], cylH[i])) { hits++; break; }
+        double arraysCollideMs = BenchMs(start) / passes;
+
+        start = clock();
+        for (int p = 0; p < passes; p++) visible += CountVisibleColumns(&obstacles, &frustum);
+        double cullMs = BenchMs(start) / passes;
+
+        start = clock();
+        for (int p = 0; p < passes; p++)
+            for (int i = 0; i < count; i++)
+            {
+                float halfH = cylH[i] * 0.5f;
+                visible -= IsSphereInFrustum(&frustum, cylPos[i], sqrtf(cylR[i] * cylR[i] + halfH * halfH));
+            }
+        double arraysCullMs = BenchMs(start) / passes;
+
+        /* every other column goes, the rest move into the holes but keep their handles */
+        start = clock();
+        for (int i = 0; i < count; i += 2) DestroyEntity(obstacles.world, handles[i]);
+        double destroyMs = BenchMs(start);
+        const Vector3 *kept = GetComponent(obstacles.world, handles[count - 1], obstacles.position);
+        bool handlesOk = !IsEntityAlive(obstacles.world, handles[0]) && kept && kept->x == cylPos[count - 1].x &&
+            GetEntityCount(obstacles.world) == count / 2;
+
+        start = clock();
+        for (int p = 0; p < passes; p++) hits += CheckCollisionObstacles(&obstacles, below, 0);
+        double halfMs = BenchMs(start) / passes;
+
+        printf("%7d  %8.2f  %7.3f  %9.2f  %7.3f  %7.3f  %7.3f  %10.2f  %12.3f%s%s\n", count, spawnMs, collideMs,
+            collideMs * 1e6 / count, arraysCollideMs, cullMs, arraysCullMs, destroyMs, halfMs,
+            (hits || visible) ? "  MISMATCH" : "", handlesOk ? "" : "  BAD HANDLES");
+
+        RL_FREE(handles); RL_FREE(cylR); RL_FREE(cylH); RL_FREE(cylPos);
+        UnloadObstacles(&obstacles);
+    }
+}
+
+/* ---------- Scene state --------------------------------------------------------------- */
+typedef struct VisibleColumn {
+    Vector3 pos;
+    CylinderShape shape;
+    Color color;
+} VisibleColumn;
 
-    Vector3 playerPos = cam.position;
+static struct {
+    Hud hud;
+    int hudMode, hudColumns;
+    CylinderRenderer *cylinders;             // shared, cached meshes, fewer slices when far
 
-    /* cylinder obstacles ------------------------------------------------------------ */
-    float   cylR[MAX_CYL_COLS], cylH[MAX_CYL_COLS];
-    Vector3 cylPos[MAX_CYL_COLS];
-    Color   cylClr[MAX_CYL_COLS];
+    Camera cam;
+    int camMode;
+    Vector3 playerPos;
 
-    for (int i = 0; i < MAX_CYL_COLS; i++)
+    Obstacles obstacles;                     // entities with a position, a shape and a color
+    ComponentId stress;                      // tag on the columns [C] adds
+    int  cylCount;
+    bool cylInstanced;                       // [L] compares with DrawCylinder()
+    double drawMs, frameMs;                  // CPU, smoothed
+    double frameStart;
+    FrameArena frameArena;                   // per frame scratch, the columns DrawCylinder() draws
+} columns;
+
+static bool InitColumnsScene(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    columns.hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    SetHudLine(&columns.hud, AddHudLine(&columns.hud, 10, 10, 10, BLACK), "Modes: [1] Free  [2] First‑person  [3] Third‑person");
+    columns.hudMode = AddHudLine(&columns.hud, 10, 25, 10, BLACK);
+    columns.hudColumns = AddHudLine(&columns.hud, 10, 40, 10, BLACK);
+    columns.cylinders = GetSharedCylinderRenderer();
+
+    /* camera + player --------------------------------------------------------------- */
+    columns.cam = (Camera){ 0 };
+    columns.cam.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
+    columns.cam.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
+    columns.cam.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    columns.cam.fovy = 60.0f;
+    columns.cam.projection = CAMERA_PERSPECTIVE;
+    columns.camMode = CAMERA_FIRST_PERSON;
+
+    columns.playerPos = columns.cam.position;
+
+    /* obstacles --------------------------------------------------------------------- */
+    columns.obstacles = LoadObstacles();
+    columns.frameArena = LoadFrameArena(256 * 1024);
+    if (!columns.obstacles.world || !columns.cylinders)
     {
-        cylR[i] = (float)GetRandomValue(5, 15) / 10.0f;      // 0.5–1.5 m
-        cylH[i] = (float)GetRandomValue(2, 8);             // 2–8 m
-        cylPos[i] = (Vector3){ GetRandomValue(-15,15), cylH[i] * 0.5f, GetRandomValue(-15,15) };
-        cylClr[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        UnloadFrameArena(&columns.frameArena);
+        UnloadObstacles(&columns.obstacles);
+        UnloadHud(&columns.hud);
+        return false;
     }
+    columns.stress = RegisterComponent(columns.obstacles.world, 0);
+    columns.cylCount = MAX_CYL_COLS;
+    columns.cylInstanced = true;
+    columns.drawMs = columns.frameMs = 0.0;
 
-    /* box obstacles ----------------------------------------------------------------- */
-    float   boxW[MAX_BOX_COLS], boxD[MAX_BOX_COLS], boxH[MAX_BOX_COLS];
-    Vector3 boxPos[MAX_BOX_COLS];
-    Color   boxClr[MAX_BOX_COLS];
+    /* columns, the first MAX_CYL_COLS near the start */
+    for (int i = 0; i < STRESS_CYL_COLS; i++)
+    {
+        float r, h;
+        Vector3 pos = RandomColumn((i < MAX_CYL_COLS) ? 15 : 150, &r, &h);
+        Color clr = { GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        AddCylinderObstacle(&columns.obstacles, pos, r, h, clr, (i < MAX_CYL_COLS) ? 0 : ComponentBit(columns.stress));
+    }
 
+    /* boxes */
     for (int i = 0; i < MAX_BOX_COLS; i++)
     {
-        boxW[i] = (float)GetRandomValue(10, 30) / 10.0f;      // 1–3 m
-        boxD[i] = (float)GetRandomValue(10, 30) / 10.0f;      // 1–3 m
-        boxH[i] = (float)GetRandomValue(2, 8);              // 2–8 m
-        boxPos[i] = (Vector3){ GetRandomValue(-15,15), boxH[i] * 0.5f, GetRandomValue(-15,15) };
-        boxClr[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        Vector3 size = {
+            (float)GetRandomValue(10, 30) / 10.0f,       // 1–3 m
+            (float)GetRandomValue(2, 8),               // 2–8 m
+            (float)GetRandomValue(10, 30) / 10.0f        // 1–3 m
+        };
+        Vector3 pos = { GetRandomValue(-15,15), size.y * 0.5f, GetRandomValue(-15,15) };
+        AddBoxObstacle(&columns.obstacles, pos, size, (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 }, 0);
     }
 
     DisableCursor();
     SetTargetFPS(60);
+    return true;
+}
 
-    /* ------------------------------- LOOP ------------------------------------------ */
-    while (!WindowShouldClose())
-    {
-        Vector3 prevP = playerPos, prevCamPos = cam.position, prevCamTar = cam.target;
-
-        if (IsKeyPressed(KEY_ONE))   camMode = CAMERA_FREE;
-        if (IsKeyPressed(KEY_TWO))   camMode = CAMERA_FIRST_PERSON;
-        if (IsKeyPressed(KEY_THREE)) camMode = CAMERA_THIRD_PERSON;
-
-        UpdateCamera(&cam, camMode);
+/* obstacles [C] hasn't turned on */
+static ComponentMask GetHiddenColumns(void)
+{
+    return (columns.cylCount == MAX_CYL_COLS) ? ComponentBit(columns.stress) : 0;
+}
 
-        if (camMode == CAMERA_FIRST_PERSON) playerPos = cam.position;
-        else if (camMode == CAMERA_THIRD_PERSON)
-        {
-            playerPos = cam.target;
-            cam.target = playerPos;
-        }
+/* ------------------------------- LOOP ------------------------------------------------- */
+static void UpdateColumnsScene(void)
+{
+    columns.frameStart = GetTime();
+    EndFrameArena(&columns.frameArena);
+    Vector3 prevP = columns.playerPos, prevCamPos = columns.cam.position, prevCamTar = columns.cam.target;
 
-        /* ---- collision tests ------------------------------------------------------ */
-        bool hit = false;
+    if (IsKeyPressed(KEY_ONE))   columns.camMode = CAMERA_FREE;
+    if (IsKeyPressed(KEY_TWO))   columns.camMode = CAMERA_FIRST_PERSON;
+    if (IsKeyPressed(KEY_THREE)) columns.camMode = CAMERA_THIRD_PERSON;
+    if (IsKeyPressed(KEY_C))     columns.cylCount = (columns.cylCount == MAX_CYL_COLS) ? STRESS_CYL_COLS : MAX_CYL_COLS;
+    if (IsKeyPressed(KEY_L))     columns.cylInstanced = !columns.cylInstanced;
 
-        for (int i = 0; i < MAX_CYL_COLS && !hit; i++)
-            if (CheckCollisionCylinders(playerPos, PLAYER_R, PLAYER_H,
-                cylPos[i], cylR[i], cylH[i])) hit = true;
+    UpdateCamera(&columns.cam, columns.camMode);
 
-        for (int i = 0; i < MAX_BOX_COLS && !hit; i++)
-            if (CheckCollisionCylinderBox(playerPos, PLAYER_R, PLAYER_H,
-                boxPos[i], boxW[i], boxH[i], boxD[i])) hit = true;
+    if (columns.camMode == CAMERA_FIRST_PERSON) columns.playerPos = columns.cam.position;
+    else if (columns.camMode == CAMERA_THIRD_PERSON)
+    {
+        columns.playerPos = columns.cam.target;
+        columns.cam.target = columns.playerPos;
+    }
 
-        if (hit) { playerPos = prevP; cam.position = prevCamPos; cam.target = prevCamTar; }
+    /* ---- collision tests ------------------------------------------------------ */
+    bool hit = CheckCollisionObstacles(&columns.obstacles, columns.playerPos, GetHiddenColumns());
 
-        /* ------------------------- DRAW ------------------------------------------- */
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+    if (hit) { columns.playerPos = prevP; columns.cam.position = prevCamPos; columns.cam.target = prevCamTar; }
+}
 
-        BeginMode3D(cam);
-        DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
+static void DrawColumnsScene(void)
+{
+    const Obstacles *obstacles = &columns.obstacles;
+    CylinderRenderer *cylinders = columns.cylinders;
+    ComponentMask hidden = GetHiddenColumns();
+    ClearBackground(RAYWHITE);
 
-        /* cylinder obstacles */
-        for (int i = 0; i < MAX_CYL_COLS; i++)
-        {
-            DrawCylinder(cylPos[i], cylR[i], cylR[i], cylH[i], 16, cylClr[i]);
-            DrawCylinderWires(cylPos[i], cylR[i], cylR[i], cylH[i], 16, MAROON);
-        }
+    double drawStart = GetTime();
+    float floorSize = (columns.cylCount > MAX_CYL_COLS) ? 320.0f : 32.0f;
+    BeginMode3D(columns.cam);
+    DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { floorSize, floorSize }, LIGHTGRAY);
 
-        /* box obstacles */
-        for (int i = 0; i < MAX_BOX_COLS; i++)
+    /* cylinder obstacles, both paths culled against the same frustum */
+    Frustum frustum = GetCameraFrustum(columns.cam, (float)GetScreenWidth() / (float)GetScreenHeight());
+    int lodCounts[CYLINDER_LOD_COUNT] = { 0 };
+    if (columns.cylInstanced)
+    {
+        /* instanced: a face and a wire draw per slice count */
+        SetCylinderCamera(cylinders, columns.cam, GetScreenHeight());
+        AddCylinderObstacleInstances(obstacles, cylinders, &frustum, hidden);
+        for (int l = 0; l < CYLINDER_LOD_COUNT; l++) lodCounts[l] = cylinders->instances[l].count;
+        DrawCylinderInstances(cylinders, MAROON);
+    }
+    else
+    {
+        /* the columns in view go in the frame arena, then all faces and all wires: the batch
+           switches between triangles and lines once, not twice per column */
+        VisibleColumn *visible = FrameAllocArray(&columns.frameArena, VisibleColumn, GetEntityCount(obstacles->world));
+        int visibleCount = 0;
+        EcsQuery query = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->cylinder) |
+                                                      ComponentBit(obstacles->color), hidden);
+        while (visible && NextQueryChunk(&query))
         {
-            DrawCube(boxPos[i], boxW[i], boxH[i], boxD[i], boxClr[i]);
-            DrawCubeWires(boxPos[i], boxW[i], boxH[i], boxD[i], DARKBLUE);
+            const Vector3 *pos = GetQueryColumn(&query, obstacles->position);
+            const CylinderShape *shape = GetQueryColumn(&query, obstacles->cylinder);
+            const Color *clr = GetQueryColumn(&query, obstacles->color);
+            for (int i = 0; i < query.count; i++)
+            {
+                float halfH = shape[i].height * 0.5f;
+                if (IsSphereInFrustum(&frustum, pos[i], sqrtf(shape[i].radius * shape[i].radius + halfH * halfH)))
+                    visible[visibleCount++] = (VisibleColumn){ pos[i], shape[i], clr[i] };
+            }
         }
+        for (int v = 0; v < visibleCount; v++)
+            DrawCylinder(visible[v].pos, visible[v].shape.radius, visible[v].shape.radius, visible[v].shape.height, 16, visible[v].color);
+        for (int v = 0; v < visibleCount; v++)
+            DrawCylinderWires(visible[v].pos, visible[v].shape.radius, visible[v].shape.radius, visible[v].shape.height, 16, MAROON);
+    }
 
-        /* player cylinder visible in 3rd‑person */
-        if (camMode == CAMERA_THIRD_PERSON)
-        {
-            DrawCylinder(playerPos, PLAYER_R, PLAYER_R, PLAYER_H, 16, PURPLE);
-            DrawCylinderWires(playerPos, PLAYER_R, PLAYER_R, PLAYER_H, 16, DARKPURPLE);
-        }
-        EndMode3D();
+    /* box obstacles */
+    DrawBoxObstacles(obstacles, NULL, DARKBLUE, hidden);
 
-        DrawText("Modes: [1] Free  [2] First‑person  [3] Third‑person", 10, 10, 10, BLACK);
-        DrawText(TextFormat("Current: %s",
-            camMode == CAMERA_FREE ? "FREE" :
-            camMode == CAMERA_FIRST_PERSON ? "FIRST PERSON" : "THIRD PERSON"), 10, 25, 10, BLACK);
-        EndDrawing();
+    /* player cylinder visible in 3rd‑person */
+    if (columns.camMode == CAMERA_THIRD_PERSON)
+    {
+        AddCylinderInstance(cylinders, columns.playerPos, PLAYER_R, PLAYER_H, PURPLE);
+        DrawCylinderInstances(cylinders, DARKPURPLE);
     }
+    EndMode3D();
+    columns.drawMs = columns.drawMs*0.95 + (GetTime() - drawStart)*1000.0*0.05;
 
-    CloseWindow();
-    return 0;
+    SetHudLine(&columns.hud, columns.hudMode, columns.camMode == CAMERA_FREE ? "Current: FREE" :
+        columns.camMode == CAMERA_FIRST_PERSON ? "Current: FIRST PERSON" : "Current: THIRD PERSON");
+    SetHudLineF(&columns.hud, columns.hudColumns, "Columns [C]: %d %s [L], 3D %.2f ms, frame %.2f ms CPU, 6/8/12/16 slices: %d/%d/%d/%d",
+        columns.cylCount, columns.cylInstanced ? "instanced" : "DrawCylinder", columns.drawMs, columns.frameMs,
+        lodCounts[0], lodCounts[1], lodCounts[2], lodCounts[3]);
+    DrawHud(&columns.hud);
+    columns.frameMs = columns.frameMs*0.95 + (GetTime() - columns.frameStart)*1000.0*0.05;    // before the swap, which waits on vsync
+}
+
+static void UnloadColumnsScene(void)
+{
+    UnloadFrameArena(&columns.frameArena);
+    UnloadObstacles(&columns.obstacles);
+    UnloadHud(&columns.hud);
 }
+
+/* -bench times the obstacle systems without opening a window */
+static void BenchColumnsScene(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    BenchObstacles(20);
+}
+
+const Scene ColumnsScene = {
+    .name = "columns", .title = "raylib – flat world with mixed columns", .width = 1280, .height = 720,
+    .init = InitColumnsScene, .update = UpdateColumnsScene, .draw = DrawColumnsScene, .unload = UnloadColumnsScene,
+    .bench = BenchColumnsScene
+};
@@ -0,0 +1,212 @@
+// crowd.c - instanced characters (see crowd.h)
+#include "crowd.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raymath.h"
+#include "rlgl.h"
+
+/* ── clustering ────────────────────────────────────────────────────── */
+static unsigned int TableSize(int count)
+{
+    unsigned int size = 64;
+    while (size < 2u*(unsigned int)count) size *= 2;
+    return size;
+}
+
+static uint64_t CellKey(Vector3 p, Vector3 origin, float cellSize)
+{
+    // 21 bits per axis, plenty for a grid over one model
+    uint64_t x = (uint64_t)(int64_t)floorf((p.x - origin.x)/cellSize) & 0x1fffff;
+    uint64_t y = (uint64_t)(int64_t)floorf((p.y - origin.y)/cellSize) & 0x1fffff;
+    uint64_t z = (uint64_t)(int64_t)floorf((p.z - origin.z)/cellSize) & 0x1fffff;
+    return (x << 42) | (y << 21) | z;
+}
+
+// Fills remap[] with the cell of every corner and sums[] with the vertices
+// summed per cell, returns how many cells there are
+static int ClusterCorners(Mesh mesh, int corners, Vector3 origin, float cellSize, int *slots, unsigned int mask,
+                          uint64_t *keys, float *sums, int *remap)
+{
+    int cellCount = 0;
+    for (int c = 0; c < corners; c++)
+    {
+        int v = (mesh.indices != NULL) ? mesh.indices[c] : c;
+        Vector3 p = { mesh.vertices[3*v], mesh.vertices[3*v + 1], mesh.vertices[3*v + 2] };
+        uint64_t key = CellKey(p, origin, cellSize);
+        unsigned int slot = (unsigned int)((key*0x9E3779B97F4A7C15ull) >> 40) & mask;
+        while (slots[slot] >= 0 && keys[slots[slot]] != key) slot = (slot + 1) & mask;
+        if (slots[slot] < 0)
+        {
+            keys[cellCount] = key;
+            slots[slot] = cellCount++;
+        }
+        float *sum = &sums[4*slots[slot]];
+        sum[0] += p.x; sum[1] += p.y; sum[2] += p.z; sum[3] += 1.0f;
+        remap[c] = slots[slot];
+    }
+    return cellCount;
+}
+
+static Mesh BuildClusteredMesh(const float *sums, int cellCount, const int *remap, int corners)
+{
+    Mesh mesh = { 0 };
+    mesh.vertices = RL_MALLOC((size_t)cellCount*3*sizeof(float));
+    mesh.indices = RL_MALLOC((size_t)corners*sizeof(unsigned short));
+    if (!mesh.vertices || !mesh.indices) { RL_FREE(mesh.vertices); RL_FREE(mesh.indices); return (Mesh){ 0 }; }
+    for (int i = 0; i < cellCount; i++)
+        for (int k = 0; k < 3; k++) mesh.vertices[3*i + k] = sums[4*i + k]/sums[4*i + 3];
+    mesh.vertexCount = cellCount;
+
+    // Triangles with two corners in one cell have collapsed
+    for (int c = 0; c + 2 < corners; c += 3)
+    {
+        int a = remap[c], b = remap[c + 1], d = remap[c + 2];
+        if (a == b || b == d || a == d) continue;
+        unsigned short *index = &mesh.indices[3*mesh.triangleCount++];
+        index[0] = (unsigned short)a; index[1] = (unsigned short)b; index[2] = (unsigned short)d;
+    }
+    if (mesh.triangleCount == 0) { RL_FREE(mesh.vertices); RL_FREE(mesh.indices); return (Mesh){ 0 }; }
+    return mesh;
+}
+
+Mesh GenMeshClustered(Mesh mesh, Vector3 origin, float cellSize)
+{
+    int corners = (mesh.indices != NULL) ? 3*mesh.triangleCount : mesh.vertexCount;
+    if (mesh.vertices == NULL || corners < 3 || !(cellSize > 0.0f)) return (Mesh){ 0 };
+
+    unsigned int tableSize = TableSize(corners);
+    int *slots = RL_MALLOC(tableSize*sizeof(int));
+    uint64_t *keys = RL_MALLOC((size_t)corners*sizeof(uint64_t));
+    float *sums = RL_CALLOC((size_t)corners*4, sizeof(float));     // x, y, z, vertices in the cell
+    int *remap = RL_MALLOC((size_t)corners*sizeof(int));
+    Mesh result = { 0 };
+    if (slots && keys && sums && remap)
+    {
+        memset(slots, 0xff, tableSize*sizeof(int));
+        int cellCount = ClusterCorners(mesh, corners, origin, cellSize, slots, tableSize - 1, keys, sums, remap);
+        if (cellCount <= 65535) result = BuildClusteredMesh(sums, cellCount, remap, corners);   // raylib indices are 16-bit
+    }
+    RL_FREE(slots);
+    RL_FREE(keys);
+    RL_FREE(sums);
+    RL_FREE(remap);
+    return result;
+}
+
+/* ── renderer ──────────────────────────────────────────────────────── */
+CrowdRenderer LoadCrowdRenderer(Model model)
+{
+    CrowdRenderer crowd = { 0 };
+    crowd.transform = model.transform;
+    crowd.partCount = (model.meshCount < CROWD_MAX_PARTS) ? model.meshCount : CROWD_MAX_PARTS;
+
+    // One grid over all parts so their seams collapse the same way
+    Vector3 min = { INFINITY, INFINITY, INFINITY }, max = { -INFINITY, -INFINITY, -INFINITY };
+    for (int p = 0; p < crowd.partCount; p++)
+    {
+        Mesh mesh = model.meshes[p];
+        for (int v = 0; mesh.vertices != NULL && v < mesh.vertexCount; v++)
+        {
+            Vector3 position = { mesh.vertices[3*v], mesh.vertices[3*v + 1], mesh.vertices[3*v + 2] };
+            min = Vector3Min(min, position);
+            max = Vector3Max(max, position);
+        }
+        crowd.parts[0][p] = mesh;
+        Material *material = (model.materials != NULL) ? &model.materials[model.meshMaterial[p]] : NULL;
+        crowd.partColors[p] = (material && material->maps) ? material->maps[MATERIAL_MAP_DIFFUSE].color : WHITE;
+    }
+    if (min.x > max.x) return crowd;                         // no vertices on the CPU
+    crowd.center = Vector3Scale(Vector3Add(min, max), 0.5f);
+    crowd.radius = 0.5f*Vector3Distance(min, max);
+
+    float longest = fmaxf(max.x - min.x, fmaxf(max.y - min.y, max.z - min.z));
+    const int grid[CROWD_LOD_COUNT] = CROWD_LOD_GRID;
+    for (int l = 1; l < CROWD_LOD_COUNT; l++)
+    {
+        crowd.cellSize[l] = longest/(float)grid[l];
+        for (int p = 0; p < crowd.partCount; p++)
+        {
+            // A part that clusters away entirely is skipped at this level
+            crowd.parts[l][p] = GenMeshClustered(model.meshes[p], min, crowd.cellSize[l]);
+            if (crowd.parts[l][p].vertexCount > 0) UploadMesh(&crowd.parts[l][p], false);
+        }
+    }
+    crowd.shader = LoadInstanceShader(true);
+    return crowd;
+}
+
+void UnloadCrowdRenderer(CrowdRenderer *crowd)
+{
+    for (int l = 1; l < CROWD_LOD_COUNT; l++)
+        for (int p = 0; p < crowd->partCount; p++)
+            if (crowd->parts[l][p].vertexCount > 0) UnloadMesh(crowd->parts[l][p]);
+    for (int l = 0; l < CROWD_LOD_COUNT; l++) UnloadInstanceBuffer(&crowd->instances[l]);
+    if (crowd->shader.id > 0) UnloadInstanceShader(crowd->shader);
+    *crowd = (CrowdRenderer){ 0 };
+}
+
+void SetCrowdCamera(CrowdRenderer *crowd, Camera camera, int screenWidth, int screenHeight)
+{
+    crowd->frustum = GetCameraFrustum(camera, (float)screenWidth/(float)screenHeight);
+    crowd->eye = camera.position;
+    crowd->orthographic = (camera.projection == CAMERA_ORTHOGRAPHIC);
+    if (crowd->orthographic) crowd->pixelsPerUnit = (float)screenHeight/camera.fovy;
+    else crowd->pixelsPerUnit = 0.5f*(float)screenHeight/tanf(0.5f*DEG2RAD*camera.fovy);
+}
+
+bool AddCrowdInstance(CrowdRenderer *crowd, Vector3 position, float scale, float yaw, Color color)
+{
+    // Same transform DrawModelEx() builds for a rotation around +Y
+    Matrix placement = MatrixMultiply(MatrixMultiply(MatrixScale(scale, scale, scale), MatrixRotateY(DEG2RAD*yaw)),
+                                      MatrixTranslate(position.x, position.y, position.z));
+    Matrix transform = MatrixMultiply(crowd->transform, placement);
+    Vector3 center = Vector3Transform(crowd->center, transform);
+    float radius = crowd->radius*scale;
+
+    crowd->stats.characters++;
+    if (!IsSphereInFrustum(&crowd->frustum, center, radius))
+    {
+        crowd->stats.culled++;
+        return false;
+    }
+
+    // Coarsest level whose cells stay within the error on screen
+    float pixels = scale*crowd->pixelsPerUnit;
+    if (!crowd->orthographic)
+    {
+        float distance = Vector3Distance(center, crowd->eye) - radius;
+        pixels = (distance > 0.0f) ? pixels/distance : INFINITY;
+    }
+    int lod = CROWD_LOD_COUNT - 1;
+    while (lod > 0 && crowd->cellSize[lod]*pixels > CROWD_LOD_MAX_ERROR) lod--;
+
+    AddInstance(&crowd->instances[lod], transform, color);
+    crowd->stats.lodCounts[lod]++;
+    return true;
+}
+
+CrowdStats DrawCrowdInstances(CrowdRenderer *crowd)
+{
+    rlDrawRenderBatchActive();
+    for (int l = 0; l < CROWD_LOD_COUNT; l++)
+    {
+        InstanceBuffer *instances = &crowd->instances[l];
+        if (instances->count == 0) continue;
+        UploadInstances(instances);
+        for (int p = 0; p < crowd->partCount; p++)
+        {
+            Mesh part = crowd->parts[l][p];
+            if (part.vertexCount == 0) continue;
+            DrawMeshInstances(part, crowd->shader, instances, crowd->partColors[p]);
+            crowd->stats.drawCalls++;
+            crowd->stats.triangles += (int64_t)part.triangleCount*instances->count;
+        }
+        ClearInstances(instances);
+    }
+
+    CrowdStats stats = crowd->stats;
+    crowd->stats = (CrowdStats){ 0 };
+    return stats;
+}
@@ -0,0 +1,71 @@
+// crowd.h - instanced characters
+//
+// DrawModel() per character submits every mesh of the model again, with its
+// own uniforms, for each character. A CrowdRenderer keeps the model's meshes
+// on the GPU once and draws every character added in a frame with one
+// instanced call per mesh part and level of detail (instancing.h), so a
+// thousand characters cost as many draws as one.
+//
+// Models rarely come with LODs, so coarser ones are built at load by vertex
+// clustering: every vertex snaps to the average of the vertices sharing its
+// cell in a grid over the model, and triangles that collapse are dropped.
+// Each character gets the coarsest level whose cell stays within
+// CROWD_LOD_MAX_ERROR pixels on screen; level 0 is the model as loaded.
+//
+// Characters outside the camera's frustum are dropped when added. Faces are
+// drawn in the instance color times the part's diffuse color, without
+// edges: at crowd sizes a wireframe costs more than the faces.
+#ifndef CROWD_H
+#define CROWD_H
+
+#include <stdint.h>
+#include "raylib.h"
+#include "frustum.h"
+#include "instancing.h"
+
+#define CROWD_MAX_PARTS     8
+#define CROWD_LOD_COUNT     4
+#define CROWD_LOD_GRID      { 0, 64, 24, 10 }   // cells along the model's longest side, 0 = as loaded
+#define CROWD_LOD_MAX_ERROR 2.0f                // pixels
+
+typedef struct CrowdStats {
+    int characters;              // added
+    int culled;                  // outside the frustum
+    int lodCounts[CROWD_LOD_COUNT];
+    int drawCalls;
+    int64_t triangles;
+} CrowdStats;
+
+typedef struct CrowdRenderer {
+    Matrix transform;            // the model's
+    int partCount;
+    Mesh parts[CROWD_LOD_COUNT][CROWD_MAX_PARTS];   // level 0 are the model's meshes, not owned; empty parts are skipped
+    Color partColors[CROWD_MAX_PARTS];
+    float cellSize[CROWD_LOD_COUNT];                // model units
+    Vector3 center;              // bounding sphere, model space
+    float radius;
+
+    Shader shader;
+    InstanceBuffer instances[CROWD_LOD_COUNT];
+
+    // View characters are culled and leveled for, see SetCrowdCamera()
+    Frustum frustum;
+    Vector3 eye;
+    float pixelsPerUnit;         // screen pixels of 1 unit at distance 1 (at any distance for orthographic)
+    bool orthographic;
+    CrowdStats stats;            // since the last draw
+} CrowdRenderer;
+
+CrowdRenderer LoadCrowdRenderer(Model model);           // The model stays with the caller and must outlive the renderer
+void UnloadCrowdRenderer(CrowdRenderer *crowd);
+
+void SetCrowdCamera(CrowdRenderer *crowd, Camera camera, int screenWidth, int screenHeight);   // Before adding the frame's characters
+// Placed like DrawModelEx(model, position, up, yaw, scale, ...), false when culled
+bool AddCrowdInstance(CrowdRenderer *crowd, Vector3 position, float scale, float yaw, Color color);
+CrowdStats DrawCrowdInstances(CrowdRenderer *crowd);    // Draws and clears the characters added so far
+
+// Vertex clustering on its own, cellSize in model units. Returns an indexed
+// mesh (not uploaded), empty when nothing is left or it needs over 65535 vertices.
+Mesh GenMeshClustered(Mesh mesh, Vector3 origin, float cellSize);
+
+#endif // CROWD_H
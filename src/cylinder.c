@@ -7,6 +7,10 @@
 #include "raylib.h"
 #include "rcamera.h"
 #include "raymath.h"
+#include "hud.h"
+#include "instancing.h"
+#include "assets.h"
+#include "scene.h"
 
 #define MAX_COLS        20
 #define PLAYER_RADIUS   0.5f
@@ -30,112 +34,129 @@ static bool CheckCollisionCylinders(Vector3 aPos, float aR, float aH,
     return true;
 }
 
-/* -------------------------------------------------------------------------------------- */
-int main(void)
-{
-    const int screenW = 1280, screenH = 720;
-    InitWindow(screenW, screenH, "raylib – cylinder player with collisions");
-
-    /* ----- Camera & player ------------------------------------------------------------ */
-    Camera cam = { 0 };
-    cam.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
-    cam.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
-    cam.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-    cam.fovy = 60.0f;
-    cam.projection = CAMERA_PERSPECTIVE;
-    int camMode = CAMERA_FIRST_PERSON;
+/* ----- Scene state -------------------------------------------------------------------- */
+static struct {
+    Hud hud;
+    int hudMode;
+    CylinderRenderer *cylinders;               // shared, see assets.h
 
-    Vector3 playerPos = cam.position;          // centre of cylinder
+    Camera cam;
+    int camMode;
+    Vector3 playerPos;                         // centre of cylinder
 
-    /* ----- World cylinders ------------------------------------------------------------ */
     float    colH[MAX_COLS];
     float    colR[MAX_COLS];
     Vector3  colPos[MAX_COLS];
     Color    colClr[MAX_COLS];
+} cyl;
+
+static bool InitCylinderScene(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    cyl.hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    SetHudLine(&cyl.hud, AddHudLine(&cyl.hud, 10, 10, 10, BLACK), "Modes: [1] Free  [2] First‑person  [3] Third‑person");
+    cyl.hudMode = AddHudLine(&cyl.hud, 10, 25, 10, BLACK);
+    cyl.cylinders = GetSharedCylinderRenderer();
+
+    /* ----- Camera & player ------------------------------------------------------------ */
+    cyl.cam = (Camera){ 0 };
+    cyl.cam.position = (Vector3){ 0.0f, PLAYER_EYE_Y, 4.0f };
+    cyl.cam.target = (Vector3){ 0.0f, PLAYER_EYE_Y, 0.0f };
+    cyl.cam.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    cyl.cam.fovy = 60.0f;
+    cyl.cam.projection = CAMERA_PERSPECTIVE;
+    cyl.camMode = CAMERA_FIRST_PERSON;
 
+    cyl.playerPos = cyl.cam.position;
+
+    /* ----- World cylinders ------------------------------------------------------------ */
     for (int i = 0; i < MAX_COLS; i++)
     {
-        colH[i] = (float)GetRandomValue(2, 8);          // 2–8 m tall
-        colR[i] = (float)GetRandomValue(1, 3) * 0.5f;      // 0.5–1.5 m radius
-        colPos[i] = (Vector3){ GetRandomValue(-15, 15),
-                               colH[i] * 0.5f,
-                               GetRandomValue(-15, 15) };
-        colClr[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
+        cyl.colH[i] = (float)GetRandomValue(2, 8);          // 2–8 m tall
+        cyl.colR[i] = (float)GetRandomValue(1, 3) * 0.5f;      // 0.5–1.5 m radius
+        cyl.colPos[i] = (Vector3){ GetRandomValue(-15, 15),
+                                   cyl.colH[i] * 0.5f,
+                                   GetRandomValue(-15, 15) };
+        cyl.colClr[i] = (Color){ GetRandomValue(20,255), GetRandomValue(10,55), 30, 255 };
     }
 
     DisableCursor();
     SetTargetFPS(60);
+    return cyl.cylinders != NULL;
+}
 
-    /* ------------------------------- GAME LOOP ---------------------------------------- */
-    while (!WindowShouldClose())
+/* ------------------------------- GAME LOOP -------------------------------------------- */
+static void UpdateCylinderScene(void)
+{
+    /* Save state for rollback */
+    Vector3 prevPlayer = cyl.playerPos;
+    Vector3 prevCamPos = cyl.cam.position;
+    Vector3 prevCamTar = cyl.cam.target;
+
+    /* Mode hotkeys */
+    if (IsKeyPressed(KEY_ONE))   cyl.camMode = CAMERA_FREE;
+    if (IsKeyPressed(KEY_TWO))   cyl.camMode = CAMERA_FIRST_PERSON;
+    if (IsKeyPressed(KEY_THREE)) cyl.camMode = CAMERA_THIRD_PERSON;
+
+    /* Update camera via helper */
+    UpdateCamera(&cyl.cam, cyl.camMode);
+
+    /* Sync player ↔ camera */
+    if (cyl.camMode == CAMERA_FIRST_PERSON)
+        cyl.playerPos = cyl.cam.position;
+    else if (cyl.camMode == CAMERA_THIRD_PERSON)
     {
-        /* Save state for rollback */
-        Vector3 prevPlayer = playerPos;
-        Vector3 prevCamPos = cam.position;
-        Vector3 prevCamTar = cam.target;
-
-        /* Mode hotkeys */
-        if (IsKeyPressed(KEY_ONE))   camMode = CAMERA_FREE;
-        if (IsKeyPressed(KEY_TWO))   camMode = CAMERA_FIRST_PERSON;
-        if (IsKeyPressed(KEY_THREE)) camMode = CAMERA_THIRD_PERSON;
-
-        /* Update camera via helper */
-        UpdateCamera(&cam, camMode);
-
-        /* Sync player ↔ camera */
-        if (camMode == CAMERA_FIRST_PERSON)
-            playerPos = cam.position;
-        else if (camMode == CAMERA_THIRD_PERSON)
-        {
-            playerPos = cam.target;
-            cam.target = playerPos;            // keep camera aimed at player
-        }
-
-        /* Collision test against every world cylinder */
-        bool hit = false;
-        for (int i = 0; i < MAX_COLS && !hit; i++)
-            if (CheckCollisionCylinders(playerPos, PLAYER_RADIUS, PLAYER_HEIGHT,
-                colPos[i], colR[i], colH[i]))
-                hit = true;
-
-        if (hit)          // rollback on hit
-        {
-            playerPos = prevPlayer;
-            cam.position = prevCamPos;
-            cam.target = prevCamTar;
-        }
-
-        /* --------------------------------- DRAW -------------------------------------- */
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        BeginMode3D(cam);
-        DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
-
-        /* world columns */
-        for (int i = 0; i < MAX_COLS; i++)
-        {
-            DrawCylinder(colPos[i], colR[i], colR[i], colH[i], 16, colClr[i]);
-            DrawCylinderWires(colPos[i], colR[i], colR[i], colH[i], 16, MAROON);
-        }
-
-        /* player cylinder (visible only in 3rd‑person) */
-        if (camMode == CAMERA_THIRD_PERSON)
-        {
-            DrawCylinder(playerPos, PLAYER_RADIUS, PLAYER_RADIUS,
-                PLAYER_HEIGHT, 16, PURPLE);
-            DrawCylinderWires(playerPos, PLAYER_RADIUS, PLAYER_RADIUS,
-                PLAYER_HEIGHT, 16, DARKPURPLE);
-        }
-        EndMode3D();
-
-        DrawText("Modes: [1] Free  [2] First‑person  [3] Third‑person", 10, 10, 10, BLACK);
-        DrawText(TextFormat("Current: %s",
-            camMode == CAMERA_FREE ? "FREE" :
-            camMode == CAMERA_FIRST_PERSON ? "FIRST PERSON" : "THIRD PERSON"), 10, 25, 10, BLACK);
-        EndDrawing();
+        cyl.playerPos = cyl.cam.target;
+        cyl.cam.target = cyl.playerPos;        // keep camera aimed at player
     }
 
-    CloseWindow();
-    return 0;
+    /* Collision test against every world cylinder */
+    bool hit = false;
+    for (int i = 0; i < MAX_COLS && !hit; i++)
+        if (CheckCollisionCylinders(cyl.playerPos, PLAYER_RADIUS, PLAYER_HEIGHT,
+            cyl.colPos[i], cyl.colR[i], cyl.colH[i]))
+            hit = true;
+
+    if (hit)          // rollback on hit
+    {
+        cyl.playerPos = prevPlayer;
+        cyl.cam.position = prevCamPos;
+        cyl.cam.target = prevCamTar;
+    }
 }
+
+static void DrawCylinderScene(void)
+{
+    ClearBackground(RAYWHITE);
+
+    BeginMode3D(cyl.cam);
+    DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 32, 32 }, LIGHTGRAY);
+
+    /* world columns, instanced with fewer slices when far */
+    SetCylinderCamera(cyl.cylinders, cyl.cam, GetScreenHeight());
+    for (int i = 0; i < MAX_COLS; i++)
+        AddCylinderInstance(cyl.cylinders, cyl.colPos[i], cyl.colR[i], cyl.colH[i], cyl.colClr[i]);
+    DrawCylinderInstances(cyl.cylinders, MAROON);
+
+    /* player cylinder (visible only in 3rd‑person) */
+    if (cyl.camMode == CAMERA_THIRD_PERSON)
+    {
+        AddCylinderInstance(cyl.cylinders, cyl.playerPos, PLAYER_RADIUS, PLAYER_HEIGHT, PURPLE);
+        DrawCylinderInstances(cyl.cylinders, DARKPURPLE);
+    }
+    EndMode3D();
+
+    SetHudLine(&cyl.hud, cyl.hudMode, cyl.camMode == CAMERA_FREE ? "Current: FREE" :
+        cyl.camMode == CAMERA_FIRST_PERSON ? "Current: FIRST PERSON" : "Current: THIRD PERSON");
+    DrawHud(&cyl.hud);
+}
+
+static void UnloadCylinderScene(void)
+{
+    UnloadHud(&cyl.hud);
+}
+
+const Scene CylinderScene = {
+    .name = "cylinder", .title = "raylib – cylinder player with collisions", .width = 1280, .height = 720,
+    .init = InitCylinderScene, .update = UpdateCylinderScene, .draw = DrawCylinderScene, .unload = UnloadCylinderScene
+};
@@ -0,0 +1,185 @@
+// debug_draw.c - batched debug shapes for collision visualization (see debug_draw.h)
+#include "debug_draw.h"
+
+#if DEBUG_DRAW_ENABLED
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "rlgl.h"
+
+typedef struct DebugVertex {
+    Vector3 position;
+    Color color;
+} DebugVertex;
+
+typedef struct DebugLabel {
+    Vector3 position;
+    Color color;
+    char text[DEBUG_DRAW_LABEL_CAPACITY];
+} DebugLabel;
+
+static struct {
+    bool enabled[DEBUG_DRAW_CATEGORY_COUNT];
+    DebugVertex *vertices;       // 2 per line
+    int vertexCount;
+    int vertexCapacity;
+    DebugLabel labels[DEBUG_DRAW_MAX_LABELS];
+    int labelCount;
+} debugDraw = { 0 };
+
+static const char *categoryNames[DEBUG_DRAW_CATEGORY_COUNT] = { "broadphase", "contacts", "BVH", "camera" };
+
+void UnloadDebugDraw(void)
+{
+    RL_FREE(debugDraw.vertices);
+    debugDraw.vertices = NULL;
+    debugDraw.vertexCount = debugDraw.vertexCapacity = 0;
+    debugDraw.labelCount = 0;
+}
+
+void SetDebugDrawCategory(DebugDrawCategory category, bool enabled)
+{
+    if ((unsigned)category < DEBUG_DRAW_CATEGORY_COUNT) debugDraw.enabled[category] = enabled;
+}
+
+void ToggleDebugDrawCategory(DebugDrawCategory category)
+{
+    if ((unsigned)category < DEBUG_DRAW_CATEGORY_COUNT) debugDraw.enabled[category] = !debugDraw.enabled[category];
+}
+
+bool IsDebugDrawCategoryEnabled(DebugDrawCategory category)
+{
+    return ((unsigned)category < DEBUG_DRAW_CATEGORY_COUNT) && debugDraw.enabled[category];
+}
+
+const char *GetDebugDrawCategoryName(DebugDrawCategory category)
+{
+    return ((unsigned)category < DEBUG_DRAW_CATEGORY_COUNT) ? categoryNames[category] : "";
+}
+
+// Room for count more vertices, NULL when out of memory
+static DebugVertex *ReserveDebugVertices(int count)
+{
+    int needed = debugDraw.vertexCount + count;
+    if (needed > debugDraw.vertexCapacity)
+    {
+        int capacity = (debugDraw.vertexCapacity > 0) ? debugDraw.vertexCapacity : 1024;
+        while (capacity < needed) capacity *= 2;
+        DebugVertex *grown = RL_REALLOC(debugDraw.vertices, (size_t)capacity*sizeof(DebugVertex));
+        if (!grown) return NULL;
+        debugDraw.vertices = grown;
+        debugDraw.vertexCapacity = capacity;
+    }
+    DebugVertex *vertices = debugDraw.vertices + debugDraw.vertexCount;
+    debugDraw.vertexCount = needed;
+    return vertices;
+}
+
+void DebugDrawLine(DebugDrawCategory category, Vector3 start, Vector3 end, Color color)
+{
+    if (!IsDebugDrawCategoryEnabled(category)) return;
+    DebugVertex *v = ReserveDebugVertices(2);
+    if (!v) return;
+    v[0] = (DebugVertex){ start, color };
+    v[1] = (DebugVertex){ end, color };
+}
+
+void DebugDrawBox(DebugDrawCategory category, BoundingBox box, Color color)
+{
+    if (!IsDebugDrawCategoryEnabled(category)) return;
+    DebugVertex *v = ReserveDebugVertices(24);
+    if (!v) return;
+
+    // Corner bit 0 picks max x, bit 1 max y, bit 2 max z; an edge joins two
+    // corners one bit apart
+    Vector3 corners[8];
+    for (int c = 0; c < 8; c++)
+        corners[c] = (Vector3){ (c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z };
+    int n = 0;
+    for (int c = 0; c < 8; c++)
+        for (int bit = 1; bit < 8; bit <<= 1)
+        {
+            if (c & bit) continue;
+            v[n++] = (DebugVertex){ corners[c], color };
+            v[n++] = (DebugVertex){ corners[c | bit], color };
+        }
+}
+
+void DebugDrawSphere(DebugDrawCategory category, Vector3 center, float radius, Color color)
+{
+    if (!IsDebugDrawCategoryEnabled(category)) return;
+    DebugVertex *v = ReserveDebugVertices(3*2*DEBUG_DRAW_SPHERE_SEGMENTS);
+    if (!v) return;
+
+    // A circle in each axis plane
+    int n = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        for (int s = 0; s < DEBUG_DRAW_SPHERE_SEGMENTS; s++)
+        {
+            for (int end = 0; end < 2; end++)
+            {
+                float angle = 2.0f*PI*(float)(s + end)/DEBUG_DRAW_SPHERE_SEGMENTS;
+                float a = radius*cosf(angle), b = radius*sinf(angle);
+                Vector3 p = center;
+                if (axis == 0) { p.y += a; p.z += b; }
+                else if (axis == 1) { p.x += a; p.z += b; }
+                else { p.x += a; p.y += b; }
+                v[n++] = (DebugVertex){ p, color };
+            }
+        }
+    }
+}
+
+void DebugDrawText(DebugDrawCategory category, Vector3 position, const char *text, Color color)
+{
+    if (!IsDebugDrawCategoryEnabled(category) || debugDraw.labelCount == DEBUG_DRAW_MAX_LABELS) return;
+    DebugLabel *label = &debugDraw.labels[debugDraw.labelCount++];
+    label->position = position;
+    label->color = color;
+    snprintf(label->text, sizeof(label->text), "%s", text);
+}
+
+int DrawDebugDraw(Camera camera)
+{
+    int lineCount = debugDraw.vertexCount/2;
+    if (debugDraw.vertexCount > 0)
+    {
+        // One rlBegin() for everything, rlgl only splits it when its batch fills up
+        BeginMode3D(camera);
+        rlBegin(RL_LINES);
+        for (int i = 0; i < debugDraw.vertexCount; i++)
+        {
+            const DebugVertex *v = &debugDraw.vertices[i];
+            rlColor4ub(v->color.r, v->color.g, v->color.b, v->color.a);
+            rlVertex3f(v->position.x, v->position.y, v->position.z);
+        }
+        rlEnd();
+        EndMode3D();
+    }
+
+    for (int i = 0; i < debugDraw.labelCount; i++)
+    {
+        const DebugLabel *label = &debugDraw.labels[i];
+        Vector3 toLabel = { label->position.x - camera.position.x, label->position.y - camera.position.y,
+                            label->position.z - camera.position.z };
+        Vector3 forward = { camera.target.x - camera.position.x, camera.target.y - camera.position.y,
+                            camera.target.z - camera.position.z };
+        if (toLabel.x*forward.x + toLabel.y*forward.y + toLabel.z*forward.z <= 0.0f) continue;   // behind the camera
+
+        Vector2 screen = GetWorldToScreen(label->position, camera);
+        int width = MeasureText(label->text, 10);
+        DrawText(label->text, (int)screen.x - width/2, (int)screen.y - 5, 10, label->color);
+    }
+
+    debugDraw.vertexCount = 0;
+    debugDraw.labelCount = 0;
+    return lineCount;
+}
+
+#else
+
+typedef int DebugDrawDisabled;   // keeps the translation unit from being empty
+
+#endif // DEBUG_DRAW_ENABLED
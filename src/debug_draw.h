@@ -0,0 +1,68 @@
+// debug_draw.h - batched debug shapes for collision visualization
+//
+// Anywhere in a frame, code can record lines, boxes, spheres and labels
+// under a category; DrawDebugDraw() then draws every line in one rlgl batch
+// and the labels on top, and starts the next frame empty. Categories are off
+// until toggled, recording into one that's off returns straight away, and
+// IsDebugDrawCategoryEnabled() lets callers skip working out what to draw.
+//
+// Only built with DEBUG (premake's Debug configurations) unless
+// DEBUG_DRAW_DISABLE is defined; otherwise every call below is a macro that
+// expands to nothing, arguments included.
+#ifndef DEBUG_DRAW_H
+#define DEBUG_DRAW_H
+
+#include "raylib.h"
+
+#if defined(DEBUG) && !defined(DEBUG_DRAW_DISABLE)
+    #define DEBUG_DRAW_ENABLED 1
+#else
+    #define DEBUG_DRAW_ENABLED 0
+#endif
+
+#define DEBUG_DRAW_MAX_LABELS     256
+#define DEBUG_DRAW_LABEL_CAPACITY 64
+#define DEBUG_DRAW_SPHERE_SEGMENTS 16   // per circle, spheres are three of them
+
+typedef enum {
+    DEBUG_DRAW_BROADPHASE = 0,   // grid cells, batch cells
+    DEBUG_DRAW_CONTACTS,         // what collided this frame
+    DEBUG_DRAW_BVH,              // bounding volume tree nodes visited by queries
+    DEBUG_DRAW_CAMERA,           // view rays and what they hit
+    DEBUG_DRAW_CATEGORY_COUNT
+} DebugDrawCategory;
+
+#if DEBUG_DRAW_ENABLED
+
+void UnloadDebugDraw(void);                                 // Frees the buffers, recording again allocates them
+void SetDebugDrawCategory(DebugDrawCategory category, bool enabled);
+void ToggleDebugDrawCategory(DebugDrawCategory category);
+bool IsDebugDrawCategoryEnabled(DebugDrawCategory category);
+const char *GetDebugDrawCategoryName(DebugDrawCategory category);
+
+void DebugDrawLine(DebugDrawCategory category, Vector3 start, Vector3 end, Color color);
+void DebugDrawBox(DebugDrawCategory category, BoundingBox box, Color color);
+void DebugDrawSphere(DebugDrawCategory category, Vector3 center, float radius, Color color);
+void DebugDrawText(DebugDrawCategory category, Vector3 position, const char *text, Color color);   // Centered on position's screen point
+
+// After EndMode3D(), with the camera the frame was drawn with. Returns how
+// many lines were drawn.
+int DrawDebugDraw(Camera camera);
+
+#else
+
+// Variadic so compound literal arguments, commas and all, vanish too
+#define UnloadDebugDraw()                ((void)0)
+#define SetDebugDrawCategory(...)        ((void)0)
+#define ToggleDebugDrawCategory(...)     ((void)0)
+#define IsDebugDrawCategoryEnabled(...)  false
+#define GetDebugDrawCategoryName(...)    ""
+#define DebugDrawLine(...)               ((void)0)
+#define DebugDrawBox(...)                ((void)0)
+#define DebugDrawSphere(...)             ((void)0)
+#define DebugDrawText(...)               ((void)0)
+#define DrawDebugDraw(...)               0
+
+#endif // DEBUG_DRAW_ENABLED
+
+#endif // DEBUG_DRAW_H
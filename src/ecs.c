@@ -0,0 +1,353 @@
+// ecs.c - archetype entity component storage (see ecs.h)
+#include "ecs.h"
+#include "heap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ECS_NO_FREE UINT32_MAX
+
+// A chunk is one block: the entity column at the start, then a column per
+// component at the offsets the archetype gives. Rows are numbered across
+// the archetype, row r is in chunk r/capacity.
+typedef struct EcsArchetype {
+    ComponentMask mask;
+    int offsets[ECS_MAX_COMPONENTS];     // byte offset of each column in a chunk, -1 without the component
+    int capacity;                        // rows per chunk
+    size_t chunkBytes;
+
+    unsigned char **chunks;              // every chunk but the last used one is full
+    int chunkCount;
+    int chunkSlots;
+    int count;                           // rows
+} EcsArchetype;
+
+// Where a live entity's row is. Dead records have archetype -1 and chain
+// the free list through row.
+typedef struct EcsRecord {
+    uint32_t generation;
+    int archetype;
+    uint32_t row;
+} EcsRecord;
+
+struct EcsWorld {
+    size_t sizes[ECS_MAX_COMPONENTS];
+    int componentCount;
+
+    EcsArchetype *archetypes;
+    int archetypeCount;
+    int archetypeCapacity;
+
+    EcsRecord *records;                  // indexed by Entity.index
+    uint32_t recordCount;
+    uint32_t recordCapacity;
+    uint32_t freeRecord;                 // ECS_NO_FREE when empty
+    int entityCount;
+};
+
+/* ── archetypes ────────────────────────────────────────────────────── */
+static size_t AlignColumn(size_t offset)
+{
+    return (offset + ECS_COLUMN_ALIGN - 1) & ~(size_t)(ECS_COLUMN_ALIGN - 1);
+}
+
+static size_t LayoutChunk(const EcsWorld *world, EcsArchetype *archetype, int capacity)
+{
+    size_t offset = AlignColumn((size_t)capacity*sizeof(Entity));
+    for (int c = 0; c < ECS_MAX_COMPONENTS; c++)
+    {
+        archetype->offsets[c] = -1;
+        if (!(archetype->mask & ComponentBit(c))) continue;
+        archetype->offsets[c] = (int)offset;
+        offset = AlignColumn(offset + (size_t)capacity*world->sizes[c]);
+    }
+    return offset;
+}
+
+static int FindArchetype(EcsWorld *world, ComponentMask mask)
+{
+    // Games have a handful of archetypes, a scan beats hashing them
+    for (int a = 0; a < world->archetypeCount; a++)
+        if (world->archetypes[a].mask == mask) return a;
+
+    if (world->archetypeCount == world->archetypeCapacity)
+    {
+        int capacity = (world->archetypeCapacity > 0) ? 2*world->archetypeCapacity : 8;
+        EcsArchetype *archetypes = RL_REALLOC(world->archetypes, (size_t)capacity*sizeof(EcsArchetype));
+        if (!archetypes) return -1;
+        world->archetypes = archetypes;
+        world->archetypeCapacity = capacity;
+    }
+
+    EcsArchetype *archetype = &world->archetypes[world->archetypeCount];
+    *archetype = (EcsArchetype){ 0 };
+    archetype->mask = mask;
+
+    // As many rows as fit ECS_CHUNK_BYTES once every column is padded
+    size_t rowBytes = sizeof(Entity);
+    int columns = 1;
+    for (int c = 0; c < ECS_MAX_COMPONENTS; c++)
+    {
+        if (!(mask & ComponentBit(c))) continue;
+        rowBytes += world->sizes[c];
+        columns++;
+    }
+    size_t padding = (size_t)columns*ECS_COLUMN_ALIGN;
+    int capacity = (ECS_CHUNK_BYTES > padding + rowBytes) ? (int)((ECS_CHUNK_BYTES - padding)/rowBytes) : 1;
+    while (capacity > 1 && LayoutChunk(world, archetype, capacity) > ECS_CHUNK_BYTES) capacity--;
+    archetype->capacity = capacity;
+    archetype->chunkBytes = LayoutChunk(world, archetype, capacity);
+    return world->archetypeCount++;
+}
+
+static unsigned char *GetChunkRow(const EcsArchetype *archetype, uint32_t row, int *index)
+{
+    *index = (int)(row%(uint32_t)archetype->capacity);
+    return archetype->chunks[row/(uint32_t)archetype->capacity];
+}
+
+static void *GetColumnRow(const EcsWorld *world, const EcsArchetype *archetype, uint32_t row, int component)
+{
+    int index;
+    unsigned char *chunk = GetChunkRow(archetype, row, &index);
+    return chunk + archetype->offsets[component] + (size_t)index*world->sizes[component];
+}
+
+// Appends an uninitialized row, -1 when no chunk can be allocated
+static int64_t AddArchetypeRow(EcsArchetype *archetype)
+{
+    uint32_t row = (uint32_t)archetype->count;
+    if (row/(uint32_t)archetype->capacity == (uint32_t)archetype->chunkCount)
+    {
+        if (archetype->chunkCount == archetype->chunkSlots)
+        {
+            int slots = (archetype->chunkSlots > 0) ? 2*archetype->chunkSlots : 4;
+            unsigned char **chunks = RL_REALLOC(archetype->chunks, (size_t)slots*sizeof(*chunks));
+            if (!chunks) return -1;
+            archetype->chunks = chunks;
+            archetype->chunkSlots = slots;
+        }
+        unsigned char *chunk = RL_MALLOC(archetype->chunkBytes);
+        if (!chunk) return -1;
+        archetype->chunks[archetype->chunkCount++] = chunk;
+    }
+    archetype->count++;
+    return row;
+}
+
+// Moves the last row into row and drops the last one
+static void RemoveArchetypeRow(EcsWorld *world, EcsArchetype *archetype, uint32_t row)
+{
+    uint32_t last = (uint32_t)archetype->count - 1;
+    if (row != last)
+    {
+        int to, from;
+        unsigned char *toChunk = GetChunkRow(archetype, row, &to);
+        unsigned char *fromChunk = GetChunkRow(archetype, last, &from);
+        Entity moved = ((Entity *)fromChunk)[from];
+        ((Entity *)toChunk)[to] = moved;
+        for (int c = 0; c < ECS_MAX_COMPONENTS; c++)
+        {
+            if (archetype->offsets[c] < 0 || world->sizes[c] == 0) continue;
+            size_t size = world->sizes[c];
+            memcpy(toChunk + archetype->offsets[c] + (size_t)to*size, fromChunk + archetype->offsets[c] + (size_t)from*size, size);
+        }
+        world->records[moved.index].row = row;
+    }
+    archetype->count--;
+
+    // One spare chunk stays, so an entity coming and going at a chunk
+    // boundary doesn't allocate every time
+    int used = (archetype->count + archetype->capacity - 1)/archetype->capacity;
+    while (archetype->chunkCount > used + 1) RL_FREE(archetype->chunks[--archetype->chunkCount]);
+}
+
+/* ── entities ──────────────────────────────────────────────────────── */
+EcsWorld *CreateWorld(void)
+{
+    EcsWorld *world = RL_CALLOC(1, sizeof(EcsWorld));
+    if (world) world->freeRecord = ECS_NO_FREE;
+    return world;
+}
+
+void DestroyWorld(EcsWorld *world)
+{
+    if (!world) return;
+    for (int a = 0; a < world->archetypeCount; a++)
+    {
+        EcsArchetype *archetype = &world->archetypes[a];
+        for (int c = 0; c < archetype->chunkCount; c++) RL_FREE(archetype->chunks[c]);
+        RL_FREE(archetype->chunks);
+    }
+    RL_FREE(world->archetypes);
+    RL_FREE(world->records);
+    RL_FREE(world);
+}
+
+ComponentId RegisterComponent(EcsWorld *world, size_t size)
+{
+    if (world->componentCount == ECS_MAX_COMPONENTS) return -1;
+    world->sizes[world->componentCount] = size;
+    return world->componentCount++;
+}
+
+static bool IsMaskRegistered(const EcsWorld *world, ComponentMask mask)
+{
+    return (world->componentCount == ECS_MAX_COMPONENTS) || !(mask >> world->componentCount);
+}
+
+static const EcsRecord *FindRecord(const EcsWorld *world, Entity entity)
+{
+    if (entity.index >= world->recordCount) return NULL;
+    const EcsRecord *record = &world->records[entity.index];
+    return (record->archetype >= 0 && record->generation == entity.generation) ? record : NULL;
+}
+
+static void ZeroRow(EcsWorld *world, const EcsArchetype *archetype, uint32_t row, ComponentMask components)
+{
+    for (int c = 0; c < ECS_MAX_COMPONENTS; c++)
+        if ((components & ComponentBit(c)) && world->sizes[c] > 0)
+            memset(GetColumnRow(world, archetype, row, c), 0, world->sizes[c]);
+}
+
+Entity CreateEntity(EcsWorld *world, ComponentMask components)
+{
+    if (!IsMaskRegistered(world, components)) return ENTITY_NONE;
+    int a = FindArchetype(world, components);
+    if (a < 0) return ENTITY_NONE;
+
+    if (world->freeRecord == ECS_NO_FREE && world->recordCount == world->recordCapacity)
+    {
+        uint32_t capacity = (world->recordCapacity > 0) ? 2*world->recordCapacity : 1024;
+        EcsRecord *records = RL_REALLOC(world->records, (size_t)capacity*sizeof(EcsRecord));
+        if (!records) return ENTITY_NONE;
+        world->records = records;
+        world->recordCapacity = capacity;
+    }
+
+    EcsArchetype *archetype = &world->archetypes[a];
+    int64_t row = AddArchetypeRow(archetype);
+    if (row < 0) return ENTITY_NONE;
+
+    Entity entity;
+    if (world->freeRecord != ECS_NO_FREE)
+    {
+        entity.index = world->freeRecord;
+        world->freeRecord = world->records[entity.index].row;
+    }
+    else
+    {
+        entity.index = world->recordCount++;
+        world->records[entity.index].generation = 1;
+    }
+    EcsRecord *record = &world->records[entity.index];
+    entity.generation = record->generation;
+    record->archetype = a;
+    record->row = (uint32_t)row;
+
+    int index;
+    ((Entity *)GetChunkRow(archetype, record->row, &index))[index] = entity;
+    ZeroRow(world, archetype, record->row, components);
+    world->entityCount++;
+    return entity;
+}
+
+void DestroyEntity(EcsWorld *world, Entity entity)
+{
+    if (!FindRecord(world, entity)) return;
+    EcsRecord *record = &world->records[entity.index];
+    RemoveArchetypeRow(world, &world->archetypes[record->archetype], record->row);
+
+    record->generation = (record->generation == UINT32_MAX) ? 1 : record->generation + 1;
+    record->archetype = -1;
+    record->row = world->freeRecord;
+    world->freeRecord = entity.index;
+    world->entityCount--;
+}
+
+bool IsEntityAlive(const EcsWorld *world, Entity entity)
+{
+    return FindRecord(world, entity) != NULL;
+}
+
+int GetEntityCount(const EcsWorld *world)
+{
+    return world->entityCount;
+}
+
+bool SetEntityComponents(EcsWorld *world, Entity entity, ComponentMask components)
+{
+    if (!FindRecord(world, entity) || !IsMaskRegistered(world, components)) return false;
+    EcsRecord *record = &world->records[entity.index];
+    if (world->archetypes[record->archetype].mask == components) return true;
+
+    int a = FindArchetype(world, components);          // may move the archetype array
+    if (a < 0) return false;
+    EcsArchetype *from = &world->archetypes[record->archetype];
+    EcsArchetype *to = &world->archetypes[a];
+    int64_t row = AddArchetypeRow(to);
+    if (row < 0) return false;
+
+    int index;
+    ((Entity *)GetChunkRow(to, (uint32_t)row, &index))[index] = entity;
+    ComponentMask kept = from->mask & components;
+    for (int c = 0; c < ECS_MAX_COMPONENTS; c++)
+        if ((kept & ComponentBit(c)) && world->sizes[c] > 0)
+            memcpy(GetColumnRow(world, to, (uint32_t)row, c), GetColumnRow(world, from, record->row, c), world->sizes[c]);
+    ZeroRow(world, to, (uint32_t)row, components & ~kept);
+
+    RemoveArchetypeRow(world, from, record->row);
+    record->archetype = a;
+    record->row = (uint32_t)row;
+    return true;
+}
+
+ComponentMask GetEntityComponents(const EcsWorld *world, Entity entity)
+{
+    const EcsRecord *record = FindRecord(world, entity);
+    return record ? world->archetypes[record->archetype].mask : 0;
+}
+
+void *GetComponent(EcsWorld *world, Entity entity, ComponentId component)
+{
+    const EcsRecord *record = FindRecord(world, entity);
+    if (!record || component < 0 || component >= ECS_MAX_COMPONENTS) return NULL;
+    const EcsArchetype *archetype = &world->archetypes[record->archetype];
+    if (archetype->offsets[component] < 0) return NULL;
+    return GetColumnRow(world, archetype, record->row, component);
+}
+
+/* ── queries ───────────────────────────────────────────────────────── */
+EcsQuery QueryWorld(EcsWorld *world, ComponentMask all, ComponentMask none)
+{
+    return (EcsQuery){ .world = world, .all = all, .none = none, .archetype = -1, .chunk = -1 };
+}
+
+bool NextQueryChunk(EcsQuery *query)
+{
+    const EcsWorld *world = query->world;
+    if (query->archetype < 0) query->archetype = 0;
+    for (int chunk = query->chunk + 1; query->archetype < world->archetypeCount; query->archetype++, chunk = 0)
+    {
+        const EcsArchetype *archetype = &world->archetypes[query->archetype];
+        if ((archetype->mask & query->all) != query->all || (archetype->mask & query->none)) continue;
+
+        int first = chunk*archetype->capacity;
+        if (first >= archetype->count) continue;
+        query->chunk = chunk;
+        query->count = (archetype->count - first < archetype->capacity) ? archetype->count - first : archetype->capacity;
+        query->entities = (const Entity *)archetype->chunks[chunk];
+        return true;
+    }
+    query->count = 0;
+    query->entities = NULL;
+    return false;
+}
+
+void *GetQueryColumn(const EcsQuery *query, ComponentId component)
+{
+    if (query->entities == NULL || component < 0 || component >= ECS_MAX_COMPONENTS) return NULL;
+    const EcsArchetype *archetype = &query->world->archetypes[query->archetype];
+    if (archetype->offsets[component] < 0) return NULL;
+    return archetype->chunks[query->chunk] + archetype->offsets[component];
+}
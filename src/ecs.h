@@ -0,0 +1,91 @@
+// ecs.h - archetype entity component storage
+//
+// Entities are handles; their data lives in components, plain structs
+// registered once with their size. All entities with the same set of
+// components share an archetype, which stores them in chunks of about
+// ECS_CHUNK_BYTES: each chunk holds one array per component (and one of
+// entity handles), so a system that reads positions and shapes walks two
+// tight arrays instead of striding over whole objects.
+//
+// Chunks are kept dense. Destroying an entity moves the last entity of its
+// archetype into the hole, so every chunk but the last is full and a query
+// never skips rows. Rows move, handles don't: an Entity stays valid until
+// it's destroyed, and a destroyed one's generation no longer matches, so a
+// stale handle is caught instead of reaching whatever reused its slot.
+//
+// Queries visit every chunk whose archetype has all of one set of
+// components and none of another:
+//
+//   EcsQuery query = QueryWorld(world, ComponentBit(position) | ComponentBit(shape), 0);
+//   while (NextQueryChunk(&query))
+//   {
+//       Vector3 *positions = GetQueryColumn(&query, position);
+//       for (int i = 0; i < query.count; i++) ...
+//   }
+//
+// Creating, destroying or changing the components of entities while a
+// query is running moves rows under it; collect the handles and do it after.
+// Size 0 components are tags, they only sort entities into archetypes.
+// Single threaded, like the rest of the game state. Doesn't depend on raylib.
+#ifndef ECS_H
+#define ECS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ECS_MAX_COMPONENTS 64            // bits in a ComponentMask
+#define ECS_CHUNK_BYTES    (16*1024)     // rows per chunk follow from the archetype's row size
+#define ECS_COLUMN_ALIGN   16
+
+typedef int ComponentId;
+typedef uint64_t ComponentMask;
+
+#define ComponentBit(id) ((ComponentMask)1 << (id))
+
+typedef struct Entity {
+    uint32_t index;
+    uint32_t generation;         // 0 is never alive
+} Entity;
+
+#define ENTITY_NONE ((Entity){ 0, 0 })
+
+typedef struct EcsWorld EcsWorld;
+
+typedef struct EcsQuery {
+    EcsWorld *world;
+    ComponentMask all;
+    ComponentMask none;
+    int archetype;               // current chunk, -1 before the first
+    int chunk;
+
+    int count;                   // rows in the current chunk
+    const Entity *entities;      // of those rows
+} EcsQuery;
+
+EcsWorld *CreateWorld(void);                            // NULL when out of memory
+void DestroyWorld(EcsWorld *world);
+
+ComponentId RegisterComponent(EcsWorld *world, size_t size);   // -1 once ECS_MAX_COMPONENTS are taken
+
+// Components start zeroed. ENTITY_NONE when out of memory or the mask names
+// unregistered components.
+Entity CreateEntity(EcsWorld *world, ComponentMask components);
+void DestroyEntity(EcsWorld *world, Entity entity);     // Stale handles are ignored
+bool IsEntityAlive(const EcsWorld *world, Entity entity);
+int GetEntityCount(const EcsWorld *world);
+
+// Moves the entity to the archetype of the new set, keeping the components
+// both sets have; added ones start zeroed. False for stale handles.
+bool SetEntityComponents(EcsWorld *world, Entity entity, ComponentMask components);
+ComponentMask GetEntityComponents(const EcsWorld *world, Entity entity);   // 0 for stale handles
+
+// Valid until the entity's row moves (see above). NULL for stale handles or
+// components the entity doesn't have.
+void *GetComponent(EcsWorld *world, Entity entity, ComponentId component);
+
+EcsQuery QueryWorld(EcsWorld *world, ComponentMask all, ComponentMask none);
+bool NextQueryChunk(EcsQuery *query);                   // False once every chunk was visited
+void *GetQueryColumn(const EcsQuery *query, ComponentId component);   // count elements, NULL when the chunk doesn't have it
+
+#endif // ECS_H
@@ -0,0 +1,109 @@
+// file_watch.c - notice when a file changes on disk (see file_watch.h)
+#include "file_watch.h"
+#include "heap.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    #include <unistd.h>
+    #define FILE_WATCH_INOTIFY
+#endif
+
+struct FileWatch {
+    char *fileName;
+    const char *baseName;        // points into fileName
+#if defined(FILE_WATCH_INOTIFY)
+    int fd;
+#endif
+    long long modTime;           // fallback polling state
+    long long size;
+};
+
+static void StatFile(const char *fileName, long long *modTime, long long *size)
+{
+    struct stat st;
+    if (stat(fileName, &st) == 0) { *modTime = (long long)st.st_mtime; *size = (long long)st.st_size; }
+    else { *modTime = -1; *size = -1; }
+}
+
+FileWatch *WatchFile(const char *fileName)
+{
+    FileWatch *watch = RL_CALLOC(1, sizeof(FileWatch));
+    size_t length = strlen(fileName);
+    if (!watch || !(watch->fileName = RL_MALLOC(length + 1))) { RL_FREE(watch); return NULL; }
+    memcpy(watch->fileName, fileName, length + 1);
+
+    const char *slash = strrchr(watch->fileName, '/');
+#if defined(_WIN32)
+    const char *backslash = strrchr(watch->fileName, '\\');
+    if (!slash || (backslash && backslash > slash)) slash = backslash;
+#endif
+    watch->baseName = slash ? slash + 1 : watch->fileName;
+    StatFile(fileName, &watch->modTime, &watch->size);
+
+#if defined(FILE_WATCH_INOTIFY)
+    // Watch the directory, not the file: saving by rename replaces the inode
+    size_t dirLength = slash ? (size_t)(slash - watch->fileName) : 0;
+    char *dir = RL_MALLOC(dirLength + 2);
+    watch->fd = -1;
+    if (dir)
+    {
+        if (!slash) strcpy(dir, ".");
+        else if (dirLength == 0) strcpy(dir, "/");
+        else { memcpy(dir, watch->fileName, dirLength); dir[dirLength] = '\0'; }
+
+        watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watch->fd >= 0 && inotify_add_watch(watch->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            close(watch->fd);
+            watch->fd = -1;
+        }
+        RL_FREE(dir);
+    }
+#endif
+    return watch;
+}
+
+bool PollFileWatch(FileWatch *watch)
+{
+    if (!watch) return false;
+#if defined(FILE_WATCH_INOTIFY)
+    if (watch->fd >= 0)
+    {
+        // Drain every pending event, a save usually produces several
+        char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        bool changed = false;
+        for (;;)
+        {
+            ssize_t length = read(watch->fd, buffer, sizeof(buffer));
+            if (length <= 0) break;
+            for (char *p = buffer; p < buffer + length;)
+            {
+                const struct inotify_event *event = (const struct inotify_event *)p;
+                if (event->len > 0 && strcmp(event->name, watch->baseName) == 0) changed = true;
+                p += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        return changed;
+    }
+#endif
+    long long modTime, size;
+    StatFile(watch->fileName, &modTime, &size);
+    if (modTime == watch->modTime && size == watch->size) return false;
+    watch->modTime = modTime;
+    watch->size = size;
+    return modTime >= 0;
+}
+
+void UnwatchFile(FileWatch *watch)
+{
+    if (!watch) return;
+#if defined(FILE_WATCH_INOTIFY)
+    if (watch->fd >= 0) close(watch->fd);
+#endif
+    RL_FREE(watch->fileName);
+    RL_FREE(watch);
+}
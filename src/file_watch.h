@@ -0,0 +1,18 @@
+// file_watch.h - notice when a file changes on disk
+//
+// On Linux this uses inotify on the file's directory, so changes made by
+// writing the file in place or by replacing it with a rename (how most tools
+// save) are both seen without touching the disk each frame. Elsewhere it
+// compares the file's modification time and size on every poll.
+#ifndef FILE_WATCH_H
+#define FILE_WATCH_H
+
+#include <stdbool.h>
+
+typedef struct FileWatch FileWatch;
+
+FileWatch *WatchFile(const char *fileName);        // NULL if the file can't be watched
+bool PollFileWatch(FileWatch *watch);              // Non-blocking, true once per batch of changes
+void UnwatchFile(FileWatch *watch);
+
+#endif // FILE_WATCH_H
@@ -0,0 +1,150 @@
+// frame_arena.c - per frame scratch memory (see frame_arena.h)
+#include "frame_arena.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_ARENA_MAGIC  0xA11CF00Du
+#define FRAME_ARENA_POISON 0xCD
+
+// Ahead of every allocation in DEBUG builds, one alignment unit
+typedef struct FrameAllocHeader {
+    uint32_t magic;
+    uint32_t frame;
+    uint64_t size;
+} FrameAllocHeader;
+
+#if FRAME_ARENA_CHECKS
+    #define HEADER_SIZE sizeof(FrameAllocHeader)
+#else
+    #define HEADER_SIZE 0
+#endif
+
+FrameArena LoadFrameArena(size_t capacity)
+{
+    FrameArena arena = { 0 };
+    capacity = (capacity + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+    arena.buffers[0] = RL_MALLOC(capacity);
+    arena.buffers[1] = RL_MALLOC(capacity);
+    if (arena.buffers[0] && arena.buffers[1]) arena.capacity = capacity;     // otherwise it all overflows
+    return arena;
+}
+
+static void FreeOverflow(FrameArena *arena, int buffer)
+{
+    for (int i = 0; i < arena->overflowCount[buffer]; i++) RL_FREE(arena->overflow[buffer][i]);
+    arena->overflowCount[buffer] = 0;
+}
+
+void UnloadFrameArena(FrameArena *arena)
+{
+    for (int b = 0; b < 2; b++)
+    {
+        FreeOverflow(arena, b);
+        RL_FREE(arena->overflow[b]);
+        RL_FREE(arena->buffers[b]);
+    }
+    *arena = (FrameArena){ 0 };
+}
+
+static unsigned char *AllocOverflow(FrameArena *arena, size_t size)
+{
+    int b = arena->current;
+    if (arena->overflowCount[b] == arena->overflowCapacity[b])
+    {
+        int capacity = (arena->overflowCapacity[b] > 0) ? 2*arena->overflowCapacity[b] : 16;
+        void **grown = RL_REALLOC(arena->overflow[b], (size_t)capacity*sizeof(void *));
+        if (!grown) return NULL;
+        arena->overflow[b] = grown;
+        arena->overflowCapacity[b] = capacity;
+    }
+    unsigned char *block = RL_MALLOC(size);
+    if (block) arena->overflow[b][arena->overflowCount[b]++] = block;
+    return block;
+}
+
+void *FrameAlloc(FrameArena *arena, size_t size)
+{
+    size_t total = (HEADER_SIZE + size + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+    size_t *used = &arena->used[arena->current];
+    unsigned char *block;
+    if (total <= arena->capacity - *used)
+    {
+        block = arena->buffers[arena->current] + *used;
+        *used += total;
+    }
+    else
+    {
+        block = AllocOverflow(arena, HEADER_SIZE + size);
+        if (!block) return NULL;
+        arena->stats.overflowBytes += size;
+    }
+#if FRAME_ARENA_CHECKS
+    *(FrameAllocHeader *)block = (FrameAllocHeader){ FRAME_ARENA_MAGIC, arena->frame, size };
+#endif
+
+    arena->stats.allocations++;
+    arena->stats.used = *used;
+    if (*used + arena->stats.overflowBytes > arena->stats.peak) arena->stats.peak = *used + arena->stats.overflowBytes;
+    return block + HEADER_SIZE;
+}
+
+void *FrameAllocZero(FrameArena *arena, size_t size)
+{
+    void *ptr = FrameAlloc(arena, size);
+    if (ptr) memset(ptr, 0, size);
+    return ptr;
+}
+
+char *FrameFormat(FrameArena *arena, const char *text, ...)
+{
+    va_list args, copy;
+    va_start(args, text);
+    va_copy(copy, args);
+    int length = vsnprintf(NULL, 0, text, copy);
+    va_end(copy);
+    char *result = (length >= 0) ? FrameAlloc(arena, (size_t)length + 1) : NULL;
+    if (result) vsnprintf(result, (size_t)length + 1, text, args);
+    va_end(args);
+    return result;
+}
+
+void EndFrameArena(FrameArena *arena)
+{
+    // The other buffer held the frame before this one, its memory is done
+    arena->frame++;
+    arena->current ^= 1;
+    FreeOverflow(arena, arena->current);
+#if FRAME_ARENA_CHECKS
+    if (arena->buffers[arena->current]) memset(arena->buffers[arena->current], FRAME_ARENA_POISON, arena->used[arena->current]);
+#endif
+    arena->used[arena->current] = 0;
+    arena->stats.used = 0;
+    arena->stats.overflowBytes = 0;
+    arena->stats.allocations = 0;
+}
+
+bool IsFrameAllocLive(const FrameArena *arena, const void *ptr)
+{
+#if FRAME_ARENA_CHECKS
+    if (ptr == NULL) return false;
+    const unsigned char *block = (const unsigned char *)ptr - HEADER_SIZE;
+    bool found = false;
+    for (int b = 0; b < 2 && !found; b++)
+    {
+        const unsigned char *start = arena->buffers[b];
+        found = (start != NULL) && (block >= start) && (block < start + arena->used[b]);
+        for (int i = 0; i < arena->overflowCount[b] && !found; i++) found = (arena->overflow[b][i] == block);
+    }
+    if (!found) return false;
+
+    FrameAllocHeader header;
+    memcpy(&header, block, sizeof(header));
+    return (header.magic == FRAME_ARENA_MAGIC) && (arena->frame - header.frame <= 1);
+#else
+    (void)arena; (void)ptr;
+    return true;
+#endif
+}
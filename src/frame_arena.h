@@ -0,0 +1,77 @@
+// frame_arena.h - per frame scratch memory
+//
+// Temporary data a frame builds (candidate lists, formatted strings, scratch
+// arrays) comes from a bump allocator instead of the heap: allocating moves
+// a pointer, and nothing is freed one by one. There are two buffers, one
+// per frame: EndFrameArena(), called once per frame before anything
+// allocates from the new one, switches to the other buffer and empties it,
+// so memory stays valid until the end of the next frame, long enough to
+// hand last frame's results to this one.
+//
+// When a frame needs more than the capacity the rest comes from the heap and
+// is freed with its buffer; stats.overflowBytes says how much to add.
+//
+// In DEBUG builds every allocation carries the frame it was made in and
+// emptied buffers are filled with 0xCD, so CheckFrameAlloc() can flag a
+// pointer kept past its frame, and stale reads show up as garbage.
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "raylib.h"
+
+#define FRAME_ARENA_ALIGNMENT 16
+
+#if defined(DEBUG)
+    #define FRAME_ARENA_CHECKS 1
+#else
+    #define FRAME_ARENA_CHECKS 0
+#endif
+
+typedef struct FrameArenaStats {
+    size_t used;                 // this frame, so far
+    size_t peak;                 // most any frame used, overflow included
+    size_t overflowBytes;        // this frame, from the heap
+    int allocations;             // this frame
+} FrameArenaStats;
+
+typedef struct FrameArena {
+    unsigned char *buffers[2];
+    size_t capacity;             // of each buffer
+    size_t used[2];
+    int current;                 // buffer of this frame
+    uint32_t frame;
+
+    void **overflow[2];          // heap blocks, freed when their buffer is emptied
+    int overflowCount[2];
+    int overflowCapacity[2];
+
+    FrameArenaStats stats;
+} FrameArena;
+
+FrameArena LoadFrameArena(size_t capacity);
+void UnloadFrameArena(FrameArena *arena);
+
+// FRAME_ARENA_ALIGNMENT aligned, valid until the end of the next frame.
+// NULL only when the heap is out too.
+void *FrameAlloc(FrameArena *arena, size_t size);
+void *FrameAllocZero(FrameArena *arena, size_t size);
+char *FrameFormat(FrameArena *arena, const char *text, ...);   // TextFormat() without its buffer limits
+void EndFrameArena(FrameArena *arena);                        // Once per frame, before anything allocates from the new frame
+
+#define FrameAllocArray(arena, type, count)     ((type *)FrameAlloc((arena), sizeof(type)*(size_t)(count)))
+#define FrameAllocArrayZero(arena, type, count) ((type *)FrameAllocZero((arena), sizeof(type)*(size_t)(count)))
+
+// True for a pointer FrameAlloc() returned this frame or the last, false
+// once its buffer has been emptied. Only knows in DEBUG builds, true otherwise.
+bool IsFrameAllocLive(const FrameArena *arena, const void *ptr);
+
+#if FRAME_ARENA_CHECKS
+    #define CheckFrameAlloc(arena, ptr) \
+        do { if (!IsFrameAllocLive((arena), (ptr))) TraceLog(LOG_ERROR, "ARENA: %s used after its frame (%s:%d)", #ptr, __FILE__, __LINE__); } while (0)
+#else
+    #define CheckFrameAlloc(arena, ptr) ((void)0)
+#endif
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,81 @@
+// frame_pacer.c - late input sampling for low latency frames (see frame_pacer.h)
+#include "frame_pacer.h"
+
+#include <math.h>
+
+#if defined(PLATFORM_DESKTOP)
+    #define GLFW_INCLUDE_NONE
+    #include "GLFW/glfw3.h"      // glfwPollEvents(), raylib's callbacks update its input state
+    #define FRAME_PACER_LATE_INPUT
+#endif
+
+#define FRAME_PACER_SMOOTHING 0.1
+
+FramePacer LoadFramePacer(int targetFps)
+{
+    FramePacer pacer = { 0 };
+    if (targetFps <= 0) targetFps = GetMonitorRefreshRate(GetCurrentMonitor());
+    if (targetFps <= 0) targetFps = 60;
+    pacer.targetFps = targetFps;
+    pacer.period = 1.0/targetFps;
+    pacer.workMean = 0.5*pacer.period;          // cautious until a few frames are in
+    pacer.swapTime = pacer.wakeTime = GetTime();
+    SetFramePacerEnabled(&pacer, true);
+    return pacer;
+}
+
+void SetFramePacerEnabled(FramePacer *pacer, bool enabled)
+{
+#if !defined(FRAME_PACER_LATE_INPUT)
+    enabled = false;                            // nothing to gain, keep raylib's limiter
+#endif
+    pacer->enabled = enabled;
+    SetTargetFPS(enabled ? 0 : pacer->targetFps);
+}
+
+#if defined(FRAME_PACER_LATE_INPUT)
+// OS sleep for the bulk, then spin, so the wake is within a few microseconds
+static void SleepUntil(FramePacer *pacer, double wake)
+{
+    double spin = FRAME_PACER_SPIN_MS/1000.0 + 2.0*pacer->oversleep;
+    double remaining = wake - GetTime();
+    if (remaining > spin)
+    {
+        double start = GetTime();
+        WaitTime(remaining - spin);
+        double over = (GetTime() - start) - (remaining - spin);
+        pacer->oversleep += FRAME_PACER_SMOOTHING*(fmax(over, 0.0) - pacer->oversleep);
+    }
+    while (GetTime() < wake) { }
+}
+#endif
+
+void WaitFramePacer(FramePacer *pacer)
+{
+    pacer->swapTime = GetTime();
+    pacer->stats.waitMs = 0.0;
+#if defined(FRAME_PACER_LATE_INPUT)
+    if (pacer->enabled)
+    {
+        double expected = pacer->workMean + FRAME_PACER_DEVIATIONS*sqrt(pacer->workVariance) + FRAME_PACER_MARGIN_MS/1000.0;
+        SleepUntil(pacer, pacer->swapTime + pacer->period - expected);
+        glfwPollEvents();
+        pacer->stats.waitMs = (GetTime() - pacer->swapTime)*1000.0;
+    }
+#endif
+    pacer->stats.savedMs += FRAME_PACER_SMOOTHING*(pacer->stats.waitMs - pacer->stats.savedMs);
+    pacer->wakeTime = GetTime();
+}
+
+void EndFramePacer(FramePacer *pacer)
+{
+    double now = GetTime();
+    double work = now - pacer->wakeTime, difference = work - pacer->workMean;
+
+    // Exponentially weighted mean and variance
+    pacer->workMean += FRAME_PACER_SMOOTHING*difference;
+    pacer->workVariance = (1.0 - FRAME_PACER_SMOOTHING)*(pacer->workVariance + FRAME_PACER_SMOOTHING*difference*difference);
+    pacer->stats.workMs = pacer->workMean*1000.0;
+    pacer->stats.workDeviationMs = sqrt(pacer->workVariance)*1000.0;
+    if (pacer->enabled && (now > pacer->swapTime + pacer->period)) pacer->stats.lateFrames++;
+}
@@ -0,0 +1,57 @@
+// frame_pacer.h - late input sampling for low latency frames
+//
+// With VSync, EndDrawing() returns at the vertical blank and polls input
+// right away, so the mouse position a frame is rendered from is a whole
+// refresh old by the time it's shown. A FramePacer instead sleeps after the
+// swap until just before the next blank, less the time the frame is
+// expected to take, then polls again so the camera is updated from the
+// freshest mouse delta. The time slept is latency saved.
+//
+// The expected time is the smoothed mean of past frames plus
+// FRAME_PACER_DEVIATIONS standard deviations and FRAME_PACER_MARGIN_MS, so
+// frames with spiky work start earlier. Sleeping goes through the OS until
+// FRAME_PACER_SPIN_MS (widened by how much the OS has been oversleeping)
+// before waking, then spins on the clock.
+//
+// The late poll pumps window events without starting a new input frame, so
+// keys pressed before or during the sleep all register. It needs GLFW
+// (PLATFORM_DESKTOP); elsewhere the pacer doesn't sleep and only measures.
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "raylib.h"
+
+#define FRAME_PACER_DEVIATIONS 3.0
+#define FRAME_PACER_MARGIN_MS  1.0       // swap and scheduling slack
+#define FRAME_PACER_SPIN_MS    0.5
+
+typedef struct FramePacerStats {
+    double workMs;               // mean frame time, late poll to EndDrawing()
+    double workDeviationMs;
+    double waitMs;               // slept this frame, the latency saved
+    double savedMs;              // waitMs smoothed
+    int lateFrames;              // past the deadline, since loading
+} FramePacerStats;
+
+typedef struct FramePacer {
+    bool enabled;
+    int targetFps;               // refresh rate the deadlines follow
+    double period;               // seconds
+    double swapTime;             // EndDrawing() returned
+    double wakeTime;             // late poll done
+    double workMean, workVariance;
+    double oversleep;            // smoothed, seconds past the requested wake
+    FramePacerStats stats;
+} FramePacer;
+
+// targetFps 0 follows the current monitor's refresh rate. Loading enables
+// the pacer, which turns raylib's own frame limiter off (SetTargetFPS(0)).
+FramePacer LoadFramePacer(int targetFps);
+void SetFramePacerEnabled(FramePacer *pacer, bool enabled);   // Disabled: SetTargetFPS(targetFps) as before
+
+// First thing in the frame: sleeps and polls input again, GetMouseDelta()
+// and the key states then cover everything since the last EndDrawing()
+void WaitFramePacer(FramePacer *pacer);
+void EndFramePacer(FramePacer *pacer);                        // Right before EndDrawing()
+
+#endif // FRAME_PACER_H
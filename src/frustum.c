@@ -0,0 +1,133 @@
+// frustum.c - view frustum culling (see frustum.h)
+#include "frustum.h"
+
+#include <math.h>
+#include "raymath.h"
+#include "rlgl.h"
+
+#if !defined(FRUSTUM_DISABLE_SIMD)
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_SIMD_SSE
+#endif
+#endif
+
+static Vector4 NormalizePlane(float a, float b, float c, float d)
+{
+    float length = sqrtf(a*a + b*b + c*c);
+    if (length > 0.0f) { a /= length; b /= length; c /= length; d /= length; }
+    return (Vector4){ a, b, c, d };
+}
+
+Matrix GetCameraViewProjection(Camera camera, float aspect)
+{
+    // Same matrices BeginMode3D() loads
+    Matrix projection;
+    if (camera.projection == CAMERA_ORTHOGRAPHIC)
+    {
+        double top = camera.fovy/2.0, right = top*aspect;
+        projection = MatrixOrtho(-right, right, -top, top, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    }
+    else projection = MatrixPerspective(camera.fovy*DEG2RAD, aspect, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    return MatrixMultiply(view, projection);
+}
+
+Frustum GetCameraFrustum(Camera camera, float aspect)
+{
+    return GetFrustumFromMatrix(GetCameraViewProjection(camera, aspect));
+}
+
+Frustum GetFrustumFromMatrix(Matrix m)
+{
+    // Gribb/Hartmann: each plane is the last row of the clip matrix plus or
+    // minus one of the others (raylib's mN fields are column major)
+    Frustum frustum;
+    frustum.planes[FRUSTUM_LEFT]   = NormalizePlane(m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8, m.m15 + m.m12);
+    frustum.planes[FRUSTUM_RIGHT]  = NormalizePlane(m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8, m.m15 - m.m12);
+    frustum.planes[FRUSTUM_BOTTOM] = NormalizePlane(m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9, m.m15 + m.m13);
+    frustum.planes[FRUSTUM_TOP]    = NormalizePlane(m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9, m.m15 - m.m13);
+    frustum.planes[FRUSTUM_NEAR]   = NormalizePlane(m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14);
+    frustum.planes[FRUSTUM_FAR]    = NormalizePlane(m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14);
+    return frustum;
+}
+
+bool IsBoxInFrustum(const Frustum *frustum, BoundingBox box)
+{
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+    {
+        // Only the corner furthest along the normal matters
+        Vector4 plane = frustum->planes[p];
+        float x = (plane.x >= 0.0f) ? box.max.x : box.min.x;
+        float y = (plane.y >= 0.0f) ? box.max.y : box.min.y;
+        float z = (plane.z >= 0.0f) ? box.max.z : box.min.z;
+        if (plane.x*x + plane.y*y + plane.z*z + plane.w < 0.0f) return false;
+    }
+    return true;
+}
+
+bool IsSphereInFrustum(const Frustum *frustum, Vector3 center, float radius)
+{
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+    {
+        Vector4 plane = frustum->planes[p];
+        if (plane.x*center.x + plane.y*center.y + plane.z*center.z + plane.w < -radius) return false;
+    }
+    return true;
+}
+
+uint32_t CullBoxes(const Frustum *frustum, const float *const bounds[6], uint32_t count, uint32_t *visible)
+{
+    // The furthest corner is picked per plane, not per box, so the inner
+    // loop is three multiply-adds and a compare for each plane
+    const float *corner[FRUSTUM_PLANE_COUNT][3];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+    {
+        const float *n = &frustum->planes[p].x;
+        for (int a = 0; a < 3; a++) corner[p][a] = (n[a] >= 0.0f) ? bounds[3 + a] : bounds[a];
+    }
+
+    uint32_t visibleCount = 0;
+    uint32_t i = 0;
+#if defined(FRUSTUM_SIMD_SSE)
+    __m128 nx[FRUSTUM_PLANE_COUNT], ny[FRUSTUM_PLANE_COUNT], nz[FRUSTUM_PLANE_COUNT], nw[FRUSTUM_PLANE_COUNT];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+    {
+        nx[p] = _mm_set1_ps(frustum->planes[p].x);
+        ny[p] = _mm_set1_ps(frustum->planes[p].y);
+        nz[p] = _mm_set1_ps(frustum->planes[p].z);
+        nw[p] = _mm_set1_ps(frustum->planes[p].w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+        {
+            __m128 d = _mm_add_ps(_mm_mul_ps(nx[p], _mm_loadu_ps(corner[p][0] + i)), nw[p]);
+            d = _mm_add_ps(d, _mm_mul_ps(ny[p], _mm_loadu_ps(corner[p][1] + i)));
+            d = _mm_add_ps(d, _mm_mul_ps(nz[p], _mm_loadu_ps(corner[p][2] + i)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+        }
+        int mask = _mm_movemask_ps(inside);
+        while (mask)
+        {
+            int lane = (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+            visible[visibleCount++] = i + (uint32_t)lane;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        bool inside = true;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT && inside; p++)
+        {
+            Vector4 plane = frustum->planes[p];
+            float d = plane.x*corner[p][0][i] + plane.w + plane.y*corner[p][1][i] + plane.z*corner[p][2][i];   // same order as SSE
+            inside = (d >= 0.0f);
+        }
+        if (inside) visible[visibleCount++] = i;
+    }
+    return visibleCount;
+}
@@ -0,0 +1,44 @@
+// frustum.h - view frustum culling
+//
+// GetCameraFrustum builds the six planes of what BeginMode3D(camera) will
+// show, using the same projection raylib sets up (rlgl's cull distances for
+// near and far). The tests are conservative: a box or sphere is only culled
+// when it's entirely outside one plane, so nothing visible is ever dropped,
+// while a few boxes near the frustum's corners may be kept.
+//
+// CullBoxes tests boxes stored as separate min/max arrays (the layout of
+// Level in level.h) four at a time with SSE where available.
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <stdint.h>
+#include "raylib.h"
+
+typedef enum {
+    FRUSTUM_LEFT = 0,
+    FRUSTUM_RIGHT,
+    FRUSTUM_BOTTOM,
+    FRUSTUM_TOP,
+    FRUSTUM_NEAR,
+    FRUSTUM_FAR,
+    FRUSTUM_PLANE_COUNT
+} FrustumPlane;
+
+// Planes are (normal, distance) with normals pointing inside: a point p is
+// in front of a plane when normal.p + distance >= 0. Normals have unit length.
+typedef struct Frustum {
+    Vector4 planes[FRUSTUM_PLANE_COUNT];
+} Frustum;
+
+Frustum GetCameraFrustum(Camera camera, float aspect);                     // aspect is width/height of the render target
+Matrix GetCameraViewProjection(Camera camera, float aspect);               // view*projection as BeginMode3D() sets them
+Frustum GetFrustumFromMatrix(Matrix viewProjection);
+bool IsBoxInFrustum(const Frustum *frustum, BoundingBox box);
+bool IsSphereInFrustum(const Frustum *frustum, Vector3 center, float radius);
+
+// Writes the index of every box that may be visible to visible[] (room for
+// count indices) and returns how many there are, in increasing order.
+// bounds[0..5] are the minX, minY, minZ, maxX, maxY, maxZ arrays.
+uint32_t CullBoxes(const Frustum *frustum, const float *const bounds[6], uint32_t count, uint32_t *visible);
+
+#endif // FRUSTUM_H
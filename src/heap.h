@@ -0,0 +1,17 @@
+// heap.h - RL_MALLOC and friends for modules that don't include raylib.h
+//
+// The demo's build force includes alloc_hook.h, which counts these; the
+// tools don't, and get the C library.
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdlib.h>
+
+#ifndef RL_MALLOC
+    #define RL_MALLOC(sz)       malloc(sz)
+    #define RL_CALLOC(n,sz)     calloc(n,sz)
+    #define RL_REALLOC(ptr,sz)  realloc(ptr,sz)
+    #define RL_FREE(ptr)        free(ptr)
+#endif
+
+#endif // HEAP_H
@@ -0,0 +1,125 @@
+// hud.c - retained text overlay (see hud.h)
+#include "hud.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+Hud LoadHud(int width, int height)
+{
+    Hud hud = { 0 };
+    hud.target = LoadRenderTexture(width, height);
+    BeginTextureMode(hud.target);
+    ClearBackground(BLANK);
+    EndTextureMode();
+    return hud;
+}
+
+void UnloadHud(Hud *hud)
+{
+    UnloadRenderTexture(hud->target);
+    *hud = (Hud){ 0 };
+}
+
+int AddHudLine(Hud *hud, int x, int y, int fontSize, Color color)
+{
+    if (hud->lineCount == HUD_MAX_LINES) return -1;
+    HudLine *line = &hud->lines[hud->lineCount];
+    *line = (HudLine){ 0 };
+    line->x = x;
+    line->y = y;
+    line->fontSize = (fontSize < 10) ? 10 : fontSize;   // DrawText()'s minimum, the default font's size
+    line->color = color;
+    return hud->lineCount++;
+}
+
+void SetHudLine(Hud *hud, int line, const char *text)
+{
+    if (line < 0 || line >= hud->lineCount) return;
+    HudLine *l = &hud->lines[line];
+    if (strncmp(l->pending, text, HUD_LINE_CAPACITY - 1) == 0) return;
+    snprintf(l->pending, HUD_LINE_CAPACITY, "%s", text);
+    l->dirty = true;
+}
+
+void SetHudLineF(Hud *hud, int line, const char *format, ...)
+{
+    char text[HUD_LINE_CAPACITY];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    SetHudLine(hud, line, text);
+}
+
+void SetHudLineColor(Hud *hud, int line, Color color)
+{
+    if (line < 0 || line >= hud->lineCount) return;
+    HudLine *l = &hud->lines[line];
+    if (ColorToInt(l->color) == ColorToInt(color)) return;
+    l->color = color;
+    l->dirty = l->recolor = true;
+}
+
+// Inside BeginTextureMode(), returns how many characters were drawn
+static int RedrawHudLine(HudLine *line)
+{
+    Font font = GetFontDefault();
+    float fontSize = (float)line->fontSize, spacing = (float)(line->fontSize/10);   // as DrawText() does
+
+    // The common start stays, cut on a character boundary
+    int same = 0;
+    if (!line->recolor)
+        while (line->text[same] != '\0' && line->text[same] == line->pending[same]) same++;
+    while (same > 0 && (((line->pending[same] & 0xc0) == 0x80) || ((line->text[same] & 0xc0) == 0x80))) same--;
+
+    float start = 0.0f;
+    if (same > 0)
+    {
+        char kept[HUD_LINE_CAPACITY];
+        memcpy(kept, line->text, same);
+        kept[same] = '\0';
+        start = MeasureTextEx(font, kept, fontSize, spacing).x + spacing;
+    }
+
+    int clearX = line->x + (int)start;
+    int clearWidth = line->x + line->width + 1 - clearX;
+    if (clearWidth > 0)
+    {
+        BeginScissorMode(clearX, line->y, clearWidth, line->fontSize);
+        ClearBackground(BLANK);
+        EndScissorMode();
+    }
+
+    const char *changed = line->pending + same;
+    if (*changed != '\0') DrawTextEx(font, changed, (Vector2){ (float)line->x + start, (float)line->y }, fontSize, spacing, line->color);
+    line->width = (line->pending[0] != '\0') ? (int)(MeasureTextEx(font, line->pending, fontSize, spacing).x + 0.5f) : 0;
+    memcpy(line->text, line->pending, HUD_LINE_CAPACITY);
+    line->dirty = line->recolor = false;
+    return TextLength(changed);
+}
+
+void DrawHud(Hud *hud)
+{
+    double start = GetTime();
+    HudStats stats = { 0 };
+
+    bool drawing = false;
+    for (int i = 0; i < hud->lineCount; i++)
+    {
+        if (!hud->lines[i].dirty) continue;
+        if (!drawing) { BeginTextureMode(hud->target); drawing = true; }
+        stats.charsRedrawn += RedrawHudLine(&hud->lines[i]);
+        stats.linesRedrawn++;
+    }
+    if (drawing) EndTextureMode();
+    double updated = GetTime();
+
+    // Render textures are upside down
+    Texture2D texture = hud->target.texture;
+    DrawTextureRec(texture, (Rectangle){ 0, 0, (float)texture.width, -(float)texture.height }, (Vector2){ 0, 0 }, WHITE);
+
+    stats.updateMs = (updated - start)*1000.0;
+    stats.drawMs = (GetTime() - start)*1000.0;
+    hud->stats = stats;
+}
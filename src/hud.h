@@ -0,0 +1,57 @@
+// hud.h - retained text overlay
+//
+// DrawText(TextFormat(...)) lays out and submits every glyph every frame,
+// though HUD lines only change on a key press or when a counter ticks. A Hud
+// keeps its lines drawn in a screen sized render texture and draws that with
+// one quad. Setting a line to the text it already shows costs a string
+// compare; when it does change, only the part after the characters the old
+// and new text start with is cleared and drawn again, so a counter going
+// from 1.23 to 1.25 redraws one digit.
+//
+// Lines use raylib's default font, like DrawText, and are single line.
+// Update them between BeginDrawing() and DrawHud(), outside of any
+// BeginMode3D()/BeginTextureMode().
+#ifndef HUD_H
+#define HUD_H
+
+#include "raylib.h"
+
+#define HUD_MAX_LINES     32
+#define HUD_LINE_CAPACITY 160            // bytes, longer text is cut
+
+typedef struct HudLine {
+    char text[HUD_LINE_CAPACITY];        // in the texture
+    char pending[HUD_LINE_CAPACITY];     // drawn at the next DrawHud()
+    int x, y;
+    int fontSize;
+    Color color;
+    int width;                           // pixels covered in the texture
+    bool dirty;
+    bool recolor;                        // draw all of it again
+} HudLine;
+
+typedef struct HudStats {
+    int linesRedrawn;                    // last DrawHud()
+    int charsRedrawn;
+    double updateMs;                     // drawing changes into the texture
+    double drawMs;                       // all of DrawHud()
+} HudStats;
+
+typedef struct Hud {
+    RenderTexture2D target;
+    HudLine lines[HUD_MAX_LINES];
+    int lineCount;
+    HudStats stats;
+} Hud;
+
+Hud LoadHud(int width, int height);                     // Needs the window, usually the screen size
+void UnloadHud(Hud *hud);
+
+// Returns the line's id, -1 when full. Lines start empty.
+int AddHudLine(Hud *hud, int x, int y, int fontSize, Color color);
+void SetHudLine(Hud *hud, int line, const char *text);
+void SetHudLineF(Hud *hud, int line, const char *format, ...);   // printf style, own buffer, not TextFormat()'s
+void SetHudLineColor(Hud *hud, int line, Color color);
+void DrawHud(Hud *hud);                                 // Applies the changes, then draws the overlay
+
+#endif // HUD_H
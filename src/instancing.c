@@ -0,0 +1,390 @@
+// instancing.c - instanced drawing of meshes and line meshes (see instancing.h)
+#include "instancing.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raymath.h"
+#include "rlgl.h"
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_43)
+    #define INSTANCING_GL
+#endif
+
+#define INSTANCE_FLOATS 16
+
+// The color lives in the bottom row of the transform (see instancing.h)
+#define INSTANCE_VERTEX_SHADER_BODY \
+    "in vec3 vertexPosition;\n" \
+    "layout(location = 12) in mat4 instanceTransform;\n" \
+    "uniform mat4 mvp;\n" \
+    "uniform vec4 colDiffuse;\n" \
+    "out vec4 fragColor;\n" \
+    "void main()\n" \
+    "{\n" \
+    "    mat4 model = instanceTransform;\n" \
+    "#ifdef INSTANCE_COLORS\n" \
+    "    fragColor = vec4(model[0][3], model[1][3], model[2][3], model[3][3])*colDiffuse;\n" \
+    "#else\n" \
+    "    fragColor = colDiffuse;\n" \
+    "#endif\n" \
+    "    model[0][3] = 0.0; model[1][3] = 0.0; model[2][3] = 0.0; model[3][3] = 1.0;\n" \
+    "    gl_Position = mvp*model*vec4(vertexPosition, 1.0);\n" \
+    "}\n"
+
+static const char *coloredVertexShader = "#version 330\n#define INSTANCE_COLORS\n" INSTANCE_VERTEX_SHADER_BODY;
+static const char *plainVertexShader = "#version 330\n" INSTANCE_VERTEX_SHADER_BODY;
+
+static const char *instanceFragmentShader =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+#if !defined(INSTANCING_GL)
+// DrawMeshInstances() draws instance by instance with this instead, it lives
+// as long as any instance shader does
+static Material fallbackMaterial = { 0 };
+static int instanceShaderCount = 0;
+#endif
+
+Shader LoadInstanceShader(bool instanceColors)
+{
+#if !defined(INSTANCING_GL)
+    if (instanceShaderCount++ == 0) fallbackMaterial = LoadMaterialDefault();
+#endif
+    return LoadShaderFromMemory(instanceColors ? coloredVertexShader : plainVertexShader, instanceFragmentShader);
+}
+
+void UnloadInstanceShader(Shader shader)
+{
+    UnloadShader(shader);
+#if !defined(INSTANCING_GL)
+    if (--instanceShaderCount == 0)
+    {
+        UnloadMaterial(fallbackMaterial);
+        fallbackMaterial = (Material){ 0 };
+    }
+#endif
+}
+
+/* ── instance buffer ───────────────────────────────────────────────── */
+void UnloadInstanceBuffer(InstanceBuffer *buffer)
+{
+    if (buffer->vboId > 0) rlUnloadVertexBuffer(buffer->vboId);
+    RL_FREE(buffer->transforms);
+    *buffer = (InstanceBuffer){ 0 };
+}
+
+void ClearInstances(InstanceBuffer *buffer)
+{
+    buffer->count = 0;
+}
+
+static float *NextInstance(InstanceBuffer *buffer)
+{
+    if (buffer->count == buffer->capacity)
+    {
+        int capacity = (buffer->capacity > 0) ? 2*buffer->capacity : 256;
+        float *grown = RL_REALLOC(buffer->transforms, (size_t)capacity*INSTANCE_FLOATS*sizeof(float));
+        if (!grown) return NULL;
+        buffer->transforms = grown;
+        buffer->capacity = capacity;
+    }
+    return buffer->transforms + (size_t)INSTANCE_FLOATS*buffer->count++;
+}
+
+void AddInstance(InstanceBuffer *buffer, Matrix transform, Color color)
+{
+    float *m = NextInstance(buffer);
+    if (!m) return;
+    m[0] = transform.m0;   m[1] = transform.m1;   m[2] = transform.m2;   m[3] = color.r/255.0f;
+    m[4] = transform.m4;   m[5] = transform.m5;   m[6] = transform.m6;   m[7] = color.g/255.0f;
+    m[8] = transform.m8;   m[9] = transform.m9;   m[10] = transform.m10; m[11] = color.b/255.0f;
+    m[12] = transform.m12; m[13] = transform.m13; m[14] = transform.m14; m[15] = color.a/255.0f;
+}
+
+void AppendInstances(InstanceBuffer *buffer, const InstanceBuffer *source)
+{
+    int count = buffer->count + source->count;
+    if (source->count == 0) return;
+    if (count > buffer->capacity)
+    {
+        int capacity = (buffer->capacity > 0) ? buffer->capacity : 256;
+        while (capacity < count) capacity *= 2;
+        float *grown = RL_REALLOC(buffer->transforms, (size_t)capacity*INSTANCE_FLOATS*sizeof(float));
+        if (!grown) return;
+        buffer->transforms = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->transforms + (size_t)INSTANCE_FLOATS*buffer->count, source->transforms,
+           (size_t)source->count*INSTANCE_FLOATS*sizeof(float));
+    buffer->count = count;
+}
+
+void UploadInstances(InstanceBuffer *buffer)
+{
+#if defined(INSTANCING_GL)
+    if (buffer->count == 0) return;
+    int size = buffer->count*INSTANCE_FLOATS*(int)sizeof(float);
+    if (buffer->count > buffer->vboCapacity)
+    {
+        // Grow to the CPU side capacity so this happens a handful of times at most
+        if (buffer->vboId > 0) rlUnloadVertexBuffer(buffer->vboId);
+        buffer->vboId = rlLoadVertexBuffer(NULL, buffer->capacity*INSTANCE_FLOATS*(int)sizeof(float), true);
+        buffer->vboCapacity = buffer->capacity;
+    }
+    rlUpdateVertexBuffer(buffer->vboId, buffer->transforms, size, 0);
+#else
+    (void)buffer;
+#endif
+}
+
+static Matrix GetInstanceTransform(const InstanceBuffer *buffer, int i, Color *color)
+{
+    const float *m = buffer->transforms + (size_t)INSTANCE_FLOATS*i;
+    *color = (Color){ (unsigned char)(m[3]*255.0f + 0.5f), (unsigned char)(m[7]*255.0f + 0.5f),
+                      (unsigned char)(m[11]*255.0f + 0.5f), (unsigned char)(m[15]*255.0f + 0.5f) };
+    return (Matrix){ m[0], m[4], m[8], m[12], m[1], m[5], m[9], m[13], m[2], m[6], m[10], m[14], 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+/* ── drawing ───────────────────────────────────────────────────────── */
+#if defined(INSTANCING_GL)
+// Sets the uniforms and points instanceTransform at the instance buffer
+// inside the currently bound vertex array
+static void BeginInstances(Shader shader, const InstanceBuffer *instances, Color tint)
+{
+    Matrix mvp = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+    float color[4] = { tint.r/255.0f, tint.g/255.0f, tint.b/255.0f, tint.a/255.0f };
+    rlEnableShader(shader.id);
+    rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], color, RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], mvp);
+
+    rlEnableVertexBuffer(instances->vboId);
+    for (int c = 0; c < 4; c++)
+    {
+        rlEnableVertexAttribute(INSTANCE_ATTRIB_LOCATION + c);
+        rlSetVertexAttribute(INSTANCE_ATTRIB_LOCATION + c, 4, RL_FLOAT, false, INSTANCE_FLOATS*sizeof(float), c*4*sizeof(float));
+        rlSetVertexAttributeDivisor(INSTANCE_ATTRIB_LOCATION + c, 1);
+    }
+    rlDisableVertexBuffer();
+}
+
+// Leaves the vertex array as UploadMesh() made it
+static void EndInstances(void)
+{
+    for (int c = 0; c < 4; c++) rlDisableVertexAttribute(INSTANCE_ATTRIB_LOCATION + c);
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+#endif
+
+void DrawMeshInstances(Mesh mesh, Shader shader, const InstanceBuffer *instances, Color tint)
+{
+    if (instances->count == 0) return;
+#if defined(INSTANCING_GL)
+    rlEnableVertexArray(mesh.vaoId);
+    BeginInstances(shader, instances, tint);
+    if (mesh.indices != NULL) rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount*3, 0, instances->count);
+    else rlDrawVertexArrayInstanced(0, mesh.vertexCount, instances->count);
+    EndInstances();
+#else
+    (void)shader;
+    for (int i = 0; i < instances->count; i++)
+    {
+        Color color;
+        Matrix transform = GetInstanceTransform(instances, i, &color);
+        fallbackMaterial.maps[MATERIAL_MAP_DIFFUSE].color = (Color){ (unsigned char)(color.r*tint.r/255), (unsigned char)(color.g*tint.g/255),
+                                                                     (unsigned char)(color.b*tint.b/255), (unsigned char)(color.a*tint.a/255) };
+        DrawMesh(mesh, fallbackMaterial, transform);
+    }
+#endif
+}
+
+void DrawLineMeshInstances(LineMesh mesh, Shader shader, const InstanceBuffer *instances, Color tint)
+{
+    if (instances->count == 0) return;
+#if defined(INSTANCING_GL)
+    if (mesh.vaoId > 0)
+    {
+        rlEnableVertexArray(mesh.vaoId);
+        BeginInstances(shader, instances, tint);
+        DrawLineMeshElements(mesh, instances->count);
+        EndInstances();
+        return;
+    }
+#endif
+    for (int i = 0; i < instances->count; i++)
+    {
+        Color color;
+        DrawLineMesh(mesh, shader, GetInstanceTransform(instances, i, &color), tint);
+    }
+}
+
+/* ── boxes ─────────────────────────────────────────────────────────── */
+BoxRenderer LoadBoxRenderer(void)
+{
+    BoxRenderer renderer = { 0 };
+    renderer.cube = GenMeshCube(1.0f, 1.0f, 1.0f);
+    renderer.edges = GenLineMeshCube();
+    renderer.faceShader = LoadInstanceShader(true);
+    renderer.edgeShader = LoadInstanceShader(false);
+    return renderer;
+}
+
+void UnloadBoxRenderer(BoxRenderer *renderer)
+{
+    UnloadMesh(renderer->cube);
+    UnloadLineMesh(renderer->edges);
+    UnloadInstanceShader(renderer->faceShader);
+    UnloadInstanceShader(renderer->edgeShader);
+    UnloadInstanceBuffer(&renderer->instances);
+    *renderer = (BoxRenderer){ 0 };
+}
+
+void AddBoxInstance(BoxRenderer *renderer, BoundingBox box, Color color)
+{
+    // Scale then translate the unit cube, written straight into the buffer
+    float *m = NextInstance(&renderer->instances);
+    if (!m) return;
+    memset(m, 0, INSTANCE_FLOATS*sizeof(float));
+    m[0] = box.max.x - box.min.x;
+    m[5] = box.max.y - box.min.y;
+    m[10] = box.max.z - box.min.z;
+    m[12] = 0.5f*(box.min.x + box.max.x);
+    m[13] = 0.5f*(box.min.y + box.max.y);
+    m[14] = 0.5f*(box.min.z + box.max.z);
+    m[3] = color.r/255.0f; m[7] = color.g/255.0f; m[11] = color.b/255.0f; m[15] = color.a/255.0f;
+}
+
+void DrawBoxInstances(BoxRenderer *renderer, Color edgeColor)
+{
+    rlDrawRenderBatchActive();                  // under the boxes, they may be translucent
+    UploadInstances(&renderer->instances);
+    DrawMeshInstances(renderer->cube, renderer->faceShader, &renderer->instances, WHITE);
+    DrawLineMeshInstances(renderer->edges, renderer->edgeShader, &renderer->instances, edgeColor);
+    ClearInstances(&renderer->instances);
+}
+
+/* ── cylinders ─────────────────────────────────────────────────────── */
+// Radius 1, height 1, base on the origin, one stack like DrawCylinder(),
+// counterclockwise from outside so back faces cull
+static Mesh GenMeshUnitCylinder(int slices)
+{
+    Mesh mesh = { 0 };
+    mesh.vertexCount = 2*slices + 2;
+    mesh.triangleCount = 4*slices;
+    mesh.vertices = RL_CALLOC((size_t)mesh.vertexCount*3, sizeof(float));
+    mesh.indices = RL_CALLOC((size_t)mesh.triangleCount*3, sizeof(unsigned short));
+    if (!mesh.vertices || !mesh.indices) { RL_FREE(mesh.vertices); RL_FREE(mesh.indices); return (Mesh){ 0 }; }
+
+    // Bottom ring, top ring, bottom center, top center
+    for (int i = 0; i < slices; i++)
+    {
+        float angle = 2.0f*PI*(float)i/(float)slices;
+        float *bottom = &mesh.vertices[3*i], *top = &mesh.vertices[3*(slices + i)];
+        bottom[0] = top[0] = sinf(angle);
+        top[1] = 1.0f;
+        bottom[2] = top[2] = cosf(angle);
+    }
+    unsigned short bottomCenter = (unsigned short)(2*slices), topCenter = (unsigned short)(2*slices + 1);
+    mesh.vertices[3*topCenter + 1] = 1.0f;
+
+    unsigned short *index = mesh.indices;
+    for (int i = 0; i < slices; i++)
+    {
+        unsigned short b0 = (unsigned short)i, b1 = (unsigned short)((i + 1)%slices);
+        unsigned short t0 = (unsigned short)(slices + b0), t1 = (unsigned short)(slices + b1);
+        *index++ = b0; *index++ = b1; *index++ = t1;                      // side
+        *index++ = b0; *index++ = t1; *index++ = t0;
+        *index++ = topCenter; *index++ = t0; *index++ = t1;               // top
+        *index++ = bottomCenter; *index++ = b1; *index++ = b0;            // bottom
+    }
+    UploadMesh(&mesh, false);
+    return mesh;
+}
+
+CylinderRenderer LoadCylinderRenderer(void)
+{
+    CylinderRenderer renderer = { 0 };
+    const int slices[CYLINDER_LOD_COUNT] = CYLINDER_LOD_SLICES;
+    for (int l = 0; l < CYLINDER_LOD_COUNT; l++)
+    {
+        // A regular polygon cuts into its circle by r*(1 - cos(pi/slices))
+        renderer.slices[l] = slices[l];
+        renderer.maxRadius[l] = CYLINDER_LOD_MAX_ERROR/(1.0f - cosf(PI/(float)slices[l]));
+        renderer.meshes[l] = GenMeshUnitCylinder(slices[l]);
+        renderer.edges[l] = GenLineMeshCylinder(slices[l]);
+    }
+    renderer.faceShader = LoadInstanceShader(true);
+    renderer.edgeShader = LoadInstanceShader(false);
+    return renderer;
+}
+
+void UnloadCylinderRenderer(CylinderRenderer *renderer)
+{
+    for (int l = 0; l < CYLINDER_LOD_COUNT; l++)
+    {
+        UnloadMesh(renderer->meshes[l]);
+        UnloadLineMesh(renderer->edges[l]);
+        UnloadInstanceBuffer(&renderer->instances[l]);
+    }
+    UnloadInstanceShader(renderer->faceShader);
+    UnloadInstanceShader(renderer->edgeShader);
+    *renderer = (CylinderRenderer){ 0 };
+}
+
+void SetCylinderCamera(CylinderRenderer *renderer, Camera camera, int screenHeight)
+{
+    renderer->eye = camera.position;
+    renderer->orthographic = (camera.projection == CAMERA_ORTHOGRAPHIC);
+    if (renderer->orthographic) renderer->pixelsPerUnit = (float)screenHeight/camera.fovy;
+    else renderer->pixelsPerUnit = 0.5f*(float)screenHeight/tanf(0.5f*DEG2RAD*camera.fovy);
+}
+
+int GetCylinderLod(const CylinderRenderer *renderer, Vector3 position, float radius, float height)
+{
+    // Screen radius at the distance of the cylinder's middle
+    float pixels = radius*renderer->pixelsPerUnit;
+    if (!renderer->orthographic)
+    {
+        Vector3 middle = { position.x, position.y + 0.5f*height, position.z };
+        float distance = Vector3Distance(middle, renderer->eye);
+        if (distance <= radius) return CYLINDER_LOD_COUNT - 1;
+        pixels /= distance;
+    }
+    int lod = 0;
+    while (lod < CYLINDER_LOD_COUNT - 1 && pixels > renderer->maxRadius[lod]) lod++;
+    return lod;
+}
+
+void AddCylinderInstance(CylinderRenderer *renderer, Vector3 position, float radius, float height, Color color)
+{
+    float *m = NextInstance(&renderer->instances[GetCylinderLod(renderer, position, radius, height)]);
+    if (!m) return;
+    memset(m, 0, INSTANCE_FLOATS*sizeof(float));
+    m[0] = radius;
+    m[5] = height;
+    m[10] = radius;
+    m[12] = position.x;
+    m[13] = position.y;
+    m[14] = position.z;
+    m[3] = color.r/255.0f; m[7] = color.g/255.0f; m[11] = color.b/255.0f; m[15] = color.a/255.0f;
+}
+
+void DrawCylinderInstances(CylinderRenderer *renderer, Color edgeColor)
+{
+    rlDrawRenderBatchActive();
+    for (int l = 0; l < CYLINDER_LOD_COUNT; l++)
+    {
+        InstanceBuffer *instances = &renderer->instances[l];
+        if (instances->count == 0) continue;
+        UploadInstances(instances);
+        DrawMeshInstances(renderer->meshes[l], renderer->faceShader, instances, WHITE);
+        DrawLineMeshInstances(renderer->edges[l], renderer->edgeShader, instances, edgeColor);
+        ClearInstances(instances);
+    }
+}
@@ -0,0 +1,91 @@
+// instancing.h - instanced drawing of meshes and line meshes
+//
+// An InstanceBuffer holds one 4x4 transform per instance, uploaded to the GPU
+// once per frame and shared by every draw that frame (faces and wireframe
+// use the same buffer). The transforms are affine, so their bottom row is
+// free; it carries the instance color, which the instance shader reads back
+// before restoring the row to (0, 0, 0, 1).
+//
+// BoxRenderer uses this to draw any number of axis-aligned boxes with two
+// draw calls: one unit cube mesh for the faces and one cube line mesh for
+// the edges.
+//
+// CylinderRenderer does the same for vertical cylinders, keeping unit
+// cylinders at a few slice counts and picking one per instance from its
+// size on screen: the fewest slices whose polygon stays within
+// CYLINDER_LOD_MAX_ERROR pixels of the true outline, so distant columns
+// get 6 or 8 and only close ones the 16 DrawCylinder() is usually given.
+// Each slice count is one draw for the faces and one for the edges.
+//
+// Instancing needs OpenGL 3.3. Older versions fall back to drawing each
+// instance on its own.
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include "raylib.h"
+#include "line_mesh.h"
+
+#define INSTANCE_ATTRIB_LOCATION 12  // instanceTransform takes 12..15, clear of raylib's mesh attributes
+
+typedef struct InstanceBuffer {
+    float *transforms;           // 16 floats per instance, column major, bottom row = color
+    int count;
+    int capacity;
+    unsigned int vboId;
+    int vboCapacity;             // instances the GPU buffer has room for
+} InstanceBuffer;
+
+typedef struct BoxRenderer {
+    Mesh cube;                   // unit cube, faces
+    LineMesh edges;              // unit cube, edges
+    Shader faceShader;           // per instance colors
+    Shader edgeShader;           // one color for all instances
+    InstanceBuffer instances;
+} BoxRenderer;
+
+#define CYLINDER_LOD_COUNT     4
+#define CYLINDER_LOD_SLICES    { 6, 8, 12, 16 }
+#define CYLINDER_LOD_MAX_ERROR 1.0f  // pixels
+
+typedef struct CylinderRenderer {
+    int slices[CYLINDER_LOD_COUNT];
+    float maxRadius[CYLINDER_LOD_COUNT];     // on screen, in pixels, for each slice count
+    Mesh meshes[CYLINDER_LOD_COUNT];         // radius 1, height 1, base on the origin
+    LineMesh edges[CYLINDER_LOD_COUNT];
+    Shader faceShader;
+    Shader edgeShader;
+    InstanceBuffer instances[CYLINDER_LOD_COUNT];
+
+    // View the slice counts are picked for, see SetCylinderCamera()
+    Vector3 eye;
+    float pixelsPerUnit;                     // screen pixels of 1 unit at distance 1 (at any distance for orthographic)
+    bool orthographic;
+} CylinderRenderer;
+
+Shader LoadInstanceShader(bool instanceColors);       // instanceColors false: colDiffuse only
+void UnloadInstanceShader(Shader shader);
+
+void UnloadInstanceBuffer(InstanceBuffer *buffer);
+void ClearInstances(InstanceBuffer *buffer);
+void AddInstance(InstanceBuffer *buffer, Matrix transform, Color color);
+void AppendInstances(InstanceBuffer *buffer, const InstanceBuffer *source);   // CPU side only, e.g. buffers filled by jobs
+void UploadInstances(InstanceBuffer *buffer);        // Call once after adding, before drawing
+
+// One draw call each, tint multiplies the instance colors
+void DrawMeshInstances(Mesh mesh, Shader shader, const InstanceBuffer *instances, Color tint);
+void DrawLineMeshInstances(LineMesh mesh, Shader shader, const InstanceBuffer *instances, Color tint);
+
+BoxRenderer LoadBoxRenderer(void);
+void UnloadBoxRenderer(BoxRenderer *renderer);
+void AddBoxInstance(BoxRenderer *renderer, BoundingBox box, Color color);
+void DrawBoxInstances(BoxRenderer *renderer, Color edgeColor);   // Draws and clears the boxes added this frame
+
+CylinderRenderer LoadCylinderRenderer(void);
+void UnloadCylinderRenderer(CylinderRenderer *renderer);
+void SetCylinderCamera(CylinderRenderer *renderer, Camera camera, int screenHeight);   // Before adding the frame's cylinders
+int GetCylinderLod(const CylinderRenderer *renderer, Vector3 position, float radius, float height);
+// Placed like DrawCylinder(position, radius, radius, height, ...): position is the base center
+void AddCylinderInstance(CylinderRenderer *renderer, Vector3 position, float radius, float height, Color color);
+void DrawCylinderInstances(CylinderRenderer *renderer, Color edgeColor);             // Draws and clears the cylinders added so far
+
+#endif // INSTANCING_H
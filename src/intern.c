@@ -0,0 +1,176 @@
+// intern.c - global string interner (see intern.h)
+#include "intern.h"
+#include "heap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERN_CHUNK_SIZE   (64*1024)
+#define INTERN_MIN_SLOTS    256
+
+// Strings live in a list of chunks that are never moved, so pointers handed
+// out by GetNameString stay valid while the interner grows.
+typedef struct InternChunk {
+    struct InternChunk *next;
+    size_t used;
+    size_t capacity;
+    char chars[];
+} InternChunk;
+
+// Open addressing with linear probing. A slot holds the id (NAME_NONE when
+// empty) and the full hash so most mismatches are rejected without touching
+// the string.
+typedef struct InternSlot {
+    NameId id;
+    uint32_t hash;
+} InternSlot;
+
+static struct {
+    InternSlot *slots;
+    uint32_t slotMask;
+
+    const char **strings;        // indexed by id, [0] unused
+    uint32_t *lengths;
+    uint32_t count;
+    uint32_t capacity;
+
+    InternChunk *chunks;
+} interner = { 0 };
+
+static uint32_t HashName(const char *name, size_t length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) hash = (hash ^ (unsigned char)name[i])*16777619u;
+    return hash;
+}
+
+static const char *StoreString(const char *name, size_t length)
+{
+    InternChunk *chunk = interner.chunks;
+    if (!chunk || chunk->capacity - chunk->used < length + 1)
+    {
+        size_t capacity = (length + 1 > INTERN_CHUNK_SIZE) ? length + 1 : INTERN_CHUNK_SIZE;
+        chunk = RL_MALLOC(sizeof(InternChunk) + capacity);
+        if (!chunk) return NULL;
+        chunk->next = interner.chunks;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        interner.chunks = chunk;
+    }
+    char *copy = chunk->chars + chunk->used;
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    chunk->used += length + 1;
+    return copy;
+}
+
+static uint32_t FindSlot(const char *name, size_t length, uint32_t hash)
+{
+    uint32_t i = hash & interner.slotMask;
+    for (;;)
+    {
+        const InternSlot *slot = &interner.slots[i];
+        if (slot->id == NAME_NONE) return i;
+        if (slot->hash == hash && interner.lengths[slot->id] == length &&
+            memcmp(interner.strings[slot->id], name, length) == 0) return i;
+        i = (i + 1) & interner.slotMask;
+    }
+}
+
+static int GrowSlots(void)
+{
+    uint32_t slotCount = interner.slots ? 2*(interner.slotMask + 1) : INTERN_MIN_SLOTS;
+    InternSlot *slots = RL_CALLOC(slotCount, sizeof(InternSlot));
+    if (!slots) return 0;
+    InternSlot *old = interner.slots;
+    uint32_t oldCount = old ? interner.slotMask + 1 : 0;
+    interner.slots = slots;
+    interner.slotMask = slotCount - 1;
+    for (uint32_t i = 0; i < oldCount; i++)
+    {
+        if (old[i].id == NAME_NONE) continue;
+        uint32_t j = old[i].hash & interner.slotMask;
+        while (slots[j].id != NAME_NONE) j = (j + 1) & interner.slotMask;
+        slots[j] = old[i];
+    }
+    RL_FREE(old);
+    return 1;
+}
+
+static int GrowIds(void)
+{
+    uint32_t capacity = interner.capacity ? 2*interner.capacity : INTERN_MIN_SLOTS/2;
+    const char **strings = RL_REALLOC((void *)interner.strings, capacity*sizeof(*strings));
+    if (!strings) return 0;
+    interner.strings = strings;
+    uint32_t *lengths = RL_REALLOC(interner.lengths, capacity*sizeof(*lengths));
+    if (!lengths) return 0;
+    interner.lengths = lengths;
+    interner.capacity = capacity;
+    return 1;
+}
+
+NameId InternNameN(const char *name, size_t length)
+{
+    if (!name || length > UINT32_MAX) return NAME_NONE;
+    // Keep the table at most half full
+    if (2*(interner.count + 1) > (interner.slots ? interner.slotMask + 1 : 0) && !GrowSlots()) return NAME_NONE;
+
+    uint32_t hash = HashName(name, length);
+    uint32_t i = FindSlot(name, length, hash);
+    if (interner.slots[i].id != NAME_NONE) return interner.slots[i].id;
+
+    if (interner.count + 1 >= interner.capacity && !GrowIds()) return NAME_NONE;
+    const char *copy = StoreString(name, length);
+    if (!copy) return NAME_NONE;
+
+    NameId id = ++interner.count;
+    interner.strings[id] = copy;
+    interner.lengths[id] = (uint32_t)length;
+    interner.slots[i].id = id;
+    interner.slots[i].hash = hash;
+    return id;
+}
+
+NameId InternName(const char *name)
+{
+    return name ? InternNameN(name, strlen(name)) : NAME_NONE;
+}
+
+NameId FindName(const char *name)
+{
+    if (!name || !interner.slots) return NAME_NONE;
+    size_t length = strlen(name);
+    return interner.slots[FindSlot(name, length, HashName(name, length))].id;
+}
+
+const char *GetNameString(NameId id)
+{
+    return (id != NAME_NONE && id <= interner.count) ? interner.strings[id] : NULL;
+}
+
+size_t GetNameLength(NameId id)
+{
+    return (id != NAME_NONE && id <= interner.count) ? interner.lengths[id] : 0;
+}
+
+uint32_t GetNameCount(void)
+{
+    return interner.count;
+}
+
+void ClearNames(void)
+{
+    InternChunk *chunk = interner.chunks;
+    while (chunk)
+    {
+        InternChunk *next = chunk->next;
+        RL_FREE(chunk);
+        chunk = next;
+    }
+    RL_FREE(interner.slots);
+    RL_FREE((void *)interner.strings);
+    RL_FREE(interner.lengths);
+    memset(&interner, 0, sizeof(interner));
+}
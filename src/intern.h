@@ -0,0 +1,28 @@
+// intern.h - global string interner
+//
+// Every distinct name is stored once in an arena and gets a dense 32-bit id,
+// starting at 1 in the order names are first seen. Looking a name up by id is
+// an array index, looking an id up by name is one hash probe sequence. Ids
+// and the returned strings stay valid until ClearNames().
+//
+// Like the rest of the game state, the interner is meant to be used from the
+// main thread only.
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t NameId;
+
+#define NAME_NONE ((NameId)0)
+
+NameId InternName(const char *name);                   // Add name if needed and return its id
+NameId InternNameN(const char *name, size_t length);   // Same for a string that isn't null-terminated
+NameId FindName(const char *name);                     // NAME_NONE if name was never interned
+const char *GetNameString(NameId id);                  // NULL for NAME_NONE or unknown ids
+size_t GetNameLength(NameId id);
+uint32_t GetNameCount(void);                           // Ids in use are 1..GetNameCount()
+void ClearNames(void);                                 // Free everything, invalidates all ids
+
+#endif // INTERN_H
@@ -0,0 +1,215 @@
+// jobs.c - a small worker pool for parallel loops (see jobs.h)
+#include "jobs.h"
+#include "heap.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    typedef HANDLE Thread;
+    typedef SRWLOCK Mutex;
+    typedef CONDITION_VARIABLE Cond;
+    #define MutexInit(m)     InitializeSRWLock(m)
+    #define MutexDestroy(m)  ((void)(m))
+    #define MutexLock(m)     AcquireSRWLockExclusive(m)
+    #define MutexUnlock(m)   ReleaseSRWLockExclusive(m)
+    #define CondInit(c)      InitializeConditionVariable(c)
+    #define CondDestroy(c)   ((void)(c))
+    #define CondWait(c, m)   SleepConditionVariableSRW(c, m, INFINITE, 0)
+    #define CondBroadcast(c) WakeAllConditionVariable(c)
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+    typedef pthread_t Thread;
+    typedef pthread_mutex_t Mutex;
+    typedef pthread_cond_t Cond;
+    #define MutexInit(m)     pthread_mutex_init(m, NULL)
+    #define MutexDestroy(m)  pthread_mutex_destroy(m)
+    #define MutexLock(m)     pthread_mutex_lock(m)
+    #define MutexUnlock(m)   pthread_mutex_unlock(m)
+    #define CondInit(c)      pthread_cond_init(c, NULL)
+    #define CondDestroy(c)   pthread_cond_destroy(c)
+    #define CondWait(c, m)   pthread_cond_wait(c, m)
+    #define CondBroadcast(c) pthread_cond_broadcast(c)
+#endif
+
+struct JobSystem {
+    Mutex lock;
+    Cond wake;                   // new jobs or quitting
+    Cond done;                   // last job of a run finished
+    Thread threads[JOBS_MAX_WORKERS];
+    int workerCount;
+    bool quit;
+
+    // Current run, count is 0 between runs
+    JobFunc func;
+    void *data;
+    int count;
+    int next;
+    int finished;
+
+    // Background slot, func is cleared when a worker takes the job
+    JobFunc backgroundFunc;
+    void *backgroundData;
+    bool backgroundBusy;         // queued or running
+};
+
+// Takes jobs until none are left, called and returns with the lock held
+static void TakeJobs(JobSystem *jobs)
+{
+    while (jobs->next < jobs->count)
+    {
+        int index = jobs->next++;
+        MutexUnlock(&jobs->lock);
+        jobs->func(jobs->data, index);
+        MutexLock(&jobs->lock);
+        if (++jobs->finished == jobs->count) CondBroadcast(&jobs->done);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI WorkerMain(LPVOID arg)
+#else
+static void *WorkerMain(void *arg)
+#endif
+{
+    JobSystem *jobs = arg;
+    MutexLock(&jobs->lock);
+    for (;;)
+    {
+        TakeJobs(jobs);
+        if (jobs->backgroundFunc)                      // taken even when quitting, see DestroyJobSystem()
+        {
+            JobFunc func = jobs->backgroundFunc;
+            jobs->backgroundFunc = NULL;
+            MutexUnlock(&jobs->lock);
+            func(jobs->backgroundData, 0);
+            MutexLock(&jobs->lock);
+            jobs->backgroundBusy = false;
+            continue;
+        }
+        if (jobs->quit) break;
+        CondWait(&jobs->wake, &jobs->lock);
+    }
+    MutexUnlock(&jobs->lock);
+    return 0;
+}
+
+static int HardwareThreads(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+#endif
+}
+
+JobSystem *CreateJobSystem(int workerCount)
+{
+    if (workerCount <= 0) workerCount = HardwareThreads() - 1;
+    if (workerCount > JOBS_MAX_WORKERS) workerCount = JOBS_MAX_WORKERS;
+    if (workerCount <= 0) return NULL;
+
+    JobSystem *jobs = RL_CALLOC(1, sizeof(JobSystem));
+    if (!jobs) return NULL;
+    MutexInit(&jobs->lock);
+    CondInit(&jobs->wake);
+    CondInit(&jobs->done);
+    for (int i = 0; i < workerCount; i++)
+    {
+#if defined(_WIN32)
+        jobs->threads[i] = CreateThread(NULL, 0, WorkerMain, jobs, 0, NULL);
+        bool started = (jobs->threads[i] != NULL);
+#else
+        bool started = (pthread_create(&jobs->threads[i], NULL, WorkerMain, jobs) == 0);
+#endif
+        if (!started) break;
+        jobs->workerCount++;
+    }
+    if (jobs->workerCount == 0) { DestroyJobSystem(jobs); return NULL; }
+    return jobs;
+}
+
+void DestroyJobSystem(JobSystem *jobs)
+{
+    if (!jobs) return;
+    MutexLock(&jobs->lock);
+    jobs->quit = true;
+    CondBroadcast(&jobs->wake);
+    MutexUnlock(&jobs->lock);
+    for (int i = 0; i < jobs->workerCount; i++)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(jobs->threads[i], INFINITE);
+        CloseHandle(jobs->threads[i]);
+#else
+        pthread_join(jobs->threads[i], NULL);
+#endif
+    }
+    CondDestroy(&jobs->wake);
+    CondDestroy(&jobs->done);
+    MutexDestroy(&jobs->lock);
+    RL_FREE(jobs);
+}
+
+int GetJobWorkerCount(const JobSystem *jobs)
+{
+    return jobs ? jobs->workerCount : 0;
+}
+
+void RunJobs(JobSystem *jobs, JobFunc func, void *data, int count)
+{
+    if (count <= 0) return;
+    if (!jobs || count == 1)
+    {
+        for (int i = 0; i < count; i++) func(data, i);
+        return;
+    }
+
+    MutexLock(&jobs->lock);
+    jobs->func = func;
+    jobs->data = data;
+    jobs->count = count;
+    jobs->next = 0;
+    jobs->finished = 0;
+    CondBroadcast(&jobs->wake);
+    TakeJobs(jobs);                                    // the caller works too
+    while (jobs->finished < jobs->count) CondWait(&jobs->done, &jobs->lock);
+    jobs->count = 0;
+    jobs->next = 0;
+    MutexUnlock(&jobs->lock);
+}
+
+bool StartBackgroundJob(JobSystem *jobs, JobFunc func, void *data)
+{
+    if (!jobs)
+    {
+        func(data, 0);
+        return true;
+    }
+    MutexLock(&jobs->lock);
+    bool started = !jobs->backgroundBusy;
+    if (started)
+    {
+        jobs->backgroundFunc = func;
+        jobs->backgroundData = data;
+        jobs->backgroundBusy = true;
+        CondBroadcast(&jobs->wake);
+    }
+    MutexUnlock(&jobs->lock);
+    return started;
+}
+
+bool IsBackgroundJobDone(JobSystem *jobs)
+{
+    if (!jobs) return true;
+    MutexLock(&jobs->lock);
+    bool done = !jobs->backgroundBusy;
+    MutexUnlock(&jobs->lock);
+    return done;
+}
@@ -0,0 +1,39 @@
+// jobs.h - a small worker pool for parallel loops
+//
+// RunJobs(jobs, func, data, count) calls func(data, i) once for every i in
+// [0, count), spread over the worker threads and the calling thread, and
+// returns when all of them are done. Jobs are handed out one index at a time,
+// so uneven jobs balance themselves; keep each one big enough (a screen tile,
+// a few thousand objects) that taking the lock doesn't show.
+//
+// StartBackgroundJob(jobs, func, data) instead queues func(data, 0) for the
+// next free worker and returns at once, for work the caller shouldn't wait
+// for (parsing a file, say). There is one background slot; poll
+// IsBackgroundJobDone() before using what the job wrote. DestroyJobSystem()
+// lets a queued background job finish first.
+//
+// A NULL JobSystem runs the loop (or the background job) on the calling
+// thread, so callers never need a separate serial path. Doesn't depend on
+// raylib.
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+
+#define JOBS_MAX_WORKERS 64
+
+typedef void (*JobFunc)(void *data, int index);
+typedef struct JobSystem JobSystem;
+
+// workerCount 0 uses one worker per hardware thread, minus the caller's.
+// Returns NULL when threads can't be started (RunJobs still works).
+JobSystem *CreateJobSystem(int workerCount);
+void DestroyJobSystem(JobSystem *jobs);
+int GetJobWorkerCount(const JobSystem *jobs);          // 0 for NULL
+
+void RunJobs(JobSystem *jobs, JobFunc func, void *data, int count);
+
+bool StartBackgroundJob(JobSystem *jobs, JobFunc func, void *data);   // false while the last one isn't done
+bool IsBackgroundJobDone(JobSystem *jobs);                             // true when none is queued or running
+
+#endif // JOBS_H
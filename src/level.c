@@ -0,0 +1,757 @@
+// level.c - loading and querying compiled binary levels (see level.h)
+#include "level.h"
+#include "heap.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define LEVEL_USE_MMAP
+#endif
+
+static const size_t sectionStride[LEVEL_SECTION_COUNT] = {
+    sizeof(float), sizeof(float), sizeof(float),
+    sizeof(float), sizeof(float), sizeof(float),
+    sizeof(uint32_t), sizeof(uint32_t),
+    sizeof(int32_t), sizeof(uint32_t), sizeof(float),
+    sizeof(uint32_t), 1, sizeof(LevelNode)
+};
+
+// Number of elements a section must hold, 0 if any size is fine
+static uint64_t SectionCount(const LevelHeader *header, int section)
+{
+    switch (section)
+    {
+        case LEVEL_SECTION_NAME_OFFSETS: return (uint64_t)header->nameCount + 1;
+        case LEVEL_SECTION_NAME_CHARS: return 0;
+        case LEVEL_SECTION_NODES: return header->nodeCount;
+        default: return header->boxCount;
+    }
+}
+
+/* ── file mapping ──────────────────────────────────────────────────── */
+// Files are mapped copy-on-write: the level can be patched in memory
+// without touching the file on disk.
+static void *MapLevelFile(const char *fileName, size_t *size)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) { CloseHandle(file); return NULL; }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) return NULL;
+    void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);       // the view keeps the mapping alive
+    if (data == NULL) return NULL;
+    *size = (size_t)fileSize.QuadPart;
+    return data;
+#elif defined(LEVEL_USE_MMAP)
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) { close(fd); return NULL; }
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+    *size = (size_t)st.st_size;
+    return data;
+#else
+    (void)fileName; (void)size;
+    return NULL;
+#endif
+}
+
+static void UnmapLevelFile(void *data, size_t size)
+{
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+#elif defined(LEVEL_USE_MMAP)
+    munmap(data, size);
+#else
+    (void)data; (void)size;
+#endif
+}
+
+// Fallback for platforms without mapping: one read into a heap block
+static void *ReadLevelFile(const char *fileName, size_t *size)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (!file) return NULL;
+    void *data = NULL;
+    long length = 0;
+    if (fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = RL_MALLOC((size_t)length);
+        if (data && fread(data, 1, (size_t)length, file) != (size_t)length) { RL_FREE(data); data = NULL; }
+    }
+    fclose(file);
+    if (data) *size = (size_t)length;
+    return data;
+}
+
+/* ── binding ───────────────────────────────────────────────────────── */
+// Checks the header and section table, then points the level's arrays into
+// the file. This is O(1): box and node contents are trusted, levels are
+// produced by the compiler. Debug builds also check every index.
+static bool BindLevel(Level *level, void *data, size_t dataSize)
+{
+    const LevelHeader *header = (const LevelHeader *)data;
+    unsigned char *bytes = (unsigned char *)data;
+    uint16_t byteOrder = 1;
+
+    if (*(const unsigned char *)&byteOrder != 1) return false;   // files are little-endian
+    if (dataSize < sizeof(LevelHeader)) return false;
+    if (header->magic != LEVEL_MAGIC || header->version != LEVEL_VERSION) return false;
+    if (header->headerSize != sizeof(LevelHeader) || header->fileSize != dataSize) return false;
+    if (header->rootNode >= (int32_t)header->nodeCount || header->rootNode < LEVEL_NULL_NODE) return false;
+    if (header->boxCount > 0 && header->nodeCount != 2*header->boxCount - 1) return false;
+
+    for (int s = 0; s < LEVEL_SECTION_COUNT; s++)
+    {
+        const LevelSection *section = &header->sections[s];
+        uint64_t count = SectionCount(header, s);
+        if (section->offset % LEVEL_SECTION_ALIGN != 0) return false;
+        if (section->offset > dataSize || section->size > dataSize - section->offset) return false;
+        if (s != LEVEL_SECTION_NAME_CHARS && section->size != count*sectionStride[s]) return false;
+    }
+
+    level->boxCount = header->boxCount;
+    level->nameCount = header->nameCount;
+    level->nodeCount = header->nodeCount;
+    level->rootNode = header->rootNode;
+    level->freeNode = LEVEL_NULL_NODE;
+    level->minX = (float *)(bytes + header->sections[LEVEL_SECTION_MIN_X].offset);
+    level->minY = (float *)(bytes + header->sections[LEVEL_SECTION_MIN_Y].offset);
+    level->minZ = (float *)(bytes + header->sections[LEVEL_SECTION_MIN_Z].offset);
+    level->maxX = (float *)(bytes + header->sections[LEVEL_SECTION_MAX_X].offset);
+    level->maxY = (float *)(bytes + header->sections[LEVEL_SECTION_MAX_Y].offset);
+    level->maxZ = (float *)(bytes + header->sections[LEVEL_SECTION_MAX_Z].offset);
+    level->colors = (uint32_t *)(bytes + header->sections[LEVEL_SECTION_COLORS].offset);
+    level->nameIds = (uint32_t *)(bytes + header->sections[LEVEL_SECTION_NAME_IDS].offset);
+    level->parents = (int32_t *)(bytes + header->sections[LEVEL_SECTION_PARENTS].offset);
+    level->subtreeEnds = (uint32_t *)(bytes + header->sections[LEVEL_SECTION_SUBTREE_ENDS].offset);
+    level->subtreeSlack = (float *)(bytes + header->sections[LEVEL_SECTION_SUBTREE_SLACK].offset);
+    level->nameOffsets = (uint32_t *)(bytes + header->sections[LEVEL_SECTION_NAME_OFFSETS].offset);
+    level->nameChars = (char *)(bytes + header->sections[LEVEL_SECTION_NAME_CHARS].offset);
+    level->nodes = (LevelNode *)(bytes + header->sections[LEVEL_SECTION_NODES].offset);
+
+    uint64_t charsSize = header->sections[LEVEL_SECTION_NAME_CHARS].size;
+    if (level->nameCount > 0 && (charsSize == 0 || level->nameChars[charsSize - 1] != '\0')) return false;
+
+#if defined(DEBUG)
+    for (uint32_t i = 0; i < level->boxCount; i++)
+    {
+        if (level->nameIds[i] >= level->nameCount) return false;
+        if (level->subtreeEnds[i] <= i || level->subtreeEnds[i] > level->boxCount) return false;
+        if (level->parents[i] >= (int32_t)i || level->parents[i] < -1) return false;
+    }
+    for (uint32_t i = 0; i <= level->nameCount; i++)
+        if (level->nameOffsets[i] > charsSize) return false;
+    for (uint32_t i = 0; i < level->nodeCount; i++)
+    {
+        const LevelNode *node = &level->nodes[i];
+        if (node->box >= (int32_t)level->boxCount) return false;
+        if (node->box < 0 && (node->child1 < 0 || node->child2 < 0 ||
+            node->child1 >= (int32_t)level->nodeCount || node->child2 >= (int32_t)level->nodeCount)) return false;
+    }
+#endif
+    return true;
+}
+
+// Gives every box the global id of its name. Names are interned once per
+// entry of the file's name table, then boxes index into that.
+static bool InternLevelNames(Level *level)
+{
+    level->names = RL_MALLOC(((size_t)level->nameCount + level->boxCount)*sizeof(NameId));
+    if (!level->names) return false;
+    NameId *tableIds = level->names + level->boxCount;
+    for (uint32_t i = 0; i < level->nameCount; i++)
+    {
+        uint32_t offset = level->nameOffsets[i];
+        tableIds[i] = InternNameN(level->nameChars + offset, level->nameOffsets[i + 1] - offset - 1);
+    }
+    for (uint32_t i = 0; i < level->boxCount; i++) level->names[i] = tableIds[level->nameIds[i]];
+    return true;
+}
+
+/* ── public API ────────────────────────────────────────────────────── */
+Level LoadLevel(const char *fileName)
+{
+    Level level = { 0 };
+    size_t size = 0;
+    void *data = MapLevelFile(fileName, &size);
+    bool mapped = (data != NULL);
+    if (!mapped) data = ReadLevelFile(fileName, &size);
+    if (!data) return level;
+
+    if (!BindLevel(&level, data, size) || !InternLevelNames(&level))
+    {
+        if (mapped) UnmapLevelFile(data, size);
+        else RL_FREE(data);
+        return (Level){ 0 };
+    }
+    level.data = data;
+    level.dataSize = size;
+    level.mapped = mapped;
+    return level;
+}
+
+Level LoadLevelFromMemory(void *data, size_t dataSize)
+{
+    Level level = { 0 };
+    if (!data) return level;
+    if (!BindLevel(&level, data, dataSize) || !InternLevelNames(&level)) { RL_FREE(data); return (Level){ 0 }; }
+    level.data = data;
+    level.dataSize = dataSize;
+    return level;
+}
+
+bool ExportLevel(const Level *level, const char *fileName)
+{
+    if (!IsLevelValid(level) || level->data == NULL) return false;
+    FILE *file = fopen(fileName, "wb");
+    if (!file) return false;
+    bool ok = (fwrite(level->data, 1, level->dataSize, file) == level->dataSize);
+    if (fclose(file) != 0) ok = false;
+    if (!ok) remove(fileName);
+    return ok;
+}
+
+void UnloadLevel(Level *level)
+{
+    if (level->editable)
+    {
+        void *arrays[] = { level->minX, level->minY, level->minZ, level->maxX, level->maxY, level->maxZ,
+                           level->colors, level->parents, level->subtreeEnds, level->subtreeSlack,
+                           level->nodes, level->names, level->boxLeaves, level->editedBoxes };
+        for (size_t i = 0; i < sizeof(arrays)/sizeof(arrays[0]); i++) RL_FREE(arrays[i]);
+        *level = (Level){ 0 };
+        return;
+    }
+    if (!level->data) return;
+    RL_FREE(level->names);
+    if (level->mapped) UnmapLevelFile(level->data, level->dataSize);
+    else RL_FREE(level->data);
+    *level = (Level){ 0 };
+}
+
+bool IsLevelValid(const Level *level)
+{
+    return level != NULL && (level->data != NULL || level->editable);
+}
+
+const char *GetLevelBoxName(const Level *level, uint32_t box)
+{
+    if (box >= level->boxCount) return NULL;
+    return GetNameString(level->names[box]);
+}
+
+int QueryLevelBoxes(const Level *level, const float min[3], const float max[3], uint32_t *boxes, int maxBoxes)
+{
+    int32_t local[LEVEL_QUERY_STACK];
+    int32_t *stack = local;
+    int top = 0, found = 0;
+    if (level->rootNode == LEVEL_NULL_NODE) return 0;
+
+    // Every level down leaves at most one sibling waiting, so the walk never
+    // holds more than height + 1 nodes
+    int capacity = level->nodes[level->rootNode].height + 1;
+    if (capacity > LEVEL_QUERY_STACK)
+    {
+        stack = RL_MALLOC((size_t)capacity*sizeof(int32_t));
+        if (!stack) return -1;
+    }
+    else capacity = LEVEL_QUERY_STACK;
+    stack[top++] = level->rootNode;
+
+    while (top > 0)
+    {
+        const LevelNode *node = &level->nodes[stack[--top]];
+        if (node->min[0] > max[0] || node->max[0] < min[0] ||
+            node->min[1] > max[1] || node->max[1] < min[1] ||
+            node->min[2] > max[2] || node->max[2] < min[2]) continue;
+
+        if (node->box >= 0)
+        {
+            if (found < maxBoxes) boxes[found] = (uint32_t)node->box;
+            found++;
+        }
+        else
+        {
+            assert(top + 2 <= capacity && "level tree heights are wrong");
+            if (top + 2 > capacity) break;
+            stack[top++] = node->child1;
+            stack[top++] = node->child2;
+        }
+    }
+    if (stack != local) RL_FREE(stack);
+    return found;
+}
+
+int ScanLevelBoxes(const Level *level, const float min[3], const float max[3], uint32_t *boxes, int maxBoxes, uint32_t *tests)
+{
+    int found = 0;
+    uint32_t testCount = 0;
+    uint32_t i = 0;
+
+    while (i < level->boxCount)
+    {
+        // The first test covers the box and everything inside it
+        float slack = level->subtreeSlack[i];
+        testCount++;
+        if (level->minX[i] - slack > max[0] || level->maxX[i] + slack < min[0] ||
+            level->minY[i] - slack > max[1] || level->maxY[i] + slack < min[1] ||
+            level->minZ[i] - slack > max[2] || level->maxZ[i] + slack < min[2])
+        {
+            i = level->subtreeEnds[i];
+            continue;
+        }
+
+        bool overlaps = true;
+        if (slack > 0.0f)
+        {
+            testCount++;
+            overlaps = !(level->minX[i] > max[0] || level->maxX[i] < min[0] ||
+                         level->minY[i] > max[1] || level->maxY[i] < min[1] ||
+                         level->minZ[i] > max[2] || level->maxZ[i] < min[2]);
+        }
+        if (overlaps && IsLevelBoxAlive(level, i))
+        {
+            if (found < maxBoxes) boxes[found] = i;
+            found++;
+        }
+        i++;
+    }
+
+    if (tests) *tests = testCount;
+    return found;
+}
+
+/* ── runtime edits ─────────────────────────────────────────────────── */
+// The tree is edited like Box2D's dynamic tree: leaves are inserted next to
+// the sibling that grows the tree's surface area least, and every node on the
+// way back up is rebalanced with a single rotation when its children's
+// heights differ by more than one.
+static float SurfaceArea(const float min[3], const float max[3])
+{
+    float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+    return dx*dy + dy*dz + dz*dx;
+}
+
+static void UnionBounds(const LevelNode *a, const LevelNode *b, float min[3], float max[3])
+{
+    for (int k = 0; k < 3; k++)
+    {
+        min[k] = (a->min[k] < b->min[k]) ? a->min[k] : b->min[k];
+        max[k] = (a->max[k] > b->max[k]) ? a->max[k] : b->max[k];
+    }
+}
+
+static void RefitNode(Level *level, int32_t index)
+{
+    LevelNode *node = &level->nodes[index];
+    const LevelNode *c1 = &level->nodes[node->child1], *c2 = &level->nodes[node->child2];
+    UnionBounds(c1, c2, node->min, node->max);
+    node->height = 1 + ((c1->height > c2->height) ? c1->height : c2->height);
+}
+
+// Moves the level out of its file block into growable arrays
+static bool MakeLevelEditable(Level *level)
+{
+    if (level->editable) return true;
+    uint32_t boxCount = level->boxCount, nodeCount = level->nodeCount;
+    uint32_t boxCapacity = (boxCount < 32) ? 32 : boxCount;
+    uint32_t nodeCapacity = 2*boxCapacity;
+    float *bounds[6] = { level->minX, level->minY, level->minZ, level->maxX, level->maxY, level->maxZ };
+    Level edit = *level;
+
+    for (int a = 0; a < 6; a++)
+    {
+        float *copy = RL_MALLOC((size_t)boxCapacity*sizeof(float));
+        if (copy) memcpy(copy, bounds[a], (size_t)boxCount*sizeof(float));
+        bounds[a] = copy;
+    }
+    edit.minX = bounds[0]; edit.minY = bounds[1]; edit.minZ = bounds[2];
+    edit.maxX = bounds[3]; edit.maxY = bounds[4]; edit.maxZ = bounds[5];
+    edit.colors = RL_MALLOC((size_t)boxCapacity*sizeof(uint32_t));
+    edit.parents = RL_MALLOC((size_t)boxCapacity*sizeof(int32_t));
+    edit.subtreeEnds = RL_MALLOC((size_t)boxCapacity*sizeof(uint32_t));
+    edit.subtreeSlack = RL_MALLOC((size_t)boxCapacity*sizeof(float));
+    edit.boxLeaves = RL_MALLOC((size_t)boxCapacity*sizeof(int32_t));
+    edit.nodes = RL_MALLOC((size_t)nodeCapacity*sizeof(LevelNode));
+    edit.names = RL_MALLOC((size_t)boxCapacity*sizeof(NameId));
+    edit.editable = true;
+    if (!edit.minX || !edit.minY || !edit.minZ || !edit.maxX || !edit.maxY || !edit.maxZ ||
+        !edit.colors || !edit.parents || !edit.subtreeEnds || !edit.subtreeSlack ||
+        !edit.boxLeaves || !edit.nodes || !edit.names)
+    {
+        UnloadLevel(&edit);   // frees whatever was allocated, leaves level alone
+        return false;
+    }
+    memcpy(edit.colors, level->colors, (size_t)boxCount*sizeof(uint32_t));
+    memcpy(edit.parents, level->parents, (size_t)boxCount*sizeof(int32_t));
+    memcpy(edit.subtreeEnds, level->subtreeEnds, (size_t)boxCount*sizeof(uint32_t));
+    memcpy(edit.subtreeSlack, level->subtreeSlack, (size_t)boxCount*sizeof(float));
+    memcpy(edit.nodes, level->nodes, (size_t)nodeCount*sizeof(LevelNode));
+    memcpy(edit.names, level->names, (size_t)boxCount*sizeof(NameId));
+    for (uint32_t n = 0; n < nodeCount; n++)
+        if (edit.nodes[n].box >= 0) edit.boxLeaves[edit.nodes[n].box] = (int32_t)n;
+
+    edit.boxCapacity = boxCapacity;
+    edit.nodeCapacity = nodeCapacity;
+    edit.freeNode = LEVEL_NULL_NODE;
+    edit.nameCount = 0;
+    edit.nameIds = NULL;
+    edit.nameOffsets = NULL;
+    edit.nameChars = NULL;
+    edit.data = NULL;
+    edit.dataSize = 0;
+    edit.mapped = false;
+
+    RL_FREE(level->names);
+    if (level->mapped) UnmapLevelFile(level->data, level->dataSize);
+    else RL_FREE(level->data);
+    *level = edit;
+    return true;
+}
+
+static bool ReserveLevelBoxes(Level *level, uint32_t boxCount)
+{
+    if (!MakeLevelEditable(level)) return false;
+    if (boxCount <= level->boxCapacity) return true;
+    uint32_t capacity = 2*level->boxCapacity;
+    if (capacity < boxCount) capacity = boxCount;
+
+    float **bounds[6] = { &level->minX, &level->minY, &level->minZ, &level->maxX, &level->maxY, &level->maxZ };
+    for (int a = 0; a < 6; a++)
+    {
+        float *grown = RL_REALLOC(*bounds[a], (size_t)capacity*sizeof(float));
+        if (!grown) return false;
+        *bounds[a] = grown;
+    }
+    void **arrays[] = { (void **)&level->colors, (void **)&level->parents, (void **)&level->subtreeEnds,
+                        (void **)&level->subtreeSlack, (void **)&level->boxLeaves, (void **)&level->names };
+    for (size_t i = 0; i < sizeof(arrays)/sizeof(arrays[0]); i++)
+    {
+        void *grown = RL_REALLOC(*arrays[i], (size_t)capacity*4);   // every per-box array has 4 byte items
+        if (!grown) return false;
+        *arrays[i] = grown;
+    }
+    level->boxCapacity = capacity;
+    return true;
+}
+
+static int32_t AllocateNode(Level *level)
+{
+    if (level->freeNode != LEVEL_NULL_NODE)
+    {
+        int32_t index = level->freeNode;
+        level->freeNode = level->nodes[index].parent;
+        return index;
+    }
+    if (level->nodeCount == level->nodeCapacity)
+    {
+        LevelNode *grown = RL_REALLOC(level->nodes, 2*(size_t)level->nodeCapacity*sizeof(LevelNode));
+        if (!grown) return LEVEL_NULL_NODE;
+        level->nodes = grown;
+        level->nodeCapacity *= 2;
+    }
+    return (int32_t)level->nodeCount++;
+}
+
+static void FreeNode(Level *level, int32_t index)
+{
+    LevelNode *node = &level->nodes[index];
+    node->parent = level->freeNode;
+    node->child1 = node->child2 = LEVEL_NULL_NODE;
+    node->box = -1;
+    node->height = -1;
+    level->freeNode = index;
+}
+
+static int32_t BalanceNode(Level *level, int32_t iA)
+{
+    LevelNode *nodes = level->nodes;
+    LevelNode *A = &nodes[iA];
+    if (A->box >= 0 || A->height < 2) return iA;
+
+    int32_t iB = A->child1, iC = A->child2;
+    LevelNode *B = &nodes[iB], *C = &nodes[iC];
+    int32_t balance = C->height - B->height;
+
+    if (balance > 1)
+    {
+        // Rotate C up
+        int32_t iF = C->child1, iG = C->child2;
+        LevelNode *F = &nodes[iF], *G = &nodes[iG];
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+        if (C->parent == LEVEL_NULL_NODE) level->rootNode = iC;
+        else if (nodes[C->parent].child1 == iA) nodes[C->parent].child1 = iC;
+        else nodes[C->parent].child2 = iC;
+
+        if (F->height > G->height)
+        {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+        }
+        else
+        {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+        }
+        RefitNode(level, iA);
+        RefitNode(level, iC);
+        return iC;
+    }
+    if (balance < -1)
+    {
+        // Rotate B up
+        int32_t iD = B->child1, iE = B->child2;
+        LevelNode *D = &nodes[iD], *E = &nodes[iE];
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+        if (B->parent == LEVEL_NULL_NODE) level->rootNode = iB;
+        else if (nodes[B->parent].child1 == iA) nodes[B->parent].child1 = iB;
+        else nodes[B->parent].child2 = iB;
+
+        if (D->height > E->height)
+        {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+        }
+        else
+        {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+        }
+        RefitNode(level, iA);
+        RefitNode(level, iB);
+        return iB;
+    }
+    return iA;
+}
+
+static void RefitAncestors(Level *level, int32_t index)
+{
+    while (index != LEVEL_NULL_NODE)
+    {
+        index = BalanceNode(level, index);
+        RefitNode(level, index);
+        index = level->nodes[index].parent;
+    }
+}
+
+static bool InsertLeaf(Level *level, int32_t leaf)
+{
+    if (level->rootNode == LEVEL_NULL_NODE)
+    {
+        level->rootNode = leaf;
+        level->nodes[leaf].parent = LEVEL_NULL_NODE;
+        return true;
+    }
+
+    // Walk down while going deeper is cheaper than pairing with this node
+    const LevelNode *leafNode = &level->nodes[leaf];
+    int32_t index = level->rootNode;
+    while (level->nodes[index].box < 0)
+    {
+        const LevelNode *node = &level->nodes[index];
+        float min[3], max[3];
+        UnionBounds(node, leafNode, min, max);
+        float area = SurfaceArea(node->min, node->max);
+        float combinedArea = SurfaceArea(min, max);
+        float cost = 2.0f*combinedArea;
+        float inheritanceCost = 2.0f*(combinedArea - area);
+
+        float childCost[2];
+        int32_t children[2] = { node->child1, node->child2 };
+        for (int c = 0; c < 2; c++)
+        {
+            const LevelNode *child = &level->nodes[children[c]];
+            UnionBounds(child, leafNode, min, max);
+            childCost[c] = SurfaceArea(min, max) + inheritanceCost;
+            if (child->box < 0) childCost[c] -= SurfaceArea(child->min, child->max);
+        }
+        if (cost < childCost[0] && cost < childCost[1]) break;
+        index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+    }
+
+    int32_t sibling = index;
+    int32_t newParent = AllocateNode(level);
+    if (newParent == LEVEL_NULL_NODE) return false;
+    LevelNode *nodes = level->nodes;               // AllocateNode may have moved them
+    int32_t oldParent = nodes[sibling].parent;
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[newParent].box = -1;
+    nodes[newParent].reserved = 0;
+    RefitNode(level, newParent);
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == LEVEL_NULL_NODE) level->rootNode = newParent;
+    else if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+    else nodes[oldParent].child2 = newParent;
+
+    RefitAncestors(level, oldParent);
+    return true;
+}
+
+static void RemoveLeaf(Level *level, int32_t leaf)
+{
+    LevelNode *nodes = level->nodes;
+    if (leaf == level->rootNode)
+    {
+        level->rootNode = LEVEL_NULL_NODE;
+        return;
+    }
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == LEVEL_NULL_NODE)
+    {
+        level->rootNode = sibling;
+        nodes[sibling].parent = LEVEL_NULL_NODE;
+        FreeNode(level, parent);
+        return;
+    }
+    if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+    else nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    FreeNode(level, parent);
+    RefitAncestors(level, grandParent);
+}
+
+static void SetLeafBounds(Level *level, uint32_t box)
+{
+    LevelNode *leaf = &level->nodes[level->boxLeaves[box]];
+    leaf->min[0] = level->minX[box]; leaf->min[1] = level->minY[box]; leaf->min[2] = level->minZ[box];
+    leaf->max[0] = level->maxX[box]; leaf->max[1] = level->maxY[box]; leaf->max[2] = level->maxZ[box];
+}
+
+// Grows subtree slack after box moved: its own slack has to cover its
+// descendants, and every ancestor's slack has to cover the box's subtree.
+static void RefitSlack(Level *level, uint32_t box)
+{
+    float lo[3] = { level->minX[box], level->minY[box], level->minZ[box] };
+    float hi[3] = { level->maxX[box], level->maxY[box], level->maxZ[box] };
+    float ext[6] = { lo[0], lo[1], lo[2], hi[0], hi[1], hi[2] };
+    for (uint32_t j = box + 1; j < level->subtreeEnds[box]; j++)
+    {
+        ext[0] = fminf(ext[0], level->minX[j]); ext[3] = fmaxf(ext[3], level->maxX[j]);
+        ext[1] = fminf(ext[1], level->minY[j]); ext[4] = fmaxf(ext[4], level->maxY[j]);
+        ext[2] = fminf(ext[2], level->minZ[j]); ext[5] = fmaxf(ext[5], level->maxZ[j]);
+    }
+    float slack = 0.0f;
+    for (int k = 0; k < 3; k++) slack = fmaxf(slack, fmaxf(lo[k] - ext[k], ext[3 + k] - hi[k]));
+    level->subtreeSlack[box] = slack;
+
+    for (int32_t a = level->parents[box]; a >= 0; a = level->parents[a])
+    {
+        float alo[3] = { level->minX[a], level->minY[a], level->minZ[a] };
+        float ahi[3] = { level->maxX[a], level->maxY[a], level->maxZ[a] };
+        float need = 0.0f;
+        for (int k = 0; k < 3; k++) need = fmaxf(need, fmaxf(alo[k] - ext[k], ext[3 + k] - ahi[k]));
+        if (need > level->subtreeSlack[a]) level->subtreeSlack[a] = need;
+    }
+}
+
+static void LogLevelEdit(Level *level, uint32_t box)
+{
+    if (level->editsLost) return;
+    if (level->editedCount == level->editedCapacity)
+    {
+        uint32_t capacity = level->editedCapacity ? 2*level->editedCapacity : 256;
+        uint32_t *grown = RL_REALLOC(level->editedBoxes, (size_t)capacity*sizeof(uint32_t));
+        if (!grown) { level->editsLost = true; return; }
+        level->editedBoxes = grown;
+        level->editedCapacity = capacity;
+    }
+    level->editedBoxes[level->editedCount++] = box;
+}
+
+void ClearLevelEdits(Level *level)
+{
+    level->editedCount = 0;
+    level->editsLost = false;
+}
+
+uint32_t AddLevelBox(Level *level, NameId name, const float min[3], const float max[3], uint32_t color)
+{
+    uint32_t box = level->boxCount;
+    if (!ReserveLevelBoxes(level, box + 1)) return UINT32_MAX;
+    int32_t leaf = AllocateNode(level);
+    if (leaf == LEVEL_NULL_NODE) return UINT32_MAX;
+
+    level->minX[box] = min[0]; level->minY[box] = min[1]; level->minZ[box] = min[2];
+    level->maxX[box] = max[0]; level->maxY[box] = max[1]; level->maxZ[box] = max[2];
+    level->colors[box] = color;
+    level->parents[box] = -1;
+    level->subtreeEnds[box] = box + 1;
+    level->subtreeSlack[box] = 0.0f;
+    level->names[box] = name;
+    level->boxLeaves[box] = leaf;
+
+    LevelNode *node = &level->nodes[leaf];
+    node->child1 = node->child2 = LEVEL_NULL_NODE;
+    node->box = (int32_t)box;
+    node->height = 0;
+    node->reserved = 0;
+    SetLeafBounds(level, box);
+    if (!InsertLeaf(level, leaf)) { FreeNode(level, leaf); return UINT32_MAX; }
+    level->boxCount++;
+    LogLevelEdit(level, box);
+    return box;
+}
+
+void MoveLevelBox(Level *level, uint32_t box, const float min[3], const float max[3])
+{
+    if (box >= level->boxCount || !IsLevelBoxAlive(level, box) || !MakeLevelEditable(level)) return;
+    level->minX[box] = min[0]; level->minY[box] = min[1]; level->minZ[box] = min[2];
+    level->maxX[box] = max[0]; level->maxY[box] = max[1]; level->maxZ[box] = max[2];
+
+    // Removing the leaf frees one internal node and inserting takes it back,
+    // so this can't fail for lack of memory
+    int32_t leaf = level->boxLeaves[box];
+    RemoveLeaf(level, leaf);
+    SetLeafBounds(level, box);
+    InsertLeaf(level, leaf);
+    RefitSlack(level, box);
+    LogLevelEdit(level, box);
+}
+
+void RemoveLevelBox(Level *level, uint32_t box)
+{
+    if (box >= level->boxCount || !IsLevelBoxAlive(level, box) || !MakeLevelEditable(level)) return;
+    int32_t leaf = level->boxLeaves[box];
+    RemoveLeaf(level, leaf);
+    FreeNode(level, leaf);
+    level->boxLeaves[box] = LEVEL_NULL_NODE;
+    level->names[box] = NAME_NONE;
+    level->removedCount++;
+    LogLevelEdit(level, box);
+}
@@ -0,0 +1,206 @@
+// level.h - compiled binary levels
+//
+// A level is the set of axis-aligned boxes exported from Blender (see
+// blenderCoordinatesScript.py and resources/*_bboxes.json), compiled offline
+// by tools/levelc.c into one little-endian file:
+//
+//   LevelHeader | minX | minY | minZ | maxX | maxY | maxZ | colors | nameIds
+//               | parents | subtreeEnds | subtreeSlack
+//               | nameOffsets | nameChars | nodes
+//
+// Box coordinates are already converted to raylib space (Blender Z up becomes
+// Y, Blender Y becomes -Z), colors are picked at compile time, names are
+// stored once in a string table and the boxes come with a bounding volume
+// tree for overlap queries. Every section starts on a LEVEL_SECTION_ALIGN
+// boundary, so LoadLevel maps the file and points straight into it.
+//
+// Boxes also form a containment hierarchy: a box's parent is the smallest box
+// that contains it (within the compile tolerance). Boxes are stored in depth
+// first order, so the descendants of box i are i+1 .. subtreeEnds[i]-1 and a
+// linear scan can step over a whole bookcase and its books after one test.
+// subtreeSlack[i] is how far any descendant pokes out of box i, 0 when the
+// whole subtree is inside it.
+//
+// This module doesn't depend on raylib so the level compiler can link it.
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "intern.h"
+
+#define LEVEL_MAGIC         0x4C56454Cu   // "LEVL" read as a little-endian uint32
+#define LEVEL_VERSION       2u
+#define LEVEL_SECTION_ALIGN 64u
+#define LEVEL_NULL_NODE     (-1)
+#define LEVEL_DEFAULT_TOLERANCE 0.001f   // 1 mm, Blender units are meters
+#define LEVEL_MAX_BOXES     (1u << 30)   // tree node indices are int32_t
+#define LEVEL_QUERY_STACK   256          // tree height QueryLevelBoxes walks without allocating
+
+typedef enum {
+    LEVEL_SECTION_MIN_X = 0,
+    LEVEL_SECTION_MIN_Y,
+    LEVEL_SECTION_MIN_Z,
+    LEVEL_SECTION_MAX_X,
+    LEVEL_SECTION_MAX_Y,
+    LEVEL_SECTION_MAX_Z,
+    LEVEL_SECTION_COLORS,        // uint32_t per box, bytes r,g,b,a
+    LEVEL_SECTION_NAME_IDS,      // uint32_t per box, index into the name table
+    LEVEL_SECTION_PARENTS,       // int32_t per box, -1 for top level boxes
+    LEVEL_SECTION_SUBTREE_ENDS,  // uint32_t per box, one past its last descendant
+    LEVEL_SECTION_SUBTREE_SLACK, // float per box
+    LEVEL_SECTION_NAME_OFFSETS,  // uint32_t per name + 1, offsets into nameChars
+    LEVEL_SECTION_NAME_CHARS,    // null-terminated names, back to back
+    LEVEL_SECTION_NODES,         // LevelNode per tree node
+    LEVEL_SECTION_COUNT
+} LevelSectionId;
+
+typedef struct LevelSection {
+    uint64_t offset;             // from the start of the file
+    uint64_t size;               // in bytes
+} LevelSection;
+
+typedef struct LevelHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t boxCount;
+    uint32_t nameCount;
+    uint32_t nodeCount;
+    int32_t  rootNode;           // LEVEL_NULL_NODE for an empty level
+    float    tolerance;          // containment tolerance used by the compiler
+    uint64_t fileSize;
+    LevelSection sections[LEVEL_SECTION_COUNT];
+} LevelHeader;
+
+// Bounding volume tree node. Leaves hold one box; internal nodes always have
+// two children. Parent links and heights let the tree be edited in place,
+// free nodes have height -1 and chain through parent.
+typedef struct LevelNode {
+    float   min[3];
+    float   max[3];
+    int32_t parent;
+    int32_t child1;
+    int32_t child2;
+    int32_t box;                 // box index for leaves, -1 for internal nodes
+    int32_t height;              // 0 for leaves
+    int32_t reserved;
+} LevelNode;
+
+typedef struct Level {
+    uint32_t boxCount;
+    uint32_t nameCount;
+    uint32_t nodeCount;
+    int32_t  rootNode;
+
+    // Structure of arrays, one entry per box, in raylib coordinates
+    float *minX, *minY, *minZ;
+    float *maxX, *maxY, *maxZ;
+    uint32_t *colors;
+    uint32_t *nameIds;
+    int32_t  *parents;
+    uint32_t *subtreeEnds;
+    float    *subtreeSlack;
+
+    uint32_t *nameOffsets;
+    char *nameChars;
+    LevelNode *nodes;
+
+    NameId *names;               // global interned id per box, NAME_NONE once removed
+
+    void  *data;                 // file contents, mapped or heap allocated
+    size_t dataSize;
+    bool   mapped;
+
+    // Runtime edits (hot reload) move every array to its own heap block with
+    // room to grow, data is NULL afterwards and the name table is dropped.
+    bool      editable;
+    uint32_t  boxCapacity;
+    uint32_t  nodeCapacity;
+    int32_t   freeNode;
+    int32_t  *boxLeaves;         // tree leaf of every box
+    uint32_t  removedCount;
+
+    // Boxes added, moved or removed since ClearLevelEdits(), in edit order
+    // and possibly repeated, so what's built from the boxes (static_batch.h)
+    // can update only what changed. editsLost is set when the log couldn't
+    // grow, everything counts as edited then.
+    uint32_t *editedBoxes;
+    uint32_t  editedCount, editedCapacity;
+    bool      editsLost;
+} Level;
+
+typedef struct LevelReloadStats {
+    uint32_t added;
+    uint32_t removed;
+    uint32_t moved;
+    uint32_t unchanged;
+    double   parseMs;            // reading and validating the JSON
+    double   applyMs;            // diffing and updating the level
+} LevelReloadStats;
+
+// Map a compiled level file. Returns a level with data == NULL on failure.
+// Box names are added to the global interner (intern.h) while loading.
+Level LoadLevel(const char *fileName);
+
+// Compile a Blender bbox JSON file ({"name": {"min":[x,y,z], "max":[x,y,z]}, ...})
+// into a heap-backed level. Colors come from colorSeed, so output is deterministic.
+// A box counts as inside another if it pokes out by at most tolerance.
+Level LoadLevelFromJson(const char *fileName, uint32_t colorSeed, float tolerance);
+
+// Levels edited at runtime can't be exported, recompile them from JSON.
+bool ExportLevel(const Level *level, const char *fileName);
+void UnloadLevel(Level *level);
+bool IsLevelValid(const Level *level);
+
+const char *GetLevelBoxName(const Level *level, uint32_t box);
+
+// Removed boxes keep their slot (so the hierarchy stays contiguous) until the
+// level is reloaded from disk. Loops over all boxes skip them with this.
+static inline bool IsLevelBoxAlive(const Level *level, uint32_t box) { return level->names[box] != NAME_NONE; }
+
+// Runtime edits, applied to the tree incrementally. Added boxes go at the end
+// as top level boxes; the hierarchy isn't re-inferred, but subtree slack is
+// grown so ScanLevelBoxes stays exact.
+uint32_t AddLevelBox(Level *level, NameId name, const float min[3], const float max[3], uint32_t color);
+void MoveLevelBox(Level *level, uint32_t box, const float min[3], const float max[3]);
+void RemoveLevelBox(Level *level, uint32_t box);
+void ClearLevelEdits(Level *level);
+
+// Re-read a Blender bbox JSON file and apply only what changed, matching
+// boxes by name. The level is left untouched if the file can't be parsed.
+bool ReloadLevelFromJson(Level *level, const char *fileName, LevelReloadStats *stats);
+
+// The same in two steps, so the slow half can run on a worker thread.
+// ParseLevelReload reads and validates the file without touching the level
+// or the interner (NULL if it can't be parsed). The file is read into memory,
+// not mapped, so it can be rewritten meanwhile: a file caught half written
+// doesn't parse, and the change that finishes it triggers the next try. ApplyLevelReload diffs the
+// result into the level on the main thread; names are interned only there,
+// for boxes that get added.
+typedef struct LevelReload LevelReload;
+LevelReload *ParseLevelReload(const char *fileName);
+bool ApplyLevelReload(Level *level, const LevelReload *reload, LevelReloadStats *stats);
+void UnloadLevelReload(LevelReload *reload);
+
+// Collect up to maxBoxes indices of boxes overlapping [min, max], returns how
+// many overlap in total (which can be more than maxBoxes). The tree walk needs
+// height + 1 stack entries; the tree is kept balanced, so that is far below
+// LEVEL_QUERY_STACK at any box count, but a deeper tree gets its stack from
+// the heap rather than losing subtrees. Returns -1 if that allocation fails.
+int QueryLevelBoxes(const Level *level, const float min[3], const float max[3], uint32_t *boxes, int maxBoxes);
+
+// Same result from a linear scan of the box arrays that skips the subtree of
+// every box the query misses. Counts box tests in *tests when it's not NULL.
+int ScanLevelBoxes(const Level *level, const float min[3], const float max[3], uint32_t *boxes, int maxBoxes, uint32_t *tests);
+
+// Used by the compiler and tools/levelgen.c: compile boxes already in raylib
+// space, bounds[0..5] being the minX, minY, minZ, maxX, maxY, maxZ arrays.
+Level BuildLevel(const char *const *names, const float *const bounds[6], uint32_t boxCount, uint32_t colorSeed, float tolerance);
+
+// Used by the compiler: wrap a heap blob laid out as above (takes ownership).
+Level LoadLevelFromMemory(void *data, size_t dataSize);
+
+#endif // LEVEL_H
@@ -0,0 +1,562 @@
+// level_build.c - compiling Blender bbox JSON into the binary level layout
+#include "level.h"
+#include "parson.h"
+#include "timing.h"
+#include "heap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~(uint64_t)((a) - 1))
+
+typedef struct TreeBuilder {
+    LevelNode *nodes;
+    int32_t nodeCount;
+    const float *minX, *minY, *minZ, *maxX, *maxY, *maxZ;
+    float *centroid[3];
+} TreeBuilder;
+
+/* ── colors ────────────────────────────────────────────────────────── */
+static uint32_t NextRandom(uint32_t *state)
+{
+    // xorshift32, the state must not be 0
+    uint32_t x = *state;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *state = x;
+}
+
+static uint32_t PickColor(uint32_t *rng)
+{
+    uint32_t r = 150 + NextRandom(rng)%106, g = 150 + NextRandom(rng)%106, b = 150 + NextRandom(rng)%106;
+    return r | (g << 8) | (b << 16) | (200u << 24);
+}
+
+/* ── JSON input ────────────────────────────────────────────────────── */
+static JSON_Schema *CompileBoxSchema(void)
+{
+    JSON_Value *schemaVal = json_parse_string("{\"min\":[0],\"max\":[0]}");
+    JSON_Schema *schema = json_schema_compile(schemaVal);
+    json_value_free(schemaVal);
+    return schema;
+}
+
+// Reads one {"min":[x,y,z], "max":[x,y,z]} entry as minX, minY, minZ, maxX,
+// maxY, maxZ in raylib space. Blender is Z up: X stays X, Blender Z becomes
+// raylib Y and Blender Y (depth) becomes -Z, which swaps min and max there.
+static void ReadBlenderBox(const JSON_Value *entry, float box[6])
+{
+    JSON_Object *o = json_value_get_object(entry);
+    JSON_Array *mn = json_object_get_array(o, "min");
+    JSON_Array *mx = json_object_get_array(o, "max");
+    float bMin[3], bMax[3];
+    for (int a = 0; a < 3; a++)
+    {
+        bMin[a] = (float)json_array_get_number(mn, a);
+        bMax[a] = (float)json_array_get_number(mx, a);
+    }
+    box[0] = bMin[0]; box[1] = bMin[2]; box[2] = -bMax[1];
+    box[3] = bMax[0]; box[4] = bMax[2]; box[5] = -bMin[1];
+}
+
+/* ── bounding volume tree ──────────────────────────────────────────── */
+// Partially sorts items[0..count) so the item at k has the k-th smallest
+// centroid on axis, with smaller ones before it and larger ones after it.
+static void SelectByCentroid(uint32_t *items, uint32_t count, uint32_t k, const float *centroid)
+{
+    int64_t lo = 0, hi = (int64_t)count - 1;
+    while (lo < hi)
+    {
+        float pivot = centroid[items[lo + (hi - lo)/2]];
+        int64_t i = lo, j = hi;
+        while (i <= j)
+        {
+            while (centroid[items[i]] < pivot) i++;
+            while (centroid[items[j]] > pivot) j--;
+            if (i <= j)
+            {
+                uint32_t t = items[i]; items[i] = items[j]; items[j] = t;
+                i++; j--;
+            }
+        }
+        if ((int64_t)k <= j) hi = j;
+        else if ((int64_t)k >= i) lo = i;
+        else break;
+    }
+}
+
+// Top-down build: split at the median centroid along the widest centroid
+// axis. The result is balanced, so queries never go deeper than log2(n) + 1.
+static int32_t BuildTreeNode(TreeBuilder *b, uint32_t *items, uint32_t count, int32_t parent)
+{
+    int32_t index = b->nodeCount++;
+    LevelNode *node = &b->nodes[index];
+    node->parent = parent;
+    node->reserved = 0;
+
+    if (count == 1)
+    {
+        uint32_t box = items[0];
+        node->min[0] = b->minX[box]; node->min[1] = b->minY[box]; node->min[2] = b->minZ[box];
+        node->max[0] = b->maxX[box]; node->max[1] = b->maxY[box]; node->max[2] = b->maxZ[box];
+        node->child1 = node->child2 = LEVEL_NULL_NODE;
+        node->box = (int32_t)box;
+        node->height = 0;
+        return index;
+    }
+
+    float lo[3], hi[3];
+    for (int a = 0; a < 3; a++) lo[a] = hi[a] = b->centroid[a][items[0]];
+    for (uint32_t i = 1; i < count; i++)
+    {
+        for (int a = 0; a < 3; a++)
+        {
+            float c = b->centroid[a][items[i]];
+            if (c < lo[a]) lo[a] = c;
+            if (c > hi[a]) hi[a] = c;
+        }
+    }
+    int axis = 0;
+    if (hi[1] - lo[1] > hi[axis] - lo[axis]) axis = 1;
+    if (hi[2] - lo[2] > hi[axis] - lo[axis]) axis = 2;
+
+    uint32_t half = count/2;
+    SelectByCentroid(items, count, half, b->centroid[axis]);
+
+    int32_t child1 = BuildTreeNode(b, items, half, index);
+    int32_t child2 = BuildTreeNode(b, items + half, count - half, index);
+    node = &b->nodes[index];
+    const LevelNode *c1 = &b->nodes[child1], *c2 = &b->nodes[child2];
+    for (int a = 0; a < 3; a++)
+    {
+        node->min[a] = (c1->min[a] < c2->min[a]) ? c1->min[a] : c2->min[a];
+        node->max[a] = (c1->max[a] > c2->max[a]) ? c1->max[a] : c2->max[a];
+    }
+    node->child1 = child1;
+    node->child2 = child2;
+    node->box = -1;
+    node->height = 1 + ((c1->height > c2->height) ? c1->height : c2->height);
+    return index;
+}
+
+// Builds the tree over boxes 0..count-1 into nodes[0..2*count-1), root at 0
+static bool BuildTree(LevelNode *nodes, const float *const bounds[6], uint32_t count)
+{
+    TreeBuilder b = { nodes, 0, bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5], { 0 } };
+    uint32_t *items = RL_MALLOC((size_t)count*sizeof(uint32_t));
+    float *centroids = RL_MALLOC(3*(size_t)count*sizeof(float));
+    if (!items || !centroids) { RL_FREE(items); RL_FREE(centroids); return false; }
+    for (int a = 0; a < 3; a++) b.centroid[a] = centroids + (size_t)a*count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (int a = 0; a < 3; a++) b.centroid[a][i] = 0.5f*(bounds[a][i] + bounds[3 + a][i]);
+        items[i] = i;
+    }
+    BuildTreeNode(&b, items, count, LEVEL_NULL_NODE);
+    RL_FREE(centroids);
+    RL_FREE(items);
+    return true;
+}
+
+/* ── containment hierarchy ─────────────────────────────────────────── */
+static float BoxVolume(const float *const bounds[6], uint32_t i)
+{
+    return (bounds[3][i] - bounds[0][i])*(bounds[4][i] - bounds[1][i])*(bounds[5][i] - bounds[2][i]);
+}
+
+// Strict order used to pick parents: bigger volume first, ties broken by
+// index. A parent always comes before its child in this order, so two
+// identical boxes can't end up as each other's parent.
+static bool IsLarger(const float *const bounds[6], uint32_t a, uint32_t b)
+{
+    float va = BoxVolume(bounds, a), vb = BoxVolume(bounds, b);
+    return (va > vb) || (va == vb && a < b);
+}
+
+// The parent of a box is the smallest larger box containing it within
+// tolerance. Containers overlap the box grown by the tolerance, so only tree
+// leaves overlapping that are looked at.
+static int32_t FindContainer(const LevelNode *nodes, const float *const bounds[6], uint32_t box, float tolerance, int32_t *stack)
+{
+    float lo[3] = { bounds[0][box], bounds[1][box], bounds[2][box] };
+    float hi[3] = { bounds[3][box], bounds[4][box], bounds[5][box] };
+    float qlo[3] = { lo[0] - tolerance, lo[1] - tolerance, lo[2] - tolerance };
+    float qhi[3] = { hi[0] + tolerance, hi[1] + tolerance, hi[2] + tolerance };
+    int32_t best = -1;
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const LevelNode *node = &nodes[stack[--top]];
+        if (node->min[0] > qhi[0] || node->max[0] < qlo[0] ||
+            node->min[1] > qhi[1] || node->max[1] < qlo[1] ||
+            node->min[2] > qhi[2] || node->max[2] < qlo[2]) continue;
+        if (node->box < 0)
+        {
+            stack[top++] = node->child1;
+            stack[top++] = node->child2;
+            continue;
+        }
+        uint32_t c = (uint32_t)node->box;
+        if (c == box || !IsLarger(bounds, c, box)) continue;
+        if (bounds[0][c] > lo[0] + tolerance || bounds[3][c] < hi[0] - tolerance ||
+            bounds[1][c] > lo[1] + tolerance || bounds[4][c] < hi[1] - tolerance ||
+            bounds[2][c] > lo[2] + tolerance || bounds[5][c] < hi[2] - tolerance) continue;
+        if (best < 0 || IsLarger(bounds, (uint32_t)best, c)) best = (int32_t)c;
+    }
+    return best;
+}
+
+/* ── compiler ──────────────────────────────────────────────────────── */
+Level BuildLevel(const char *const *names, const float *const bounds[6], uint32_t boxCount, uint32_t colorSeed, float tolerance)
+{
+    Level level = { 0 };
+    uint64_t charsSize = 0;
+    for (uint32_t i = 0; i < boxCount; i++) charsSize += strlen(names[i]) + 1;
+    if (boxCount > LEVEL_MAX_BOXES || charsSize > UINT32_MAX) return level;
+
+    // Lay out the file
+    uint32_t nodeCount = (boxCount > 0) ? 2*boxCount - 1 : 0;
+    uint64_t counts[LEVEL_SECTION_COUNT] = {
+        boxCount, boxCount, boxCount, boxCount, boxCount, boxCount,
+        boxCount, boxCount, boxCount, boxCount, boxCount,
+        (uint64_t)boxCount + 1, charsSize, nodeCount
+    };
+    uint64_t strides[LEVEL_SECTION_COUNT] = {
+        sizeof(float), sizeof(float), sizeof(float), sizeof(float), sizeof(float), sizeof(float),
+        sizeof(uint32_t), sizeof(uint32_t), sizeof(int32_t), sizeof(uint32_t), sizeof(float),
+        sizeof(uint32_t), 1, sizeof(LevelNode)
+    };
+    LevelHeader header = { 0 };
+    uint64_t offset = ALIGN_UP(sizeof(LevelHeader), LEVEL_SECTION_ALIGN);
+    for (int s = 0; s < LEVEL_SECTION_COUNT; s++)
+    {
+        header.sections[s].offset = offset;
+        header.sections[s].size = counts[s]*strides[s];
+        offset = ALIGN_UP(offset + header.sections[s].size, LEVEL_SECTION_ALIGN);
+    }
+    header.magic = LEVEL_MAGIC;
+    header.version = LEVEL_VERSION;
+    header.headerSize = sizeof(LevelHeader);
+    header.boxCount = boxCount;
+    header.nameCount = boxCount;
+    header.nodeCount = nodeCount;
+    header.rootNode = (boxCount > 0) ? 0 : LEVEL_NULL_NODE;
+    header.tolerance = tolerance;
+    header.fileSize = offset;
+    if (offset > SIZE_MAX) return level;
+
+    // Scratch: per box in input order its parent, depth first position and
+    // subtree extent
+    uint32_t *scratch = RL_MALLOC(5*(size_t)boxCount*sizeof(uint32_t) + 1);
+    float *extent = RL_MALLOC(6*(size_t)boxCount*sizeof(float) + 1);
+    unsigned char *data = RL_CALLOC(1, (size_t)offset);
+    if (!scratch || !extent || !data)
+    {
+        RL_FREE(scratch); RL_FREE(extent); RL_FREE(data);
+        return level;
+    }
+    memcpy(data, &header, sizeof(header));
+#define SECTION(type, id) ((type *)(data + header.sections[id].offset))
+    float *minX = SECTION(float, LEVEL_SECTION_MIN_X), *minY = SECTION(float, LEVEL_SECTION_MIN_Y);
+    float *minZ = SECTION(float, LEVEL_SECTION_MIN_Z), *maxX = SECTION(float, LEVEL_SECTION_MAX_X);
+    float *maxY = SECTION(float, LEVEL_SECTION_MAX_Y), *maxZ = SECTION(float, LEVEL_SECTION_MAX_Z);
+    uint32_t *colors = SECTION(uint32_t, LEVEL_SECTION_COLORS);
+    uint32_t *nameIds = SECTION(uint32_t, LEVEL_SECTION_NAME_IDS);
+    int32_t *parents = SECTION(int32_t, LEVEL_SECTION_PARENTS);
+    uint32_t *subtreeEnds = SECTION(uint32_t, LEVEL_SECTION_SUBTREE_ENDS);
+    float *subtreeSlack = SECTION(float, LEVEL_SECTION_SUBTREE_SLACK);
+    uint32_t *nameOffsets = SECTION(uint32_t, LEVEL_SECTION_NAME_OFFSETS);
+    char *nameChars = SECTION(char, LEVEL_SECTION_NAME_CHARS);
+    LevelNode *nodes = SECTION(LevelNode, LEVEL_SECTION_NODES);
+#undef SECTION
+
+    if (boxCount > 0 && !BuildTree(nodes, bounds, boxCount))
+    {
+        RL_FREE(scratch); RL_FREE(extent); RL_FREE(data);
+        return level;
+    }
+
+    // Containment hierarchy, in input order. The tree is balanced, so the
+    // search stack needs 2 entries per level.
+    uint32_t *parentOf = scratch;                        // UINT32_MAX for top level boxes
+    uint32_t *firstChild = scratch + boxCount;
+    uint32_t *nextSibling = scratch + 2*(size_t)boxCount;
+    uint32_t *order = scratch + 3*(size_t)boxCount;       // depth first position -> input index
+    uint32_t *position = scratch + 4*(size_t)boxCount;    // input index -> depth first position
+    int32_t stack[2*64];
+    for (uint32_t i = 0; i < boxCount; i++) firstChild[i] = nextSibling[i] = UINT32_MAX;
+    for (uint32_t i = 0; i < boxCount; i++)
+    {
+        int32_t p = FindContainer(nodes, bounds, i, tolerance, stack);
+        parentOf[i] = (p < 0) ? UINT32_MAX : (uint32_t)p;
+    }
+    for (uint32_t i = boxCount; i-- > 0;)                 // keeps children in input order
+    {
+        if (parentOf[i] == UINT32_MAX) continue;
+        nextSibling[i] = firstChild[parentOf[i]];
+        firstChild[parentOf[i]] = i;
+    }
+
+    // Depth first order: top level boxes in input order, each followed by its
+    // descendants. position doubles as the DFS stack while it's unused.
+    uint32_t emitted = 0;
+    for (uint32_t r = 0; r < boxCount; r++)
+    {
+        if (parentOf[r] != UINT32_MAX) continue;
+        uint32_t top = 0;
+        position[top++] = r;
+        while (top > 0)
+        {
+            uint32_t v = position[--top];
+            order[emitted++] = v;
+            uint32_t childCount = 0;
+            for (uint32_t c = firstChild[v]; c != UINT32_MAX; c = nextSibling[c]) childCount++;
+            top += childCount;                           // push children so the first pops first
+            uint32_t slot = top;
+            for (uint32_t c = firstChild[v]; c != UINT32_MAX; c = nextSibling[c]) position[--slot] = c;
+        }
+    }
+    for (uint32_t i = 0; i < boxCount; i++) position[order[i]] = i;
+
+    uint32_t rng = colorSeed ? colorSeed : 0x9E3779B9u;
+    uint32_t charsUsed = 0;
+    for (uint32_t i = 0; i < boxCount; i++)
+    {
+        uint32_t src = order[i];
+        minX[i] = bounds[0][src]; minY[i] = bounds[1][src]; minZ[i] = bounds[2][src];
+        maxX[i] = bounds[3][src]; maxY[i] = bounds[4][src]; maxZ[i] = bounds[5][src];
+        parents[i] = (parentOf[src] == UINT32_MAX) ? -1 : (int32_t)position[parentOf[src]];
+        subtreeEnds[i] = i + 1;
+
+        colors[i] = PickColor(&rng);
+
+        size_t len = strlen(names[src]) + 1;
+        nameIds[i] = i;
+        nameOffsets[i] = charsUsed;
+        memcpy(nameChars + charsUsed, names[src], len);
+        charsUsed += (uint32_t)len;
+    }
+    nameOffsets[boxCount] = charsUsed;
+
+    // Children come after their parent, so walking backwards finishes every
+    // subtree before its root is folded into the parent
+    for (uint32_t i = 0; i < boxCount; i++)
+    {
+        float box[6] = { minX[i], minY[i], minZ[i], maxX[i], maxY[i], maxZ[i] };
+        for (int a = 0; a < 6; a++) extent[(size_t)a*boxCount + i] = box[a];
+    }
+    for (uint32_t i = boxCount; i-- > 0;)
+    {
+        float *e[6];
+        for (int a = 0; a < 6; a++) e[a] = extent + (size_t)a*boxCount;
+        float slack = 0.0f;
+        slack = fmaxf(slack, minX[i] - e[0][i]); slack = fmaxf(slack, e[3][i] - maxX[i]);
+        slack = fmaxf(slack, minY[i] - e[1][i]); slack = fmaxf(slack, e[4][i] - maxY[i]);
+        slack = fmaxf(slack, minZ[i] - e[2][i]); slack = fmaxf(slack, e[5][i] - maxZ[i]);
+        subtreeSlack[i] = slack;
+
+        int32_t p = parents[i];
+        if (p < 0) continue;
+        if (subtreeEnds[i] > subtreeEnds[p]) subtreeEnds[p] = subtreeEnds[i];
+        for (int a = 0; a < 3; a++)
+        {
+            e[a][p] = fminf(e[a][p], e[a][i]);
+            e[3 + a][p] = fmaxf(e[3 + a][p], e[3 + a][i]);
+        }
+    }
+
+    // The tree was built over input order, point its leaves at the new slots
+    for (uint32_t n = 0; n < nodeCount; n++)
+        if (nodes[n].box >= 0) nodes[n].box = (int32_t)position[nodes[n].box];
+
+    RL_FREE(scratch); RL_FREE(extent);
+    return LoadLevelFromMemory(data, (size_t)offset);
+}
+
+Level LoadLevelFromJson(const char *fileName, uint32_t colorSeed, float tolerance)
+{
+    Level level = { 0 };
+    JSON_Value *rootVal = json_parse_file(fileName);
+    JSON_Object *rootObj = json_value_get_object(rootVal);
+    if (!rootObj) { json_value_free(rootVal); return level; }
+
+    // Keep the entries that are well formed. JSON keys are unique, so each
+    // accepted entry adds one name to the table. Names point into the parsed
+    // document, which outlives BuildLevel.
+    JSON_Schema *schema = CompileBoxSchema();
+    size_t entryCount = json_object_get_count(rootObj);
+    const char **names = RL_MALLOC((entryCount + 1)*sizeof(char *));
+    float *raw = RL_MALLOC(6*(entryCount + 1)*sizeof(float));
+    if (!names || !raw || entryCount > LEVEL_MAX_BOXES)
+    {
+        RL_FREE(names); RL_FREE(raw); json_schema_free(schema); json_value_free(rootVal);
+        return level;
+    }
+    uint32_t boxCount = 0;
+    for (size_t e = 0; e < entryCount; e++)
+    {
+        const JSON_Value *entry = json_object_get_value_at(rootObj, e);
+        char badPath[128];
+        if (json_schema_validate(schema, entry, badPath, sizeof(badPath)) != JSONSuccess)
+        {
+            fprintf(stderr, "%s: skipping \"%s\", bad value at '%s'\n", fileName, json_object_get_name(rootObj, e), badPath);
+            continue;
+        }
+        float converted[6];
+        ReadBlenderBox(entry, converted);
+        for (int a = 0; a < 6; a++) raw[(size_t)a*entryCount + boxCount] = converted[a];
+        names[boxCount++] = json_object_get_name(rootObj, e);
+    }
+    json_schema_free(schema);
+
+    const float *bounds[6];
+    for (int a = 0; a < 6; a++) bounds[a] = raw + (size_t)a*entryCount;
+    level = BuildLevel(names, bounds, boxCount, colorSeed, tolerance);
+    RL_FREE(names); RL_FREE(raw);
+    json_value_free(rootVal);
+    return level;
+}
+
+/* ── hot reload ────────────────────────────────────────────────────── */
+struct LevelReload {
+    JSON_Value *document;        // owns the names
+    const char **names;
+    float *boxes;                // 6 per entry, raylib space
+    size_t count;
+    double parseMs;
+};
+
+// The whole file in a heap buffer, NULL unless all of it could be read.
+// Not json_parse_file(): it maps the file, and Blender rewriting the file
+// in place while the mapping is parsed truncates it under the parser (SIGBUS).
+static char *ReadReloadFile(const char *fileName)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (!file) return NULL;
+    char *text = NULL;
+    long length = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+    if (length > 0 && fseek(file, 0, SEEK_SET) == 0 && (text = RL_MALLOC((size_t)length + 1)))
+    {
+        if (fread(text, 1, (size_t)length, file) == (size_t)length) text[length] = '\0';
+        else { RL_FREE(text); text = NULL; }
+    }
+    fclose(file);
+    return text;
+}
+
+LevelReload *ParseLevelReload(const char *fileName)
+{
+    double start = NowMs();
+    char *text = ReadReloadFile(fileName);
+    JSON_Value *rootVal = text ? json_parse_string(text) : NULL;
+    RL_FREE(text);
+    JSON_Object *rootObj = json_value_get_object(rootVal);
+    LevelReload *reload = rootObj ? RL_CALLOC(1, sizeof(LevelReload)) : NULL;
+    if (!reload) { json_value_free(rootVal); return NULL; }
+
+    // Read everything first so a bad file leaves the level as it was
+    JSON_Schema *schema = CompileBoxSchema();
+    size_t entryCount = json_object_get_count(rootObj);
+    reload->document = rootVal;
+    reload->names = RL_MALLOC((entryCount + 1)*sizeof(const char *));
+    reload->boxes = RL_MALLOC((entryCount + 1)*6*sizeof(float));
+    if (!reload->names || !reload->boxes)
+    {
+        json_schema_free(schema);
+        UnloadLevelReload(reload);
+        return NULL;
+    }
+    for (size_t e = 0; e < entryCount; e++)
+    {
+        const JSON_Value *entry = json_object_get_value_at(rootObj, e);
+        char badPath[128];
+        if (json_schema_validate(schema, entry, badPath, sizeof(badPath)) != JSONSuccess)
+        {
+            fprintf(stderr, "%s: skipping \"%s\", bad value at '%s'\n", fileName, json_object_get_name(rootObj, e), badPath);
+            continue;
+        }
+        reload->names[reload->count] = json_object_get_name(rootObj, e);
+        ReadBlenderBox(entry, reload->boxes + 6*reload->count);
+        reload->count++;
+    }
+    json_schema_free(schema);
+    reload->parseMs = NowMs() - start;
+    return reload;
+}
+
+void UnloadLevelReload(LevelReload *reload)
+{
+    if (!reload) return;
+    json_value_free(reload->document);
+    RL_FREE(reload->names); RL_FREE(reload->boxes);
+    RL_FREE(reload);
+}
+
+bool ApplyLevelReload(Level *level, const LevelReload *reload, LevelReloadStats *stats)
+{
+    LevelReloadStats result = { 0 };
+    double start = NowMs();
+
+    // Names are dense ids, so the loaded boxes are indexed by name with a
+    // plain array. Looking names up doesn't intern them, only the boxes that
+    // actually get added bring new names in.
+    uint32_t nameCount = GetNameCount();
+    uint32_t boxCount = level->boxCount;
+    uint32_t *boxOfName = RL_MALLOC(((size_t)nameCount + 1)*sizeof(uint32_t));
+    bool *seen = RL_CALLOC((size_t)boxCount + 1, sizeof(bool));
+    if (!boxOfName || !seen)
+    {
+        RL_FREE(boxOfName); RL_FREE(seen);
+        return false;
+    }
+    for (uint32_t n = 0; n <= nameCount; n++) boxOfName[n] = UINT32_MAX;
+    for (uint32_t i = 0; i < boxCount; i++)
+        if (IsLevelBoxAlive(level, i)) boxOfName[level->names[i]] = i;
+
+    for (size_t e = 0; e < reload->count; e++)
+    {
+        const float *b = reload->boxes + 6*e;
+        const char *name = reload->names[e];
+        NameId id = FindName(name);
+        uint32_t box = (id != NAME_NONE && id <= nameCount) ? boxOfName[id] : UINT32_MAX;
+        if (box == UINT32_MAX)
+        {
+            uint32_t rng = 0;
+            for (const char *c = name; *c; c++) rng = rng*31 + (unsigned char)*c;
+            rng |= 1;
+            id = InternName(name);
+            if (id != NAME_NONE && AddLevelBox(level, id, b, b + 3, PickColor(&rng)) != UINT32_MAX) result.added++;
+            continue;
+        }
+        seen[box] = true;
+        if (level->minX[box] != b[0] || level->minY[box] != b[1] || level->minZ[box] != b[2] ||
+            level->maxX[box] != b[3] || level->maxY[box] != b[4] || level->maxZ[box] != b[5])
+        {
+            MoveLevelBox(level, box, b, b + 3);
+            result.moved++;
+        }
+        else result.unchanged++;
+    }
+    for (uint32_t i = 0; i < boxCount; i++)
+    {
+        if (seen[i] || !IsLevelBoxAlive(level, i)) continue;
+        RemoveLevelBox(level, i);
+        result.removed++;
+    }
+
+    RL_FREE(boxOfName); RL_FREE(seen);
+    result.parseMs = reload->parseMs;
+    result.applyMs = NowMs() - start;
+    if (stats) *stats = result;
+    return true;
+}
+
+bool ReloadLevelFromJson(Level *level, const char *fileName, LevelReloadStats *stats)
+{
+    LevelReload *reload = ParseLevelReload(fileName);
+    bool applied = reload && ApplyLevelReload(level, reload, stats);
+    UnloadLevelReload(reload);
+    return applied;
+}
@@ -0,0 +1,296 @@
+// line_mesh.c - indexed line meshes (see line_mesh.h)
+#include "line_mesh.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raymath.h"
+#include "rlgl.h"
+
+// rlgl only exposes triangle draws, the line draw calls come from the GL
+// loader raylib is built with
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_43)
+    #include "glad.h"
+    #define LINE_MESH_GL
+#endif
+
+static const char *lineVertexShader =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "uniform mat4 mvp;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+    "}\n";
+
+static const char *lineFragmentShader =
+    "#version 330\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    finalColor = colDiffuse;\n"
+    "}\n";
+
+LineMesh GenLineMeshCube(void)
+{
+    static const float corners[8][3] = {
+        { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f },
+        { -0.5f, -0.5f,  0.5f }, { 0.5f, -0.5f,  0.5f }, { 0.5f, 0.5f,  0.5f }, { -0.5f, 0.5f,  0.5f }
+    };
+    static const unsigned int edges[12][2] = {
+        { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 },      // back face
+        { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 },      // front face
+        { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }       // sides
+    };
+    LineMesh mesh = { 0 };
+    mesh.vertices = RL_MALLOC(sizeof(corners));
+    mesh.indices = RL_MALLOC(sizeof(edges));
+    if (!mesh.vertices || !mesh.indices) { UnloadLineMesh(mesh); return (LineMesh){ 0 }; }
+    memcpy(mesh.vertices, corners, sizeof(corners));
+    memcpy(mesh.indices, edges, sizeof(edges));
+    mesh.vertexCount = 8;
+    mesh.lineCount = 12;
+    UploadLineMesh(&mesh);
+    return mesh;
+}
+
+LineMesh GenLineMeshCylinder(int slices)
+{
+    LineMesh mesh = { 0 };
+    if (slices < 3) slices = 3;
+    mesh.vertices = RL_MALLOC((size_t)2*slices*3*sizeof(float));
+    mesh.indices = RL_MALLOC((size_t)3*slices*2*sizeof(unsigned int));
+    if (!mesh.vertices || !mesh.indices) { UnloadLineMesh(mesh); return (LineMesh){ 0 }; }
+
+    // Bottom ring then top ring, placed like DrawCylinderWires() places them
+    for (int i = 0; i < slices; i++)
+    {
+        float angle = 2.0f*PI*(float)i/(float)slices;
+        float *bottom = &mesh.vertices[3*i], *top = &mesh.vertices[3*(slices + i)];
+        bottom[0] = top[0] = sinf(angle);
+        bottom[1] = 0.0f;
+        top[1] = 1.0f;
+        bottom[2] = top[2] = cosf(angle);
+    }
+    unsigned int *line = mesh.indices;
+    for (int i = 0; i < slices; i++)
+    {
+        unsigned int next = (unsigned int)((i + 1)%slices), n = (unsigned int)slices;
+        *line++ = (unsigned int)i;     *line++ = next;                    // bottom
+        *line++ = n + (unsigned int)i; *line++ = n + next;                // top
+        *line++ = (unsigned int)i;     *line++ = n + (unsigned int)i;     // side
+    }
+    mesh.vertexCount = 2*slices;
+    mesh.lineCount = 3*slices;
+    UploadLineMesh(&mesh);
+    return mesh;
+}
+
+/* ── unique edges ──────────────────────────────────────────────────── */
+// Loaded models usually come unindexed (three vertices per triangle), so
+// corners are welded by exact position first, then each edge between two
+// welded corners is kept once however many triangles share it.
+typedef struct EdgeBuilder {
+    LineMesh mesh;
+    int vertexCapacity, lineCapacity;
+    int *vertexSlots;            // open addressing, index into mesh.vertices or -1
+    uint64_t *edgeSlots;         // (lower << 32 | higher) + 1, 0 when empty
+    unsigned int vertexMask, edgeMask;
+} EdgeBuilder;
+
+static unsigned int HashBits(uint64_t x)
+{
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return (unsigned int)x;
+}
+
+static unsigned int TableSize(int entries)
+{
+    unsigned int size = 64;
+    while (size < 2u*(unsigned int)entries) size *= 2;
+    return size;
+}
+
+static int WeldVertex(EdgeBuilder *b, const float *v)
+{
+    float p[3] = { v[0] + 0.0f, v[1] + 0.0f, v[2] + 0.0f };      // -0 welds with 0
+    uint32_t bits[3];
+    memcpy(bits, p, sizeof(bits));
+    unsigned int slot = HashBits(((uint64_t)bits[0] << 32 | bits[1]) ^ ((uint64_t)bits[2]*0x9e3779b97f4a7c15ull)) & b->vertexMask;
+    for (;; slot = (slot + 1) & b->vertexMask)
+    {
+        int index = b->vertexSlots[slot];
+        if (index < 0) break;
+        if (memcmp(b->mesh.vertices + 3*index, p, sizeof(p)) == 0) return index;
+    }
+    int index = b->mesh.vertexCount++;
+    memcpy(b->mesh.vertices + 3*index, p, sizeof(p));
+    b->vertexSlots[slot] = index;
+    return index;
+}
+
+static void AddEdge(EdgeBuilder *b, unsigned int i, unsigned int j)
+{
+    if (i == j) return;                                       // degenerate triangle
+    if (i > j) { unsigned int t = i; i = j; j = t; }
+    uint64_t key = ((uint64_t)i << 32 | j) + 1;
+    unsigned int slot = HashBits(key) & b->edgeMask;
+    for (; b->edgeSlots[slot] != 0; slot = (slot + 1) & b->edgeMask)
+        if (b->edgeSlots[slot] == key) return;
+    b->edgeSlots[slot] = key;
+    b->mesh.indices[2*b->mesh.lineCount] = i;
+    b->mesh.indices[2*b->mesh.lineCount + 1] = j;
+    b->mesh.lineCount++;
+}
+
+static void AddMeshEdges(EdgeBuilder *b, Mesh mesh)
+{
+    int corners = (mesh.indices != NULL) ? 3*mesh.triangleCount : mesh.vertexCount - mesh.vertexCount%3;
+    int welded[3];
+    for (int c = 0; c < corners; c++)
+    {
+        int vertex = (mesh.indices != NULL) ? mesh.indices[c] : c;
+        welded[c%3] = WeldVertex(b, mesh.vertices + 3*vertex);
+        if (c%3 != 2) continue;
+        AddEdge(b, (unsigned int)welded[0], (unsigned int)welded[1]);
+        AddEdge(b, (unsigned int)welded[1], (unsigned int)welded[2]);
+        AddEdge(b, (unsigned int)welded[2], (unsigned int)welded[0]);
+    }
+}
+
+LineMesh GenLineMeshFromModel(Model model)
+{
+    // Sized for the worst case: every corner distinct, no edge shared
+    EdgeBuilder b = { 0 };
+    for (int m = 0; m < model.meshCount; m++)
+    {
+        if (model.meshes[m].vertices == NULL) continue;
+        int corners = (model.meshes[m].indices != NULL) ? 3*model.meshes[m].triangleCount : model.meshes[m].vertexCount;
+        b.vertexCapacity += corners;
+        b.lineCapacity += corners;
+    }
+    if (b.lineCapacity == 0) return (LineMesh){ 0 };
+
+    unsigned int vertexTable = TableSize(b.vertexCapacity), edgeTable = TableSize(b.lineCapacity);
+    b.vertexMask = vertexTable - 1;
+    b.edgeMask = edgeTable - 1;
+    b.vertexSlots = RL_MALLOC(vertexTable*sizeof(int));
+    b.edgeSlots = RL_CALLOC(edgeTable, sizeof(uint64_t));
+    b.mesh.vertices = RL_MALLOC((size_t)b.vertexCapacity*3*sizeof(float));
+    b.mesh.indices = RL_MALLOC((size_t)b.lineCapacity*2*sizeof(unsigned int));
+    if (!b.vertexSlots || !b.edgeSlots || !b.mesh.vertices || !b.mesh.indices)
+    {
+        RL_FREE(b.vertexSlots);
+        RL_FREE(b.edgeSlots);
+        UnloadLineMesh(b.mesh);
+        return (LineMesh){ 0 };
+    }
+    memset(b.vertexSlots, 0xff, vertexTable*sizeof(int));
+
+    for (int m = 0; m < model.meshCount; m++)
+        if (model.meshes[m].vertices != NULL) AddMeshEdges(&b, model.meshes[m]);
+    RL_FREE(b.vertexSlots);
+    RL_FREE(b.edgeSlots);
+
+    // Give back what welding and sharing saved
+    float *vertices = RL_REALLOC(b.mesh.vertices, (size_t)b.mesh.vertexCount*3*sizeof(float) + 1);
+    unsigned int *indices = RL_REALLOC(b.mesh.indices, (size_t)b.mesh.lineCount*2*sizeof(unsigned int) + 1);
+    if (vertices) b.mesh.vertices = vertices;
+    if (indices) b.mesh.indices = indices;
+
+    UploadLineMesh(&b.mesh);
+    return b.mesh;
+}
+
+LineMesh GenLineMeshFromMesh(Mesh mesh)
+{
+    Model model = { 0 };
+    model.meshCount = 1;
+    model.meshes = &mesh;
+    return GenLineMeshFromModel(model);
+}
+
+/* ── GPU ───────────────────────────────────────────────────────────── */
+void UploadLineMesh(LineMesh *mesh)
+{
+    if (mesh->vaoId > 0 || mesh->lineCount == 0) return;
+#if defined(LINE_MESH_GL)
+    mesh->vaoId = rlLoadVertexArray();
+    if (mesh->vaoId == 0) return;
+    rlEnableVertexArray(mesh->vaoId);
+    mesh->vboId = rlLoadVertexBuffer(mesh->vertices, mesh->vertexCount*3*(int)sizeof(float), false);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+    mesh->eboId = rlLoadVertexBufferElement(mesh->indices, mesh->lineCount*2*(int)sizeof(unsigned int), false);
+    rlDisableVertexArray();
+#endif
+}
+
+void UnloadLineMesh(LineMesh mesh)
+{
+    if (mesh.vaoId > 0)
+    {
+        rlUnloadVertexArray(mesh.vaoId);
+        rlUnloadVertexBuffer(mesh.vboId);
+        rlUnloadVertexBuffer(mesh.eboId);
+    }
+    RL_FREE(mesh.vertices);
+    RL_FREE(mesh.indices);
+}
+
+Shader LoadLineShader(void)
+{
+    return LoadShaderFromMemory(lineVertexShader, lineFragmentShader);
+}
+
+void DrawLineMeshElements(LineMesh mesh, int instances)
+{
+#if defined(LINE_MESH_GL)
+    rlEnableVertexArray(mesh.vaoId);
+    if (instances > 0) glDrawElementsInstanced(GL_LINES, mesh.lineCount*2, GL_UNSIGNED_INT, 0, instances);
+    else glDrawElements(GL_LINES, mesh.lineCount*2, GL_UNSIGNED_INT, 0);
+    rlDisableVertexArray();
+#else
+    (void)mesh; (void)instances;
+#endif
+}
+
+void DrawLineMesh(LineMesh mesh, Shader shader, Matrix transform, Color color)
+{
+    if (mesh.vaoId == 0)
+    {
+        // No vertex arrays: push the lines through the immediate mode batch
+        rlBegin(RL_LINES);
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        for (int i = 0; i < 2*mesh.lineCount; i++)
+        {
+            const float *v = mesh.vertices + 3*mesh.indices[i];
+            Vector3 p = Vector3Transform((Vector3){ v[0], v[1], v[2] }, transform);
+            rlVertex3f(p.x, p.y, p.z);
+        }
+        rlEnd();
+        return;
+    }
+
+    // Same matrices DrawMesh() uses
+    Matrix model = MatrixMultiply(transform, rlGetMatrixTransform());
+    Matrix mvp = MatrixMultiply(MatrixMultiply(model, rlGetMatrixModelview()), rlGetMatrixProjection());
+    float tint[4] = { color.r/255.0f, color.g/255.0f, color.b/255.0f, color.a/255.0f };
+
+    rlEnableShader(shader.id);
+    rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], tint, RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], mvp);
+    DrawLineMeshElements(mesh, 0);
+    rlDisableShader();
+}
+
+void DrawLineMeshModel(LineMesh mesh, Shader shader, Model model, Vector3 position, float scale, Color color)
+{
+    // Same transform DrawModelEx() builds, without rotation
+    Matrix placement = MatrixMultiply(MatrixScale(scale, scale, scale), MatrixTranslate(position.x, position.y, position.z));
+    DrawLineMesh(mesh, shader, MatrixMultiply(model.transform, placement), color);
+}
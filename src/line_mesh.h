@@ -0,0 +1,43 @@
+// line_mesh.h - indexed line meshes
+//
+// raylib only draws meshes as triangles, so wireframes go through rlgl's
+// immediate mode (DrawCubeWires, DrawModelWires) and are rebuilt every frame.
+// A LineMesh keeps its vertices and line indices on the GPU and draws them
+// as GL_LINES in one call. The CPU copy stays around for building and for
+// drawing in immediate mode on OpenGL versions without vertex arrays.
+#ifndef LINE_MESH_H
+#define LINE_MESH_H
+
+#include "raylib.h"
+
+typedef struct LineMesh {
+    int vertexCount;
+    int lineCount;
+    float *vertices;             // x, y, z per vertex
+    unsigned int *indices;       // 2 per line
+
+    unsigned int vaoId;          // 0 until uploaded
+    unsigned int vboId;
+    unsigned int eboId;
+} LineMesh;
+
+LineMesh GenLineMeshCube(void);                        // 12 edges of a unit cube centered on the origin
+LineMesh GenLineMeshCylinder(int slices);              // Radius 1, height 1, base on the origin, as DrawCylinderWires()
+
+// Wireframe of a model's triangles, every edge once. DrawModelWires draws
+// each triangle in line mode, so edges shared by two triangles go out twice
+// and the whole model is submitted again; this is built once at load and
+// drawn in a single call.
+LineMesh GenLineMeshFromModel(Model model);            // All meshes merged, positions welded
+LineMesh GenLineMeshFromMesh(Mesh mesh);
+void UploadLineMesh(LineMesh *mesh);
+void UnloadLineMesh(LineMesh mesh);
+
+Shader LoadLineShader(void);                           // Plain color shader for DrawLineMesh()
+void DrawLineMesh(LineMesh mesh, Shader shader, Matrix transform, Color color);
+void DrawLineMeshModel(LineMesh mesh, Shader shader, Model model, Vector3 position, float scale, Color color);  // Placed like DrawModelWires()
+
+// Low level: issue the draw for the bound shader, instances 0 for a plain draw
+void DrawLineMeshElements(LineMesh mesh, int instances);
+
+#endif // LINE_MESH_H
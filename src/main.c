@@ -1,55 +1,154 @@
 /*
-Raylib example file.
-This is an example main file for a simple raylib project.
-Use this as a starting point or replace it with your code.
+Scene host: one window, one frame loop, the demos as scenes (see scene.h).
 
-by Jeffery Myers is marked with CC0 1.0. To view a copy of this license, visit https://creativecommons.org/publicdomain/zero/1.0/
+    app [-bench] [scene] [arguments for the scene]
 
+Without a scene name the bedroom starts, and arguments that aren't a scene
+name go to it: `app my_level.json` works as before. -bench runs the scene's
+headless benchmark instead of opening the window. [Tab] / [Shift+Tab]
+switch scenes while running.
+
+Based on the raylib quickstart example by Jeffery Myers, CC0 1.0.
 */
-/* 
+#include <stdio.h>
+#include <string.h>
 #include "raylib.h"
-
+#include "scene.h"
+#include "assets.h"
+#include "hud.h"
 #include "resource_dir.h"	// utility header for SearchAndSetResourceDir
 
-int main ()
+#define MAX_FILE_ARGS 8
+
+static const Scene *scenes[] = {
+    &BedroomScene, &BedScene, &ColumnsScene, &CylinderScene, &CrowdScene, &CubeScene
+};
+#define SCENE_COUNT ((int)(sizeof(scenes)/sizeof(scenes[0])))
+
+static int FindScene(const char *name)
+{
+    for (int s = 0; s < SCENE_COUNT; s++)
+        if (strcmp(scenes[s]->name, name) == 0) return s;
+    return -1;
+}
+
+/* Loads are measured apart from the rest so the overlay can tell a switch
+   that had to load something from one that found it all resident */
+typedef struct SceneSwitch {
+    double ms;                   // unload, resize and init, CPU
+    double loadMs;               // of which loading shared assets
+    int loads;
+    int reuses;
+} SceneSwitch;
+
+static bool StartScene(const Scene *scene, int argc, char **argv, SceneSwitch *timing)
+{
+    AssetStats before = GetAssetStats();
+    double start = GetTime();
+    if (GetScreenWidth() != scene->width || GetScreenHeight() != scene->height) SetWindowSize(scene->width, scene->height);
+    SetWindowTitle(scene->title);
+    bool started = scene->init(argc, argv);
+    AssetStats after = GetAssetStats();
+    timing->ms = (GetTime() - start)*1000.0;
+    timing->loadMs = after.loadMs - before.loadMs;
+    timing->loads = after.loads - before.loads;
+    timing->reuses = after.reuses - before.reuses;
+    return started;
+}
+
+int main(int argc, char **argv)
 {
-	// Tell the window to use vsync and work on high DPI displays
-	SetConfigFlags(FLAG_VSYNC_HINT | FLAG_WINDOW_HIGHDPI);
-
-	// Create the window and OpenGL context
-	InitWindow(1280, 800, "Hello Raylib");
-
-	// Utility function from resource_dir.h to find the resources folder and set it as the current working directory so we can load from it
-	SearchAndSetResourceDir("resources");
-
-	// Load a texture from the resources directory
-	Texture wabbit = LoadTexture("wabbit_alpha.png");
-	
-	// game loop
-	while (!WindowShouldClose())		// run the loop untill the user presses ESCAPE or presses the Close button on the window
-	{
-		// drawing
-		BeginDrawing();
-
-		// Setup the back buffer for drawing (clear color and depth buffers)
-		ClearBackground(BLACK);
-
-		// draw some text using the default font
-		DrawText("Hello Raylib", 200,200,20,WHITE);
-
-		// draw our texture to the screen
-		DrawTexture(wabbit, 400, 200, WHITE);
-		
-		// end the frame and get ready for the next one  (display frame, poll input, etc...)
-		EndDrawing();
-	}
-
-	// cleanup
-	// unload our texture so it can be cleaned up
-	UnloadTexture(wabbit);
-
-	// destroy the window and cleanup the OpenGL context
-	CloseWindow();
-	return 0;
+    bool bench = (argc > 1 && strcmp(argv[1], "-bench") == 0);
+    int first = bench ? 2 : 1;
+    int current = (argc > first) ? FindScene(argv[first]) : -1;
+    if (current >= 0) first++;
+    else current = 0;
+    const int named = current;                   // gets the arguments whenever it starts
+    int sceneArgc = argc - first;
+    char **sceneArgv = argv + first;
+
+    // Assets load from the resources folder, files named on the command
+    // line are kept where they were given
+    static char files[MAX_FILE_ARGS][1024];
+    for (int a = 0; a < sceneArgc && a < MAX_FILE_ARGS; a++)
+    {
+        const char *arg = sceneArgv[a];
+        if (arg[0] == '/' || arg[0] == '\\' || (arg[0] != '\0' && arg[1] == ':') || !FileExists(arg)) continue;
+        snprintf(files[a], sizeof(files[a]), "%s/%s", GetWorkingDirectory(), arg);
+        sceneArgv[a] = files[a];
+    }
+    SearchAndSetResourceDir("resources");
+
+    if (bench)
+    {
+        if (!scenes[current]->bench) { fprintf(stderr, "%s has no benchmark\n", scenes[current]->name); return 1; }
+        scenes[current]->bench(sceneArgc, sceneArgv);
+        return 0;
+    }
+
+    // VSync for the bedroom's frame pacer, the other scenes cap at 60 FPS anyway
+    SetConfigFlags(FLAG_VSYNC_HINT);
+    InitWindow(scenes[current]->width, scenes[current]->height, scenes[current]->title);
+
+    SceneSwitch timing = { 0 };
+    if (!StartScene(scenes[current], sceneArgc, sceneArgv, &timing))
+    {
+        TraceLog(LOG_ERROR, "SCENE: %s didn't start", scenes[current]->name);
+        UnloadAssets();
+        CloseWindow();
+        return 1;
+    }
+
+    // The overlay gets its own retained HUD along the bottom, loaded again
+    // when a scene resizes the window
+    Hud hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    int hudScene = AddHudLine(&hud, 10, GetScreenHeight() - 20, 10, DARKGRAY);
+
+    while (!WindowShouldClose())
+    {
+        if (IsKeyPressed(KEY_TAB))
+        {
+            int step = (IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT)) ? SCENE_COUNT - 1 : 1;
+            int next = (current + step) % SCENE_COUNT;
+            double start = GetTime();
+            scenes[current]->unload();
+            double unloadMs = (GetTime() - start)*1000.0;
+
+            // A scene that can't start is skipped for the one after it
+            int tries = 0;
+            while (!StartScene(scenes[next], (next == named) ? sceneArgc : 0, (next == named) ? sceneArgv : NULL, &timing) &&
+                   ++tries < SCENE_COUNT)
+            {
+                TraceLog(LOG_WARNING, "SCENE: %s didn't start, skipping it", scenes[next]->name);
+                next = (next + step) % SCENE_COUNT;
+            }
+            if (tries == SCENE_COUNT) { current = -1; break; }
+            timing.ms += unloadMs;
+            current = next;
+            TraceLog(LOG_INFO, "SCENE: Switched to %s in %.2f ms (%d assets loaded in %.2f ms, %d resident reused)",
+                scenes[current]->name, timing.ms, timing.loads, timing.loadMs, timing.reuses);
+
+            if (hud.target.texture.width != GetScreenWidth() || hud.target.texture.height != GetScreenHeight())
+            {
+                UnloadHud(&hud);
+                hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+                hudScene = AddHudLine(&hud, 10, GetScreenHeight() - 20, 10, DARKGRAY);
+            }
+        }
+
+        scenes[current]->update();
+
+        BeginDrawing();
+        scenes[current]->draw();
+        SetHudLineF(&hud, hudScene, "Scene [Tab] %d/%d: %s, switched in %.2f ms, %d assets loaded (%.2f ms), %d reused",
+            current + 1, SCENE_COUNT, scenes[current]->name, timing.ms, timing.loads, timing.loadMs, timing.reuses);
+        DrawHud(&hud);
+        EndDrawing();
+    }
+
+    if (current >= 0) scenes[current]->unload();
+    UnloadHud(&hud);
+    UnloadAssets();
+    CloseWindow();
+    return 0;
 }
-*/
\ No newline at end of file
@@ -0,0 +1,93 @@
+// obstacles.c - column and box obstacles as entities (see obstacles.h)
+#include "obstacles.h"
+
+#include <math.h>
+
+Obstacles LoadObstacles(void)
+{
+    Obstacles obstacles = { 0 };
+    obstacles.world = CreateWorld();
+    if (!obstacles.world) return obstacles;
+    obstacles.position = RegisterComponent(obstacles.world, sizeof(Vector3));
+    obstacles.cylinder = RegisterComponent(obstacles.world, sizeof(CylinderShape));
+    obstacles.box = RegisterComponent(obstacles.world, sizeof(BoxShape));
+    obstacles.color = RegisterComponent(obstacles.world, sizeof(Color));
+    return obstacles;
+}
+
+void UnloadObstacles(Obstacles *obstacles)
+{
+    DestroyWorld(obstacles->world);
+    *obstacles = (Obstacles){ 0 };
+}
+
+Entity AddCylinderObstacle(Obstacles *obstacles, Vector3 position, float radius, float height, Color color, ComponentMask tags)
+{
+    if (!obstacles->world) return ENTITY_NONE;
+    Entity entity = CreateEntity(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->cylinder) |
+                                                   ComponentBit(obstacles->color) | tags);
+    if (!IsEntityAlive(obstacles->world, entity)) return entity;
+    *(Vector3 *)GetComponent(obstacles->world, entity, obstacles->position) = position;
+    *(CylinderShape *)GetComponent(obstacles->world, entity, obstacles->cylinder) = (CylinderShape){ radius, height };
+    *(Color *)GetComponent(obstacles->world, entity, obstacles->color) = color;
+    return entity;
+}
+
+Entity AddBoxObstacle(Obstacles *obstacles, Vector3 position, Vector3 size, Color color, ComponentMask tags)
+{
+    if (!obstacles->world) return ENTITY_NONE;
+    Entity entity = CreateEntity(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->box) |
+                                                   ComponentBit(obstacles->color) | tags);
+    if (!IsEntityAlive(obstacles->world, entity)) return entity;
+    *(Vector3 *)GetComponent(obstacles->world, entity, obstacles->position) = position;
+    *(BoxShape *)GetComponent(obstacles->world, entity, obstacles->box) = (BoxShape){ size };
+    *(Color *)GetComponent(obstacles->world, entity, obstacles->color) = color;
+    return entity;
+}
+
+int AddCylinderObstacleInstances(const Obstacles *obstacles, CylinderRenderer *cylinders, const Frustum *frustum, ComponentMask none)
+{
+    if (!obstacles->world) return 0;
+    int submitted = 0;
+    EcsQuery query = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->cylinder) |
+                                                  ComponentBit(obstacles->color), none);
+    while (NextQueryChunk(&query))
+    {
+        const Vector3 *positions = GetQueryColumn(&query, obstacles->position);
+        const CylinderShape *shapes = GetQueryColumn(&query, obstacles->cylinder);
+        const Color *colors = GetQueryColumn(&query, obstacles->color);
+        for (int i = 0; i < query.count; i++)
+        {
+            float halfHeight = shapes[i].height*0.5f;
+            if (frustum && !IsSphereInFrustum(frustum, positions[i], sqrtf(shapes[i].radius*shapes[i].radius + halfHeight*halfHeight))) continue;
+            AddCylinderInstance(cylinders, positions[i], shapes[i].radius, shapes[i].height, colors[i]);
+            submitted++;
+        }
+    }
+    return submitted;
+}
+
+int DrawBoxObstacles(const Obstacles *obstacles, const Frustum *frustum, Color wireColor, ComponentMask none)
+{
+    if (!obstacles->world) return 0;
+    int drawn = 0;
+    EcsQuery query = QueryWorld(obstacles->world, ComponentBit(obstacles->position) | ComponentBit(obstacles->box) |
+                                                  ComponentBit(obstacles->color), none);
+    while (NextQueryChunk(&query))
+    {
+        const Vector3 *positions = GetQueryColumn(&query, obstacles->position);
+        const BoxShape *shapes = GetQueryColumn(&query, obstacles->box);
+        const Color *colors = GetQueryColumn(&query, obstacles->color);
+        for (int i = 0; i < query.count; i++)
+        {
+            Vector3 half = { shapes[i].size.x*0.5f, shapes[i].size.y*0.5f, shapes[i].size.z*0.5f };
+            BoundingBox bounds = { { positions[i].x - half.x, positions[i].y - half.y, positions[i].z - half.z },
+                                   { positions[i].x + half.x, positions[i].y + half.y, positions[i].z + half.z } };
+            if (frustum && !IsBoxInFrustum(frustum, bounds)) continue;
+            DrawCubeV(positions[i], shapes[i].size, colors[i]);
+            DrawCubeWiresV(positions[i], shapes[i].size, wireColor);
+            drawn++;
+        }
+    }
+    return drawn;
+}
@@ -0,0 +1,49 @@
+// obstacles.h - column and box obstacles as entities
+//
+// The demos' obstacles used to be parallel arrays with a fixed cap, one set
+// per shape. Now each obstacle is an entity (ecs.h) with a position, a
+// shape and a color component: columns and boxes are two archetypes, so the
+// collision, culling and drawing loops each walk the columns they read
+// chunk by chunk, and there's no cap but memory.
+//
+// Positions are where the old arrays had them: the middle of the box, and
+// for columns what DrawCylinder() is given. Extra tag components (size 0)
+// can be added when spawning to sort obstacles into their own archetype.
+#ifndef OBSTACLES_H
+#define OBSTACLES_H
+
+#include "raylib.h"
+#include "ecs.h"
+#include "frustum.h"
+#include "instancing.h"
+
+typedef struct CylinderShape {
+    float radius;
+    float height;
+} CylinderShape;
+
+typedef struct BoxShape {
+    Vector3 size;
+} BoxShape;
+
+typedef struct Obstacles {
+    EcsWorld *world;
+    ComponentId position;        // Vector3
+    ComponentId cylinder;        // CylinderShape
+    ComponentId box;             // BoxShape
+    ComponentId color;           // Color
+} Obstacles;
+
+Obstacles LoadObstacles(void);
+void UnloadObstacles(Obstacles *obstacles);
+
+Entity AddCylinderObstacle(Obstacles *obstacles, Vector3 position, float radius, float height, Color color, ComponentMask tags);
+Entity AddBoxObstacle(Obstacles *obstacles, Vector3 position, Vector3 size, Color color, ComponentMask tags);
+
+// Render systems, inside BeginMode3D(). A NULL frustum draws everything,
+// obstacles with any of the none components are skipped. Return how many
+// were submitted.
+int AddCylinderObstacleInstances(const Obstacles *obstacles, CylinderRenderer *cylinders, const Frustum *frustum, ComponentMask none);
+int DrawBoxObstacles(const Obstacles *obstacles, const Frustum *frustum, Color wireColor, ComponentMask none);
+
+#endif // OBSTACLES_H
@@ -0,0 +1,342 @@
+// occlusion.c - occlusion culling with a software depth buffer (see occlusion.h)
+#include "occlusion.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+
+#if !defined(OCCLUSION_DISABLE_SIMD)
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OCCLUSION_SIMD_SSE
+#endif
+#endif
+
+// Corner c of a box takes max on axis a when bit a of c is set, triangles are
+// counter-clockwise seen from outside (same as static_batch.c)
+static const unsigned char boxTriangles[12][3] = {
+    { 0, 2, 1 }, { 1, 2, 3 },    // -Z
+    { 4, 5, 6 }, { 5, 7, 6 },    // +Z
+    { 0, 4, 2 }, { 2, 4, 6 },    // -X
+    { 1, 3, 5 }, { 3, 7, 5 },    // +X
+    { 0, 1, 4 }, { 1, 5, 4 },    // -Y
+    { 2, 6, 3 }, { 3, 6, 7 }     // +Y
+};
+
+// x, y, w in clip space, d the distance to the far plane (w - z): d/w is
+// 1 - ndc z, linear on screen and larger for nearer points, for perspective
+// and orthographic projections alike
+typedef struct ClipVertex {
+    float x, y, w, d;
+} ClipVertex;
+
+static ClipVertex ToClip(Matrix m, float x, float y, float z)
+{
+    ClipVertex v;
+    v.x = m.m0*x + m.m4*y + m.m8*z + m.m12;
+    v.y = m.m1*x + m.m5*y + m.m9*z + m.m13;
+    v.w = m.m3*x + m.m7*y + m.m11*z + m.m15;
+    v.d = (m.m3 - m.m2)*x + (m.m7 - m.m6)*y + (m.m11 - m.m10)*z + (m.m15 - m.m14);
+    return v;
+}
+
+static void BoxCorners(Matrix m, BoundingBox box, ClipVertex corners[8])
+{
+    for (int c = 0; c < 8; c++)
+        corners[c] = ToClip(m, (c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z);
+}
+
+OcclusionBuffer LoadOcclusionBuffer(int width, int height, JobSystem *jobs)
+{
+    OcclusionBuffer buffer = { 0 };
+    if (width <= 0 || height <= 0) return buffer;
+    buffer.tilesX = (width + OCCLUSION_TILE_WIDTH - 1)/OCCLUSION_TILE_WIDTH;
+    buffer.tilesY = (height + OCCLUSION_TILE_HEIGHT - 1)/OCCLUSION_TILE_HEIGHT;
+    buffer.width = buffer.tilesX*OCCLUSION_TILE_WIDTH;
+    buffer.height = buffer.tilesY*OCCLUSION_TILE_HEIGHT;
+    buffer.blocksX = buffer.width/OCCLUSION_BLOCK_SIZE;
+    buffer.blocksY = buffer.height/OCCLUSION_BLOCK_SIZE;
+    buffer.depth = RL_CALLOC((size_t)buffer.width*buffer.height, sizeof(float));
+    buffer.blockDepth = RL_CALLOC((size_t)buffer.blocksX*buffer.blocksY, sizeof(float));
+    buffer.jobs = jobs;
+    if (!buffer.depth || !buffer.blockDepth) UnloadOcclusionBuffer(&buffer);
+    return buffer;
+}
+
+void UnloadOcclusionBuffer(OcclusionBuffer *buffer)
+{
+    RL_FREE(buffer->depth);
+    RL_FREE(buffer->blockDepth);
+    RL_FREE(buffer->triangles);
+    *buffer = (OcclusionBuffer){ 0 };
+}
+
+void BeginOcclusion(OcclusionBuffer *buffer, Matrix viewProjection)
+{
+    buffer->viewProjection = viewProjection;
+    buffer->triangleCount = 0;
+    buffer->stats = (OcclusionStats){ 0 };
+}
+
+/* ── triangle setup ────────────────────────────────────────────────── */
+static void AddScreenTriangle(OcclusionBuffer *buffer, const ClipVertex *v0, const ClipVertex *v1, const ClipVertex *v2)
+{
+    float x[3], y[3], z[3];
+    const ClipVertex *v[3] = { v0, v1, v2 };
+    for (int i = 0; i < 3; i++)
+    {
+        float invW = 1.0f/v[i]->w;
+        x[i] = (0.5f + 0.5f*v[i]->x*invW)*buffer->width;
+        y[i] = (0.5f - 0.5f*v[i]->y*invW)*buffer->height;           // rows go down
+        z[i] = v[i]->d*invW;
+    }
+
+    // Counter-clockwise in NDC is clockwise once rows go down: front faces
+    // have a negative area here. Swap two corners so inside is positive.
+    float area = (x[1] - x[0])*(y[2] - y[0]) - (x[2] - x[0])*(y[1] - y[0]);
+    if (!(area < 0.0f)) return;                                        // back facing or degenerate
+    float t;
+    t = x[1]; x[1] = x[2]; x[2] = t;
+    t = y[1]; y[1] = y[2]; y[2] = t;
+    t = z[1]; z[1] = z[2]; z[2] = t;
+    area = -area;
+
+    float minX = fminf(x[0], fminf(x[1], x[2])), maxX = fmaxf(x[0], fmaxf(x[1], x[2]));
+    float minY = fminf(y[0], fminf(y[1], y[2])), maxY = fmaxf(y[0], fmaxf(y[1], y[2]));
+    if (maxX < 0.0f || maxY < 0.0f || minX > (float)buffer->width || minY > (float)buffer->height) return;
+
+    if (buffer->triangleCount == buffer->triangleCapacity)
+    {
+        int capacity = (buffer->triangleCapacity > 0) ? 2*buffer->triangleCapacity : 256;
+        OcclusionTriangle *grown = RL_REALLOC(buffer->triangles, (size_t)capacity*sizeof(OcclusionTriangle));
+        if (!grown) return;
+        buffer->triangles = grown;
+        buffer->triangleCapacity = capacity;
+    }
+    OcclusionTriangle *tri = &buffer->triangles[buffer->triangleCount++];
+    for (int i = 0; i < 3; i++)
+    {
+        int j = (i + 1)%3;
+        tri->a[i] = -(y[j] - y[i]);
+        tri->b[i] = x[j] - x[i];
+        tri->c[i] = -(tri->a[i]*x[i] + tri->b[i]*y[i]);
+    }
+    tri->zx = ((z[1] - z[0])*(y[2] - y[0]) - (z[2] - z[0])*(y[1] - y[0]))/area;
+    tri->zy = ((z[2] - z[0])*(x[1] - x[0]) - (z[1] - z[0])*(x[2] - x[0]))/area;
+    tri->z0 = z[0] - tri->zx*x[0] - tri->zy*y[0];
+    tri->minX = (minX > 0.0f) ? (int)minX : 0;
+    tri->minY = (minY > 0.0f) ? (int)minY : 0;
+    tri->maxX = (maxX < (float)buffer->width) ? (int)maxX : buffer->width - 1;
+    tri->maxY = (maxY < (float)buffer->height) ? (int)maxY : buffer->height - 1;
+    buffer->stats.triangles++;
+}
+
+static ClipVertex LerpClip(ClipVertex a, ClipVertex b, float t)
+{
+    return (ClipVertex){ a.x + (b.x - a.x)*t, a.y + (b.y - a.y)*t, a.w + (b.w - a.w)*t, a.d + (b.d - a.d)*t };
+}
+
+// Clips against w >= OCCLUSION_NEAR_W, which leaves a triangle or a quad
+static void AddClipTriangle(OcclusionBuffer *buffer, ClipVertex v0, ClipVertex v1, ClipVertex v2)
+{
+    ClipVertex in[3] = { v0, v1, v2 }, out[4];
+    int count = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        ClipVertex a = in[i], b = in[(i + 1)%3];
+        bool aInside = (a.w >= OCCLUSION_NEAR_W), bInside = (b.w >= OCCLUSION_NEAR_W);
+        if (aInside) out[count++] = a;
+        if (aInside != bInside) out[count++] = LerpClip(a, b, (OCCLUSION_NEAR_W - a.w)/(b.w - a.w));
+    }
+    if (count >= 3) AddScreenTriangle(buffer, &out[0], &out[1], &out[2]);
+    if (count == 4) AddScreenTriangle(buffer, &out[0], &out[2], &out[3]);
+}
+
+void AddOccluderBox(OcclusionBuffer *buffer, BoundingBox box)
+{
+    ClipVertex corners[8];
+    BoxCorners(buffer->viewProjection, box, corners);
+    for (int t = 0; t < 12; t++)
+        AddClipTriangle(buffer, corners[boxTriangles[t][0]], corners[boxTriangles[t][1]], corners[boxTriangles[t][2]]);
+    buffer->stats.occluders++;
+}
+
+int AddLargestOccluders(OcclusionBuffer *buffer, const float *const bounds[6], const uint32_t *candidates,
+                        uint32_t candidateCount, Vector3 eye, int maxOccluders)
+{
+    if (maxOccluders > OCCLUSION_MAX_OCCLUDERS) maxOccluders = OCCLUSION_MAX_OCCLUDERS;
+    uint32_t best[OCCLUSION_MAX_OCCLUDERS];
+    float bestScore[OCCLUSION_MAX_OCCLUDERS];
+    int bestCount = 0;
+
+    // Sorted insertion, the list is short and most candidates lose at once
+    for (uint32_t c = 0; c < candidateCount; c++)
+    {
+        uint32_t i = candidates[c];
+        float lo[3] = { bounds[0][i], bounds[1][i], bounds[2][i] }, hi[3] = { bounds[3][i], bounds[4][i], bounds[5][i] };
+        if (eye.x >= lo[0] && eye.x <= hi[0] && eye.y >= lo[1] && eye.y <= hi[1] && eye.z >= lo[2] && eye.z <= hi[2]) continue;
+
+        float dx = hi[0] - lo[0], dy = hi[1] - lo[1], dz = hi[2] - lo[2];
+        float cx = 0.5f*(lo[0] + hi[0]) - eye.x, cy = 0.5f*(lo[1] + hi[1]) - eye.y, cz = 0.5f*(lo[2] + hi[2]) - eye.z;
+        float score = (dx*dy + dy*dz + dz*dx)/fmaxf(cx*cx + cy*cy + cz*cz, 1e-4f);
+        if (bestCount == maxOccluders && !(score > bestScore[bestCount - 1])) continue;
+
+        int k = (bestCount < maxOccluders) ? bestCount++ : bestCount - 1;
+        for (; k > 0 && bestScore[k - 1] < score; k--) { best[k] = best[k - 1]; bestScore[k] = bestScore[k - 1]; }
+        best[k] = i;
+        bestScore[k] = score;
+    }
+
+    for (int k = 0; k < bestCount; k++)
+    {
+        uint32_t i = best[k];
+        AddOccluderBox(buffer, (BoundingBox){ { bounds[0][i], bounds[1][i], bounds[2][i] }, { bounds[3][i], bounds[4][i], bounds[5][i] } });
+    }
+    return bestCount;
+}
+
+/* ── rasterization ─────────────────────────────────────────────────── */
+static void RasterizeTriangleRows(const OcclusionBuffer *buffer, const OcclusionTriangle *tri, int x0, int y0, int x1, int y1)
+{
+    // x0 and x1 are multiples of 4 (tile columns), pixels are sampled at their centers
+    for (int y = y0; y < y1; y++)
+    {
+        float *row = buffer->depth + (size_t)y*buffer->width;
+        float py = (float)y + 0.5f;
+#if defined(OCCLUSION_SIMD_SSE)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 steps = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        __m128 rowE[3], stepE[3];
+        for (int e = 0; e < 3; e++)
+        {
+            rowE[e] = _mm_set1_ps(tri->b[e]*py + tri->c[e]);
+            stepE[e] = _mm_set1_ps(tri->a[e]);
+        }
+        __m128 rowZ = _mm_set1_ps(tri->zy*py + tri->z0), stepZ = _mm_set1_ps(tri->zx);
+        for (int x = x0; x < x1; x += 4)
+        {
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)x), steps);
+            __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepE[0], px), rowE[0]), zero);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepE[1], px), rowE[1]), zero));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepE[2], px), rowE[2]), zero));
+            __m128 z = _mm_and_ps(inside, _mm_add_ps(_mm_mul_ps(stepZ, px), rowZ));   // 0 outside, never wins
+            _mm_storeu_ps(row + x, _mm_max_ps(_mm_loadu_ps(row + x), z));
+        }
+#else
+        for (int x = x0; x < x1; x++)
+        {
+            float px = (float)x + 0.5f;
+            bool inside = true;
+            for (int e = 0; e < 3; e++) inside = inside && (tri->a[e]*px + (tri->b[e]*py + tri->c[e]) >= 0.0f);
+            float z = tri->zx*px + (tri->zy*py + tri->z0);
+            if (inside && z > row[x]) row[x] = z;
+        }
+#endif
+    }
+}
+
+static void RasterizeTile(void *data, int tile)
+{
+    OcclusionBuffer *buffer = data;
+    int tx0 = (tile%buffer->tilesX)*OCCLUSION_TILE_WIDTH, ty0 = (tile/buffer->tilesX)*OCCLUSION_TILE_HEIGHT;
+    int tx1 = tx0 + OCCLUSION_TILE_WIDTH, ty1 = ty0 + OCCLUSION_TILE_HEIGHT;
+
+    for (int y = ty0; y < ty1; y++) memset(buffer->depth + (size_t)y*buffer->width + tx0, 0, OCCLUSION_TILE_WIDTH*sizeof(float));
+
+    for (int t = 0; t < buffer->triangleCount; t++)
+    {
+        const OcclusionTriangle *tri = &buffer->triangles[t];
+        if (tri->maxX < tx0 || tri->minX >= tx1 || tri->maxY < ty0 || tri->minY >= ty1) continue;
+        int x0 = (tri->minX > tx0) ? (tri->minX & ~3) : tx0;
+        int x1 = (tri->maxX + 1 < tx1) ? ((tri->maxX + 4) & ~3) : tx1;
+        int y0 = (tri->minY > ty0) ? tri->minY : ty0;
+        int y1 = (tri->maxY + 1 < ty1) ? tri->maxY + 1 : ty1;
+        RasterizeTriangleRows(buffer, tri, x0, y0, x1, y1);
+    }
+
+    // Farthest depth of the blocks in this tile
+    for (int by = ty0/OCCLUSION_BLOCK_SIZE; by < ty1/OCCLUSION_BLOCK_SIZE; by++)
+    {
+        for (int bx = tx0/OCCLUSION_BLOCK_SIZE; bx < tx1/OCCLUSION_BLOCK_SIZE; bx++)
+        {
+            float farthest = INFINITY;
+            for (int y = by*OCCLUSION_BLOCK_SIZE; y < (by + 1)*OCCLUSION_BLOCK_SIZE; y++)
+            {
+                const float *row = buffer->depth + (size_t)y*buffer->width;
+                for (int x = bx*OCCLUSION_BLOCK_SIZE; x < (bx + 1)*OCCLUSION_BLOCK_SIZE; x++) farthest = fminf(farthest, row[x]);
+            }
+            buffer->blockDepth[(size_t)by*buffer->blocksX + bx] = farthest;
+        }
+    }
+}
+
+void RasterizeOccluders(OcclusionBuffer *buffer)
+{
+    if (!buffer->depth) return;
+    double start = NowMs();
+    RunJobs(buffer->jobs, RasterizeTile, buffer, buffer->tilesX*buffer->tilesY);
+    buffer->stats.rasterMs += NowMs() - start;
+}
+
+/* ── tests ─────────────────────────────────────────────────────────── */
+bool IsBoxOccluded(const OcclusionBuffer *buffer, BoundingBox box)
+{
+    if (!buffer->depth) return false;
+    ClipVertex corners[8];
+    BoxCorners(buffer->viewProjection, box, corners);
+
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY, nearest = 0.0f;
+    for (int c = 0; c < 8; c++)
+    {
+        if (!(corners[c].w >= OCCLUSION_NEAR_W)) return false;
+        float invW = 1.0f/corners[c].w;
+        float x = (0.5f + 0.5f*corners[c].x*invW)*buffer->width;
+        float y = (0.5f - 0.5f*corners[c].y*invW)*buffer->height;
+        minX = fminf(minX, x); maxX = fmaxf(maxX, x);
+        minY = fminf(minY, y); maxY = fmaxf(maxY, y);
+        nearest = fmaxf(nearest, corners[c].d*invW);
+    }
+
+    // Every pixel the rectangle touches; off screen is for the frustum to decide
+    if (maxX <= 0.0f || maxY <= 0.0f || minX >= (float)buffer->width || minY >= (float)buffer->height) return false;
+    int x0 = (minX > 0.0f) ? (int)minX : 0, y0 = (minY > 0.0f) ? (int)minY : 0;
+    int x1 = (maxX < (float)buffer->width) ? (int)ceilf(maxX) : buffer->width;
+    int y1 = (maxY < (float)buffer->height) ? (int)ceilf(maxY) : buffer->height;
+    float threshold = nearest*(1.0f + OCCLUSION_DEPTH_BIAS);
+
+    for (int by = y0/OCCLUSION_BLOCK_SIZE; by*OCCLUSION_BLOCK_SIZE < y1; by++)
+    {
+        for (int bx = x0/OCCLUSION_BLOCK_SIZE; bx*OCCLUSION_BLOCK_SIZE < x1; bx++)
+        {
+            if (buffer->blockDepth[(size_t)by*buffer->blocksX + bx] > threshold) continue;     // whole block is nearer
+
+            int px0 = (bx*OCCLUSION_BLOCK_SIZE > x0) ? bx*OCCLUSION_BLOCK_SIZE : x0;
+            int px1 = ((bx + 1)*OCCLUSION_BLOCK_SIZE < x1) ? (bx + 1)*OCCLUSION_BLOCK_SIZE : x1;
+            int py0 = (by*OCCLUSION_BLOCK_SIZE > y0) ? by*OCCLUSION_BLOCK_SIZE : y0;
+            int py1 = ((by + 1)*OCCLUSION_BLOCK_SIZE < y1) ? (by + 1)*OCCLUSION_BLOCK_SIZE : y1;
+            for (int y = py0; y < py1; y++)
+            {
+                const float *row = buffer->depth + (size_t)y*buffer->width;
+                for (int x = px0; x < px1; x++) if (!(row[x] > threshold)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+uint32_t CullOccludedBoxes(OcclusionBuffer *buffer, const float *const bounds[6], uint32_t *indices, uint32_t count)
+{
+    double start = NowMs();
+    uint32_t kept = 0;
+    for (uint32_t k = 0; k < count; k++)
+    {
+        uint32_t i = indices[k];
+        BoundingBox box = { { bounds[0][i], bounds[1][i], bounds[2][i] }, { bounds[3][i], bounds[4][i], bounds[5][i] } };
+        if (!IsBoxOccluded(buffer, box)) indices[kept++] = i;
+    }
+    buffer->stats.tested += count;
+    buffer->stats.culled += count - kept;
+    buffer->stats.testMs += NowMs() - start;
+    return kept;
+}
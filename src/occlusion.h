@@ -0,0 +1,86 @@
+// occlusion.h - occlusion culling with a software depth buffer
+//
+// Frustum culling keeps everything in front of the camera, including the
+// furniture behind a wall. Each frame a handful of large boxes (walls,
+// bookcases, the bed) are rasterized on the CPU into a small depth buffer,
+// and the other boxes are tested against it: a box whose screen rectangle
+// is covered by nearer occluder pixels everywhere is hidden.
+//
+// The buffer stores 1/w (larger is nearer, 0 where nothing was drawn), which
+// interpolates linearly across a triangle in screen space. It's split in
+// tiles rasterized as one job each (jobs.h), four pixels at a time with SSE
+// where available (OCCLUSION_DISABLE_SIMD turns it off). Every
+// OCCLUSION_BLOCK_SIZE square block also keeps its farthest depth, so most
+// tests read one value per block instead of every pixel.
+//
+// Tests are conservative for the box being tested (its nearest corner and
+// every pixel its rectangle touches), occluders only cover pixels whose
+// centers they cover. Boxes crossing the near plane are never occluded.
+//
+// Only raylib's types are used, nothing is called, so this runs headless.
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include <stdint.h>
+#include "raylib.h"
+#include "jobs.h"
+
+#define OCCLUSION_TILE_WIDTH    32
+#define OCCLUSION_TILE_HEIGHT   16
+#define OCCLUSION_BLOCK_SIZE    8
+#define OCCLUSION_MAX_OCCLUDERS 64
+#define OCCLUSION_NEAR_W        0.01f     // clip space w occluders are clipped at
+#define OCCLUSION_DEPTH_BIAS    0.001f    // relative, keeps occluders from hiding themselves
+
+typedef struct OcclusionTriangle {
+    float a[3], b[3], c[3];      // edge functions, >= 0 inside
+    float zx, zy, z0;            // depth plane
+    int minX, minY, maxX, maxY;  // pixels touched
+} OcclusionTriangle;
+
+typedef struct OcclusionStats {
+    int occluders;
+    int triangles;               // front facing, after near clipping
+    uint32_t tested;
+    uint32_t culled;
+    double rasterMs;
+    double testMs;
+} OcclusionStats;
+
+typedef struct OcclusionBuffer {
+    int width, height;           // multiples of the tile size
+    int tilesX, tilesY;
+    int blocksX, blocksY;
+    float *depth;                // width*height, row major, top row first
+    float *blockDepth;           // farthest depth of every block
+    Matrix viewProjection;
+
+    OcclusionTriangle *triangles;
+    int triangleCount;
+    int triangleCapacity;
+
+    JobSystem *jobs;             // NULL rasterizes on the calling thread
+    OcclusionStats stats;        // since BeginOcclusion()
+} OcclusionBuffer;
+
+// Sizes are rounded up to whole tiles. The buffer doesn't own jobs.
+OcclusionBuffer LoadOcclusionBuffer(int width, int height, JobSystem *jobs);
+void UnloadOcclusionBuffer(OcclusionBuffer *buffer);
+
+// Per frame: begin with the camera's GetCameraViewProjection() (frustum.h),
+// add occluders, rasterize, then test.
+void BeginOcclusion(OcclusionBuffer *buffer, Matrix viewProjection);
+void AddOccluderBox(OcclusionBuffer *buffer, BoundingBox box);
+// Adds the maxOccluders candidates that look biggest from eye (area over
+// squared distance), skipping boxes the eye is inside. Returns how many.
+// Candidates must be opaque: a translucent occluder hides what shows through it.
+int AddLargestOccluders(OcclusionBuffer *buffer, const float *const bounds[6], const uint32_t *candidates,
+                        uint32_t candidateCount, Vector3 eye, int maxOccluders);
+void RasterizeOccluders(OcclusionBuffer *buffer);
+
+bool IsBoxOccluded(const OcclusionBuffer *buffer, BoundingBox box);
+// Removes occluded boxes from indices[] keeping the order, returns how many
+// are left. Counted in the stats.
+uint32_t CullOccludedBoxes(OcclusionBuffer *buffer, const float *const bounds[6], uint32_t *indices, uint32_t count);
+
+#endif // OCCLUSION_H
@@ -1,15 +1,34 @@
-﻿// main.c
+﻿// ourBedroom.c - the bedroom level scene: JSON boxes, three camera modes
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "raylib.h"
 #include "raymath.h"
 #include "rcamera.h"   // for UpdateCamera()
-#include "parson.h"    // https://github.com/kgabis/parson
+#include "level.h"
+#include "file_watch.h"
+#include "frustum.h"
+#include "instancing.h"
+#include "static_batch.h"
+#include "occlusion.h"
+#include "render_queue.h"
+#include "render_list.h"
+#include "jobs.h"
+#include "hud.h"
+#include "debug_draw.h"
+#include "frame_pacer.h"
+#include "frame_arena.h"
+#include "timing.h"
+#include "alloc_hook.h"
+#include "scene.h"
 
 #define PLAYER_W   0.5f
 #define PLAYER_H   1.0f
 #define PLAYER_D   0.5f
 #define MOVE_SPEED 5.0f
+#define MAX_CONTACTS 16
+
+#define LEVEL_JSON "bb#_bboxes.json"   // compiled to bb#_bboxes.lvl, see tools/levelc.c
 
 static BoundingBox MakeCubeBox(Vector3 c, float w, float h, float d) {
     return (BoundingBox) {
@@ -18,192 +37,604 @@ static BoundingBox MakeCubeBox(Vector3 c, float w, float h, float d) {
     };
 }
 
-int main(void)
-{
-    float camYaw = 180.0f;       // degrees, start looking toward -Z
-    float camPitch = 20.0f;        // degrees
-    float camDist = 6.0f;         // 3rd‑person distance
-
-    /* ── load JSON boxes ─────────────────────────────────────────────── */
-    const char* fileAddr =
-        "C:\\Users\\20020\\Desktop\\CSE125\\raylib-quickstart-main\\"
-        "raylib-quickstart-main\\resources\\bb#_bboxes.json";
-
-    JSON_Value* rootVal = json_parse_file(fileAddr);
-    if (!rootVal) { fprintf(stderr, "Cannot parse %s\n", fileAddr); return 1; }
-    JSON_Object* rootObj = json_value_get_object(rootVal);
-    size_t       boxCnt = json_object_get_count(rootObj);
-
-    BoundingBox* boxes = malloc(boxCnt * sizeof(BoundingBox));
-    Color* colors = malloc(boxCnt * sizeof(Color));
-
-    for (size_t i = 0;i < boxCnt;i++) {
-        JSON_Object* o = json_object_get_object(rootObj,
-            json_object_get_name(rootObj, i));
-        JSON_Array* mn = json_object_get_array(o, "min");
-        JSON_Array* mx = json_object_get_array(o, "max");
-        /* ---- read Blender coords ---- */
-        Vector3 bMin = { (float)json_array_get_number(mn,0),
-                         (float)json_array_get_number(mn,1),
-                         (float)json_array_get_number(mn,2) };
-        Vector3 bMax = { (float)json_array_get_number(mx,0),
-                         (float)json_array_get_number(mx,1),
-                         (float)json_array_get_number(mx,2) };
-        boxes[i].min = (Vector3){
-           bMin.x,               // X stays X
-           bMin.z,               // Blender Z  becomes Raylib Y
-          -bMax.y                // Blender Y  (depth) becomes -Z
-        };
-        boxes[i].max = (Vector3){
-            bMax.x,
-            bMax.z,
-           -bMin.y
-        };
-        colors[i] = (Color){ GetRandomValue(150,255),
-                           GetRandomValue(150,255),
-                           GetRandomValue(150,255),200 };
+static BoundingBox GetLevelBox(const Level* level, uint32_t i) {
+    return (BoundingBox) {
+        { level->minX[i], level->minY[i], level->minZ[i] },
+        { level->maxX[i], level->maxY[i], level->maxZ[i] }
+    };
+}
+
+static Color GetLevelBoxColor(const Level* level, uint32_t i) {
+    uint32_t c = level->colors[i];
+    return (Color) { (unsigned char)c, (unsigned char)(c >> 8),
+                     (unsigned char)(c >> 16), (unsigned char)(c >> 24) };
+}
+
+/* Translucent boxes (the default colors, see level_build.c) show what's
+   behind them, only opaque ones can occlude */
+static bool IsLevelBoxOpaque(const Level* level, uint32_t i) {
+    return (level->colors[i] >> 24) == 255;
+}
+
+static bool HasOpaqueBoxes(const Level* level) {
+    for (uint32_t i = 0; i < level->boxCount; i++)
+        if (IsLevelBoxAlive(level, i) && IsLevelBoxOpaque(level, i)) return true;
+    return false;
+}
+
+/* Map the compiled level; when it's missing or stale (older format), compile
+   the Blender export and cache the result next to it (same name, .lvl) for
+   the next launch. */
+static Level LoadBedroomLevel(const char* jsonFile) {
+    char levelFile[1024];
+    size_t length = strlen(jsonFile);
+    if (length > 5 && strcmp(jsonFile + length - 5, ".json") == 0) length -= 5;
+    snprintf(levelFile, sizeof(levelFile), "%.*s.lvl", (int)length, jsonFile);
+
+    Level level = { 0 };
+    if (FileExists(levelFile) &&
+        GetFileModTime(levelFile) >= GetFileModTime(jsonFile)) level = LoadLevel(levelFile);
+    if (!IsLevelValid(&level)) {
+        level = LoadLevelFromJson(jsonFile, 0, LEVEL_DEFAULT_TOLERANCE);
+        if (IsLevelValid(&level) && !ExportLevel(&level, levelFile))
+            fprintf(stderr, "Cannot write %s\n", levelFile);
+    }
+    return level;
+}
+
+#if DEBUG_DRAW_ENABLED
+/* The tree nodes a query for box walks through: nodes it overlaps in blue,
+   leaves it overlaps in orange */
+static void DebugDrawLevelQuery(const Level* level, BoundingBox box) {
+    if (level->rootNode < 0) return;
+    /* The walk holds at most height + 1 nodes, as in QueryLevelBoxes */
+    int32_t local[LEVEL_QUERY_STACK];
+    int32_t* stack = local;
+    int capacity = level->nodes[level->rootNode].height + 1;
+    if (capacity > LEVEL_QUERY_STACK) {
+        stack = RL_MALLOC((size_t)capacity * sizeof(int32_t));
+        if (!stack) return;
     }
-    json_value_free(rootVal);
+    else capacity = LEVEL_QUERY_STACK;
 
-    /* ── window & camera ─────────────────────────────────────────────── */
-    InitWindow(1920, 1080, "Cube + JSON boxes (3 camera modes)");
+    int top = 0;
+    stack[top++] = level->rootNode;
+    while (top > 0) {
+        const LevelNode* node = &level->nodes[stack[--top]];
+        BoundingBox bounds = { { node->min[0], node->min[1], node->min[2] }, { node->max[0], node->max[1], node->max[2] } };
+        if (!CheckCollisionBoxes(bounds, box)) continue;
+        DebugDrawBox(DEBUG_DRAW_BVH, bounds, (node->box >= 0) ? ORANGE : BLUE);
+        if (node->box < 0 && top + 2 <= capacity) {
+            stack[top++] = node->child1;
+            stack[top++] = node->child2;
+        }
+    }
+    if (stack != local) RL_FREE(stack);
+}
+
+/* The view ray up to the nearest drawn box it hits */
+static void DebugDrawCameraRay(const Level* level, Camera camera, const uint32_t* boxes, uint32_t count) {
+    Ray ray = { camera.position, Vector3Normalize(Vector3Subtract(camera.target, camera.position)) };
+    RayCollision nearest = { 0 };
+    uint32_t nearestBox = 0;
+    for (uint32_t v = 0; v < count; v++) {
+        RayCollision hit = GetRayCollisionBox(ray, GetLevelBox(level, boxes[v]));
+        if (hit.hit && (!nearest.hit || hit.distance < nearest.distance)) { nearest = hit; nearestBox = boxes[v]; }
+    }
+    if (!nearest.hit) {
+        DebugDrawLine(DEBUG_DRAW_CAMERA, ray.position, Vector3Add(ray.position, Vector3Scale(ray.direction, 50.0f)), GRAY);
+        return;
+    }
+    DebugDrawLine(DEBUG_DRAW_CAMERA, ray.position, nearest.point, MAGENTA);
+    DebugDrawLine(DEBUG_DRAW_CAMERA, nearest.point, Vector3Add(nearest.point, Vector3Scale(nearest.normal, 0.25f)), MAGENTA);
+    DebugDrawSphere(DEBUG_DRAW_CAMERA, nearest.point, 0.05f, MAGENTA);
+    DebugDrawText(DEBUG_DRAW_CAMERA, nearest.point, TextFormat("%s %.2f m", GetNameString(level->names[nearestBox]), nearest.distance), MAGENTA);
+}
+#endif
+
+/* Headless (-bench): the render list stages and the sort for one thread up
+   to one per hardware thread, with a null submitter, from cameras looking
+   down on the level from each corner. Occlusion is left out, its raster
+   already runs on the job system. */
+static void BenchRenderList(const Level* level, int frames) {
+    if (level->rootNode < 0) return;
+    const LevelNode* root = &level->nodes[level->rootNode];
+    Vector3 lo = { root->min[0], root->min[1], root->min[2] }, hi = { root->max[0], root->max[1], root->max[2] };
+    Vector3 center = Vector3Scale(Vector3Add(lo, hi), 0.5f);
+
+    RenderQueue queue = LoadRenderQueue();
+    int mesh = AddRenderMesh(&queue, (Mesh) { 0 });
+    int material = AddRenderMaterial(&queue, (Material) { 0 });
+    InstanceBuffer edges = { 0 };
+
+    JobSystem* probe = CreateJobSystem(0);
+    int maxThreads = GetJobWorkerCount(probe) + 1;
+    DestroyJobSystem(probe);
+
+    printf("%u boxes, %d frames per run\n", level->boxCount, frames);
+    printf("threads  chunks  visible    cull ms   build ms   merge ms    sort ms   total ms  speedup\n");
+    double serialMs = 0.0;
+    for (int threads = 1;; threads = (threads * 2 < maxThreads) ? threads * 2 : maxThreads) {
+        JobSystem* jobs = (threads > 1) ? CreateJobSystem(threads - 1) : NULL;
+        RenderList list = LoadRenderList(jobs);
+        RenderListStats sum = { 0 };
+        double sortMs = 0.0, totalMs = 0.0;
+        for (int f = 0; f < frames; f++) {
+            Camera camera = { 0 };
+            camera.position = (Vector3) { (f & 1) ? hi.x : lo.x, hi.y + 2.0f, (f & 2) ? hi.z : lo.z };
+            camera.target = center;
+            camera.up = (Vector3) { 0.0f, 1.0f, 0.0f };
+            camera.fovy = 60.0f;
+            camera.projection = CAMERA_PERSPECTIVE;
+            Frustum frustum = GetCameraFrustum(camera, 16.0f / 9.0f);
+
+            double start = NowMs();
+            BeginRenderQueue(&queue, camera);
+            CullRenderList(&list, level, &frustum);
+            BuildRenderList(&list, NULL, &queue, mesh, material, &edges);
+            RenderQueueStats queueStats = SubmitRenderQueue(&queue, NULL, NULL);
+            ClearInstances(&edges);
+            totalMs += NowMs() - start;
+
+            sum.visible += list.stats.visible;
+            sum.cullMs += list.stats.cullMs;
+            sum.buildMs += list.stats.buildMs;
+            sum.mergeMs += list.stats.mergeMs;
+            sortMs += queueStats.sortMs;
+        }
+        if (threads == 1) serialMs = totalMs;
+        printf("%7d  %6d  %7u  %9.3f  %9.3f  %9.3f  %9.3f  %9.3f  %6.2fx\n", list.stats.threads, list.stats.chunks,
+            sum.visible / (uint32_t)frames, sum.cullMs / frames, sum.buildMs / frames, sum.mergeMs / frames,
+            sortMs / frames, totalMs / frames, serialMs / totalMs);
+        UnloadRenderList(&list);
+        DestroyJobSystem(jobs);
+        if (threads == maxThreads) break;
+    }
+
+    UnloadInstanceBuffer(&edges);
+    UnloadRenderQueue(&queue);
+}
+
+enum { DRAW_SORTED = 0, DRAW_BAKED, DRAW_INSTANCED, DRAW_IMMEDIATE, DRAW_MODE_COUNT };
+enum { HUD_MODES = 0, HUD_CURRENT, HUD_BUMPED, HUD_RELOAD, HUD_FPS, HUD_PACER, HUD_BOXES, HUD_PASS, HUD_OCCLUSION,
+       HUD_QUEUE, HUD_LIST, HUD_UI, HUD_MEMORY, HUD_DEBUG };     // ids, added in this order
+enum { MODE_FREE = 0, MODE_FIRST, MODE_THIRD };
+
+/* ── scene state ─────────────────────────────────────────────────── */
+static struct {
+    Level level;
+    const char* levelJson;
+    FileWatch* levelWatch;                           // re-export from Blender to hot reload
+    bool reloadRequested;                            // the file changed, parse it once the worker is free
+    bool reloadParsing;                              // a job worker is parsing it into parsedReload
+    LevelReload* parsedReload;
+    LevelReloadStats reloadStats;
+    bool reloaded;
+    int boxDrawMode;                                 // [B] cycles through them to compare
+    RenderQueueStats queueStats;
+    bool occlusionCulling;                           // [O]
+    double drawMs;                                   // CPU time of the 3D pass, smoothed
+    double listMs;                                   // culling and packets before it, smoothed
+    double uiMs;                                     // HUD, smoothed
+
+    FramePacer pacer;                                // [P], mouse look sampled just before the frame is built
+    BoxRenderer boxRenderer;
+    StaticBatch staticBatch;
+    RenderQueue renderQueue;                         // boxes are translucent, they need sorting to blend right
+    Material boxMaterial;
+    int cubeMesh, boxMaterialId;
+    JobSystem* jobs;
+    Hud hud;
+    OcclusionBuffer occlusion;
+    RenderList renderList;                           // culling and packets on the workers
+    FrameArena frameArena;                           // scratch data, valid until the end of the next frame
+    int heapAllocations;                             // last frame, through RL_MALLOC & co.
+    AllocCounts frameStartAllocs;
+
+    Camera camera;
+    int camMode;
+    float camYaw;                                    // degrees, start looking toward -Z
+    float camPitch;                                  // degrees
+    float camDist;                                   // 3rd‑person distance
+    Vector3 playerPos;
+    NameId lastHitName;
+
+    Frustum frustum;                                 // update culls, draw submits what's left
+    uint32_t visibleCount;
+} bedroom;
+
+/* any other bbox export (e.g. from tools/levelgen.c) can be given as the first argument */
+static bool InitBedroomScene(int argc, char** argv) {
+    /* ── load level boxes ────────────────────────────────────────────── */
+    bedroom.levelJson = (argc > 0) ? argv[0] : LEVEL_JSON;
+    bedroom.level = LoadBedroomLevel(bedroom.levelJson);
+    if (!IsLevelValid(&bedroom.level)) { fprintf(stderr, "Cannot load %s\n", bedroom.levelJson); return false; }
+    bedroom.levelWatch = WatchFile(bedroom.levelJson);
+    bedroom.reloadRequested = bedroom.reloadParsing = false;
+    bedroom.parsedReload = NULL;
+    bedroom.reloadStats = (LevelReloadStats) { 0 };
+    bedroom.reloaded = false;
+    bedroom.boxDrawMode = DRAW_SORTED;
+    bedroom.queueStats = (RenderQueueStats) { 0 };
+    bedroom.occlusionCulling = HasOpaqueBoxes(&bedroom.level);   // nothing to occlude with otherwise
+    bedroom.drawMs = bedroom.listMs = bedroom.uiMs = 0.0;
+
+    /* ── renderers & camera ──────────────────────────────────────────── */
     DisableCursor();
-    SetTargetFPS(60);
+    bedroom.pacer = LoadFramePacer(0);
+    bedroom.boxRenderer = LoadBoxRenderer();
+    bedroom.staticBatch = BuildStaticBatch(&bedroom.level, 0.0f);
+    UploadStaticBatch(&bedroom.staticBatch);
+    bedroom.renderQueue = LoadRenderQueue();
+    bedroom.boxMaterial = LoadMaterialDefault();
+    bedroom.boxMaterial.shader = LoadInstanceShader(true);      // the queue draws instanced
+    bedroom.cubeMesh = AddRenderMesh(&bedroom.renderQueue, bedroom.boxRenderer.cube);
+    bedroom.boxMaterialId = AddRenderMaterial(&bedroom.renderQueue, bedroom.boxMaterial);
+    bedroom.jobs = CreateJobSystem(0);
+    bedroom.hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    const int hudLeft[] = { 10, 35, 60, 85 };
+    for (int l = HUD_MODES; l <= HUD_RELOAD; l++)
+        AddHudLine(&bedroom.hud, 10, hudLeft[l], 20, (l == HUD_RELOAD) ? DARKGRAY : BLACK);
+    for (int l = HUD_FPS; l <= HUD_DEBUG; l++)
+        AddHudLine(&bedroom.hud, 1180, 10 + 25 * (l - HUD_FPS), 20, DARKGRAY);
+    SetHudLine(&bedroom.hud, HUD_MODES, "Modes: [1] Free  [2] First‑person  [3] Third‑person");
+    bedroom.occlusion = LoadOcclusionBuffer(256, 144, bedroom.jobs);   // a tile per job
+    bedroom.renderList = LoadRenderList(bedroom.jobs);
+    bedroom.frameArena = LoadFrameArena(256 * 1024);
+    bedroom.heapAllocations = 0;
 
-    Camera camera = { 0 };
+    bedroom.camera = (Camera) { 0 };
     //Vector3 spawnPos = (Vector3){ -4.0f, PLAYER_H * 0.5f, -4.0f };
     Vector3 spawnPos = (Vector3){ 1.0f, 1.0f, 0.5f };
-    camera.position = spawnPos;
-    camera.target = spawnPos;
-    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-    camera.fovy = 60.f;
-    camera.projection = CAMERA_PERSPECTIVE;
-
-    enum { MODE_FREE = 0, MODE_FIRST, MODE_THIRD };
-    int camMode = MODE_FIRST;
-
-    Vector3 playerPos = spawnPos;
-    Vector3 prevPlayerPos, prevCamPos, prevCamTar;
-
-    /* ── main loop ───────────────────────────────────────────────────── */
-    while (!WindowShouldClose())
-    {
-        prevPlayerPos = playerPos;
-        prevCamPos = camera.position;
-        prevCamTar = camera.target;
-
-        /* switch modes */
-        if (IsKeyPressed(KEY_ONE))   camMode = MODE_FREE;
-        if (IsKeyPressed(KEY_TWO))   camMode = MODE_FIRST;
-        if (IsKeyPressed(KEY_THREE)) camMode = MODE_THIRD;
-
-        ///* camera look / orbit -------------------------------------------- */
-        //UpdateCamera(&camera,
-        //    camMode == MODE_FREE ? CAMERA_FREE :
-        //    camMode == MODE_FIRST ? CAMERA_FIRST_PERSON : CAMERA_THIRD_PERSON);
-
-        ///* --- KEEP THE WORLD UPRIGHT ------------------------------------- */
-        //camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };   // force Y‑up every frame
-
-        if (camMode == MODE_FREE) {
-            UpdateCamera(&camera, CAMERA_FREE);
-        }
-        else if (camMode == MODE_FIRST) {
-            /* lock eyes to cube centre, use Raylib FPS controls */
-            camera.position = playerPos;
-            Vector3 temp = { 0.0f, 0.0f, -1.0f };
-            camera.target = Vector3Add(playerPos, temp);  // dummy forward
-            UpdateCamera(&camera, CAMERA_FIRST_PERSON);
-        }
-        else {  /* MODE_THIRD — custom orbit ------------------------- */
-            Vector2 mouse = GetMouseDelta();
-            const float SENS = 0.3f;
-            camYaw -= mouse.x * SENS;
-            camPitch -= mouse.y * SENS;
-            if (camPitch > 85) camPitch = 85;
-            if (camPitch < -85) camPitch = -85;
-
-            camDist += GetMouseWheelMove() * -0.5f;
-            if (camDist < 2.0f) camDist = 2.0f;
-            if (camDist > 12.0f) camDist = 12.0f;
-
-            float yawRad = DEG2RAD * camYaw;
-            float pitchRad = DEG2RAD * camPitch;
-
-            Vector3 offset = {
-                camDist * cosf(pitchRad) * sinf(yawRad),
-                camDist * sinf(pitchRad),
-                camDist * cosf(pitchRad) * cosf(yawRad)
-            };
-
-            camera.target = playerPos;
-            camera.position = Vector3Add(playerPos, offset);
-            camera.up = (Vector3){ 0,1,0 };   /* KEEP Y‑UP */
-        }
+    bedroom.camera.position = spawnPos;
+    bedroom.camera.target = spawnPos;
+    bedroom.camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    bedroom.camera.fovy = 60.f;
+    bedroom.camera.projection = CAMERA_PERSPECTIVE;
+    bedroom.camMode = MODE_FIRST;
+    bedroom.camYaw = 180.0f;
+    bedroom.camPitch = 20.0f;
+    bedroom.camDist = 6.0f;
 
+    bedroom.playerPos = spawnPos;
+    bedroom.lastHitName = NAME_NONE;
+    bedroom.frameStartAllocs = GetAllocCounts();
+    return true;
+}
 
-        /* handle cube movement on X‑Z plane (always WASD world‑aligned) */
-        float dt = GetFrameTime();
-        Vector3 dir = { 0 };
-        if (IsKeyDown(KEY_W)) dir.z -= 1;
-        if (IsKeyDown(KEY_S)) dir.z += 1;
-        if (IsKeyDown(KEY_A)) dir.x -= 1;
-        if (IsKeyDown(KEY_D)) dir.x += 1;
-        if (dir.x || dir.z) {
-            dir = Vector3Normalize(dir);
-            playerPos = Vector3Add(playerPos, Vector3Scale(dir, MOVE_SPEED * dt));
-        }
+/* ── main loop ───────────────────────────────────────────────────── */
+/* on a job worker: reads and validates the export, touches nothing but parsedReload */
+static void ParseLevelReloadJob(void* data, int index) {
+    (void)data; (void)index;
+    bedroom.parsedReload = ParseLevelReload(bedroom.levelJson);
+}
 
-        /* sync player↔camera depending on mode */
-        if (camMode == MODE_FIRST) {
-            camera.position = playerPos;                 // eyes in cube center
-        }
-        else if (camMode == MODE_THIRD) {
-            camera.target = playerPos;                 // look at cube
-            playerPos = camera.target;
-        }
+static void UpdateBedroomScene(void) {
+    Level* level = &bedroom.level;
+    Camera* camera = &bedroom.camera;
+    WaitFramePacer(&bedroom.pacer);
+    /* the frame before this one ended with the host's overlay and the swap */
+    bedroom.heapAllocations = (int)(GetAllocCounts().allocations - bedroom.frameStartAllocs.allocations);
+    EndFrameArena(&bedroom.frameArena);
+    bedroom.frameStartAllocs = GetAllocCounts();
+    Vector3 prevPlayerPos = bedroom.playerPos;
+    Vector3 prevCamPos = camera->position;
+    Vector3 prevCamTar = camera->target;
+
+    /* hot reload: the export is parsed on a worker, only boxes that changed touch the tree */
+    if (PollFileWatch(bedroom.levelWatch)) bedroom.reloadRequested = true;
+    if (bedroom.reloadParsing && IsBackgroundJobDone(bedroom.jobs)) {
+        bedroom.reloadParsing = false;
+        bedroom.reloaded = bedroom.parsedReload && ApplyLevelReload(level, bedroom.parsedReload, &bedroom.reloadStats);
+        UnloadLevelReload(bedroom.parsedReload);
+        bedroom.parsedReload = NULL;
+        UpdateStaticBatch(&bedroom.staticBatch, level);  // rebakes only the cells edited boxes touch
+        ClearLevelEdits(level);
+        if (bedroom.reloaded)
+            TraceLog(LOG_INFO, "LEVEL: Reloaded %s: +%u -%u ~%u, parse %.2f ms, apply %.2f ms", bedroom.levelJson,
+                bedroom.reloadStats.added, bedroom.reloadStats.removed, bedroom.reloadStats.moved,
+                bedroom.reloadStats.parseMs, bedroom.reloadStats.applyMs);
+        else
+            TraceLog(LOG_WARNING, "LEVEL: Keeping current level, %s didn't parse (retried on its next change)", bedroom.levelJson);
+    }
+    if (bedroom.reloadRequested && !bedroom.reloadParsing &&
+        StartBackgroundJob(bedroom.jobs, ParseLevelReloadJob, NULL)) {
+        bedroom.reloadRequested = false;
+        bedroom.reloadParsing = true;                // without workers it has already run, applied next frame
+    }
+
+    /* switch modes */
+    if (IsKeyPressed(KEY_ONE))   bedroom.camMode = MODE_FREE;
+    if (IsKeyPressed(KEY_TWO))   bedroom.camMode = MODE_FIRST;
+    if (IsKeyPressed(KEY_THREE)) bedroom.camMode = MODE_THIRD;
+    if (IsKeyPressed(KEY_B))     bedroom.boxDrawMode = (bedroom.boxDrawMode + 1) % DRAW_MODE_COUNT;
+    if (IsKeyPressed(KEY_O))     bedroom.occlusionCulling = !bedroom.occlusionCulling;
+    if (IsKeyPressed(KEY_P))     SetFramePacerEnabled(&bedroom.pacer, !bedroom.pacer.enabled);
+#if DEBUG_DRAW_ENABLED
+    for (int c = 0; c < DEBUG_DRAW_CATEGORY_COUNT; c++)
+        if (IsKeyPressed(KEY_F1 + c)) ToggleDebugDrawCategory((DebugDrawCategory)c);
+#endif
+
+    ///* camera look / orbit -------------------------------------------- */
+    //UpdateCamera(camera,
+    //    camMode == MODE_FREE ? CAMERA_FREE :
+    //    camMode == MODE_FIRST ? CAMERA_FIRST_PERSON : CAMERA_THIRD_PERSON);
+
+    ///* --- KEEP THE WORLD UPRIGHT ------------------------------------- */
+    //camera->up = (Vector3){ 0.0f, 1.0f, 0.0f };   // force Y‑up every frame
+
+    if (bedroom.camMode == MODE_FREE) {
+        UpdateCamera(camera, CAMERA_FREE);
+    }
+    else if (bedroom.camMode == MODE_FIRST) {
+        /* lock eyes to cube centre, use Raylib FPS controls */
+        camera->position = bedroom.playerPos;
+        Vector3 temp = { 0.0f, 0.0f, -1.0f };
+        camera->target = Vector3Add(bedroom.playerPos, temp);  // dummy forward
+        UpdateCamera(camera, CAMERA_FIRST_PERSON);
+    }
+    else {  /* MODE_THIRD — custom orbit ------------------------- */
+        Vector2 mouse = GetMouseDelta();
+        const float SENS = 0.3f;
+        bedroom.camYaw -= mouse.x * SENS;
+        bedroom.camPitch -= mouse.y * SENS;
+        if (bedroom.camPitch > 85) bedroom.camPitch = 85;
+        if (bedroom.camPitch < -85) bedroom.camPitch = -85;
+
+        bedroom.camDist += GetMouseWheelMove() * -0.5f;
+        if (bedroom.camDist < 2.0f) bedroom.camDist = 2.0f;
+        if (bedroom.camDist > 12.0f) bedroom.camDist = 12.0f;
+
+        float yawRad = DEG2RAD * bedroom.camYaw;
+        float pitchRad = DEG2RAD * bedroom.camPitch;
+
+        Vector3 offset = {
+            bedroom.camDist * cosf(pitchRad) * sinf(yawRad),
+            bedroom.camDist * sinf(pitchRad),
+            bedroom.camDist * cosf(pitchRad) * cosf(yawRad)
+        };
+
+        camera->target = bedroom.playerPos;
+        camera->position = Vector3Add(bedroom.playerPos, offset);
+        camera->up = (Vector3){ 0,1,0 };   /* KEEP Y‑UP */
+    }
+
+
+    /* handle cube movement on X‑Z plane (always WASD world‑aligned) */
+    float dt = GetFrameTime();
+    Vector3 dir = { 0 };
+    if (IsKeyDown(KEY_W)) dir.z -= 1;
+    if (IsKeyDown(KEY_S)) dir.z += 1;
+    if (IsKeyDown(KEY_A)) dir.x -= 1;
+    if (IsKeyDown(KEY_D)) dir.x += 1;
+    if (dir.x || dir.z) {
+        dir = Vector3Normalize(dir);
+        bedroom.playerPos = Vector3Add(bedroom.playerPos, Vector3Scale(dir, MOVE_SPEED * dt));
+    }
 
+    /* sync player↔camera depending on mode */
+    if (bedroom.camMode == MODE_FIRST) {
+        camera->position = bedroom.playerPos;            // eyes in cube center
+    }
+    else if (bedroom.camMode == MODE_THIRD) {
+        camera->target = bedroom.playerPos;              // look at cube
+        bedroom.playerPos = camera->target;
+    }
+
+
+    /* collision test */
+    BoundingBox pBox = MakeCubeBox(bedroom.playerPos, PLAYER_W, PLAYER_H, PLAYER_D);
+    uint32_t* contacts = FrameAllocArray(&bedroom.frameArena, uint32_t, MAX_CONTACTS);
+    int contactCount = contacts ? QueryLevelBoxes(level, (const float*)&pBox.min, (const float*)&pBox.max, contacts, MAX_CONTACTS) : 0;
+    if (contactCount > MAX_CONTACTS) contactCount = MAX_CONTACTS;
+    bool hit = contactCount > 0;
+#if DEBUG_DRAW_ENABLED
+    if (IsDebugDrawCategoryEnabled(DEBUG_DRAW_BVH)) DebugDrawLevelQuery(level, pBox);
+#endif
+    if (hit) {
+        CheckFrameAlloc(&bedroom.frameArena, contacts);
+        DebugDrawBox(DEBUG_DRAW_CONTACTS, pBox, RED);
+        for (int c = 0; c < contactCount; c++)
+            DebugDrawBox(DEBUG_DRAW_CONTACTS, GetLevelBox(level, contacts[c]), ORANGE);
+        DebugDrawText(DEBUG_DRAW_CONTACTS, bedroom.playerPos, GetNameString(level->names[contacts[0]]), MAROON);
+        /* rollback */
+        bedroom.lastHitName = level->names[contacts[0]];
+        bedroom.playerPos = prevPlayerPos;
+        camera->position = prevCamPos;
+        camera->target = prevCamTar;
+    }
+
+    /* frustum culling: only boxes in view are submitted (baked boxes are culled by cell) */
+    Matrix viewProjection = GetCameraViewProjection(*camera, (float)GetScreenWidth() / (float)GetScreenHeight());
+    bedroom.frustum = GetFrustumFromMatrix(viewProjection);
+    bedroom.visibleCount = 0;
+    double listStart = GetTime();
+    if (bedroom.boxDrawMode != DRAW_BAKED || bedroom.occlusionCulling) {
+        bedroom.visibleCount = CullRenderList(&bedroom.renderList, level, &bedroom.frustum);
 
-        /* collision test */
-        BoundingBox pBox = MakeCubeBox(playerPos, PLAYER_W, PLAYER_H, PLAYER_D);
-        bool hit = false;
-        for (size_t i = 0;i < boxCnt && !hit;i++)
-            if (CheckCollisionBoxes(pBox, boxes[i])) hit = true;
-        if (hit) {                       // rollback
-            playerPos = prevPlayerPos;
-            camera.position = prevCamPos;
-            camera.target = prevCamTar;
+        /* occlusion culling: the biggest opaque boxes in view hide what's behind them */
+        if (bedroom.occlusionCulling) {
+            const float* bounds[6] = { level->minX, level->minY, level->minZ, level->maxX, level->maxY, level->maxZ };
+            uint32_t* opaque = FrameAllocArray(&bedroom.frameArena, uint32_t, bedroom.visibleCount);
+            uint32_t opaqueCount = 0;
+            for (uint32_t v = 0; opaque && v < bedroom.visibleCount; v++)
+                if (IsLevelBoxOpaque(level, bedroom.renderList.visible[v])) opaque[opaqueCount++] = bedroom.renderList.visible[v];
+            BeginOcclusion(&bedroom.occlusion, viewProjection);
+            AddLargestOccluders(&bedroom.occlusion, bounds, opaque, opaqueCount, camera->position, 32);
+            RasterizeOccluders(&bedroom.occlusion);
         }
 
-        /* ── draw ──────────────────────────────────────────────────── */
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+        /* occlusion tests and, sorted, the packets and edge instances, all on the workers */
+        if (bedroom.boxDrawMode == DRAW_SORTED) BeginRenderQueue(&bedroom.renderQueue, *camera);
+        if (bedroom.boxDrawMode != DRAW_BAKED)
+            bedroom.visibleCount = BuildRenderList(&bedroom.renderList, bedroom.occlusionCulling ? &bedroom.occlusion : NULL,
+                (bedroom.boxDrawMode == DRAW_SORTED) ? &bedroom.renderQueue : NULL, bedroom.cubeMesh, bedroom.boxMaterialId,
+                &bedroom.boxRenderer.instances);
+    }
+    bedroom.listMs = bedroom.listMs * 0.95 + (GetTime() - listStart) * 1000.0 * 0.05;
+#if DEBUG_DRAW_ENABLED
+    if (IsDebugDrawCategoryEnabled(DEBUG_DRAW_CAMERA)) DebugDrawCameraRay(level, *camera, bedroom.renderList.visible, bedroom.visibleCount);
+    if (IsDebugDrawCategoryEnabled(DEBUG_DRAW_BROADPHASE)) {
+        const StaticBatch* batch = &bedroom.staticBatch;
+        for (int c = 0; c < batch->cellCount; c++)
+            DebugDrawBox(DEBUG_DRAW_BROADPHASE, (BoundingBox) { { batch->minX[c], batch->minY[c], batch->minZ[c] },
+                { batch->maxX[c], batch->maxY[c], batch->maxZ[c] } }, SKYBLUE);
+    }
+#endif
+}
+
+/* ── draw ──────────────────────────────────────────────────── */
+static void DrawBedroomScene(void) {
+    const Level* level = &bedroom.level;
+    Camera camera = bedroom.camera;
+    Hud* hud = &bedroom.hud;
+    const uint32_t* visibleBoxes = bedroom.renderList.visible;
+    uint32_t visibleCount = bedroom.visibleCount;
+    uint32_t liveBoxes = level->boxCount - level->removedCount, drawnBoxes = 0;
+    int drawCalls = 0;
+
+    ClearBackground(RAYWHITE);
 
-        BeginMode3D(camera);
-        DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 50, 50 }, LIGHTGRAY);
+    double drawStart = GetTime();
+    BeginMode3D(camera);
+    DrawPlane((Vector3) { 0, 0, 0 }, (Vector2) { 50, 50 }, LIGHTGRAY);
+    DrawCube(bedroom.playerPos, PLAYER_W, PLAYER_H, PLAYER_D, RED);          // opaque first
+    DrawCubeWires(bedroom.playerPos, PLAYER_W, PLAYER_H, PLAYER_D, MAROON);
 
-        for (size_t i = 0;i < boxCnt;i++) {
-            Vector3 sz = Vector3Subtract(boxes[i].max, boxes[i].min);
-            Vector3 ce = Vector3Add(boxes[i].min, Vector3Scale(sz, 0.5f));
-            DrawCube(ce, sz.x, sz.y, sz.z, colors[i]);
+    if (bedroom.boxDrawMode == DRAW_SORTED) {
+        /* edges in one instanced draw, faces sorted through the queue, which draws
+           each run of same-material boxes instanced, both built before the frame started */
+        BoxRenderer* boxRenderer = &bedroom.boxRenderer;
+        drawnBoxes = visibleCount;
+        UploadInstances(&boxRenderer->instances);
+        DrawLineMeshInstances(boxRenderer->edges, boxRenderer->edgeShader, &boxRenderer->instances, DARKGRAY);
+        ClearInstances(&boxRenderer->instances);
+        bedroom.queueStats = DrawRenderQueue(&bedroom.renderQueue);
+        drawCalls = bedroom.queueStats.drawCalls + ((drawnBoxes > 0) ? 1 : 0);
+    }
+    else if (bedroom.boxDrawMode == DRAW_BAKED) {
+        /* two draws per visible cell */
+        StaticBatchStats batchStats = DrawStaticBatch(&bedroom.staticBatch, &bedroom.frustum,
+            bedroom.occlusionCulling ? &bedroom.occlusion : NULL, DARKGRAY);
+        drawnBoxes = batchStats.boxesDrawn;
+        drawCalls = batchStats.drawCalls;
+    }
+    else if (bedroom.boxDrawMode == DRAW_INSTANCED) {
+        /* one instanced draw for the faces, one for the edges */
+        for (uint32_t v = 0;v < visibleCount;v++) {
+            uint32_t i = visibleBoxes[v];
+            if (!IsLevelBoxAlive(level, i)) continue;
+            AddBoxInstance(&bedroom.boxRenderer, GetLevelBox(level, i), GetLevelBoxColor(level, i));
+            drawnBoxes++;
+        }
+        DrawBoxInstances(&bedroom.boxRenderer, DARKGRAY);
+        drawCalls = (drawnBoxes > 0) ? 2 : 0;
+    }
+    else {
+        for (uint32_t v = 0;v < visibleCount;v++) {
+            uint32_t i = visibleBoxes[v];
+            if (!IsLevelBoxAlive(level, i)) continue;
+            BoundingBox box = GetLevelBox(level, i);
+            Vector3 sz = Vector3Subtract(box.max, box.min);
+            Vector3 ce = Vector3Add(box.min, Vector3Scale(sz, 0.5f));
+            DrawCube(ce, sz.x, sz.y, sz.z, GetLevelBoxColor(level, i));
             DrawCubeWires(ce, sz.x, sz.y, sz.z, DARKGRAY);
+            drawnBoxes++;
         }
+        drawCalls = 2 * (int)drawnBoxes;             // rlgl starts a new draw each time it switches triangles/lines
+    }
 
-        DrawCube(playerPos, PLAYER_W, PLAYER_H, PLAYER_D, RED);
-        DrawCubeWires(playerPos, PLAYER_W, PLAYER_H, PLAYER_D, MAROON);
-        EndMode3D();
+    EndMode3D();
+    bedroom.drawMs = bedroom.drawMs * 0.95 + (GetTime() - drawStart) * 1000.0 * 0.05;
+    int debugLines = DrawDebugDraw(camera);
 
-        DrawText("Modes: [1] Free  [2] First‑person  [3] Third‑person",
-            10, 10, 20, BLACK);
-        DrawText(TextFormat("Current: %s",
-            camMode == MODE_FREE ? "FREE" :
-            camMode == MODE_FIRST ? "FIRST PERSON" : "THIRD PERSON"),
-            10, 35, 20, BLACK);
-        DrawFPS(1180, 10);
-        EndDrawing();
-    }
+    /* HUD: lines only redraw what changed since last frame */
+    double uiStart = GetTime();
+    const FramePacer* pacer = &bedroom.pacer;
+    const RenderQueueStats* queueStats = &bedroom.queueStats;
+    const RenderListStats* listStats = &bedroom.renderList.stats;
+    const OcclusionStats* occlusionStats = &bedroom.occlusion.stats;
+    SetHudLine(hud, HUD_CURRENT, bedroom.camMode == MODE_FREE ? "Current: FREE" :
+        bedroom.camMode == MODE_FIRST ? "Current: FIRST PERSON" : "Current: THIRD PERSON");
+    if (bedroom.lastHitName != NAME_NONE) SetHudLineF(hud, HUD_BUMPED, "Last bumped: %s", GetNameString(bedroom.lastHitName));
+    if (bedroom.reloaded)
+        SetHudLineF(hud, HUD_RELOAD, "Reload: +%u -%u ~%u, parse %.2f ms, apply %.2f ms", bedroom.reloadStats.added,
+            bedroom.reloadStats.removed, bedroom.reloadStats.moved, bedroom.reloadStats.parseMs, bedroom.reloadStats.applyMs);
+    int fps = GetFPS();
+    SetHudLineF(hud, HUD_FPS, "%2i FPS", fps);
+    SetHudLineColor(hud, HUD_FPS, (fps < 15) ? RED : (fps < 30) ? ORANGE : LIME);   // as DrawFPS()
+    if (pacer->enabled)
+        SetHudLineF(hud, HUD_PACER, "Pacer [P]: input %.1f ms fresher, frame %.2f +- %.2f ms, %d late", pacer->stats.savedMs,
+            pacer->stats.workMs, pacer->stats.workDeviationMs, pacer->stats.lateFrames);
+    else SetHudLineF(hud, HUD_PACER, "Pacer [P]: off, SetTargetFPS(%d)", pacer->targetFps);
+    SetHudLineF(hud, HUD_BOXES, "Boxes drawn: %u / %u", drawnBoxes, liveBoxes);
+    SetHudLineF(hud, HUD_PASS, "3D pass: %.2f ms CPU, %d box draw calls, %s [B]", bedroom.drawMs, drawCalls,
+        bedroom.boxDrawMode == DRAW_SORTED ? "sorted" : bedroom.boxDrawMode == DRAW_BAKED ? "baked" :
+        bedroom.boxDrawMode == DRAW_INSTANCED ? "instanced" : "DrawCube");
+    if (bedroom.occlusionCulling)
+        SetHudLineF(hud, HUD_OCCLUSION, "Occlusion [O]: %u / %u hidden, %d occluders, raster %.2f ms", occlusionStats->culled,
+            occlusionStats->tested, occlusionStats->occluders, occlusionStats->rasterMs);
+    else SetHudLine(hud, HUD_OCCLUSION, "Occlusion [O]: off");
+    if (bedroom.boxDrawMode == DRAW_SORTED)
+        SetHudLineF(hud, HUD_QUEUE, "Queue: %d packets (%d translucent), %d draws, %d material / %d mesh changes, sort %.3f ms",
+            queueStats->packets, queueStats->translucent, queueStats->drawCalls, queueStats->materialChanges,
+            queueStats->meshChanges, queueStats->sortMs);
+    else SetHudLine(hud, HUD_QUEUE, "");
+    if (bedroom.boxDrawMode != DRAW_BAKED)
+        SetHudLineF(hud, HUD_LIST, "Render list: %.2f ms, %d threads, %d chunks (cull %.2f, build %.2f, merge %.2f ms)", bedroom.listMs,
+            listStats->threads, listStats->chunks, listStats->cullMs, listStats->buildMs, listStats->mergeMs);
+    else SetHudLine(hud, HUD_LIST, "");
+#if DEBUG_DRAW_ENABLED
+    const char* debugText = "Debug draw [F1-F4]:";
+    bool formatted = false;                          // debugText is in the frame arena
+    for (int c = 0; c < DEBUG_DRAW_CATEGORY_COUNT; c++)
+        if (IsDebugDrawCategoryEnabled((DebugDrawCategory)c)) {
+            debugText = FrameFormat(&bedroom.frameArena, "%s %s", debugText, GetDebugDrawCategoryName((DebugDrawCategory)c));
+            formatted = true;
+        }
+    if (formatted) CheckFrameAlloc(&bedroom.frameArena, debugText);
+    SetHudLineF(hud, HUD_DEBUG, "%s, %d lines", debugText, debugLines);
+#else
+    (void)debugLines;
+#endif
+    SetHudLineF(hud, HUD_MEMORY, "Frame memory: %zu B arena (of %zu KB), peak %zu B, %d heap allocations",
+        bedroom.frameArena.stats.used, bedroom.frameArena.capacity / 1024, bedroom.frameArena.stats.peak, bedroom.heapAllocations);
+    SetHudLineF(hud, HUD_UI, "HUD: %.3f ms CPU, %d lines / %d chars redrawn", bedroom.uiMs, hud->stats.linesRedrawn,
+        hud->stats.charsRedrawn);
+    DrawHud(hud);
+    bedroom.uiMs = bedroom.uiMs * 0.95 + (GetTime() - uiStart) * 1000.0 * 0.05;
+    EndFramePacer(&bedroom.pacer);
+}
 
-    free(boxes); free(colors);
-    CloseWindow();
-    return 0;
+static void UnloadBedroomScene(void) {
+    SetFramePacerEnabled(&bedroom.pacer, false);     // back to raylib's limiter for the next scene
+    UnloadFrameArena(&bedroom.frameArena);
+    UnloadRenderList(&bedroom.renderList);
+    UnloadHud(&bedroom.hud);
+    UnloadDebugDraw();
+    UnloadBoxRenderer(&bedroom.boxRenderer);
+    UnloadStaticBatch(&bedroom.staticBatch);
+    UnloadRenderQueue(&bedroom.renderQueue);
+    UnloadInstanceShader(bedroom.boxMaterial.shader);
+    RL_FREE(bedroom.boxMaterial.maps);               // the rest of it is raylib's defaults
+    UnloadOcclusionBuffer(&bedroom.occlusion);
+    DestroyJobSystem(bedroom.jobs);                  // finishes a reload still being parsed
+    UnloadLevelReload(bedroom.parsedReload);
+    UnwatchFile(bedroom.levelWatch);
+    UnloadLevel(&bedroom.level);
 }
+
+/* -bench times building the render list without opening a window */
+static void BenchBedroomScene(int argc, char** argv) {
+    const char* levelJson = (argc > 0) ? argv[0] : LEVEL_JSON;
+    Level level = LoadBedroomLevel(levelJson);
+    if (!IsLevelValid(&level)) { fprintf(stderr, "Cannot load %s\n", levelJson); return; }
+    BenchRenderList(&level, 100);
+    UnloadLevel(&level);
+}
+
+const Scene BedroomScene = {
+    .name = "bedroom", .title = "Cube + JSON boxes (3 camera modes)", .width = 1920, .height = 1080,
+    .init = InitBedroomScene, .update = UpdateBedroomScene, .draw = DrawBedroomScene, .unload = UnloadBedroomScene,
+    .bench = BenchBedroomScene
+};
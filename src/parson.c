@@ -22,6 +22,12 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  THE SOFTWARE.
 */
+/* glibc hides MAP_ANONYMOUS and madvise in strict ISO C modes (-std=c17), which would quietly turn
+ * file mapping off. Has to come before the first system header. */
+#if !defined(PARSON_DISABLE_MMAP) && defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
 #ifdef _MSC_VER
 #ifndef _CRT_SECURE_NO_WARNINGS
 #define _CRT_SECURE_NO_WARNINGS
@@ -48,6 +54,50 @@
 #include <math.h>
 #include <errno.h>
 
+/* Whitespace runs and string bodies are scanned in 16/32 byte blocks when the target supports it.
+ * Define PARSON_DISABLE_SIMD to force the scalar scanners. Aligned block loads may read past the
+ * end of the input (never past its page), address sanitizer builds use the scalar scanners. */
+#if defined(__SANITIZE_ADDRESS__)
+#define PARSON_DISABLE_SIMD
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define PARSON_DISABLE_SIMD
+#endif
+#endif
+
+#if !defined(PARSON_DISABLE_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PARSON_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARSON_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PARSON_SIMD_NEON
+#endif
+#endif
+
+/* json_parse_file memory-maps regular files on POSIX systems instead of reading them into a heap
+ * buffer. Define PARSON_DISABLE_MMAP to always read files with stdio. */
+#if !defined(PARSON_DISABLE_MMAP) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__)))
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if defined(MAP_ANONYMOUS) && defined(MAP_FIXED)
+#define PARSON_USE_MMAP
+#endif
+#endif
+
+#if defined(_MSC_VER) && (defined(PARSON_SIMD_AVX2) || defined(PARSON_SIMD_SSE2) || defined(PARSON_SIMD_NEON))
+#include <intrin.h>
+#endif
+
 /* Apparently sscanf is not implemented in some "standard" libraries, so don't use it, if you
  * don't have to. */
 #ifdef sscanf
@@ -64,6 +114,10 @@
 #define STARTING_CAPACITY 16
 #define MAX_NESTING       2048
 
+#ifndef PARSON_SMALL_OBJECT_CAPACITY
+#define PARSON_SMALL_OBJECT_CAPACITY 8 /* must stay below STARTING_CAPACITY * 7/10 */
+#endif
+
 #ifndef PARSON_DEFAULT_FLOAT_FORMAT
 #define PARSON_DEFAULT_FLOAT_FORMAT "%1.17g" /* do not increase precision without incresing NUM_BUF_SIZE */
 #endif
@@ -78,7 +132,7 @@
 
 #define SIZEOF_TOKEN(a)       (sizeof(a) - 1)
 #define SKIP_CHAR(str)        ((*str)++)
-#define SKIP_WHITESPACES(str) while (isspace((unsigned char)(**str))) { SKIP_CHAR(str); }
+#define SKIP_WHITESPACES(str) (*(str) = skip_whitespaces(*(str)))
 #define MAX(a, b)             ((a) > (b) ? (a) : (b))
 
 #undef malloc
@@ -92,17 +146,41 @@
 
 #define OBJECT_INVALID_IX ((size_t)-1)
 
-static JSON_Malloc_Function parson_malloc = malloc;
-static JSON_Free_Function parson_free = free;
+#if defined(_MSC_VER)
+#define PARSON_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_THREADS__)
+#define PARSON_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__) || defined(__clang__)
+#define PARSON_THREAD_LOCAL __thread
+#else
+#define PARSON_THREAD_LOCAL /* no thread local storage, contexts aren't thread safe */
+#endif
+
+static JSON_Malloc_Function parson_global_malloc = malloc;
+static JSON_Free_Function parson_global_free = free;
+
+static char *parson_global_float_format = NULL;
 
-static int parson_escape_slashes = 1;
+static void * global_context_malloc(void *allocator_data, size_t size);
+static void   global_context_free(void *allocator_data, void *ptr);
 
-static char *parson_float_format = NULL;
+/* Process-wide settings, used when the calling thread has no current context. */
+static JSON_Context parson_global_context = {
+    global_context_malloc, global_context_free, NULL, 1, NULL, NULL
+};
+
+static PARSON_THREAD_LOCAL const JSON_Context *parson_current_context = NULL;
 
-static JSON_Number_Serialization_Function parson_number_serialization_function = NULL;
+#define PARSON_CONTEXT() (parson_current_context ? parson_current_context : &parson_global_context)
 
 #define IS_CONT(b) (((unsigned char)(b) & 0xC0) == 0x80) /* is utf-8 continuation byte */
 
+/* same set as isspace() in the "C" locale: ' ', '\t', '\n', '\v', '\f', '\r' */
+#define IS_SPACE(c) ((c) == ' ' || (unsigned char)((c) - '\t') <= ('\r' - '\t'))
+
+/* bytes that end a run of plain string characters: '\"', '\\' and 0x00-0x1F */
+#define IS_STRING_SPECIAL(c) ((c) == '\"' || (c) == '\\' || (c) < 0x20)
+
 typedef int parson_bool_t;
 
 #define PARSON_TRUE 1
@@ -124,9 +202,10 @@ typedef union json_value_value {
 } JSON_Value_Value;
 
 struct json_value_t {
-    JSON_Value      *parent;
-    JSON_Value_Type  type;
-    JSON_Value_Value value;
+    JSON_Value         *parent;
+    const JSON_Context *context; /* allocated through, every value of a document shares it */
+    JSON_Value_Type     type;
+    JSON_Value_Value    value;
 };
 
 struct json_object_t {
@@ -141,6 +220,18 @@ struct json_object_t {
     size_t         cell_capacity;
 };
 
+/* Objects start out small: up to PARSON_SMALL_OBJECT_CAPACITY items live in slots allocated in the
+   same block as the object and are found by a linear search over cached hashes. cells and cell_ixs
+   are only allocated once the object outgrows its slots and is promoted to the hash table layout. */
+typedef struct json_object_small_block {
+    JSON_Object    object;
+    unsigned long  hashes[PARSON_SMALL_OBJECT_CAPACITY];
+    char          *names[PARSON_SMALL_OBJECT_CAPACITY];
+    JSON_Value    *values[PARSON_SMALL_OBJECT_CAPACITY];
+} JSON_Object_Small_Block;
+
+#define OBJECT_IS_SMALL(obj) ((obj)->cell_capacity == 0)
+
 struct json_array_t {
     JSON_Value  *wrapping_value;
     JSON_Value **items;
@@ -148,8 +239,43 @@ struct json_array_t {
     size_t       capacity;
 };
 
+/* Compiled schemas are a single block: the header, then nodes in preorder, then object keys (keys
+   of one object are contiguous, in schema order), then the key names. */
+typedef struct json_schema_node {
+    JSON_Value_Type type; /* JSONNull accepts values of every type */
+    size_t          first; /* object: index of first key, array: index of element node */
+    size_t          count; /* object: number of keys, array: 0 (all arrays) or 1 */
+} JSON_Schema_Node;
+
+typedef struct json_schema_key {
+    const char   *name;
+    size_t        name_len;
+    unsigned long hash;
+    size_t        node;
+} JSON_Schema_Key;
+
+struct json_schema_t {
+    JSON_Schema_Node *nodes;
+    JSON_Schema_Key  *keys;
+    size_t            node_count;
+    size_t            key_count;
+};
+
+/* The path of a mismatch is built from the inside out, at the end of the caller's buffer */
+typedef struct json_schema_error_path {
+    char         *buf;
+    size_t        start;
+    parson_bool_t truncated;
+} JSON_Schema_Error_Path;
+
 /* Various */
+static void * parson_malloc(size_t size);
+static void   parson_free(void *ptr);
+static const JSON_Context * parson_enter_context(const JSON_Value *owner);
 static char * read_file(const char *filename);
+static char * map_file(const char *filename, parson_bool_t writable, size_t *out_map_size);
+static void   unmap_file(char *contents, size_t map_size);
+static void   release_parsed_input(const char *position);
 static void   remove_comments(char *string, const char *start_token, const char *end_token);
 static char * parson_strndup(const char *string, size_t n);
 static char * parson_strdup(const char *string);
@@ -162,6 +288,8 @@ static JSON_Status   verify_utf8_sequence(const unsigned char *string, int *len)
 static parson_bool_t is_valid_utf8(const char *string, size_t string_len);
 static parson_bool_t is_decimal(const char *string, size_t length);
 static unsigned long hash_string(const char *string, size_t n);
+static const char *  skip_whitespaces(const char *string);
+static const char *  scan_string_body(const char *string);
 
 /* JSON Object */
 static JSON_Object * json_object_make(JSON_Value *wrapping_value);
@@ -169,8 +297,12 @@ static JSON_Status   json_object_init(JSON_Object *object, size_t capacity);
 static void          json_object_deinit(JSON_Object *object, parson_bool_t free_keys, parson_bool_t free_values);
 static JSON_Status   json_object_grow_and_rehash(JSON_Object *object);
 static size_t        json_object_get_cell_ix(const JSON_Object *object, const char *key, size_t key_len, unsigned long hash, parson_bool_t *out_found);
+static size_t        json_object_get_item_ix(const JSON_Object *object, const char *key, size_t key_len, unsigned long hash);
+static JSON_Status   json_object_append(JSON_Object *object, char *name, unsigned long hash, JSON_Value *value);
 static JSON_Status   json_object_add(JSON_Object *object, char *name, JSON_Value *value);
 static JSON_Value  * json_object_getn_value(const JSON_Object *object, const char *name, size_t name_len);
+static JSON_Status   json_object_set_value_internal(JSON_Object *object, const char *name, JSON_Value *value);
+static JSON_Status   json_object_dotset_value_internal(JSON_Object *object, const char *name, JSON_Value *value);
 static JSON_Status   json_object_remove_internal(JSON_Object *object, const char *name, parson_bool_t free_value);
 static JSON_Status   json_object_dotremove_internal(JSON_Object *object, const char *name, parson_bool_t free_value);
 static void          json_object_free(JSON_Object *object);
@@ -183,6 +315,7 @@ static void         json_array_free(JSON_Array *array);
 
 /* JSON Value */
 static JSON_Value * json_value_init_string_no_copy(char *string, size_t length);
+static JSON_Value * json_value_deep_copy_r(const JSON_Value *value);
 static const JSON_String * json_value_get_string_desc(const JSON_Value *value);
 
 /* Parser */
@@ -198,11 +331,44 @@ static JSON_Value *  parse_number_value(const char **string);
 static JSON_Value *  parse_null_value(const char **string);
 static JSON_Value *  parse_value(const char **string, size_t nesting);
 
+/* Compiled schema */
+static void          json_schema_measure(const JSON_Value *schema, size_t *node_count, size_t *key_count, size_t *names_size);
+static size_t        json_schema_emit(JSON_Schema *compiled, const JSON_Value *schema, char **names);
+static JSON_Status   json_schema_validate_r(const JSON_Schema *schema, size_t node_ix, const JSON_Value *value, JSON_Schema_Error_Path *path);
+static const JSON_Value * json_schema_find_value(const JSON_Object *object, const JSON_Schema_Key *key, size_t hint);
+static void          json_schema_path_prepend(JSON_Schema_Error_Path *path, const char *segment, size_t segment_len);
+
 /* Serialization */
 static int json_serialize_to_buffer_r(const JSON_Value *value, char *buf, int level, parson_bool_t is_pretty, char *num_buf);
 static int json_serialize_string(const char *string, size_t len, char *buf);
 
 /* Various */
+static void * global_context_malloc(void *allocator_data, size_t size) {
+    (void)allocator_data;
+    return parson_global_malloc(size);
+}
+
+static void global_context_free(void *allocator_data, void *ptr) {
+    (void)allocator_data;
+    parson_global_free(ptr);
+}
+
+static void * parson_malloc(size_t size) {
+    const JSON_Context *context = PARSON_CONTEXT();
+    return context->malloc_fun(context->allocator_data, size);
+}
+
+static void parson_free(void *ptr) {
+    const JSON_Context *context = PARSON_CONTEXT();
+    context->free_fun(context->allocator_data, ptr);
+}
+
+/* Changing a document allocates and frees through the context its values were allocated from,
+   whichever context is current. Returns the context to make current again afterwards. */
+static const JSON_Context * parson_enter_context(const JSON_Value *owner) {
+    return json_context_make_current(owner->context);
+}
+
 static char * read_file(const char * filename) {
     FILE *fp = fopen(filename, "r");
     size_t size_to_read = 0;
@@ -236,6 +402,110 @@ static char * read_file(const char * filename) {
     return file_contents;
 }
 
+/* Maps a regular file and returns its contents terminated with a null character, or NULL if the file
+   can't be mapped (callers fall back to read_file then). The file is mapped over an anonymous
+   reservation one page longer than the file: the tail of the file's last page and the extra page
+   read as zeros, so the parser gets a terminated string without a copy. Pages are faulted in as
+   the parser advances and MADV_SEQUENTIAL lets the kernel read ahead of it, which overlaps I/O
+   with parsing. A writable mapping is private, only pages that are written to get copied. */
+static char * map_file(const char *filename, parson_bool_t writable, size_t *out_map_size) {
+#ifdef PARSON_USE_MMAP
+    int fd = -1;
+    struct stat st;
+    size_t file_size = 0, page_size = 0, map_size = 0;
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *reservation = MAP_FAILED, *contents = MAP_FAILED;
+    long page_size_l = sysconf(_SC_PAGESIZE);
+
+    *out_map_size = 0;
+    if (page_size_l <= 0) {
+        return NULL;
+    }
+    page_size = (size_t)page_size_l;
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+    file_size = (size_t)st.st_size;
+    map_size = ((file_size + page_size - 1) / page_size + 1) * page_size;
+    reservation = mmap(NULL, map_size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    contents = mmap(reservation, file_size, prot, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    close(fd);
+    if (contents == MAP_FAILED) {
+        munmap(reservation, map_size);
+        return NULL;
+    }
+#if defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(contents, file_size, POSIX_MADV_SEQUENTIAL);
+#endif
+    *out_map_size = map_size;
+    return (char*)contents;
+#else
+    (void)filename;
+    (void)writable;
+    *out_map_size = 0;
+    return NULL;
+#endif
+}
+
+static void unmap_file(char *contents, size_t map_size) {
+#ifdef PARSON_USE_MMAP
+    munmap(contents, map_size);
+#else
+    (void)contents;
+    (void)map_size;
+#endif
+}
+
+/* Clean pages of a read-only mapping stay resident until the mapping goes, so a mapped file would
+   cost as much peak memory as a read one. While json_parse_file parses a mapping, the containers
+   hand out pages the parser is done with, a few MB at a time; nothing looks back at them, parsed
+   keys and strings are copies. */
+#if defined(PARSON_USE_MMAP) && defined(MADV_DONTNEED)
+#define PARSON_RELEASE_CHUNK ((size_t)4 << 20)
+
+typedef struct parson_mapped_input_t {
+    char   *released; /* start of pages still mapped in, NULL when not parsing a mapping */
+    size_t  page_size;
+} parson_mapped_input_t;
+
+static PARSON_THREAD_LOCAL parson_mapped_input_t parson_mapped_input = { NULL, 0 };
+
+static void begin_mapped_input(char *contents) {
+    parson_mapped_input.released = contents;
+    parson_mapped_input.page_size = (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static void end_mapped_input(void) {
+    parson_mapped_input.released = NULL;
+}
+
+static void release_parsed_input(const char *position) {
+    char *released = parson_mapped_input.released;
+    size_t length = 0;
+    if (released == NULL || position < released || (size_t)(position - released) < PARSON_RELEASE_CHUNK) {
+        return;
+    }
+    length = (size_t)(position - released) & ~(parson_mapped_input.page_size - 1);
+    madvise(released, length, MADV_DONTNEED);
+    parson_mapped_input.released = released + length;
+}
+#else
+#define begin_mapped_input(contents) ((void)(contents))
+#define end_mapped_input() ((void)0)
+static void release_parsed_input(const char *position) {
+    (void)position;
+}
+#endif
+
 static void remove_comments(char *string, const char *start_token, const char *end_token) {
     parson_bool_t in_string = PARSON_FALSE, escaped = PARSON_FALSE;
     size_t i;
@@ -436,19 +706,162 @@ static unsigned long hash_string(const char *string, size_t n) {
 #endif
 }
 
+/* Block scanners.
+   Every block is loaded from an address aligned to its own size, so a load never crosses a page
+   boundary even when it reads past the terminating null character. Bytes in front of the start
+   pointer are masked off. The masks have PARSON_SIMD_MASK_BITS bits per byte. */
+#if defined(PARSON_SIMD_AVX2) || defined(PARSON_SIMD_SSE2) || defined(PARSON_SIMD_NEON)
+#define PARSON_SIMD
+
+typedef unsigned long long parson_mask_t;
+
+#if defined(PARSON_SIMD_AVX2)
+#define PARSON_SIMD_BLOCK_SIZE 32
+#define PARSON_SIMD_MASK_BITS  1
+
+static parson_mask_t block_not_space_mask(const unsigned char *block) {
+    __m256i v = _mm256_load_si256((const __m256i*)block);
+    __m256i ctl = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+    __m256i is_ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(ctl, _mm256_set1_epi8('\r' - '\t')), ctl);
+    __m256i is_space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), is_ctl);
+    return ~(parson_mask_t)(unsigned int)_mm256_movemask_epi8(is_space) & 0xFFFFFFFFULL;
+}
+
+static parson_mask_t block_string_special_mask(const unsigned char *block) {
+    __m256i v = _mm256_load_si256((const __m256i*)block);
+    __m256i is_ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+    __m256i is_quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"'));
+    __m256i is_bslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    __m256i special = _mm256_or_si256(_mm256_or_si256(is_quote, is_bslash), is_ctl);
+    return (parson_mask_t)(unsigned int)_mm256_movemask_epi8(special);
+}
+#elif defined(PARSON_SIMD_SSE2)
+#define PARSON_SIMD_BLOCK_SIZE 16
+#define PARSON_SIMD_MASK_BITS  1
+
+static parson_mask_t block_not_space_mask(const unsigned char *block) {
+    __m128i v = _mm_load_si128((const __m128i*)block);
+    __m128i ctl = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    __m128i is_ctl = _mm_cmpeq_epi8(_mm_min_epu8(ctl, _mm_set1_epi8('\r' - '\t')), ctl);
+    __m128i is_space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), is_ctl);
+    return ~(parson_mask_t)_mm_movemask_epi8(is_space) & 0xFFFFULL;
+}
+
+static parson_mask_t block_string_special_mask(const unsigned char *block) {
+    __m128i v = _mm_load_si128((const __m128i*)block);
+    __m128i is_ctl = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+    __m128i is_quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('\"'));
+    __m128i is_bslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    __m128i special = _mm_or_si128(_mm_or_si128(is_quote, is_bslash), is_ctl);
+    return (parson_mask_t)_mm_movemask_epi8(special);
+}
+#else /* PARSON_SIMD_NEON */
+#define PARSON_SIMD_BLOCK_SIZE 16
+#define PARSON_SIMD_MASK_BITS  4
+
+/* NEON has no movemask, narrowing shift packs each byte lane into a nibble */
+static parson_mask_t neon_movemask(uint8x16_t v) {
+    uint8x8_t packed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return (parson_mask_t)vget_lane_u64(vreinterpret_u64_u8(packed), 0);
+}
+
+static parson_mask_t block_not_space_mask(const unsigned char *block) {
+    uint8x16_t v = vld1q_u8(block);
+    uint8x16_t is_ctl = vcleq_u8(vsubq_u8(v, vdupq_n_u8('\t')), vdupq_n_u8('\r' - '\t'));
+    uint8x16_t is_space = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), is_ctl);
+    return neon_movemask(vmvnq_u8(is_space));
+}
+
+static parson_mask_t block_string_special_mask(const unsigned char *block) {
+    uint8x16_t v = vld1q_u8(block);
+    uint8x16_t is_ctl = vcleq_u8(v, vdupq_n_u8(0x1F));
+    uint8x16_t is_quote = vceqq_u8(v, vdupq_n_u8('\"'));
+    uint8x16_t is_bslash = vceqq_u8(v, vdupq_n_u8('\\'));
+    return neon_movemask(vorrq_u8(vorrq_u8(is_quote, is_bslash), is_ctl));
+}
+#endif
+
+static int mask_first_byte(parson_mask_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long ix = 0;
+#if defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64)
+    _BitScanForward64(&ix, mask);
+#else
+    if (!_BitScanForward(&ix, (unsigned long)mask)) {
+        _BitScanForward(&ix, (unsigned long)(mask >> 32));
+        ix += 32;
+    }
+#endif
+    return (int)ix / PARSON_SIMD_MASK_BITS;
+#else
+    return __builtin_ctzll(mask) / PARSON_SIMD_MASK_BITS;
+#endif
+}
+
+/* Advances 'string' to the first byte whose bit is set by block_mask_fun.
+   Both scanned sets include the null character, so the loop terminates. */
+#define SCAN_BLOCKS(string, block_mask_fun) do {\
+        size_t misalignment_ = (size_t)(string) & (PARSON_SIMD_BLOCK_SIZE - 1);\
+        const unsigned char *block_ = (const unsigned char*)(string) - misalignment_;\
+        parson_mask_t mask_ = block_mask_fun(block_) & (~0ULL << (misalignment_ * PARSON_SIMD_MASK_BITS));\
+        while (mask_ == 0) {\
+            block_ += PARSON_SIMD_BLOCK_SIZE;\
+            mask_ = block_mask_fun(block_);\
+        }\
+        (string) = (const char*)block_ + mask_first_byte(mask_);\
+    } while (0)
+#endif /* PARSON_SIMD */
+
+static const char * skip_whitespaces(const char *string) {
+    /* most tokens are preceded by no or a single whitespace, don't pay for a block load there */
+    if (!IS_SPACE(string[0])) {
+        return string;
+    }
+    if (!IS_SPACE(string[1])) {
+        return string + 1;
+    }
+#ifdef PARSON_SIMD
+    string += 2;
+    SCAN_BLOCKS(string, block_not_space_mask);
+    return string;
+#else
+    string += 2;
+    while (IS_SPACE(*string)) {
+        string++;
+    }
+    return string;
+#endif
+}
+
+static const char * scan_string_body(const char *string) {
+#ifdef PARSON_SIMD
+    SCAN_BLOCKS(string, block_string_special_mask);
+    return string;
+#else
+    while (!IS_STRING_SPECIAL((unsigned char)*string)) {
+        string++;
+    }
+    return string;
+#endif
+}
+
 /* JSON Object */
 static JSON_Object * json_object_make(JSON_Value *wrapping_value) {
-    JSON_Status res = JSONFailure;
-    JSON_Object *new_obj = (JSON_Object*)parson_malloc(sizeof(JSON_Object));
-    if (new_obj == NULL) {
+    JSON_Object_Small_Block *block = (JSON_Object_Small_Block*)parson_malloc(sizeof(JSON_Object_Small_Block));
+    JSON_Object *new_obj = NULL;
+    if (block == NULL) {
         return NULL;
     }
+    new_obj = &block->object;
     new_obj->wrapping_value = wrapping_value;
-    res = json_object_init(new_obj, 0);
-    if (res != JSONSuccess) {
-        parson_free(new_obj);
-        return NULL;
-    }
+    new_obj->cells = NULL;
+    new_obj->cell_ixs = NULL;
+    new_obj->hashes = block->hashes;
+    new_obj->names = block->names;
+    new_obj->values = block->values;
+    new_obj->count = 0;
+    new_obj->item_capacity = PARSON_SMALL_OBJECT_CAPACITY;
+    new_obj->cell_capacity = 0;
     return new_obj;
 }
 
@@ -507,13 +920,15 @@ static void json_object_deinit(JSON_Object *object, parson_bool_t free_keys, par
 
     object->count = 0;
     object->item_capacity = 0;
-    object->cell_capacity = 0;
 
-    parson_free(object->cells);
-    parson_free(object->names);
-    parson_free(object->values);
-    parson_free(object->cell_ixs);
-    parson_free(object->hashes);
+    if (!OBJECT_IS_SMALL(object)) { /* small objects keep their slots inside the object's own block */
+        parson_free(object->cells);
+        parson_free(object->names);
+        parson_free(object->values);
+        parson_free(object->cell_ixs);
+        parson_free(object->hashes);
+    }
+    object->cell_capacity = 0;
 
     object->cells = NULL;
     object->names = NULL;
@@ -525,8 +940,6 @@ static void json_object_deinit(JSON_Object *object, parson_bool_t free_keys, par
 static JSON_Status json_object_grow_and_rehash(JSON_Object *object) {
     JSON_Value *wrapping_value = NULL;
     JSON_Object new_object;
-    char *key = NULL;
-    JSON_Value *value = NULL;
     unsigned int i = 0;
     size_t new_capacity = MAX(object->cell_capacity * 2, STARTING_CAPACITY);
     JSON_Status res = json_object_init(&new_object, new_capacity);
@@ -538,14 +951,8 @@ static JSON_Status json_object_grow_and_rehash(JSON_Object *object) {
     new_object.wrapping_value = wrapping_value;
 
     for (i = 0; i < object->count; i++) {
-        key = object->names[i];
-        value = object->values[i];
-        res = json_object_add(&new_object, key, value);
-        if (res != JSONSuccess) {
-            json_object_deinit(&new_object, PARSON_FALSE, PARSON_FALSE);
-            return JSONFailure;
-        }
-        value->parent = wrapping_value;
+        /* names are already unique and hashes are cached, new_object has room for all of them */
+        json_object_append(&new_object, object->names[i], object->hashes[i], object->values[i]);
     }
     json_object_deinit(object, PARSON_FALSE, PARSON_FALSE);
     *object = new_object;
@@ -583,35 +990,49 @@ static size_t json_object_get_cell_ix(const JSON_Object *object, const char *key
     return OBJECT_INVALID_IX;
 }
 
-static JSON_Status json_object_add(JSON_Object *object, char *name, JSON_Value *value) {
-    unsigned long hash = 0;
+/* Returns index of the item named key or OBJECT_INVALID_IX, works for both object layouts. */
+static size_t json_object_get_item_ix(const JSON_Object *object, const char *key, size_t key_len, unsigned long hash) {
     parson_bool_t found = PARSON_FALSE;
     size_t cell_ix = 0;
-    JSON_Status res = JSONFailure;
-
-    if (!object || !name || !value) {
-        return JSONFailure;
+    size_t i = 0;
+    if (OBJECT_IS_SMALL(object)) {
+        for (i = 0; i < object->count; i++) {
+            /* lengths first, key may hold NULs and be longer than the name */
+            if (object->hashes[i] == hash
+                && strlen(object->names[i]) == key_len
+                && memcmp(key, object->names[i], key_len) == 0) {
+                return i;
+            }
+        }
+        return OBJECT_INVALID_IX;
     }
-
-    hash = hash_string(name, strlen(name));
-    found = PARSON_FALSE;
-    cell_ix = json_object_get_cell_ix(object, name, strlen(name), hash, &found);
-    if (found) {
-        return JSONFailure;
+    cell_ix = json_object_get_cell_ix(object, key, key_len, hash, &found);
+    if (!found) {
+        return OBJECT_INVALID_IX;
     }
+    return object->cells[cell_ix];
+}
+
+/* Adds an item without checking for duplicates, caller has to make sure name isn't used yet. */
+static JSON_Status json_object_append(JSON_Object *object, char *name, unsigned long hash, JSON_Value *value) {
+    parson_bool_t found = PARSON_FALSE;
+    size_t cell_ix = 0;
+    JSON_Status res = JSONFailure;
 
     if (object->count >= object->item_capacity) {
         res = json_object_grow_and_rehash(object);
         if (res != JSONSuccess) {
             return JSONFailure;
         }
-        cell_ix = json_object_get_cell_ix(object, name, strlen(name), hash, &found);
     }
 
+    if (!OBJECT_IS_SMALL(object)) {
+        cell_ix = json_object_get_cell_ix(object, name, strlen(name), hash, &found);
+        object->cells[cell_ix] = object->count;
+        object->cell_ixs[object->count] = cell_ix;
+    }
     object->names[object->count] = name;
-    object->cells[cell_ix] = object->count;
     object->values[object->count] = value;
-    object->cell_ixs[object->count] = cell_ix;
     object->hashes[object->count] = hash;
     object->count++;
     value->parent = json_object_get_wrapping_value(object);
@@ -619,21 +1040,33 @@ static JSON_Status json_object_add(JSON_Object *object, char *name, JSON_Value *
     return JSONSuccess;
 }
 
+static JSON_Status json_object_add(JSON_Object *object, char *name, JSON_Value *value) {
+    unsigned long hash = 0;
+    size_t name_len = 0;
+
+    if (!object || !name || !value) {
+        return JSONFailure;
+    }
+
+    name_len = strlen(name);
+    hash = hash_string(name, name_len);
+    if (json_object_get_item_ix(object, name, name_len, hash) != OBJECT_INVALID_IX) {
+        return JSONFailure;
+    }
+    return json_object_append(object, name, hash, value);
+}
+
 static JSON_Value * json_object_getn_value(const JSON_Object *object, const char *name, size_t name_len) {
     unsigned long hash = 0;
-    parson_bool_t found = PARSON_FALSE;
-    size_t cell_ix = 0;
     size_t item_ix = 0;
     if (!object || !name) {
         return NULL;
     }
     hash = hash_string(name, name_len);
-    found = PARSON_FALSE;
-    cell_ix = json_object_get_cell_ix(object, name, name_len, hash, &found);
-    if (!found) {
+    item_ix = json_object_get_item_ix(object, name, name_len, hash);
+    if (item_ix == OBJECT_INVALID_IX) {
         return NULL;
     }
-    item_ix = object->cells[cell_ix];
     return object->values[item_ix];
 }
 
@@ -654,13 +1087,20 @@ static JSON_Status json_object_remove_internal(JSON_Object *object, const char *
     }
 
     hash = hash_string(name, strlen(name));
-    found = PARSON_FALSE;
-    cell = json_object_get_cell_ix(object, name, strlen(name), hash, &found);
-    if (!found) {
-        return JSONFailure;
+    if (OBJECT_IS_SMALL(object)) {
+        item_ix = json_object_get_item_ix(object, name, strlen(name), hash);
+        if (item_ix == OBJECT_INVALID_IX) {
+            return JSONFailure;
+        }
+    } else {
+        found = PARSON_FALSE;
+        cell = json_object_get_cell_ix(object, name, strlen(name), hash, &found);
+        if (!found) {
+            return JSONFailure;
+        }
+        item_ix = object->cells[cell];
     }
 
-    item_ix = object->cells[cell];
     if (free_value) {
         val = object->values[item_ix];
         json_value_free(val);
@@ -672,12 +1112,18 @@ static JSON_Status json_object_remove_internal(JSON_Object *object, const char *
     if (item_ix < last_item_ix) {
         object->names[item_ix] = object->names[last_item_ix];
         object->values[item_ix] = object->values[last_item_ix];
-        object->cell_ixs[item_ix] = object->cell_ixs[last_item_ix];
         object->hashes[item_ix] = object->hashes[last_item_ix];
-        object->cells[object->cell_ixs[item_ix]] = item_ix;
+        if (!OBJECT_IS_SMALL(object)) {
+            object->cell_ixs[item_ix] = object->cell_ixs[last_item_ix];
+            object->cells[object->cell_ixs[item_ix]] = item_ix;
+        }
     }
     object->count--;
 
+    if (OBJECT_IS_SMALL(object)) {
+        return JSONSuccess;
+    }
+
     i = cell;
     j = i;
     for (x = 0; x < (object->cell_capacity - 1); x++) {
@@ -777,6 +1223,7 @@ static JSON_Value * json_value_init_string_no_copy(char *string, size_t length)
         return NULL;
     }
     new_value->parent = NULL;
+    new_value->context = PARSON_CONTEXT();
     new_value->type = JSONString;
     new_value->value.string.chars = string;
     new_value->value.string.length = length;
@@ -789,8 +1236,11 @@ static JSON_Status skip_quotes(const char **string) {
         return JSONFailure;
     }
     SKIP_CHAR(string);
-    while (**string != '\"') {
-        if (**string == '\0') {
+    for (;;) {
+        *string = scan_string_body(*string);
+        if (**string == '\"') {
+            break;
+        } else if (**string == '\0') {
             return JSONFailure;
         } else if (**string == '\\') {
             SKIP_CHAR(string);
@@ -854,9 +1304,9 @@ static JSON_Status parse_utf16(const char **unprocessed, char **processed) {
 /* Copies and processes passed string up to supplied length.
 Example: "\u006Corem ipsum" -> lorem ipsum */
 static char* process_string(const char *input, size_t input_len, size_t *output_len) {
-    const char *input_ptr = input;
+    const char *input_ptr = input, *run_end = NULL;
     size_t initial_size = (input_len + 1) * sizeof(char);
-    size_t final_size = 0;
+    size_t final_size = 0, run_len = 0;
     char *output = NULL, *output_ptr = NULL, *resized_output = NULL;
     output = (char*)parson_malloc(initial_size);
     if (output == NULL) {
@@ -864,6 +1314,18 @@ static char* process_string(const char *input, size_t input_len, size_t *output_
     }
     output_ptr = output;
     while ((*input_ptr != '\0') && (size_t)(input_ptr - input) < input_len) {
+        /* copy the run of plain characters in one go */
+        run_end = scan_string_body(input_ptr);
+        run_len = (size_t)(run_end - input_ptr);
+        if (run_len > input_len - (size_t)(input_ptr - input)) {
+            run_len = input_len - (size_t)(input_ptr - input);
+        }
+        if (run_len > 0) {
+            memcpy(output_ptr, input_ptr, run_len);
+            output_ptr += run_len;
+            input_ptr += run_len;
+            continue;
+        }
         if (*input_ptr == '\\') {
             input_ptr++;
             switch (*input_ptr) {
@@ -894,7 +1356,10 @@ static char* process_string(const char *input, size_t input_len, size_t *output_
     *output_ptr = '\0';
     /* resize to new length */
     final_size = (size_t)(output_ptr-output) + 1;
-    /* todo: don't resize if final_size == initial_size */
+    if (final_size == initial_size) { /* no escapes, nothing to shrink */
+        *output_len = final_size - 1;
+        return output;
+    }
     resized_output = (char*)parson_malloc(final_size);
     if (resized_output == NULL) {
         goto error;
@@ -1000,6 +1465,7 @@ static JSON_Value * parse_object_value(const char **string, size_t nesting) {
             json_value_free(output_value);
             return NULL;
         }
+        release_parsed_input(*string);
         SKIP_WHITESPACES(string);
         if (**string != ',') {
             break;
@@ -1048,6 +1514,7 @@ static JSON_Value * parse_array_value(const char **string, size_t nesting) {
             json_value_free(output_value);
             return NULL;
         }
+        release_parsed_input(*string);
         SKIP_WHITESPACES(string);
         if (**string != ',') {
             break;
@@ -1263,10 +1730,10 @@ static int json_serialize_to_buffer_r(const JSON_Value *value, char *buf, int le
             if (buf != NULL) {
                 num_buf = buf;
             }
-            if (parson_number_serialization_function) {
-                written = parson_number_serialization_function(num, num_buf);
+            if (PARSON_CONTEXT()->number_serialization_function) {
+                written = PARSON_CONTEXT()->number_serialization_function(num, num_buf);
             } else {
-                const char *float_format = parson_float_format ? parson_float_format : PARSON_DEFAULT_FLOAT_FORMAT;
+                const char *float_format = PARSON_CONTEXT()->float_format ? PARSON_CONTEXT()->float_format : PARSON_DEFAULT_FLOAT_FORMAT;
                 written = parson_sprintf(num_buf, float_format, num);
             }
             if (written < 0) {
@@ -1335,7 +1802,7 @@ static int json_serialize_string(const char *string, size_t len, char *buf) {
             case '\x1e': APPEND_STRING("\\u001e"); break;
             case '\x1f': APPEND_STRING("\\u001f"); break;
             case '/':
-                if (parson_escape_slashes) {
+                if (PARSON_CONTEXT()->escape_slashes) {
                     APPEND_STRING("\\/");  /* to make json embeddable in xml\/html */
                 } else {
                     APPEND_STRING("/");
@@ -1359,8 +1826,17 @@ static int json_serialize_string(const char *string, size_t len, char *buf) {
 
 /* Parser API */
 JSON_Value * json_parse_file(const char *filename) {
-    char *file_contents = read_file(filename);
+    size_t map_size = 0;
+    char *file_contents = map_file(filename, PARSON_FALSE, &map_size);
     JSON_Value *output_value = NULL;
+    if (file_contents != NULL) {
+        begin_mapped_input(file_contents);
+        output_value = json_parse_string(file_contents);
+        end_mapped_input();
+        unmap_file(file_contents, map_size);
+        return output_value;
+    }
+    file_contents = read_file(filename);
     if (file_contents == NULL) {
         return NULL;
     }
@@ -1370,8 +1846,20 @@ JSON_Value * json_parse_file(const char *filename) {
 }
 
 JSON_Value * json_parse_file_with_comments(const char *filename) {
-    char *file_contents = read_file(filename);
+    size_t map_size = 0;
+    char *file_contents = map_file(filename, PARSON_TRUE, &map_size);
+    char *file_contents_ptr = NULL;
     JSON_Value *output_value = NULL;
+    if (file_contents != NULL) {
+        /* the mapping is private, comments can be blanked out in place */
+        remove_comments(file_contents, "/*", "*/");
+        remove_comments(file_contents, "//", "\n");
+        file_contents_ptr = file_contents;
+        output_value = parse_value((const char**)&file_contents_ptr, 0);
+        unmap_file(file_contents, map_size);
+        return output_value;
+    }
+    file_contents = read_file(filename);
     if (file_contents == NULL) {
         return NULL;
     }
@@ -1597,6 +2085,11 @@ JSON_Value * json_value_get_parent (const JSON_Value *value) {
 }
 
 void json_value_free(JSON_Value *value) {
+    const JSON_Context *previous = NULL;
+    if (value == NULL) {
+        return;
+    }
+    previous = parson_enter_context(value);
     switch (json_value_get_type(value)) {
         case JSONObject:
             json_object_free(value->value.object);
@@ -1611,6 +2104,7 @@ void json_value_free(JSON_Value *value) {
             break;
     }
     parson_free(value);
+    json_context_make_current(previous);
 }
 
 JSON_Value * json_value_init_object(void) {
@@ -1619,6 +2113,7 @@ JSON_Value * json_value_init_object(void) {
         return NULL;
     }
     new_value->parent = NULL;
+    new_value->context = PARSON_CONTEXT();
     new_value->type = JSONObject;
     new_value->value.object = json_object_make(new_value);
     if (!new_value->value.object) {
@@ -1634,6 +2129,7 @@ JSON_Value * json_value_init_array(void) {
         return NULL;
     }
     new_value->parent = NULL;
+    new_value->context = PARSON_CONTEXT();
     new_value->type = JSONArray;
     new_value->value.array = json_array_make(new_value);
     if (!new_value->value.array) {
@@ -1680,6 +2176,7 @@ JSON_Value * json_value_init_number(double number) {
         return NULL;
     }
     new_value->parent = NULL;
+    new_value->context = PARSON_CONTEXT();
     new_value->type = JSONNumber;
     new_value->value.number = number;
     return new_value;
@@ -1691,6 +2188,7 @@ JSON_Value * json_value_init_boolean(int boolean) {
         return NULL;
     }
     new_value->parent = NULL;
+    new_value->context = PARSON_CONTEXT();
     new_value->type = JSONBoolean;
     new_value->value.boolean = boolean ? 1 : 0;
     return new_value;
@@ -1702,11 +2200,12 @@ JSON_Value * json_value_init_null(void) {
         return NULL;
     }
     new_value->parent = NULL;
+    new_value->context = PARSON_CONTEXT();
     new_value->type = JSONNull;
     return new_value;
 }
 
-JSON_Value * json_value_deep_copy(const JSON_Value *value) {
+static JSON_Value * json_value_deep_copy_r(const JSON_Value *value) {
     size_t i = 0;
     JSON_Value *return_value = NULL, *temp_value_copy = NULL, *temp_value = NULL;
     const JSON_String *temp_string = NULL;
@@ -1727,7 +2226,7 @@ JSON_Value * json_value_deep_copy(const JSON_Value *value) {
             temp_array_copy = json_value_get_array(return_value);
             for (i = 0; i < json_array_get_count(temp_array); i++) {
                 temp_value = json_array_get_value(temp_array, i);
-                temp_value_copy = json_value_deep_copy(temp_value);
+                temp_value_copy = json_value_deep_copy_r(temp_value);
                 if (temp_value_copy == NULL) {
                     json_value_free(return_value);
                     return NULL;
@@ -1749,7 +2248,7 @@ JSON_Value * json_value_deep_copy(const JSON_Value *value) {
             for (i = 0; i < json_object_get_count(temp_object); i++) {
                 temp_key = json_object_get_name(temp_object, i);
                 temp_value = json_object_get_value(temp_object, temp_key);
-                temp_value_copy = json_value_deep_copy(temp_value);
+                temp_value_copy = json_value_deep_copy_r(temp_value);
                 if (!temp_value_copy) {
                     json_value_free(return_value);
                     return NULL;
@@ -1796,6 +2295,13 @@ JSON_Value * json_value_deep_copy(const JSON_Value *value) {
     }
 }
 
+JSON_Value * json_value_deep_copy(const JSON_Value *value) {
+    if (value == NULL) {
+        return NULL;
+    }
+    return json_value_deep_copy_ctx(value->context, value);
+}
+
 size_t json_serialization_size(const JSON_Value *value) {
     char num_buf[PARSON_NUM_BUF_SIZE]; /* recursively allocating buffer on stack is a bad idea, so let's do it only once */
     int res = json_serialize_to_buffer_r(value, NULL, 0, PARSON_FALSE, num_buf);
@@ -1933,7 +2439,8 @@ JSON_Status json_array_remove(JSON_Array *array, size_t ix) {
 }
 
 JSON_Status json_array_replace_value(JSON_Array *array, size_t ix, JSON_Value *value) {
-    if (array == NULL || value == NULL || value->parent != NULL || ix >= json_array_get_count(array)) {
+    if (array == NULL || value == NULL || value->parent != NULL || ix >= json_array_get_count(array) ||
+        value->context != array->wrapping_value->context) {
         return JSONFailure;
     }
     json_value_free(json_array_get_value(array, ix));
@@ -1943,63 +2450,98 @@ JSON_Status json_array_replace_value(JSON_Array *array, size_t ix, JSON_Value *v
 }
 
 JSON_Status json_array_replace_string(JSON_Array *array, size_t i, const char* string) {
-    JSON_Value *value = json_value_init_string(string);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_replace_value(array, i, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_string(string);
+    if (value != NULL) {
+        status = json_array_replace_value(array, i, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_replace_string_with_len(JSON_Array *array, size_t i, const char *string, size_t len) {
-    JSON_Value *value = json_value_init_string_with_len(string, len);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_replace_value(array, i, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_string_with_len(string, len);
+    if (value != NULL) {
+        status = json_array_replace_value(array, i, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_replace_number(JSON_Array *array, size_t i, double number) {
-    JSON_Value *value = json_value_init_number(number);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_replace_value(array, i, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_number(number);
+    if (value != NULL) {
+        status = json_array_replace_value(array, i, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_replace_boolean(JSON_Array *array, size_t i, int boolean) {
-    JSON_Value *value = json_value_init_boolean(boolean);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_replace_value(array, i, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_boolean(boolean);
+    if (value != NULL) {
+        status = json_array_replace_value(array, i, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_replace_null(JSON_Array *array, size_t i) {
-    JSON_Value *value = json_value_init_null();
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_replace_value(array, i, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_null();
+    if (value != NULL) {
+        status = json_array_replace_value(array, i, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_clear(JSON_Array *array) {
@@ -2015,76 +2557,114 @@ JSON_Status json_array_clear(JSON_Array *array) {
 }
 
 JSON_Status json_array_append_value(JSON_Array *array, JSON_Value *value) {
-    if (array == NULL || value == NULL || value->parent != NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL || value == NULL || value->parent != NULL || value->context != array->wrapping_value->context) {
         return JSONFailure;
     }
-    return json_array_add(array, value);
+    previous = parson_enter_context(array->wrapping_value);
+    status = json_array_add(array, value);
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_append_string(JSON_Array *array, const char *string) {
-    JSON_Value *value = json_value_init_string(string);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_append_value(array, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_string(string);
+    if (value != NULL) {
+        status = json_array_append_value(array, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_append_string_with_len(JSON_Array *array, const char *string, size_t len) {
-    JSON_Value *value = json_value_init_string_with_len(string, len);
-    if (value == NULL) {
-        return JSONFailure;
-    }
-    if (json_array_append_value(array, value) != JSONSuccess) {
-        json_value_free(value);
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    return JSONSuccess;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_string_with_len(string, len);
+    if (value != NULL) {
+        status = json_array_append_value(array, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
+    }
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_append_number(JSON_Array *array, double number) {
-    JSON_Value *value = json_value_init_number(number);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_append_value(array, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_number(number);
+    if (value != NULL) {
+        status = json_array_append_value(array, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_append_boolean(JSON_Array *array, int boolean) {
-    JSON_Value *value = json_value_init_boolean(boolean);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_append_value(array, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_boolean(boolean);
+    if (value != NULL) {
+        status = json_array_append_value(array, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_array_append_null(JSON_Array *array) {
-    JSON_Value *value = json_value_init_null();
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (array == NULL) {
         return JSONFailure;
     }
-    if (json_array_append_value(array, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(array->wrapping_value);
+    value = json_value_init_null();
+    if (value != NULL) {
+        status = json_array_append_value(array, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
-JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Value *value) {
+static JSON_Status json_object_set_value_internal(JSON_Object *object, const char *name, JSON_Value *value) {
     unsigned long hash = 0;
-    parson_bool_t found = PARSON_FALSE;
-    size_t cell_ix = 0;
     size_t item_ix = 0;
     JSON_Value *old_value = NULL;
     char *key_copy = NULL;
@@ -2093,83 +2673,138 @@ JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Va
         return JSONFailure;
     }
     hash = hash_string(name, strlen(name));
-    found = PARSON_FALSE;
-    cell_ix = json_object_get_cell_ix(object, name, strlen(name), hash, &found);
-    if (found) {
-        item_ix = object->cells[cell_ix];
+    item_ix = json_object_get_item_ix(object, name, strlen(name), hash);
+    if (item_ix != OBJECT_INVALID_IX) {
         old_value = object->values[item_ix];
         json_value_free(old_value);
         object->values[item_ix] = value;
         value->parent = json_object_get_wrapping_value(object);
         return JSONSuccess;
     }
-    if (object->count >= object->item_capacity) {
-        JSON_Status res = json_object_grow_and_rehash(object);
-        if (res != JSONSuccess) {
-            return JSONFailure;
-        }
-        cell_ix = json_object_get_cell_ix(object, name, strlen(name), hash, &found);
-    }
     key_copy = parson_strdup(name);
     if (!key_copy) {
         return JSONFailure;
     }
-    object->names[object->count] = key_copy;
-    object->cells[cell_ix] = object->count;
-    object->values[object->count] = value;
-    object->cell_ixs[object->count] = cell_ix;
-    object->hashes[object->count] = hash;
-    object->count++;
-    value->parent = json_object_get_wrapping_value(object);
+    if (json_object_append(object, key_copy, hash, value) != JSONSuccess) {
+        parson_free(key_copy);
+        return JSONFailure;
+    }
     return JSONSuccess;
 }
 
+/* Runs set_value or dotset_value in the object's context, values from another context are refused */
+static JSON_Status json_object_set_in_context(JSON_Object *object, const char *name, JSON_Value *value, parson_bool_t dotted) {
+    const JSON_Context *previous = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL || value == NULL || value->context != object->wrapping_value->context) {
+        return JSONFailure;
+    }
+    previous = parson_enter_context(object->wrapping_value);
+    status = dotted ? json_object_dotset_value_internal(object, name, value) : json_object_set_value_internal(object, name, value);
+    json_context_make_current(previous);
+    return status;
+}
+
+JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Value *value) {
+    return json_object_set_in_context(object, name, value, PARSON_FALSE);
+}
+
 JSON_Status json_object_set_string(JSON_Object *object, const char *name, const char *string) {
-    JSON_Value *value = json_value_init_string(string);
-    JSON_Status status = json_object_set_value(object, name, value);
-    if (status != JSONSuccess) {
-        json_value_free(value);
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
+        return JSONFailure;
     }
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_string(string);
+    if (value != NULL) {
+        status = json_object_set_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
+    }
+    json_context_make_current(previous);
     return status;
 }
 
 JSON_Status json_object_set_string_with_len(JSON_Object *object, const char *name, const char *string, size_t len) {
-    JSON_Value *value = json_value_init_string_with_len(string, len);
-    JSON_Status status = json_object_set_value(object, name, value);
-    if (status != JSONSuccess) {
-        json_value_free(value);
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
+        return JSONFailure;
     }
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_string_with_len(string, len);
+    if (value != NULL) {
+        status = json_object_set_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
+    }
+    json_context_make_current(previous);
     return status;
 }
 
 JSON_Status json_object_set_number(JSON_Object *object, const char *name, double number) {
-    JSON_Value *value = json_value_init_number(number);
-    JSON_Status status = json_object_set_value(object, name, value);
-    if (status != JSONSuccess) {
-        json_value_free(value);
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
+        return JSONFailure;
     }
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_number(number);
+    if (value != NULL) {
+        status = json_object_set_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
+    }
+    json_context_make_current(previous);
     return status;
 }
 
 JSON_Status json_object_set_boolean(JSON_Object *object, const char *name, int boolean) {
-    JSON_Value *value = json_value_init_boolean(boolean);
-    JSON_Status status = json_object_set_value(object, name, value);
-    if (status != JSONSuccess) {
-        json_value_free(value);
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
+        return JSONFailure;
+    }
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_boolean(boolean);
+    if (value != NULL) {
+        status = json_object_set_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
+    json_context_make_current(previous);
     return status;
 }
 
 JSON_Status json_object_set_null(JSON_Object *object, const char *name) {
-    JSON_Value *value = json_value_init_null();
-    JSON_Status status = json_object_set_value(object, name, value);
-    if (status != JSONSuccess) {
-        json_value_free(value);
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
+        return JSONFailure;
     }
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_null();
+    if (value != NULL) {
+        status = json_object_set_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
+    }
+    json_context_make_current(previous);
     return status;
 }
 
-JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON_Value *value) {
+static JSON_Status json_object_dotset_value_internal(JSON_Object *object, const char *name, JSON_Value *value) {
     const char *dot_pos = NULL;
     JSON_Value *temp_value = NULL, *new_value = NULL;
     JSON_Object *temp_object = NULL, *new_object = NULL;
@@ -2182,7 +2817,7 @@ JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON
     }
     dot_pos = strchr(name, '.');
     if (dot_pos == NULL) {
-        return json_object_set_value(object, name, value);
+        return json_object_set_value_internal(object, name, value);
     }
     name_len = dot_pos - name;
     temp_value = json_object_getn_value(object, name, name_len);
@@ -2192,14 +2827,14 @@ JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON
             return JSONFailure;
         }
         temp_object = json_value_get_object(temp_value);
-        return json_object_dotset_value(temp_object, dot_pos + 1, value);
+        return json_object_dotset_value_internal(temp_object, dot_pos + 1, value);
     }
     new_value = json_value_init_object();
     if (new_value == NULL) {
         return JSONFailure;
     }
     new_object = json_value_get_object(new_value);
-    status = json_object_dotset_value(new_object, dot_pos + 1, value);
+    status = json_object_dotset_value_internal(new_object, dot_pos + 1, value);
     if (status != JSONSuccess) {
         json_value_free(new_value);
         return JSONFailure;
@@ -2220,79 +2855,136 @@ JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON
     return JSONSuccess;
 }
 
+JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON_Value *value) {
+    return json_object_set_in_context(object, name, value, PARSON_TRUE);
+}
+
 JSON_Status json_object_dotset_string(JSON_Object *object, const char *name, const char *string) {
-    JSON_Value *value = json_value_init_string(string);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
         return JSONFailure;
     }
-    if (json_object_dotset_value(object, name, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_string(string);
+    if (value != NULL) {
+        status = json_object_dotset_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_object_dotset_string_with_len(JSON_Object *object, const char *name, const char *string, size_t len) {
-    JSON_Value *value = json_value_init_string_with_len(string, len);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
         return JSONFailure;
     }
-    if (json_object_dotset_value(object, name, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_string_with_len(string, len);
+    if (value != NULL) {
+        status = json_object_dotset_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_object_dotset_number(JSON_Object *object, const char *name, double number) {
-    JSON_Value *value = json_value_init_number(number);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
         return JSONFailure;
     }
-    if (json_object_dotset_value(object, name, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_number(number);
+    if (value != NULL) {
+        status = json_object_dotset_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_object_dotset_boolean(JSON_Object *object, const char *name, int boolean) {
-    JSON_Value *value = json_value_init_boolean(boolean);
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
         return JSONFailure;
     }
-    if (json_object_dotset_value(object, name, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_boolean(boolean);
+    if (value != NULL) {
+        status = json_object_dotset_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_object_dotset_null(JSON_Object *object, const char *name) {
-    JSON_Value *value = json_value_init_null();
-    if (value == NULL) {
+    const JSON_Context *previous = NULL;
+    JSON_Value *value = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
         return JSONFailure;
     }
-    if (json_object_dotset_value(object, name, value) != JSONSuccess) {
-        json_value_free(value);
-        return JSONFailure;
+    previous = parson_enter_context(object->wrapping_value);
+    value = json_value_init_null();
+    if (value != NULL) {
+        status = json_object_dotset_value_internal(object, name, value);
+        if (status != JSONSuccess) {
+            json_value_free(value);
+        }
     }
-    return JSONSuccess;
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_object_remove(JSON_Object *object, const char *name) {
-    return json_object_remove_internal(object, name, PARSON_TRUE);
+    const JSON_Context *previous = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
+        return JSONFailure;
+    }
+    previous = parson_enter_context(object->wrapping_value);
+    status = json_object_remove_internal(object, name, PARSON_TRUE);
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_object_dotremove(JSON_Object *object, const char *name) {
-    return json_object_dotremove_internal(object, name, PARSON_TRUE);
+    const JSON_Context *previous = NULL;
+    JSON_Status status = JSONFailure;
+    if (object == NULL) {
+        return JSONFailure;
+    }
+    previous = parson_enter_context(object->wrapping_value);
+    status = json_object_dotremove_internal(object, name, PARSON_TRUE);
+    json_context_make_current(previous);
+    return status;
 }
 
 JSON_Status json_object_clear(JSON_Object *object) {
+    const JSON_Context *previous = NULL;
     size_t i = 0;
     if (object == NULL) {
         return JSONFailure;
     }
+    previous = parson_enter_context(object->wrapping_value);
     for (i = 0; i < json_object_get_count(object); i++) {
         parson_free(object->names[i]);
         object->names[i] = NULL;
@@ -2304,6 +2996,7 @@ JSON_Status json_object_clear(JSON_Object *object) {
     for (i = 0; i < object->cell_capacity; i++) {
         object->cells[i] = OBJECT_INVALID_IX;
     }
+    json_context_make_current(previous);
     return JSONSuccess;
 }
 
@@ -2367,6 +3060,225 @@ JSON_Status json_validate(const JSON_Value *schema, const JSON_Value *value) {
     }
 }
 
+static void json_schema_measure(const JSON_Value *schema, size_t *node_count, size_t *key_count, size_t *names_size) {
+    const JSON_Object *object = NULL;
+    const JSON_Array *array = NULL;
+    size_t i = 0;
+    *node_count += 1;
+    switch (json_value_get_type(schema)) {
+        case JSONArray:
+            array = json_value_get_array(schema);
+            if (json_array_get_count(array) > 0) {
+                json_schema_measure(json_array_get_value(array, 0), node_count, key_count, names_size);
+            }
+            break;
+        case JSONObject:
+            object = json_value_get_object(schema);
+            *key_count += object->count;
+            for (i = 0; i < object->count; i++) {
+                *names_size += strlen(object->names[i]) + 1;
+                json_schema_measure(object->values[i], node_count, key_count, names_size);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static size_t json_schema_emit(JSON_Schema *compiled, const JSON_Value *schema, char **names) {
+    const JSON_Object *object = NULL;
+    const JSON_Array *array = NULL;
+    JSON_Schema_Key *key = NULL;
+    size_t node_ix = compiled->node_count;
+    size_t first = 0, name_len = 0, i = 0;
+    compiled->node_count++;
+    compiled->nodes[node_ix].type = json_value_get_type(schema);
+    compiled->nodes[node_ix].first = 0;
+    compiled->nodes[node_ix].count = 0;
+    switch (compiled->nodes[node_ix].type) {
+        case JSONArray:
+            array = json_value_get_array(schema);
+            if (json_array_get_count(array) > 0) { /* only the first value is checked, like json_validate */
+                first = json_schema_emit(compiled, json_array_get_value(array, 0), names);
+                compiled->nodes[node_ix].first = first;
+                compiled->nodes[node_ix].count = 1;
+            }
+            break;
+        case JSONObject:
+            object = json_value_get_object(schema);
+            first = compiled->key_count;
+            compiled->key_count += object->count;
+            compiled->nodes[node_ix].first = first;
+            compiled->nodes[node_ix].count = object->count;
+            for (i = 0; i < object->count; i++) {
+                key = &compiled->keys[first + i];
+                name_len = strlen(object->names[i]);
+                memcpy(*names, object->names[i], name_len + 1);
+                key->name = *names;
+                key->name_len = name_len;
+                key->hash = hash_string(key->name, name_len);
+                *names += name_len + 1;
+                key->node = json_schema_emit(compiled, object->values[i], names);
+            }
+            break;
+        default:
+            break;
+    }
+    return node_ix;
+}
+
+/* Schema keys are usually in the same order as the keys of documents they validate, so the key at
+   the same index is tried before a hash lookup. */
+static const JSON_Value * json_schema_find_value(const JSON_Object *object, const JSON_Schema_Key *key, size_t hint) {
+    size_t item_ix = 0;
+    if (hint < object->count
+        && object->hashes[hint] == key->hash
+        && strcmp(object->names[hint], key->name) == 0) {
+        return object->values[hint];
+    }
+    item_ix = json_object_get_item_ix(object, key->name, key->name_len, key->hash);
+    if (item_ix == OBJECT_INVALID_IX) {
+        return NULL;
+    }
+    return object->values[item_ix];
+}
+
+static void json_schema_path_prepend(JSON_Schema_Error_Path *path, const char *segment, size_t segment_len) {
+    parson_bool_t needs_dot = PARSON_FALSE;
+    if (path->buf == NULL || path->truncated) {
+        return;
+    }
+    /* names are separated from whatever follows them with a dot, indices aren't */
+    needs_dot = path->buf[path->start] != '\0' && path->buf[path->start] != '[';
+    if (segment_len + (needs_dot ? 1 : 0) > path->start) {
+        path->truncated = PARSON_TRUE;
+        return;
+    }
+    if (needs_dot) {
+        path->start--;
+        path->buf[path->start] = '.';
+    }
+    path->start -= segment_len;
+    memcpy(path->buf + path->start, segment, segment_len);
+}
+
+static JSON_Status json_schema_validate_r(const JSON_Schema *schema, size_t node_ix, const JSON_Value *value, JSON_Schema_Error_Path *path) {
+    const JSON_Schema_Node *node = &schema->nodes[node_ix];
+    const JSON_Schema_Key *key = NULL;
+    const JSON_Value *temp_value = NULL;
+    const JSON_Array *array = NULL;
+    const JSON_Object *object = NULL;
+    JSON_Value_Type element_type = JSONError;
+    char index_buf[PARSON_NUM_BUF_SIZE];
+    int index_len = 0;
+    size_t i = 0;
+    if (node->type == JSONNull) { /* null represents all values */
+        return JSONSuccess;
+    }
+    if (node->type != value->type) {
+        return JSONFailure;
+    }
+    switch (node->type) {
+        case JSONArray:
+            if (node->count == 0) {
+                return JSONSuccess; /* Empty array allows all types */
+            }
+            array = value->value.array;
+            element_type = schema->nodes[node->first].type;
+            if (element_type != JSONArray && element_type != JSONObject) {
+                /* arrays of scalars only need a type check per item */
+                for (i = 0; i < array->count && element_type != JSONNull; i++) {
+                    if (array->items[i]->type != element_type) {
+                        index_len = parson_sprintf(index_buf, "[%lu]", (unsigned long)i);
+                        json_schema_path_prepend(path, index_buf, (size_t)index_len);
+                        return JSONFailure;
+                    }
+                }
+                return JSONSuccess;
+            }
+            for (i = 0; i < array->count; i++) {
+                if (json_schema_validate_r(schema, node->first, array->items[i], path) != JSONSuccess) {
+                    index_len = parson_sprintf(index_buf, "[%lu]", (unsigned long)i);
+                    json_schema_path_prepend(path, index_buf, (size_t)index_len);
+                    return JSONFailure;
+                }
+            }
+            return JSONSuccess;
+        case JSONObject:
+            if (node->count == 0) {
+                return JSONSuccess; /* Empty object allows all objects */
+            }
+            object = value->value.object;
+            if (object->count < node->count) {
+                return JSONFailure; /* Tested object mustn't have less name-value pairs than schema */
+            }
+            for (i = 0; i < node->count; i++) {
+                key = &schema->keys[node->first + i];
+                temp_value = json_schema_find_value(object, key, i);
+                if (temp_value == NULL
+                    || json_schema_validate_r(schema, key->node, temp_value, path) != JSONSuccess) {
+                    json_schema_path_prepend(path, key->name, key->name_len);
+                    return JSONFailure;
+                }
+            }
+            return JSONSuccess;
+        default:
+            return JSONSuccess; /* equality already tested before switch */
+    }
+}
+
+JSON_Schema * json_schema_compile(const JSON_Value *schema) {
+    JSON_Schema *compiled = NULL;
+    size_t node_count = 0, key_count = 0, names_size = 0;
+    char *names = NULL;
+    if (schema == NULL) {
+        return NULL;
+    }
+    json_schema_measure(schema, &node_count, &key_count, &names_size);
+    compiled = (JSON_Schema*)parson_malloc(sizeof(JSON_Schema)
+                                           + node_count * sizeof(JSON_Schema_Node)
+                                           + key_count * sizeof(JSON_Schema_Key)
+                                           + names_size);
+    if (compiled == NULL) {
+        return NULL;
+    }
+    compiled->nodes = (JSON_Schema_Node*)(compiled + 1);
+    compiled->keys = (JSON_Schema_Key*)(compiled->nodes + node_count);
+    compiled->node_count = 0;
+    compiled->key_count = 0;
+    names = (char*)(compiled->keys + key_count);
+    json_schema_emit(compiled, schema, &names);
+    return compiled;
+}
+
+JSON_Status json_schema_validate(const JSON_Schema *schema, const JSON_Value *value, char *error_path, size_t error_path_size) {
+    JSON_Schema_Error_Path path;
+    JSON_Status status = JSONFailure;
+    path.buf = NULL;
+    path.start = 0;
+    path.truncated = PARSON_FALSE;
+    if (error_path != NULL && error_path_size > 0) {
+        path.buf = error_path;
+        path.start = error_path_size - 1;
+        error_path[path.start] = '\0';
+    }
+    if (schema == NULL || value == NULL) {
+        if (path.buf) {
+            path.buf[0] = '\0';
+        }
+        return JSONFailure;
+    }
+    status = json_schema_validate_r(schema, 0, value, &path);
+    if (path.buf) {
+        memmove(path.buf, path.buf + path.start, error_path_size - path.start);
+    }
+    return status;
+}
+
+void json_schema_free(JSON_Schema *schema) {
+    parson_free(schema);
+}
+
 int json_value_equals(const JSON_Value *a, const JSON_Value *b) {
     JSON_Object *a_object = NULL, *b_object = NULL;
     JSON_Array *a_array = NULL, *b_array = NULL;
@@ -2461,26 +3373,117 @@ int json_boolean(const JSON_Value *value) {
 }
 
 void json_set_allocation_functions(JSON_Malloc_Function malloc_fun, JSON_Free_Function free_fun) {
-    parson_malloc = malloc_fun;
-    parson_free = free_fun;
+    parson_global_malloc = malloc_fun;
+    parson_global_free = free_fun;
 }
 
 void json_set_escape_slashes(int escape_slashes) {
-    parson_escape_slashes = escape_slashes;
+    parson_global_context.escape_slashes = escape_slashes;
 }
 
 void json_set_float_serialization_format(const char *format) {
-    if (parson_float_format) {
-        parson_free(parson_float_format);
-        parson_float_format = NULL;
+    size_t format_len = 0;
+    if (parson_global_float_format) {
+        parson_global_free(parson_global_float_format);
+        parson_global_float_format = NULL;
     }
+    parson_global_context.float_format = NULL;
     if (!format) {
-        parson_float_format = NULL;
         return;
     }
-    parson_float_format = parson_strdup(format);
+    format_len = strlen(format);
+    parson_global_float_format = (char*)parson_global_malloc(format_len + 1);
+    if (!parson_global_float_format) {
+        return;
+    }
+    memcpy(parson_global_float_format, format, format_len + 1);
+    parson_global_context.float_format = parson_global_float_format;
 }
 
 void json_set_number_serialization_function(JSON_Number_Serialization_Function func) {
-    parson_number_serialization_function = func;
+    parson_global_context.number_serialization_function = func;
+}
+
+/* Contexts */
+static void * default_context_malloc(void *allocator_data, size_t size) {
+    (void)allocator_data;
+    return malloc(size);
+}
+
+static void default_context_free(void *allocator_data, void *ptr) {
+    (void)allocator_data;
+    free(ptr);
+}
+
+void json_context_init(JSON_Context *context) {
+    if (context == NULL) {
+        return;
+    }
+    context->malloc_fun = default_context_malloc;
+    context->free_fun = default_context_free;
+    context->allocator_data = NULL;
+    context->escape_slashes = 1;
+    context->float_format = NULL;
+    context->number_serialization_function = NULL;
+}
+
+const JSON_Context * json_context_make_current(const JSON_Context *context) {
+    const JSON_Context *previous = parson_current_context;
+    parson_current_context = context;
+    return previous;
+}
+
+JSON_Value * json_parse_file_ctx(const JSON_Context *context, const char *filename) {
+    const JSON_Context *previous = json_context_make_current(context);
+    JSON_Value *result = json_parse_file(filename);
+    json_context_make_current(previous);
+    return result;
+}
+
+JSON_Value * json_parse_file_with_comments_ctx(const JSON_Context *context, const char *filename) {
+    const JSON_Context *previous = json_context_make_current(context);
+    JSON_Value *result = json_parse_file_with_comments(filename);
+    json_context_make_current(previous);
+    return result;
+}
+
+JSON_Value * json_parse_string_ctx(const JSON_Context *context, const char *string) {
+    const JSON_Context *previous = json_context_make_current(context);
+    JSON_Value *result = json_parse_string(string);
+    json_context_make_current(previous);
+    return result;
+}
+
+JSON_Value * json_parse_string_with_comments_ctx(const JSON_Context *context, const char *string) {
+    const JSON_Context *previous = json_context_make_current(context);
+    JSON_Value *result = json_parse_string_with_comments(string);
+    json_context_make_current(previous);
+    return result;
+}
+
+char * json_serialize_to_string_ctx(const JSON_Context *context, const JSON_Value *value) {
+    const JSON_Context *previous = json_context_make_current(context);
+    char *result = json_serialize_to_string(value);
+    json_context_make_current(previous);
+    return result;
+}
+
+char * json_serialize_to_string_pretty_ctx(const JSON_Context *context, const JSON_Value *value) {
+    const JSON_Context *previous = json_context_make_current(context);
+    char *result = json_serialize_to_string_pretty(value);
+    json_context_make_current(previous);
+    return result;
+}
+
+void json_free_serialized_string_ctx(const JSON_Context *context, char *string) {
+    const JSON_Context *previous = json_context_make_current(context);
+    json_free_serialized_string(string);
+    json_context_make_current(previous);
+}
+
+JSON_Value * json_value_deep_copy_ctx(const JSON_Context *context, const JSON_Value *value) {
+    const JSON_Context *previous = json_context_make_current(context);
+    JSON_Value *result = json_value_deep_copy_r(value);
+    json_context_make_current(previous);
+    return result;
 }
@@ -73,6 +73,50 @@ typedef void   (*JSON_Free_Function)(void *);
 */
 typedef int (*JSON_Number_Serialization_Function)(double num, char *buf);
 
+/* Allocation functions used by a JSON_Context, 'allocator_data' is passed through unchanged
+   (e.g. a per-thread arena). */
+typedef void * (*JSON_Context_Malloc_Function)(void *allocator_data, size_t size);
+typedef void   (*JSON_Context_Free_Function)(void *allocator_data, void *ptr);
+
+/* Allocator and serialization settings for a group of documents. Contexts let every thread use its
+   own allocator and settings without touching the process-wide ones set by the functions below.
+   Initialize with json_context_init and change the fields you need. A context has to outlive
+   every value allocated through it.
+   Every value remembers the context it was allocated from. Freeing a value and the json_object_*
+   and json_array_* functions that change a document allocate and free through the document's
+   context, whichever one is current. Values from another context are refused by the set, dotset,
+   append and replace functions; json_value_deep_copy_ctx moves a copy into another context. */
+typedef struct json_context_t {
+    JSON_Context_Malloc_Function       malloc_fun;
+    JSON_Context_Free_Function         free_fun;
+    void                              *allocator_data;
+    int                                escape_slashes;    /* 1 by default */
+    const char                        *float_format;      /* not copied, NULL for default format */
+    JSON_Number_Serialization_Function number_serialization_function; /* NULL for default */
+} JSON_Context;
+
+/* Sets stdlib malloc/free and default serialization settings. */
+void json_context_init(JSON_Context *context);
+
+/* Makes context current for the calling thread: values created, parsed or serialized on this thread
+   from now on go through it. NULL switches the thread back to the process-wide settings. Returns
+   the previously current context (NULL if none). */
+const JSON_Context * json_context_make_current(const JSON_Context *context);
+
+/* Same as their counterparts without _ctx suffix, but run with context current for the duration
+   of the call. Safe to call concurrently from several threads with different contexts. */
+JSON_Value * json_parse_file_ctx(const JSON_Context *context, const char *filename);
+JSON_Value * json_parse_file_with_comments_ctx(const JSON_Context *context, const char *filename);
+JSON_Value * json_parse_string_ctx(const JSON_Context *context, const char *string);
+JSON_Value * json_parse_string_with_comments_ctx(const JSON_Context *context, const char *string);
+char *       json_serialize_to_string_ctx(const JSON_Context *context, const JSON_Value *value);
+char *       json_serialize_to_string_pretty_ctx(const JSON_Context *context, const JSON_Value *value);
+void         json_free_serialized_string_ctx(const JSON_Context *context, char *string);
+JSON_Value * json_value_deep_copy_ctx(const JSON_Context *context, const JSON_Value *value);
+
+/* The functions below change the process-wide settings used when no context is current.
+   They are not thread safe. */
+
 /* Call only once, before calling any other function from parson API. If not called, malloc and free
    from stdlib will be used for all allocations */
 void json_set_allocation_functions(JSON_Malloc_Function malloc_fun, JSON_Free_Function free_fun);
@@ -133,6 +177,19 @@ int  json_value_equals(const JSON_Value *a, const JSON_Value *b);
  */
 JSON_Status json_validate(const JSON_Value *schema, const JSON_Value *value);
 
+/* Compiled validation
+   json_schema_compile flattens a schema into a validation program with precomputed key hashes,
+   so validating many documents against the same schema doesn't walk the schema tree again.
+   json_schema_validate accepts exactly the values json_validate accepts. On failure it writes
+   the path of the first mismatch to error_path (e.g. "boxes[3].min"), keeping the innermost part
+   if it doesn't fit; error_path can be NULL. Compiled schemas are immutable and can be shared
+   between threads. The schema value can be freed after compiling. */
+typedef struct json_schema_t JSON_Schema;
+
+JSON_Schema * json_schema_compile(const JSON_Value *schema);
+JSON_Status   json_schema_validate(const JSON_Schema *schema, const JSON_Value *value, char *error_path, size_t error_path_size);
+void          json_schema_free(JSON_Schema *schema);
+
 /*
  * JSON Object
  */
@@ -246,7 +303,7 @@ JSON_Value * json_value_init_string_with_len(const char *string, size_t length);
 JSON_Value * json_value_init_number (double number);
 JSON_Value * json_value_init_boolean(int boolean);
 JSON_Value * json_value_init_null   (void);
-JSON_Value * json_value_deep_copy   (const JSON_Value *value);
+JSON_Value * json_value_deep_copy   (const JSON_Value *value); /* the copy is in value's context */
 void         json_value_free        (JSON_Value *value);
 
 JSON_Value_Type json_value_get_type   (const JSON_Value *value);
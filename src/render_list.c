@@ -0,0 +1,183 @@
+// render_list.c - building the level's box draws on worker threads (see render_list.h)
+#include "render_list.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+
+RenderList LoadRenderList(JobSystem *jobs)
+{
+    RenderList list = { 0 };
+    list.jobs = jobs;
+    return list;
+}
+
+void UnloadRenderList(RenderList *list)
+{
+    for (int c = 0; c < RENDER_LIST_MAX_CHUNKS; c++)
+    {
+        UnloadRenderBuffer(&list->chunks[c].packets);
+        UnloadInstanceBuffer(&list->chunks[c].edges);
+    }
+    RL_FREE(list->visible);
+    *list = (RenderList){ 0 };
+}
+
+// Even ranges, a few per thread so a chunk full of visible boxes doesn't
+// leave the other threads waiting
+static void SplitChunks(RenderList *list, uint32_t boxCount)
+{
+    int threads = GetJobWorkerCount(list->jobs) + 1;
+    uint32_t chunkCount = (uint32_t)(threads*RENDER_LIST_CHUNKS_PER_THREAD);
+    uint32_t most = (boxCount + RENDER_LIST_MIN_CHUNK_BOXES - 1)/RENDER_LIST_MIN_CHUNK_BOXES;
+    if (chunkCount > most) chunkCount = most;
+    if (chunkCount > RENDER_LIST_MAX_CHUNKS) chunkCount = RENDER_LIST_MAX_CHUNKS;
+    if (chunkCount == 0) chunkCount = 1;
+
+    for (uint32_t c = 0; c < chunkCount; c++)
+    {
+        RenderListChunk *chunk = &list->chunks[c];
+        chunk->begin = (uint32_t)((uint64_t)boxCount*c/chunkCount);
+        chunk->end = (uint32_t)((uint64_t)boxCount*(c + 1)/chunkCount);
+        chunk->visibleBegin = chunk->begin;
+        chunk->visibleCount = 0;
+        chunk->occluded = 0;
+    }
+    list->chunkCount = (int)chunkCount;
+    list->stats.threads = threads;
+    list->stats.chunks = (int)chunkCount;
+}
+
+// Packs the chunks' slices to the front of visible[], in chunk order.
+// Slices never start before what's already packed, so memmove is enough.
+static uint32_t PackVisible(RenderList *list)
+{
+    uint32_t packed = 0;
+    for (int c = 0; c < list->chunkCount; c++)
+    {
+        RenderListChunk *chunk = &list->chunks[c];
+        if (chunk->visibleBegin != packed)
+            memmove(list->visible + packed, list->visible + chunk->visibleBegin, chunk->visibleCount*sizeof(uint32_t));
+        chunk->visibleBegin = packed;
+        packed += chunk->visibleCount;
+    }
+    list->visibleCount = packed;
+    return packed;
+}
+
+/* ── stage 1: frustum culling ──────────────────────────────────────── */
+static void CullChunk(void *data, int index)
+{
+    RenderList *list = data;
+    RenderListChunk *chunk = &list->chunks[index];
+    const Level *level = list->level;
+    uint32_t begin = chunk->begin;
+
+    // CullBoxes on a range is CullBoxes on arrays starting at its first box
+    const float *bounds[6] = { level->minX + begin, level->minY + begin, level->minZ + begin,
+                               level->maxX + begin, level->maxY + begin, level->maxZ + begin };
+    uint32_t *visible = list->visible + chunk->visibleBegin;
+    chunk->visibleCount = CullBoxes(list->frustum, bounds, chunk->end - begin, visible);
+    for (uint32_t v = 0; v < chunk->visibleCount; v++) visible[v] += begin;
+}
+
+uint32_t CullRenderList(RenderList *list, const Level *level, const Frustum *frustum)
+{
+    list->stats = (RenderListStats){ 0 };
+    list->visibleCount = 0;
+    list->chunkCount = 0;
+    if (list->capacity < level->boxCount)
+    {
+        uint32_t *grown = RL_REALLOC(list->visible, level->boxCount*sizeof(uint32_t));
+        if (!grown) return 0;
+        list->visible = grown;
+        list->capacity = level->boxCount;
+    }
+
+    double start = NowMs();
+    SplitChunks(list, level->boxCount);
+    list->level = level;
+    list->frustum = frustum;
+    RunJobs(list->jobs, CullChunk, list, list->chunkCount);
+    double merge = NowMs();
+    PackVisible(list);
+    list->stats.visible = list->visibleCount;
+    list->stats.mergeMs = NowMs() - merge;
+    list->stats.cullMs = merge - start;
+    return list->visibleCount;
+}
+
+/* ── stage 2: occlusion and packets ────────────────────────────────── */
+static void BuildChunk(void *data, int index)
+{
+    RenderList *list = data;
+    RenderListChunk *chunk = &list->chunks[index];
+    const Level *level = list->level;
+    uint32_t *visible = list->visible + chunk->visibleBegin;
+
+    uint32_t kept = 0, tested = 0;
+    for (uint32_t v = 0; v < chunk->visibleCount; v++)
+    {
+        uint32_t i = visible[v];
+        if (!IsLevelBoxAlive(level, i)) continue;
+        BoundingBox box = { { level->minX[i], level->minY[i], level->minZ[i] }, { level->maxX[i], level->maxY[i], level->maxZ[i] } };
+        if (list->occlusion != NULL)
+        {
+            tested++;
+            if (IsBoxOccluded(list->occlusion, box)) continue;
+        }
+        visible[kept++] = i;
+        if (list->queue == NULL) continue;
+
+        // Unit cube scaled to the box then moved to its center
+        uint32_t c = level->colors[i];
+        Color color = { (unsigned char)c, (unsigned char)(c >> 8), (unsigned char)(c >> 16), (unsigned char)(c >> 24) };
+        Matrix transform = { 0 };
+        transform.m0 = box.max.x - box.min.x;
+        transform.m5 = box.max.y - box.min.y;
+        transform.m10 = box.max.z - box.min.z;
+        transform.m12 = 0.5f*(box.min.x + box.max.x);
+        transform.m13 = 0.5f*(box.min.y + box.max.y);
+        transform.m14 = 0.5f*(box.min.z + box.max.z);
+        transform.m15 = 1.0f;
+        PushRenderBuffer(list->queue, &chunk->packets, list->mesh, list->material, transform, color);
+        AddInstance(&chunk->edges, transform, color);
+    }
+    chunk->occluded = (list->occlusion != NULL) ? tested - kept : 0;
+    chunk->visibleCount = kept;
+}
+
+uint32_t BuildRenderList(RenderList *list, OcclusionBuffer *occlusion, RenderQueue *queue,
+                         int mesh, int material, InstanceBuffer *edges)
+{
+    if (list->chunkCount == 0) return 0;
+
+    double start = NowMs();
+    list->occlusion = occlusion;
+    list->queue = queue;
+    list->mesh = mesh;
+    list->material = material;
+    RunJobs(list->jobs, BuildChunk, list, list->chunkCount);
+    double merge = NowMs();
+
+    uint32_t occluded = 0;
+    for (int c = 0; c < list->chunkCount; c++)
+    {
+        RenderListChunk *chunk = &list->chunks[c];
+        occluded += chunk->occluded;
+        if (queue != NULL) MergeRenderBuffers(queue, &chunk->packets, 1);
+        if (edges != NULL) AppendInstances(edges, &chunk->edges);
+        ClearInstances(&chunk->edges);
+    }
+    PackVisible(list);
+    list->stats.mergeMs += NowMs() - merge;
+    list->stats.buildMs = merge - start;
+    list->stats.occluded = occluded;
+    list->stats.drawn = list->visibleCount;
+    if (occlusion != NULL)
+    {
+        occlusion->stats.tested += list->visibleCount + occluded;
+        occlusion->stats.culled += occluded;
+    }
+    return list->visibleCount;
+}
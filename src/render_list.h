@@ -0,0 +1,85 @@
+// render_list.h - building the level's box draws on worker threads
+//
+// Frustum culling, occlusion tests and draw packets for the level boxes run
+// as jobs (jobs.h) over chunks, fixed ranges of boxes. Each chunk writes to
+// its own slice of the visible list, its own RenderBuffer and its own edge
+// InstanceBuffer, so nothing is shared between jobs. The main thread merges
+// the chunks in order, which gives the same result for any thread count, and
+// is left with sorting and the GL calls.
+//
+// A frame is two stages with the occlusion raster in between:
+//
+//   CullRenderList()    frustum culling, visible[] in level order
+//                       (occluders picked from visible[] and rasterized)
+//   BuildRenderList()   occlusion tests, removed boxes dropped, then packets
+//                       pushed into the queue and edges into an instance buffer
+//
+// Nothing here calls the GPU: with SubmitRenderQueue() and no submit function
+// a frame runs headless, which is how ourBedroom -bench measures scaling.
+#ifndef RENDER_LIST_H
+#define RENDER_LIST_H
+
+#include <stdint.h>
+#include "raylib.h"
+#include "level.h"
+#include "frustum.h"
+#include "occlusion.h"
+#include "render_queue.h"
+#include "instancing.h"
+#include "jobs.h"
+
+#define RENDER_LIST_MAX_CHUNKS      256
+#define RENDER_LIST_MIN_CHUNK_BOXES 4096      // smaller isn't worth a job
+#define RENDER_LIST_CHUNKS_PER_THREAD 4       // uneven chunks balance out
+
+typedef struct RenderListChunk {
+    uint32_t begin, end;         // level boxes
+    uint32_t visibleBegin;       // slice of visible[] this chunk writes
+    uint32_t visibleCount;
+    uint32_t occluded;
+    RenderBuffer packets;
+    InstanceBuffer edges;
+} RenderListChunk;
+
+typedef struct RenderListStats {
+    int threads;                 // workers plus the calling thread
+    int chunks;
+    uint32_t visible;            // after frustum culling
+    uint32_t occluded;
+    uint32_t drawn;
+    double cullMs;               // wall clock of each stage
+    double buildMs;
+    double mergeMs;              // both stages' merges
+} RenderListStats;
+
+typedef struct RenderList {
+    JobSystem *jobs;             // not owned, NULL runs on the calling thread
+    uint32_t *visible;           // level box indices
+    uint32_t visibleCount;
+    uint32_t capacity;
+    RenderListChunk chunks[RENDER_LIST_MAX_CHUNKS];
+    int chunkCount;
+    RenderListStats stats;       // since CullRenderList()
+
+    // Current stage's inputs, read by the jobs
+    const Level *level;
+    const Frustum *frustum;
+    const OcclusionBuffer *occlusion;
+    const RenderQueue *queue;
+    int mesh, material;
+} RenderList;
+
+RenderList LoadRenderList(JobSystem *jobs);
+void UnloadRenderList(RenderList *list);
+
+// Returns the visible count, list->visible holds the boxes
+uint32_t CullRenderList(RenderList *list, const Level *level, const Frustum *frustum);
+
+// Drops removed boxes and the ones hidden in occlusion (may be NULL, tests
+// are counted in its stats) from list->visible, returns how many are left.
+// With a queue (after BeginRenderQueue()) every box left is also pushed as a
+// unit cube packet (mesh, material, the box's color) and added to edges.
+uint32_t BuildRenderList(RenderList *list, OcclusionBuffer *occlusion, RenderQueue *queue,
+                         int mesh, int material, InstanceBuffer *edges);
+
+#endif // RENDER_LIST_H
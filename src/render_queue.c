@@ -0,0 +1,259 @@
+// render_queue.c - sorted draw submission (see render_queue.h)
+#include "render_queue.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raymath.h"
+#include "rlgl.h"
+#include "timing.h"
+
+#define KEY_PASS_SHIFT   62
+#define KEY_FIELD_BITS   10
+#define KEY_DEPTH_BITS   24
+#define KEY_FIELD_MASK   ((1u << KEY_FIELD_BITS) - 1)
+#define KEY_DEPTH_MASK   ((1u << KEY_DEPTH_BITS) - 1)
+
+RenderQueue LoadRenderQueue(void)
+{
+    RenderQueue queue = { 0 };
+    queue.meshes = RL_MALLOC(RENDER_MAX_MESHES*sizeof(Mesh));
+    queue.materials = RL_MALLOC(RENDER_MAX_MATERIALS*sizeof(Material));
+    if (!queue.meshes || !queue.materials) UnloadRenderQueue(&queue);
+    return queue;
+}
+
+void UnloadRenderQueue(RenderQueue *queue)
+{
+    RL_FREE(queue->meshes);
+    RL_FREE(queue->materials);
+    RL_FREE(queue->items);
+    RL_FREE(queue->packets);
+    RL_FREE(queue->scratch);
+    UnloadInstanceBuffer(&queue->batch);
+    *queue = (RenderQueue){ 0 };
+}
+
+int AddRenderMesh(RenderQueue *queue, Mesh mesh)
+{
+    if (!queue->meshes || queue->meshCount == RENDER_MAX_MESHES) return -1;
+    queue->meshes[queue->meshCount] = mesh;
+    return queue->meshCount++;
+}
+
+int AddRenderMaterial(RenderQueue *queue, Material material)
+{
+    if (!queue->materials || queue->materialCount == RENDER_MAX_MATERIALS) return -1;
+    queue->materials[queue->materialCount] = material;
+    return queue->materialCount++;
+}
+
+void BeginRenderQueue(RenderQueue *queue, Camera camera)
+{
+    queue->count = 0;
+    queue->eye = camera.position;
+    queue->forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+}
+
+// Positive floats compare like their bits, the top 24 below the sign are plenty
+static uint32_t DepthBits(float depth)
+{
+    if (!(depth > 0.0f)) return 0;                  // behind the eye, or NaN
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return (bits >> 7) & KEY_DEPTH_MASK;
+}
+
+uint64_t GetRenderKey(RenderPass pass, int material, int mesh, float depth)
+{
+    uint64_t key = (uint64_t)pass << KEY_PASS_SHIFT;
+    uint64_t materialBits = (uint64_t)material & KEY_FIELD_MASK, meshBits = (uint64_t)mesh & KEY_FIELD_MASK;
+    if (pass == RENDER_PASS_OPAQUE)
+    {
+        key |= materialBits << 52;
+        key |= meshBits << 42;
+        key |= (uint64_t)DepthBits(depth) << 18;
+    }
+    else
+    {
+        key |= (uint64_t)(KEY_DEPTH_MASK - DepthBits(depth)) << 38;
+        key |= materialBits << 28;
+        key |= meshBits << 18;
+    }
+    return key;
+}
+
+static RenderPacket MakeRenderPacket(const RenderQueue *queue, int mesh, int material, Matrix transform, Color color,
+                                     RenderItem *item, uint32_t index)
+{
+    Vector3 origin = { transform.m12, transform.m13, transform.m14 };
+    float depth = Vector3DotProduct(Vector3Subtract(origin, queue->eye), queue->forward);
+    RenderPass pass = (color.a < 255) ? RENDER_PASS_TRANSLUCENT : RENDER_PASS_OPAQUE;
+    *item = (RenderItem){ transform, color, (uint16_t)mesh, (uint16_t)material };
+    return (RenderPacket){ GetRenderKey(pass, material, mesh, depth), index };
+}
+
+static bool IsRenderPacketValid(const RenderQueue *queue, int mesh, int material)
+{
+    return (mesh >= 0) && (mesh < queue->meshCount) && (material >= 0) && (material < queue->materialCount);
+}
+
+// Room for count packets in all, false when out of memory
+static bool ReserveRenderQueue(RenderQueue *queue, int count)
+{
+    if (count <= queue->capacity) return true;
+    int capacity = (queue->capacity > 0) ? queue->capacity : 256;
+    while (capacity < count) capacity *= 2;
+    RenderItem *items = RL_REALLOC(queue->items, (size_t)capacity*sizeof(RenderItem));
+    if (items) queue->items = items;
+    RenderPacket *packets = RL_REALLOC(queue->packets, (size_t)capacity*sizeof(RenderPacket));
+    if (packets) queue->packets = packets;
+    RenderPacket *scratch = RL_REALLOC(queue->scratch, (size_t)capacity*sizeof(RenderPacket));
+    if (scratch) queue->scratch = scratch;
+    if (!items || !packets || !scratch) return false;
+    queue->capacity = capacity;
+    return true;
+}
+
+void PushRenderPacket(RenderQueue *queue, int mesh, int material, Matrix transform, Color color)
+{
+    if (!IsRenderPacketValid(queue, mesh, material) || !ReserveRenderQueue(queue, queue->count + 1)) return;
+    int i = queue->count++;
+    queue->packets[i] = MakeRenderPacket(queue, mesh, material, transform, color, &queue->items[i], (uint32_t)i);
+}
+
+void UnloadRenderBuffer(RenderBuffer *buffer)
+{
+    RL_FREE(buffer->items);
+    RL_FREE(buffer->packets);
+    *buffer = (RenderBuffer){ 0 };
+}
+
+void PushRenderBuffer(const RenderQueue *queue, RenderBuffer *buffer, int mesh, int material, Matrix transform, Color color)
+{
+    if (!IsRenderPacketValid(queue, mesh, material)) return;
+    if (buffer->count == buffer->capacity)
+    {
+        int capacity = (buffer->capacity > 0) ? 2*buffer->capacity : 256;
+        RenderItem *items = RL_REALLOC(buffer->items, (size_t)capacity*sizeof(RenderItem));
+        if (items) buffer->items = items;
+        RenderPacket *packets = RL_REALLOC(buffer->packets, (size_t)capacity*sizeof(RenderPacket));
+        if (packets) buffer->packets = packets;
+        if (!items || !packets) return;
+        buffer->capacity = capacity;
+    }
+    int i = buffer->count++;
+    buffer->packets[i] = MakeRenderPacket(queue, mesh, material, transform, color, &buffer->items[i], (uint32_t)i);
+}
+
+void MergeRenderBuffers(RenderQueue *queue, RenderBuffer *buffers, int bufferCount)
+{
+    int total = queue->count;
+    for (int b = 0; b < bufferCount; b++) total += buffers[b].count;
+    if (!ReserveRenderQueue(queue, total)) return;
+
+    for (int b = 0; b < bufferCount; b++)
+    {
+        RenderBuffer *buffer = &buffers[b];
+        uint32_t base = (uint32_t)queue->count;
+        memcpy(queue->items + base, buffer->items, (size_t)buffer->count*sizeof(RenderItem));
+        RenderPacket *packets = queue->packets + base;
+        for (int i = 0; i < buffer->count; i++)
+            packets[i] = (RenderPacket){ buffer->packets[i].key, base + buffer->packets[i].item };
+        queue->count += buffer->count;
+        buffer->count = 0;
+    }
+}
+
+void SortRenderQueue(RenderQueue *queue)
+{
+    int count = queue->count;
+    if (count < 2) return;
+
+    // Bytes every key shares don't need a pass (the unused low bits, the
+    // pass when everything is translucent, ...)
+    uint64_t differing = 0;
+    for (int i = 1; i < count; i++) differing |= queue->packets[i].key ^ queue->packets[0].key;
+
+    RenderPacket *src = queue->packets, *dst = queue->scratch;
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        if (((differing >> shift) & 0xff) == 0) continue;
+        int offsets[256] = { 0 };
+        for (int i = 0; i < count; i++) offsets[(src[i].key >> shift) & 0xff]++;
+        for (int d = 0, sum = 0; d < 256; d++) { int n = offsets[d]; offsets[d] = sum; sum += n; }
+        for (int i = 0; i < count; i++) dst[offsets[(src[i].key >> shift) & 0xff]++] = src[i];
+        RenderPacket *t = src; src = dst; dst = t;
+    }
+    queue->packets = src;
+    queue->scratch = dst;
+}
+
+RenderQueueStats SubmitRenderQueue(RenderQueue *queue, RenderSubmitFunc submit, void *context)
+{
+    RenderQueueStats stats = { 0 };
+    double start = NowMs();
+    SortRenderQueue(queue);
+    stats.sortMs = NowMs() - start;
+    stats.packets = queue->count;
+
+    int material = -1, mesh = -1;
+    for (int p = 0; p < queue->count;)
+    {
+        const RenderItem *first = &queue->items[queue->packets[p].item];
+        RenderPass pass = (RenderPass)(queue->packets[p].key >> KEY_PASS_SHIFT);
+        if (first->material != material) { material = first->material; stats.materialChanges++; }
+        if (first->mesh != mesh) { mesh = first->mesh; stats.meshChanges++; }
+
+        // The run: everything up to the next change of pass, mesh or material
+        int end = p + 1;
+        while (end < queue->count)
+        {
+            const RenderItem *item = &queue->items[queue->packets[end].item];
+            if ((RenderPass)(queue->packets[end].key >> KEY_PASS_SHIFT) != pass || item->mesh != mesh || item->material != material) break;
+            end++;
+        }
+        if (pass == RENDER_PASS_TRANSLUCENT) stats.translucent += end - p;
+        stats.drawCalls++;
+
+        if (submit != NULL)
+        {
+            ClearInstances(&queue->batch);
+            for (int i = p; i < end; i++)
+            {
+                const RenderItem *item = &queue->items[queue->packets[i].item];
+                AddInstance(&queue->batch, item->transform, item->color);
+            }
+            submit(context, pass, queue->meshes[mesh], queue->materials[material], &queue->batch);
+        }
+        p = end;
+    }
+
+    queue->count = 0;
+    return stats;
+}
+
+static void DrawRenderRun(void *context, RenderPass pass, Mesh mesh, Material material, const InstanceBuffer *instances)
+{
+    bool *translucent = context;
+    if (!*translucent && (pass == RENDER_PASS_TRANSLUCENT))
+    {
+        rlDisableDepthMask();
+        *translucent = true;
+    }
+    // The queue's buffer, so uploading from here is fine
+    UploadInstances((InstanceBuffer *)instances);
+    DrawMeshInstances(mesh, material.shader, instances, material.maps[MATERIAL_MAP_DIFFUSE].color);
+}
+
+RenderQueueStats DrawRenderQueue(RenderQueue *queue)
+{
+    // Meshes draw straight away, anything still in the immediate mode batch
+    // (floor, wires) goes first so translucent packets blend over it
+    rlDrawRenderBatchActive();
+
+    bool translucent = false;
+    RenderQueueStats stats = SubmitRenderQueue(queue, DrawRenderRun, &translucent);
+    if (translucent) rlEnableDepthMask();
+    return stats;
+}
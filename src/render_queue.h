@@ -0,0 +1,116 @@
+// render_queue.h - sorted draw submission
+//
+// Instead of drawing as they go, callers push packets (mesh, material,
+// transform, color) and the queue draws them in one go, in the order given
+// by a 64-bit key per packet:
+//
+//   opaque       pass | material | mesh | depth      front to back
+//   translucent  pass | depth | material | mesh      back to front
+//
+// Opaque packets are grouped by material, then mesh, so switches happen once
+// per group, and drawn nearest first within a group. Translucent packets
+// (color alpha < 255) come after all opaque ones, farthest first so they
+// blend over what's behind them, with depth writes off. Depth is the
+// distance along the view direction to the packet's origin.
+//
+// Consecutive packets in the sorted order that share pass, mesh and
+// material are submitted together, as one instanced draw (instancing.h)
+// whose instances keep the sorted order, so a whole group costs a single
+// draw call. Only a material's shader and diffuse color are used: the
+// shader comes from LoadInstanceShader(true), the color tints the packets'.
+//
+// Keys are radix sorted, 8 bits a pass, skipping bytes every key shares;
+// the sort is stable so equal keys keep their push order.
+//
+// Packets can also be built off the main thread: each job pushes into its
+// own RenderBuffer (keys only read the queue's camera) and the buffers are
+// merged in a fixed order before drawing (see render_list.h).
+// SubmitRenderQueue() with a NULL submit function sorts and counts without
+// touching the GPU, for headless runs.
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <stdint.h>
+#include "raylib.h"
+#include "instancing.h"
+
+#define RENDER_MAX_MATERIALS 1024      // 10 key bits each
+#define RENDER_MAX_MESHES    1024
+
+typedef enum {
+    RENDER_PASS_OPAQUE = 0,
+    RENDER_PASS_TRANSLUCENT
+} RenderPass;
+
+typedef struct RenderPacket {
+    uint64_t key;
+    uint32_t item;               // index into items
+} RenderPacket;
+
+typedef struct RenderItem {
+    Matrix transform;
+    Color color;
+    uint16_t mesh;
+    uint16_t material;
+} RenderItem;
+
+typedef struct RenderQueueStats {
+    int packets;
+    int translucent;
+    int drawCalls;               // runs of packets sharing pass, mesh and material
+    int materialChanges;         // shader and textures bound, the first one counts
+    int meshChanges;             // vertex arrays bound
+    double sortMs;
+} RenderQueueStats;
+
+typedef struct RenderBuffer {
+    RenderItem *items;
+    RenderPacket *packets;       // item indices are into this buffer's items
+    int count;
+    int capacity;
+} RenderBuffer;
+
+// Called once per run of packets sharing pass, mesh and material, in order;
+// instances holds their transforms and colors, not yet uploaded
+typedef void (*RenderSubmitFunc)(void *context, RenderPass pass, Mesh mesh, Material material, const InstanceBuffer *instances);
+
+typedef struct RenderQueue {
+    Mesh *meshes;                // registered, not owned
+    int meshCount;
+    Material *materials;
+    int materialCount;
+
+    RenderItem *items;
+    RenderPacket *packets;
+    RenderPacket *scratch;       // radix sort ping-pong
+    int count;
+    int capacity;
+    InstanceBuffer batch;        // the run being submitted
+
+    Vector3 eye;
+    Vector3 forward;
+} RenderQueue;
+
+RenderQueue LoadRenderQueue(void);
+void UnloadRenderQueue(RenderQueue *queue);                 // Meshes and materials stay with the caller
+
+// Returns the id packets refer to, -1 when full
+int AddRenderMesh(RenderQueue *queue, Mesh mesh);
+int AddRenderMaterial(RenderQueue *queue, Material material);
+
+void BeginRenderQueue(RenderQueue *queue, Camera camera);   // Clears, depth is measured from this camera
+void PushRenderPacket(RenderQueue *queue, int mesh, int material, Matrix transform, Color color);
+
+// Same as PushRenderPacket() into a separate buffer, safe from any thread
+// between BeginRenderQueue() and the merge. Merging appends the buffers in
+// the order given and clears them.
+void PushRenderBuffer(const RenderQueue *queue, RenderBuffer *buffer, int mesh, int material, Matrix transform, Color color);
+void MergeRenderBuffers(RenderQueue *queue, RenderBuffer *buffers, int bufferCount);
+void UnloadRenderBuffer(RenderBuffer *buffer);
+
+uint64_t GetRenderKey(RenderPass pass, int material, int mesh, float depth);
+void SortRenderQueue(RenderQueue *queue);                   // DrawRenderQueue() does it, exposed for tests
+RenderQueueStats SubmitRenderQueue(RenderQueue *queue, RenderSubmitFunc submit, void *context);   // Sorts, submits and clears, NULL submit only counts
+RenderQueueStats DrawRenderQueue(RenderQueue *queue);       // Submits to rlgl, inside BeginMode3D()
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,44 @@
+// scene.h - the demos as scenes of one program
+//
+// Every demo used to be its own program with its own main(), which is why
+// they couldn't be built together. Each is now a Scene: hooks main.c calls
+// around its single window and frame loop. Tab switches to the next scene
+// (Shift+Tab the previous one); the switch unloads the old scene, loads the
+// new one and says how long that took.
+//
+// Scenes get models and what's built from them through assets.h, so what
+// one scene loaded is still resident when the next one asks for it.
+//
+// A scene's state lives in its own file. Hooks run on the main thread:
+//   init    after the window is resized to width x height; the scene named
+//           on the command line gets the arguments after its name, others
+//           none. False when the scene can't run, with nothing left loaded
+//   update  input and simulation, before BeginDrawing()
+//   draw    between BeginDrawing() and EndDrawing()
+//   unload  frees what init made, shared assets stay
+//   bench   headless benchmark (main.c's -bench), before any window; NULL
+//           when the scene has none
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "raylib.h"
+
+typedef struct Scene {
+    const char *name;            // on the command line
+    const char *title;           // window title
+    int width, height;           // window size
+    bool (*init)(int argc, char **argv);
+    void (*update)(void);
+    void (*draw)(void);
+    void (*unload)(void);
+    void (*bench)(int argc, char **argv);
+} Scene;
+
+extern const Scene BedroomScene;                // ourBedroom.c
+extern const Scene BedScene;                    // bed.c
+extern const Scene ColumnsScene;                // box_cylinder.c
+extern const Scene CylinderScene;               // cylinder.c
+extern const Scene CrowdScene;                  // JerryHumanTest.c
+extern const Scene CubeScene;                   // box_core_3d_camera_first_person.c
+
+#endif // SCENE_H
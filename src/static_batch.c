@@ -0,0 +1,359 @@
+// static_batch.c - baking level boxes into cell meshes (see static_batch.h)
+//
+// Nothing here calls raylib, the header is only needed for Mesh and the
+// RL_MALLOC family, so the vertex generation can be checked without a window.
+#include "static_batch.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BOX_VERTICES  8
+#define BOX_TRIANGLES 12
+#define BOX_LINES     12
+
+// Corner c of a box takes max on axis a when bit a of c is set
+static const unsigned short boxTriangles[BOX_TRIANGLES][3] = {
+    { 0, 2, 1 }, { 1, 2, 3 },    // -Z
+    { 4, 5, 6 }, { 5, 7, 6 },    // +Z
+    { 0, 4, 2 }, { 2, 4, 6 },    // -X
+    { 1, 3, 5 }, { 3, 7, 5 },    // +X
+    { 0, 1, 4 }, { 1, 5, 4 },    // -Y
+    { 2, 6, 3 }, { 3, 6, 7 }     // +Y
+};
+
+static const unsigned int boxLines[BOX_LINES][2] = {
+    { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },      // along X
+    { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },      // along Y
+    { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }       // along Z
+};
+
+typedef struct CellBox {
+    uint64_t cell;
+    uint32_t box;
+} CellBox;
+
+static int CompareCellBoxes(const void *a, const void *b)
+{
+    const CellBox *x = a, *y = b;
+    if (x->cell != y->cell) return (x->cell < y->cell) ? -1 : 1;
+    return (x->box < y->box) ? -1 : (x->box > y->box);
+}
+
+// Grid coordinate with the sign bit flipped, so unsigned order is numeric order
+static uint32_t GridCoordinate(float center, float cellSize)
+{
+    double g = floor((double)center/cellSize);
+    if (!(g >= (double)INT32_MIN)) g = (double)INT32_MIN;    // also catches NaN
+    if (g > (double)INT32_MAX) g = (double)INT32_MAX;
+    return (uint32_t)(int32_t)g ^ 0x80000000u;
+}
+
+static bool AllocateCell(StaticBatch *batch, int c, uint32_t boxCount)
+{
+    Mesh *faces = &batch->faces[c];
+    faces->vertexCount = (int)(boxCount*BOX_VERTICES);
+    faces->triangleCount = (int)(boxCount*BOX_TRIANGLES);
+    faces->vertices = RL_MALLOC((size_t)faces->vertexCount*3*sizeof(float));
+    faces->colors = RL_MALLOC((size_t)faces->vertexCount*4*sizeof(unsigned char));
+    faces->indices = RL_MALLOC((size_t)faces->triangleCount*3*sizeof(unsigned short));
+
+    LineMesh *edges = &batch->edges[c];
+    edges->vertexCount = faces->vertexCount;
+    edges->lineCount = (int)(boxCount*BOX_LINES);
+    edges->vertices = RL_MALLOC((size_t)edges->vertexCount*3*sizeof(float));
+    edges->indices = RL_MALLOC((size_t)edges->lineCount*2*sizeof(unsigned int));
+
+    batch->boxCounts[c] = boxCount;
+    return faces->vertices && faces->colors && faces->indices && edges->vertices && edges->indices;
+}
+
+static void AddBox(StaticBatch *batch, int c, uint32_t slot, const Level *level, uint32_t box)
+{
+    const float lo[3] = { level->minX[box], level->minY[box], level->minZ[box] };
+    const float hi[3] = { level->maxX[box], level->maxY[box], level->maxZ[box] };
+    uint32_t color = level->colors[box];
+    unsigned int first = slot*BOX_VERTICES;
+
+    Mesh *faces = &batch->faces[c];
+    LineMesh *edges = &batch->edges[c];
+    float *v = faces->vertices + 3*(size_t)first;
+    unsigned char *rgba = faces->colors + 4*(size_t)first;
+    for (int corner = 0; corner < BOX_VERTICES; corner++)
+    {
+        for (int a = 0; a < 3; a++) v[3*corner + a] = (corner & (1 << a)) ? hi[a] : lo[a];
+        memcpy(rgba + 4*corner, &color, 4);                // bytes are r, g, b, a already
+    }
+    memcpy(edges->vertices + 3*(size_t)first, v, BOX_VERTICES*3*sizeof(float));
+
+    unsigned short *triangle = faces->indices + 3*(size_t)slot*BOX_TRIANGLES;
+    for (int t = 0; t < BOX_TRIANGLES; t++)
+        for (int k = 0; k < 3; k++) triangle[3*t + k] = (unsigned short)(first + boxTriangles[t][k]);
+    unsigned int *line = edges->indices + 2*(size_t)slot*BOX_LINES;
+    for (int l = 0; l < BOX_LINES; l++)
+        for (int k = 0; k < 2; k++) line[2*l + k] = first + boxLines[l][k];
+
+    batch->minX[c] = fminf(batch->minX[c], lo[0]); batch->maxX[c] = fmaxf(batch->maxX[c], hi[0]);
+    batch->minY[c] = fminf(batch->minY[c], lo[1]); batch->maxY[c] = fmaxf(batch->maxY[c], hi[1]);
+    batch->minZ[c] = fminf(batch->minZ[c], lo[2]); batch->maxZ[c] = fmaxf(batch->maxZ[c], hi[2]);
+}
+
+// Square cells holding about STATIC_BATCH_TARGET_CELL_BOXES boxes on average,
+// assuming they're spread evenly over the XZ extent of the level
+static float AutomaticCellSize(const Level *level)
+{
+    float lo[2] = { INFINITY, INFINITY }, hi[2] = { -INFINITY, -INFINITY };
+    uint32_t liveCount = 0;
+    for (uint32_t i = 0; i < level->boxCount; i++)
+    {
+        if (!IsLevelBoxAlive(level, i)) continue;
+        lo[0] = fminf(lo[0], level->minX[i]); hi[0] = fmaxf(hi[0], level->maxX[i]);
+        lo[1] = fminf(lo[1], level->minZ[i]); hi[1] = fmaxf(hi[1], level->maxZ[i]);
+        liveCount++;
+    }
+    if (liveCount == 0) return STATIC_BATCH_DEFAULT_CELL;
+    double area = (double)(hi[0] - lo[0])*(hi[1] - lo[1]);
+    double size = sqrt(area*STATIC_BATCH_TARGET_CELL_BOXES/liveCount);
+    return (size > STATIC_BATCH_DEFAULT_CELL) ? (float)size : STATIC_BATCH_DEFAULT_CELL;
+}
+
+// Grid cell of a live box, by its center
+static uint64_t BoxCell(const Level *level, uint32_t box, float cellSize)
+{
+    uint32_t x = GridCoordinate(0.5f*(level->minX[box] + level->maxX[box]), cellSize);
+    uint32_t z = GridCoordinate(0.5f*(level->minZ[box] + level->maxZ[box]), cellSize);
+    return ((uint64_t)x << 32) | z;
+}
+
+// Cells the boxes fill once sorted: a cell ends where the grid cell changes
+// or it's full
+static int CountCells(const CellBox *sorted, uint32_t count)
+{
+    int cellCount = 0;
+    for (uint32_t i = 0, run = 0; i < count; i++, run++)
+    {
+        if (i == 0 || sorted[i].cell != sorted[i - 1].cell || run == STATIC_BATCH_MAX_CELL_BOXES) { cellCount++; run = 0; }
+    }
+    return cellCount;
+}
+
+// Per cell arrays for cellCount cells, meshes zeroed
+static bool AllocateCellArrays(StaticBatch *batch, int cellCount)
+{
+    batch->cellCount = cellCount;
+    batch->minX = RL_MALLOC(6*(size_t)cellCount*sizeof(float));
+    batch->boxCounts = RL_CALLOC((size_t)cellCount, sizeof(uint32_t));
+    batch->faces = RL_CALLOC((size_t)cellCount, sizeof(Mesh));
+    batch->edges = RL_CALLOC((size_t)cellCount, sizeof(LineMesh));
+    batch->cellKeys = RL_MALLOC((size_t)cellCount*sizeof(uint64_t));
+    batch->visible = RL_MALLOC((size_t)cellCount*sizeof(uint32_t));
+    if (!batch->minX || !batch->boxCounts || !batch->faces || !batch->edges || !batch->cellKeys || !batch->visible) return false;
+    batch->minY = batch->minX + cellCount;   batch->minZ = batch->minY + cellCount;
+    batch->maxX = batch->minZ + cellCount;   batch->maxY = batch->maxX + cellCount;
+    batch->maxZ = batch->maxY + cellCount;
+    return true;
+}
+
+static void FreeCellArrays(StaticBatch *batch)
+{
+    RL_FREE(batch->minX);
+    RL_FREE(batch->boxCounts);
+    RL_FREE(batch->faces);
+    RL_FREE(batch->edges);
+    RL_FREE(batch->cellKeys);
+    RL_FREE(batch->visible);
+}
+
+static void FreeCellMeshes(Mesh *faces, LineMesh *edges)
+{
+    RL_FREE(faces->vertices);
+    RL_FREE(faces->colors);
+    RL_FREE(faces->indices);
+    RL_FREE(edges->vertices);
+    RL_FREE(edges->indices);
+}
+
+// Bakes the sorted boxes into cells first, first + 1, ... (CountCells of them)
+static bool BakeCells(StaticBatch *batch, int first, const CellBox *sorted, uint32_t count, const Level *level)
+{
+    int c = first - 1;
+    for (uint32_t i = 0, slot = 0; i < count; i++, slot++)
+    {
+        if (i == 0 || sorted[i].cell != sorted[i - 1].cell || slot == STATIC_BATCH_MAX_CELL_BOXES)
+        {
+            uint32_t end = i + 1;
+            while (end < count && sorted[end].cell == sorted[i].cell && end - i < STATIC_BATCH_MAX_CELL_BOXES) end++;
+            c++;
+            slot = 0;
+            batch->minX[c] = batch->minY[c] = batch->minZ[c] = INFINITY;
+            batch->maxX[c] = batch->maxY[c] = batch->maxZ[c] = -INFINITY;
+            batch->cellKeys[c] = sorted[i].cell;
+            if (!AllocateCell(batch, c, end - i)) return false;
+        }
+        AddBox(batch, c, slot, level, sorted[i].box);
+    }
+    return true;
+}
+
+StaticBatch BuildStaticBatch(const Level *level, float cellSize)
+{
+    StaticBatch batch = { 0 };
+    batch.cellSize = (cellSize > 0.0f) ? cellSize : AutomaticCellSize(level);
+
+    // Bucket the live boxes by grid cell, box order within a cell
+    uint32_t liveCount = 0;
+    CellBox *sorted = RL_MALLOC((size_t)level->boxCount*sizeof(CellBox) + 1);
+    batch.boxCells = RL_MALLOC((size_t)level->boxCount*sizeof(uint64_t) + 1);
+    batch.boxCapacity = level->boxCount;
+    if (!sorted || !batch.boxCells) { RL_FREE(sorted); FreeStaticBatch(&batch); return batch; }
+    for (uint32_t i = 0; i < level->boxCount; i++)
+    {
+        batch.boxCells[i] = STATIC_BATCH_NO_CELL;
+        if (!IsLevelBoxAlive(level, i)) continue;
+        batch.boxCells[i] = BoxCell(level, i, batch.cellSize);
+        sorted[liveCount++] = (CellBox){ batch.boxCells[i], i };
+    }
+    qsort(sorted, liveCount, sizeof(CellBox), CompareCellBoxes);
+
+    int cellCount = CountCells(sorted, liveCount);
+    if (cellCount == 0) { RL_FREE(sorted); FreeStaticBatch(&batch); return batch; }
+    if (!AllocateCellArrays(&batch, cellCount) || !BakeCells(&batch, 0, sorted, liveCount, level))
+    {
+        RL_FREE(sorted);
+        FreeStaticBatch(&batch);
+        return batch;
+    }
+    RL_FREE(sorted);
+    return batch;
+}
+
+static int CompareCellKeys(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+static bool IsDirtyCell(const uint64_t *dirty, uint32_t dirtyCount, uint64_t cell)
+{
+    return bsearch(&cell, dirty, dirtyCount, sizeof(uint64_t), CompareCellKeys) != NULL;
+}
+
+int RebakeStaticBatch(StaticBatch *batch, const Level *level, const uint32_t *boxes, uint32_t count)
+{
+    if (batch->cellCount == 0 || !batch->boxCells) return -1;
+    if (level->boxCount > batch->boxCapacity)
+    {
+        uint64_t *grown = RL_REALLOC(batch->boxCells, (size_t)level->boxCount*sizeof(uint64_t));
+        if (!grown) return -1;
+        for (uint32_t i = batch->boxCapacity; i < level->boxCount; i++) grown[i] = STATIC_BATCH_NO_CELL;
+        batch->boxCells = grown;
+        batch->boxCapacity = level->boxCount;
+    }
+
+    // Grid cells an edited box left or went to
+    uint64_t *dirty = RL_MALLOC((2*(size_t)count + 1)*sizeof(uint64_t));
+    if (!dirty) return -1;
+    uint32_t dirtyCount = 0;
+    for (uint32_t e = 0; e < count; e++)
+    {
+        uint32_t box = boxes[e];
+        if (box >= level->boxCount) continue;
+        uint64_t now = IsLevelBoxAlive(level, box) ? BoxCell(level, box, batch->cellSize) : STATIC_BATCH_NO_CELL;
+        if (batch->boxCells[box] != STATIC_BATCH_NO_CELL) dirty[dirtyCount++] = batch->boxCells[box];
+        if (now != STATIC_BATCH_NO_CELL) dirty[dirtyCount++] = now;
+        batch->boxCells[box] = now;
+    }
+    qsort(dirty, dirtyCount, sizeof(uint64_t), CompareCellKeys);
+    uint32_t unique = 0;
+    for (uint32_t d = 0; d < dirtyCount; d++)
+        if (unique == 0 || dirty[d] != dirty[unique - 1]) dirty[unique++] = dirty[d];
+    dirtyCount = unique;
+
+    // Everything now in those cells, baked the same way BuildStaticBatch would
+    uint32_t dirtyBoxes = 0;
+    CellBox *sorted = RL_MALLOC((size_t)level->boxCount*sizeof(CellBox) + 1);
+    if (!sorted) { RL_FREE(dirty); return -1; }
+    for (uint32_t i = 0; i < level->boxCount; i++)
+        if (batch->boxCells[i] != STATIC_BATCH_NO_CELL && IsDirtyCell(dirty, dirtyCount, batch->boxCells[i]))
+            sorted[dirtyBoxes++] = (CellBox){ batch->boxCells[i], i };
+    qsort(sorted, dirtyBoxes, sizeof(CellBox), CompareCellBoxes);
+
+    // Clean cells move over as they are, baked cells go at the end
+    int kept = 0, staleCount = 0;
+    for (int c = 0; c < batch->cellCount; c++)
+        if (IsDirtyCell(dirty, dirtyCount, batch->cellKeys[c])) staleCount++; else kept++;
+    if (kept == 0)                                    // a full build is no slower then
+    {
+        RL_FREE(sorted); RL_FREE(dirty);
+        return -1;
+    }
+    int baked = CountCells(sorted, dirtyBoxes);
+    StaticBatch next = *batch;
+    bool ok = AllocateCellArrays(&next, kept + baked);
+    if (ok && batch->uploaded && staleCount > 0)
+    {
+        next.staleFaces = RL_MALLOC(((size_t)batch->staleCount + staleCount)*sizeof(Mesh));
+        next.staleEdges = RL_MALLOC(((size_t)batch->staleCount + staleCount)*sizeof(LineMesh));
+        ok = next.staleFaces && next.staleEdges;
+        if (ok && batch->staleCount > 0)
+        {
+            memcpy(next.staleFaces, batch->staleFaces, (size_t)batch->staleCount*sizeof(Mesh));
+            memcpy(next.staleEdges, batch->staleEdges, (size_t)batch->staleCount*sizeof(LineMesh));
+        }
+    }
+    if (ok)
+    {
+        int k = 0;
+        for (int c = 0; c < batch->cellCount; c++)
+        {
+            if (IsDirtyCell(dirty, dirtyCount, batch->cellKeys[c])) continue;
+            next.minX[k] = batch->minX[c]; next.minY[k] = batch->minY[c]; next.minZ[k] = batch->minZ[c];
+            next.maxX[k] = batch->maxX[c]; next.maxY[k] = batch->maxY[c]; next.maxZ[k] = batch->maxZ[c];
+            next.boxCounts[k] = batch->boxCounts[c];
+            next.faces[k] = batch->faces[c];
+            next.edges[k] = batch->edges[c];
+            next.cellKeys[k] = batch->cellKeys[c];
+            k++;
+        }
+        ok = BakeCells(&next, kept, sorted, dirtyBoxes, level);
+    }
+    RL_FREE(sorted);
+    if (!ok)
+    {
+        RL_FREE(dirty);
+        for (int c = kept; c < next.cellCount && next.faces && next.edges; c++) FreeCellMeshes(&next.faces[c], &next.edges[c]);
+        FreeCellArrays(&next);
+        if (next.staleFaces != batch->staleFaces) RL_FREE(next.staleFaces);
+        if (next.staleEdges != batch->staleEdges) RL_FREE(next.staleEdges);
+        return -1;
+    }
+
+    // Replaced cells: uploaded ones wait for UpdateStaticBatch to unload them
+    for (int c = 0; c < batch->cellCount; c++)
+    {
+        if (!IsDirtyCell(dirty, dirtyCount, batch->cellKeys[c])) continue;
+        if (batch->uploaded)
+        {
+            next.staleFaces[next.staleCount] = batch->faces[c];
+            next.staleEdges[next.staleCount] = batch->edges[c];
+            next.staleCount++;
+        }
+        else FreeCellMeshes(&batch->faces[c], &batch->edges[c]);
+    }
+    RL_FREE(dirty);
+    if (next.staleFaces != batch->staleFaces) { RL_FREE(batch->staleFaces); RL_FREE(batch->staleEdges); }
+    FreeCellArrays(batch);
+    *batch = next;
+    return baked;
+}
+
+void FreeStaticBatch(StaticBatch *batch)
+{
+    for (int c = 0; c < batch->cellCount && batch->faces && batch->edges; c++) FreeCellMeshes(&batch->faces[c], &batch->edges[c]);
+    for (int c = 0; c < batch->staleCount; c++) FreeCellMeshes(&batch->staleFaces[c], &batch->staleEdges[c]);
+    FreeCellArrays(batch);
+    RL_FREE(batch->boxCells);
+    RL_FREE(batch->staleFaces);
+    RL_FREE(batch->staleEdges);
+    *batch = (StaticBatch){ 0 };
+}
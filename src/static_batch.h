@@ -0,0 +1,90 @@
+// static_batch.h - level boxes baked into a few large meshes
+//
+// Level boxes never move during play, yet DrawCube/DrawCubeWires rebuild them
+// as immediate mode geometry every frame. A StaticBatch merges them once at
+// load into per-cell meshes: boxes are bucketed by the XZ grid cell their
+// center falls in, and each cell becomes one face Mesh (8 shared corners per
+// box with the box color as vertex color) plus one LineMesh for the edges.
+// Cells hold at most STATIC_BATCH_MAX_CELL_BOXES boxes so the face indices
+// fit raylib's 16-bit index buffers; a crowded cell is split in several.
+//
+// Cell bounds are kept as separate min/max arrays so CullBoxes (frustum.h)
+// culls whole cells, and a visible cell costs two draw calls.
+//
+// The batch remembers which grid cell every box went into, so after runtime
+// edits (hot reload) only the grid cells edited boxes left or entered are
+// baked and uploaded again; the other cells keep their meshes.
+//
+// BuildStaticBatch (static_batch.c) only fills CPU arrays and calls nothing
+// from raylib, so it runs and can be checked without a window. Uploading and
+// drawing live in static_batch_draw.c.
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include <stdint.h>
+#include "raylib.h"
+#include "frustum.h"
+#include "level.h"
+#include "line_mesh.h"
+#include "occlusion.h"
+
+#define STATIC_BATCH_MAX_CELL_BOXES 8192   // 8 vertices a box, 65536 fit 16-bit indices
+#define STATIC_BATCH_DEFAULT_CELL   4.0f   // meters, smallest automatic cell size
+#define STATIC_BATCH_TARGET_CELL_BOXES 2048
+#define STATIC_BATCH_NO_CELL UINT64_MAX          // boxCells entry of a box that isn't baked
+
+typedef struct StaticBatch {
+    int cellCount;
+    float cellSize;
+
+    // One entry per cell, bounds of the boxes baked into it
+    float *minX, *minY, *minZ;
+    float *maxX, *maxY, *maxZ;
+    uint32_t *boxCounts;
+    Mesh *faces;
+    LineMesh *edges;
+    uint64_t *cellKeys;          // grid cell, a crowded one is split over several cells
+
+    uint64_t *boxCells;          // grid cell of every level box, by box index
+    uint32_t boxCapacity;
+    Mesh *staleFaces;            // replaced by RebakeStaticBatch, still on the GPU
+    LineMesh *staleEdges;
+    int staleCount;
+
+    uint32_t *visible;           // culling scratch, one entry per cell
+    Material material;           // raylib's default material, vertex colors only
+    Shader edgeShader;
+    bool uploaded;
+} StaticBatch;
+
+typedef struct StaticBatchStats {
+    int cellsDrawn;
+    int cellsOccluded;
+    uint32_t boxesDrawn;
+    int drawCalls;
+} StaticBatchStats;
+
+// Bake every live box of the level into cellSize wide cells; 0 picks a size
+// from the level's extent and box count, so big sparse levels don't end up
+// with thousands of nearly empty cells. Returns cellCount 0 when the level
+// is empty or memory runs out.
+StaticBatch BuildStaticBatch(const Level *level, float cellSize);
+void FreeStaticBatch(StaticBatch *batch);                 // CPU side only, for batches never uploaded
+
+// Rebake the grid cells the given boxes (added, moved or removed since the
+// last bake) were or are in. Clean cells are kept, the rebaked ones go at
+// the end and cells they replace are parked as stale for the GPU side.
+// Returns how many cells were baked, -1 if the batch has to be rebuilt
+// instead (empty batch, every cell touched, out of memory).
+int RebakeStaticBatch(StaticBatch *batch, const Level *level, const uint32_t *boxes, uint32_t count);
+
+void UploadStaticBatch(StaticBatch *batch);               // Needs a window, once after building
+void UnloadStaticBatch(StaticBatch *batch);
+// After level edits (level->editedBoxes): rebakes and uploads only the cells
+// they touch, or rebuilds the whole batch when that can't be done. Doesn't
+// clear the level's edit log.
+void UpdateStaticBatch(StaticBatch *batch, const Level *level);
+// occlusion may be NULL, otherwise cells hidden in it are skipped
+StaticBatchStats DrawStaticBatch(StaticBatch *batch, const Frustum *frustum, const OcclusionBuffer *occlusion, Color edgeColor);
+
+#endif // STATIC_BATCH_H
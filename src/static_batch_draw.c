@@ -0,0 +1,112 @@
+// static_batch_draw.c - uploading and drawing baked level boxes (see static_batch.h)
+#include "static_batch.h"
+
+#include "raymath.h"
+#include "rlgl.h"
+
+void UploadStaticBatch(StaticBatch *batch)
+{
+    if (batch->uploaded || batch->cellCount == 0) return;
+    for (int c = 0; c < batch->cellCount; c++)
+    {
+        UploadMesh(&batch->faces[c], false);
+        UploadLineMesh(&batch->edges[c]);
+    }
+    batch->material = LoadMaterialDefault();
+    batch->edgeShader = LoadLineShader();
+    batch->uploaded = true;
+}
+
+// Cells RebakeStaticBatch replaced, CPU arrays and GPU buffers
+static void UnloadStaleCells(StaticBatch *batch)
+{
+    for (int c = 0; c < batch->staleCount; c++)
+    {
+        UnloadMesh(batch->staleFaces[c]);
+        UnloadLineMesh(batch->staleEdges[c]);
+    }
+    RL_FREE(batch->staleFaces);
+    RL_FREE(batch->staleEdges);
+    batch->staleFaces = NULL;
+    batch->staleEdges = NULL;
+    batch->staleCount = 0;
+}
+
+void UnloadStaticBatch(StaticBatch *batch)
+{
+    if (batch->uploaded)
+    {
+        UnloadStaleCells(batch);
+        // These free the CPU arrays too, FreeStaticBatch gets the rest
+        for (int c = 0; c < batch->cellCount; c++)
+        {
+            UnloadMesh(batch->faces[c]);
+            UnloadLineMesh(batch->edges[c]);
+            batch->faces[c] = (Mesh){ 0 };
+            batch->edges[c] = (LineMesh){ 0 };
+        }
+        UnloadMaterial(batch->material);
+        UnloadShader(batch->edgeShader);
+    }
+    FreeStaticBatch(batch);
+}
+
+void UpdateStaticBatch(StaticBatch *batch, const Level *level)
+{
+    if (level->editedCount == 0 && !level->editsLost) return;
+    int baked = level->editsLost ? -1 : RebakeStaticBatch(batch, level, level->editedBoxes, level->editedCount);
+    if (baked < 0)
+    {
+        float cellSize = batch->cellSize;
+        UnloadStaticBatch(batch);
+        *batch = BuildStaticBatch(level, cellSize);
+        UploadStaticBatch(batch);
+        return;
+    }
+    if (!batch->uploaded) return;
+    UnloadStaleCells(batch);
+    for (int c = batch->cellCount - baked; c < batch->cellCount; c++)
+    {
+        UploadMesh(&batch->faces[c], false);
+        UploadLineMesh(&batch->edges[c]);
+    }
+}
+
+StaticBatchStats DrawStaticBatch(StaticBatch *batch, const Frustum *frustum, const OcclusionBuffer *occlusion, Color edgeColor)
+{
+    StaticBatchStats stats = { 0 };
+    if (!batch->uploaded) return stats;
+
+    const float *bounds[6] = { batch->minX, batch->minY, batch->minZ, batch->maxX, batch->maxY, batch->maxZ };
+    uint32_t visibleCount = CullBoxes(frustum, bounds, (uint32_t)batch->cellCount, batch->visible);
+    if (occlusion != NULL)
+    {
+        uint32_t kept = 0;
+        for (uint32_t v = 0; v < visibleCount; v++)
+        {
+            uint32_t c = batch->visible[v];
+            BoundingBox cell = { { batch->minX[c], batch->minY[c], batch->minZ[c] }, { batch->maxX[c], batch->maxY[c], batch->maxZ[c] } };
+            if (!IsBoxOccluded(occlusion, cell)) batch->visible[kept++] = c;
+        }
+        stats.cellsOccluded = (int)(visibleCount - kept);
+        visibleCount = kept;
+    }
+
+    // Meshes draw straight away, flush what's already in the immediate mode
+    // batch so the translucent boxes blend over it
+    rlDrawRenderBatchActive();
+
+    // All faces, then all edges, so each shader is bound once per run
+    for (uint32_t v = 0; v < visibleCount; v++)
+    {
+        uint32_t c = batch->visible[v];
+        DrawMesh(batch->faces[c], batch->material, MatrixIdentity());
+        stats.boxesDrawn += batch->boxCounts[c];
+    }
+    for (uint32_t v = 0; v < visibleCount; v++)
+        DrawLineMesh(batch->edges[batch->visible[v]], batch->edgeShader, MatrixIdentity(), edgeColor);
+
+    stats.cellsDrawn = (int)visibleCount;
+    stats.drawCalls = 2*(int)visibleCount;
+    return stats;
+}
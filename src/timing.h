@@ -0,0 +1,11 @@
+// timing.h - a monotonic clock that works without a window
+//
+// raylib's GetTime() counts from InitWindow(), which headless runs (-bench,
+// the tools) never call, and modules that don't depend on raylib can't use
+// it anyway. They time themselves with this.
+#ifndef TIMING_H
+#define TIMING_H
+
+double NowMs(void);              // Milliseconds from an arbitrary start, only differences mean anything
+
+#endif // TIMING_H
@@ -0,0 +1,53 @@
+// levelc.c - offline level compiler
+//
+// Usage: levelc [-seed N] [-tolerance T] input.json output.lvl
+//
+// Reads a Blender bbox export (resources/*_bboxes.json) and writes the binary
+// level described in src/level.h, which the game maps at startup instead of
+// parsing JSON.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "level.h"
+
+int main(int argc, char **argv)
+{
+    uint32_t seed = 0;
+    float tolerance = LEVEL_DEFAULT_TOLERANCE;
+    int arg = 1;
+    while (argc - arg > 2)
+    {
+        if (strcmp(argv[arg], "-seed") == 0) seed = (uint32_t)strtoul(argv[arg + 1], NULL, 10);
+        else if (strcmp(argv[arg], "-tolerance") == 0) tolerance = strtof(argv[arg + 1], NULL);
+        else break;
+        arg += 2;
+    }
+    if (argc - arg != 2)
+    {
+        fprintf(stderr, "usage: %s [-seed N] [-tolerance T] input.json output.lvl\n", argv[0]);
+        return 2;
+    }
+
+    Level level = LoadLevelFromJson(argv[arg], seed, tolerance);
+    if (!IsLevelValid(&level))
+    {
+        fprintf(stderr, "%s: cannot compile %s\n", argv[0], argv[arg]);
+        return 1;
+    }
+    if (!ExportLevel(&level, argv[arg + 1]))
+    {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[arg + 1]);
+        UnloadLevel(&level);
+        return 1;
+    }
+    uint32_t topLevel = 0, parentCount = 0;
+    for (uint32_t i = 0; i < level.boxCount; i++)
+    {
+        if (level.parents[i] < 0) topLevel++;
+        if (level.subtreeEnds[i] > i + 1) parentCount++;
+    }
+    printf("%s: %u boxes (%u top level, %u containing others), %u tree nodes, %zu bytes\n",
+           argv[arg + 1], level.boxCount, topLevel, parentCount, level.nodeCount, level.dataSize);
+    UnloadLevel(&level);
+    return 0;
+}
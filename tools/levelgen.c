@@ -0,0 +1,300 @@
+// levelgen.c - synthetic levels for benchmarks
+//
+// Usage: levelgen [-seed N] [-count N] [-layout uniform|furniture|shelves]
+//                 [-lvl output.lvl] output.json
+//
+// Writes count boxes (1e2 to 1e7 for benchmarks, "1e6" style counts work)
+// in the Blender bbox schema of resources/*_bboxes.json, and with -lvl also
+// the compiled binary level, without going through the JSON. The same seed
+// always gives the same files, and levelc on the JSON gives the same .lvl.
+//
+// Layouts:
+//   uniform    boxes of random size scattered over a square floor
+//   furniture  rooms of furniture pieces with small items clustered on and
+//              around them, like the bedroom scene
+//   shelves    a library of bookcases holding shelves holding books, so the
+//              containment hierarchy is three levels deep
+//
+// The floor grows with the count so the density stays the same at any scale.
+// Coordinates are Blender's: meters, Z up.
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "level.h"
+
+#define LEVELGEN_MIN_COUNT  1u
+#define LEVELGEN_MAX_COUNT  100000000u
+
+typedef enum { LAYOUT_UNIFORM = 0, LAYOUT_FURNITURE, LAYOUT_SHELVES } Layout;
+
+static const char *layoutNames[] = { "uniform", "furniture", "shelves" };
+
+typedef struct Generator {
+    uint64_t rng;
+    uint32_t count;              // boxes wanted
+    uint32_t used;
+    float *boxes;                // 6 floats per box: min x, y, z, max x, y, z
+    char *names;                 // null-terminated names, back to back
+    size_t namesUsed, namesCapacity;
+    size_t *nameOffsets;
+} Generator;
+
+/* ── random numbers ────────────────────────────────────────────────── */
+// splitmix64 and float math only, so output doesn't depend on the C library
+static uint64_t NextRandom(Generator *g)
+{
+    uint64_t z = (g->rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static float RandomFloat(Generator *g, float lo, float hi)
+{
+    return lo + (hi - lo)*(float)(NextRandom(g) >> 40)*(1.0f/16777216.0f);
+}
+
+static uint32_t RandomInt(Generator *g, uint32_t lo, uint32_t hi)   // inclusive
+{
+    return lo + (uint32_t)(NextRandom(g)%((uint64_t)hi - lo + 1));
+}
+
+/* ── output buffers ────────────────────────────────────────────────── */
+static bool IsFull(const Generator *g)
+{
+    return g->used == g->count;
+}
+
+// Adds one box, returns false once the generator is full
+static bool AddBox(Generator *g, const float min[3], const float max[3], const char *format, ...)
+{
+    if (IsFull(g)) return false;
+    if (g->namesCapacity - g->namesUsed < 64)
+    {
+        size_t capacity = 2*g->namesCapacity;
+        char *grown = realloc(g->names, capacity);
+        if (!grown) { fprintf(stderr, "levelgen: out of memory\n"); exit(1); }
+        g->names = grown;
+        g->namesCapacity = capacity;
+    }
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(g->names + g->namesUsed, 64, format, args);
+    va_end(args);
+
+    float *box = g->boxes + 6*(size_t)g->used;
+    for (int a = 0; a < 3; a++) { box[a] = min[a]; box[3 + a] = max[a]; }
+    g->nameOffsets[g->used++] = g->namesUsed;
+    g->namesUsed += (size_t)length + 1;
+    return true;
+}
+
+/* ── layouts ───────────────────────────────────────────────────────── */
+// Side of a square grid with enough cells for count items, perCell at a time
+static uint32_t GridSide(uint32_t count, uint32_t perCell)
+{
+    uint32_t cells = (count + perCell - 1)/perCell;
+    uint32_t side = (uint32_t)sqrtf((float)cells);
+    while ((uint64_t)side*side < cells) side++;
+    return side;
+}
+
+static void GenerateUniform(Generator *g)
+{
+    // About one box per 4 square meters
+    float side = 2.0f*(float)GridSide(g->count, 1);
+    for (uint32_t i = 0; !IsFull(g); i++)
+    {
+        float size[3] = { RandomFloat(g, 0.1f, 1.0f), RandomFloat(g, 0.1f, 1.0f), RandomFloat(g, 0.1f, 1.0f) };
+        float min[3] = { RandomFloat(g, 0.0f, side), RandomFloat(g, 0.0f, side), RandomFloat(g, 0.0f, 2.5f) };
+        float max[3] = { min[0] + size[0], min[1] + size[1], min[2] + size[2] };
+        AddBox(g, min, max, "box%u", i);
+    }
+}
+
+// Rooms of 6 x 5 x 3 m on a grid, each with a few furniture pieces standing
+// on the floor and small items sitting on top of them or next to them
+static void GenerateFurniture(Generator *g)
+{
+    const float roomW = 6.0f, roomD = 5.0f;
+    uint32_t side = GridSide(g->count, 40);
+    for (uint32_t room = 0; !IsFull(g); room++)
+    {
+        float ox = roomW*(float)(room%side), oy = roomD*(float)(room/side);
+        uint32_t pieces = RandomInt(g, 3, 8);
+        for (uint32_t p = 0; p < pieces && !IsFull(g); p++)
+        {
+            float w = RandomFloat(g, 0.4f, 2.0f), d = RandomFloat(g, 0.4f, 1.6f), h = RandomFloat(g, 0.4f, 2.2f);
+            float x = ox + RandomFloat(g, 0.1f, roomW - 0.1f - w), y = oy + RandomFloat(g, 0.1f, roomD - 0.1f - d);
+            float min[3] = { x, y, 0.0f }, max[3] = { x + w, y + d, h };
+            AddBox(g, min, max, "room%u_piece%u", room, p);
+
+            uint32_t items = RandomInt(g, 0, 12);
+            for (uint32_t i = 0; i < items && !IsFull(g); i++)
+            {
+                float iw = RandomFloat(g, 0.03f, 0.3f), id = RandomFloat(g, 0.03f, 0.3f), ih = RandomFloat(g, 0.02f, 0.4f);
+                float imin[3], imax[3];
+                if (i%3 != 2)
+                {
+                    // On top
+                    imin[0] = x + RandomFloat(g, 0.0f, fmaxf(w - iw, 0.0f));
+                    imin[1] = y + RandomFloat(g, 0.0f, fmaxf(d - id, 0.0f));
+                    imin[2] = h;
+                }
+                else
+                {
+                    // On the floor, within half a meter
+                    imin[0] = x + RandomFloat(g, -0.5f, w + 0.5f);
+                    imin[1] = y + RandomFloat(g, -0.5f, d + 0.5f);
+                    imin[2] = 0.0f;
+                }
+                imax[0] = imin[0] + iw; imax[1] = imin[1] + id; imax[2] = imin[2] + ih;
+                AddBox(g, imin, imax, "room%u_piece%u_item%u", room, p, i);
+            }
+        }
+    }
+}
+
+// Rows of 1 x 0.35 x 2 m bookcases, five shelves each, the shelves filled
+// with books. Every shelf is inside its case and every book inside its shelf.
+static void GenerateShelves(Generator *g)
+{
+    const float caseW = 1.0f, caseD = 0.35f, caseH = 2.0f, wall = 0.02f;
+    const float aisle = 1.5f;    // between rows
+    const uint32_t shelfCount = 5;
+    uint32_t side = GridSide(g->count, 100);
+    for (uint32_t c = 0; !IsFull(g); c++)
+    {
+        float x = (caseW + 0.05f)*(float)(c%side), y = (caseD + aisle)*(float)(c/side);
+        float min[3] = { x, y, 0.0f }, max[3] = { x + caseW, y + caseD, caseH };
+        AddBox(g, min, max, "case%u", c);
+
+        float shelfH = (caseH - wall)/(float)shelfCount;
+        for (uint32_t s = 0; s < shelfCount && !IsFull(g); s++)
+        {
+            float smin[3] = { x + wall, y + wall, wall + shelfH*(float)s };
+            float smax[3] = { x + caseW - wall, y + caseD, wall + shelfH*(float)(s + 1) - wall };
+            AddBox(g, smin, smax, "case%u_shelf%u", c, s);
+
+            // Books side by side from the left, leaving a random gap at the end
+            float bx = smin[0], end = smax[0] - RandomFloat(g, 0.0f, 0.3f);
+            for (uint32_t b = 0; !IsFull(g); b++)
+            {
+                float bw = RandomFloat(g, 0.015f, 0.06f);
+                if (bx + bw > end) break;
+                float bd = RandomFloat(g, 0.15f, caseD - 2.0f*wall), bh = (smax[2] - smin[2])*RandomFloat(g, 0.6f, 0.95f);
+                float bmin[3] = { bx, smin[1], smin[2] }, bmax[3] = { bx + bw, smin[1] + bd, smin[2] + bh };
+                AddBox(g, bmin, bmax, "case%u_shelf%u_book%u", c, s, b);
+                bx += bw + RandomFloat(g, 0.0f, 0.004f);
+            }
+        }
+    }
+}
+
+/* ── writers ───────────────────────────────────────────────────────── */
+static bool WriteJson(const Generator *g, const char *fileName)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (!file) return false;
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+    fputs("{\n", file);
+    for (uint32_t i = 0; i < g->used; i++)
+    {
+        // %.9g round-trips floats, so the JSON compiles to the same boxes
+        const float *b = g->boxes + 6*(size_t)i;
+        fprintf(file, "  \"%s\": {\"min\": [%.9g, %.9g, %.9g], \"max\": [%.9g, %.9g, %.9g]}%s\n",
+                g->names + g->nameOffsets[i], b[0], b[1], b[2], b[3], b[4], b[5], (i + 1 < g->used) ? "," : "");
+    }
+    fputs("}\n", file);
+    bool ok = !ferror(file);
+    if (fclose(file) != 0) ok = false;
+    if (!ok) remove(fileName);
+    return ok;
+}
+
+// Same conversion as the JSON loader: Blender Y (depth) becomes raylib -Z
+static bool WriteLevel(const Generator *g, const char *fileName)
+{
+    size_t count = g->used;
+    float *raw = malloc(6*count*sizeof(float) + 1);
+    const char **names = malloc(count*sizeof(char *) + 1);
+    if (!raw || !names) { free(raw); free(names); return false; }
+    const float *bounds[6];
+    for (int a = 0; a < 6; a++) bounds[a] = raw + (size_t)a*count;
+    for (size_t i = 0; i < count; i++)
+    {
+        const float *b = g->boxes + 6*i;
+        raw[i] = b[0];             raw[3*count + i] = b[3];
+        raw[count + i] = b[2];     raw[4*count + i] = b[5];
+        raw[2*count + i] = -b[4];  raw[5*count + i] = -b[1];
+        names[i] = g->names + g->nameOffsets[i];
+    }
+    Level level = BuildLevel(names, bounds, (uint32_t)count, 0, LEVEL_DEFAULT_TOLERANCE);
+    free(raw); free(names);
+    bool ok = IsLevelValid(&level) && ExportLevel(&level, fileName);
+    UnloadLevel(&level);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    double count = 1000;
+    int layout = LAYOUT_UNIFORM;
+    const char *lvlName = NULL;
+    int arg = 1;
+    while (argc - arg > 1)
+    {
+        if (strcmp(argv[arg], "-seed") == 0) seed = strtoull(argv[arg + 1], NULL, 10);
+        else if (strcmp(argv[arg], "-count") == 0) count = strtod(argv[arg + 1], NULL);
+        else if (strcmp(argv[arg], "-lvl") == 0) lvlName = argv[arg + 1];
+        else if (strcmp(argv[arg], "-layout") == 0)
+        {
+            layout = -1;
+            for (int l = 0; l < 3; l++) if (strcmp(argv[arg + 1], layoutNames[l]) == 0) layout = l;
+            if (layout < 0) break;
+        }
+        else break;
+        arg += 2;
+    }
+    if (argc - arg != 1 || layout < 0 || !(count >= LEVELGEN_MIN_COUNT && count <= LEVELGEN_MAX_COUNT))
+    {
+        fprintf(stderr, "usage: %s [-seed N] [-count N] [-layout uniform|furniture|shelves] [-lvl output.lvl] output.json\n", argv[0]);
+        return 2;
+    }
+
+    Generator g = { 0 };
+    g.rng = seed;
+    g.count = (uint32_t)count;
+    g.namesCapacity = 16*(size_t)g.count + 64;
+    g.boxes = malloc(6*(size_t)g.count*sizeof(float));
+    g.names = malloc(g.namesCapacity);
+    g.nameOffsets = malloc((size_t)g.count*sizeof(size_t));
+    if (!g.boxes || !g.names || !g.nameOffsets)
+    {
+        fprintf(stderr, "%s: out of memory for %u boxes\n", argv[0], g.count);
+        return 1;
+    }
+
+    if (layout == LAYOUT_UNIFORM) GenerateUniform(&g);
+    else if (layout == LAYOUT_FURNITURE) GenerateFurniture(&g);
+    else GenerateShelves(&g);
+
+    int result = 0;
+    if (!WriteJson(&g, argv[arg]))
+    {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[arg]);
+        result = 1;
+    }
+    else if (lvlName && !WriteLevel(&g, lvlName))
+    {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], lvlName);
+        result = 1;
+    }
+    else printf("%s: %u %s boxes, seed %llu\n", argv[arg], g.used, layoutNames[layout], (unsigned long long)seed);
+
+    free(g.boxes); free(g.names); free(g.nameOffsets);
+    return result;
+}
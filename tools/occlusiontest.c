@@ -0,0 +1,344 @@
+// occlusiontest.c - the occlusion rasterizer against a ray cast reference
+//
+// Usage: occlusiontest [-seed N] [-scenes N] [-threads N]
+//
+// Rasterizes scenes (default 100) of random occluder boxes seen from random
+// cameras and checks the buffer pixel by pixel against depths found by
+// casting a ray through every pixel center into the boxes; pixels whose
+// neighborhood straddles a box silhouette are skipped, only which side of
+// the edge a center falls on is allowed to differ. Every block's depth has
+// to be the farthest of its pixels, and rasterizing on N worker threads
+// (default 4) has to give the same bits as on the calling thread.
+//
+// Then known layouts: boxes behind a wall, beside it, in front of it,
+// behind the seam of two walls, crossing the near plane, off screen, the
+// wall itself, and what CullOccludedBoxes keeps of them, in order.
+//
+// Only raylib's types are used. Build with OCCLUSION_DISABLE_SIMD to check
+// the scalar rasterizer. Exits with 1 on any failure.
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "jobs.h"
+#include "occlusion.h"
+
+#define OCCLUSIONTEST_WIDTH       320
+#define OCCLUSIONTEST_HEIGHT      180
+#define OCCLUSIONTEST_MAX_BOXES   40
+#define OCCLUSIONTEST_NEAR        0.05     // rlgl's default cull distances
+#define OCCLUSIONTEST_FAR         4000.0
+#define OCCLUSIONTEST_FOVY        60.0
+#define OCCLUSIONTEST_TOLERANCE   1e-3     // relative depth error allowed
+#define OCCLUSIONTEST_EDGE        0.05f    // pixels, how close to a silhouette a center is skipped
+
+typedef struct Camera3 {
+    double eye[3];
+    double right[3], up[3], forward[3];
+    double sx, sy;               // projection scale of view x and y
+    double a, b;                 // clip z = a*view z + b
+} Camera3;
+
+static uint64_t rng;
+static int failures;
+
+/* ── random numbers ────────────────────────────────────────────────── */
+static uint64_t NextRandom(void)
+{
+    uint64_t z = (rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static float RandomFloat(float lo, float hi)
+{
+    return lo + (hi - lo)*(float)(NextRandom() >> 40)*(1.0f/16777216.0f);
+}
+
+static void Check(bool ok, const char *what)
+{
+    if (!ok) failures++;
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+}
+
+/* ── camera ────────────────────────────────────────────────────────── */
+// A right handed look-at camera with raylib's perspective projection
+static Camera3 LookAt(const double eye[3], double yaw, double pitch, double aspect)
+{
+    Camera3 cam = { 0 };
+    memcpy(cam.eye, eye, sizeof(cam.eye));
+    cam.forward[0] = sin(yaw)*cos(pitch); cam.forward[1] = sin(pitch); cam.forward[2] = -cos(yaw)*cos(pitch);
+    cam.right[0] = cos(yaw); cam.right[1] = 0.0; cam.right[2] = sin(yaw);
+    cam.up[0] = cam.right[1]*cam.forward[2] - cam.right[2]*cam.forward[1];
+    cam.up[1] = cam.right[2]*cam.forward[0] - cam.right[0]*cam.forward[2];
+    cam.up[2] = cam.right[0]*cam.forward[1] - cam.right[1]*cam.forward[0];
+    cam.sy = 1.0/tan(0.5*OCCLUSIONTEST_FOVY*3.14159265358979323846/180.0);
+    cam.sx = cam.sy/aspect;
+    cam.a = (OCCLUSIONTEST_FAR + OCCLUSIONTEST_NEAR)/(OCCLUSIONTEST_NEAR - OCCLUSIONTEST_FAR);
+    cam.b = 2.0*OCCLUSIONTEST_FAR*OCCLUSIONTEST_NEAR/(OCCLUSIONTEST_NEAR - OCCLUSIONTEST_FAR);
+    return cam;
+}
+
+static double Dot(const double a[3], const double b[3])
+{
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+// Projection times view: view x = right.(p - eye), y = up.(p - eye), z = -forward.(p - eye)
+static Matrix ViewProjection(const Camera3 *cam)
+{
+    const double *r = cam->right, *u = cam->up, *f = cam->forward;
+    double re = Dot(r, cam->eye), ue = Dot(u, cam->eye), fe = Dot(f, cam->eye);
+    return (Matrix){
+        (float)(cam->sx*r[0]), (float)(cam->sx*r[1]), (float)(cam->sx*r[2]), (float)(-cam->sx*re),
+        (float)(cam->sy*u[0]), (float)(cam->sy*u[1]), (float)(cam->sy*u[2]), (float)(-cam->sy*ue),
+        (float)(-cam->a*f[0]), (float)(-cam->a*f[1]), (float)(-cam->a*f[2]), (float)(cam->a*fe + cam->b),
+        (float)f[0], (float)f[1], (float)f[2], (float)(-fe)
+    };
+}
+
+/* ── reference ─────────────────────────────────────────────────────── */
+// Distance along the view axis at which the ray through screen point (x, y)
+// enters the box, or 0 when it misses
+static double EnterBox(const Camera3 *cam, int width, int height, float x, float y, BoundingBox box)
+{
+    double nx = 2.0*x/width - 1.0, ny = 1.0 - 2.0*y/height;
+    double dx = nx/cam->sx, dy = ny/cam->sy;
+    double dir[3], lo[3] = { box.min.x, box.min.y, box.min.z }, hi[3] = { box.max.x, box.max.y, box.max.z };
+    for (int a = 0; a < 3; a++) dir[a] = cam->right[a]*dx + cam->up[a]*dy + cam->forward[a];
+
+    double enter = 0.0, leave = INFINITY;
+    for (int a = 0; a < 3; a++)
+    {
+        if (dir[a] == 0.0)
+        {
+            if (cam->eye[a] < lo[a] || cam->eye[a] > hi[a]) return 0.0;
+            continue;
+        }
+        double t0 = (lo[a] - cam->eye[a])/dir[a], t1 = (hi[a] - cam->eye[a])/dir[a];
+        if (t0 > t1) { double t = t0; t0 = t1; t1 = t; }
+        if (t0 > enter) enter = t0;
+        if (t1 < leave) leave = t1;
+    }
+    return (enter > 0.0 && enter <= leave) ? enter : 0.0;
+}
+
+// Nearest box hit at a screen point, -1 for none
+static int NearestBox(const Camera3 *cam, int width, int height, float x, float y, const BoundingBox *boxes, int count, double *distance)
+{
+    int nearest = -1;
+    *distance = INFINITY;
+    for (int i = 0; i < count; i++)
+    {
+        double s = EnterBox(cam, width, height, x, y, boxes[i]);
+        if (s > 0.0 && s < *distance) { *distance = s; nearest = i; }
+    }
+    return nearest;
+}
+
+/* ── random scenes ─────────────────────────────────────────────────── */
+static bool CheckScene(OcclusionBuffer *serial, OcclusionBuffer *threaded, int scene)
+{
+    double eye[3] = { RandomFloat(-20.0f, 20.0f), RandomFloat(0.5f, 3.0f), RandomFloat(-20.0f, 20.0f) };
+    Camera3 cam = LookAt(eye, RandomFloat(-3.14159f, 3.14159f), RandomFloat(-0.5f, 0.5f), (double)serial->width/serial->height);
+    Matrix viewProjection = ViewProjection(&cam);
+
+    // Boxes in the view, all of them in front of the near plane
+    BoundingBox boxes[OCCLUSIONTEST_MAX_BOXES];
+    int count = 1 + (int)(NextRandom()%OCCLUSIONTEST_MAX_BOXES);
+    for (int i = 0; i < count; i++)
+    {
+        double s = RandomFloat(4.0f, 60.0f), dx = RandomFloat(-0.8f, 0.8f)*s/cam.sx, dy = RandomFloat(-0.8f, 0.8f)*s/cam.sy;
+        float size[3] = { RandomFloat(0.1f, 2.5f), RandomFloat(0.1f, 2.5f), RandomFloat(0.1f, 2.5f) };
+        float center[3];
+        for (int a = 0; a < 3; a++) center[a] = (float)(eye[a] + cam.right[a]*dx + cam.up[a]*dy + cam.forward[a]*s);
+        boxes[i] = (BoundingBox){ { center[0] - size[0], center[1] - size[1], center[2] - size[2] },
+                                  { center[0] + size[0], center[1] + size[1], center[2] + size[2] } };
+    }
+
+    OcclusionBuffer *buffers[2] = { serial, threaded };
+    for (int b = 0; b < 2; b++)
+    {
+        BeginOcclusion(buffers[b], viewProjection);
+        for (int i = 0; i < count; i++) AddOccluderBox(buffers[b], boxes[i]);
+        RasterizeOccluders(buffers[b]);
+    }
+
+    int width = serial->width, height = serial->height;
+    size_t pixels = (size_t)width*height;
+    bool same = (memcmp(serial->depth, threaded->depth, pixels*sizeof(float)) == 0) &&
+                (memcmp(serial->blockDepth, threaded->blockDepth, (size_t)serial->blocksX*serial->blocksY*sizeof(float)) == 0);
+
+    // Box hit through every pixel center first; only centers next to a
+    // different hit can be near a silhouette and get the closer look
+    int *hits = malloc(pixels*sizeof(int));
+    double *distances = malloc(pixels*sizeof(double));
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++) hits[(size_t)y*width + x] = NearestBox(&cam, width, height, (float)x + 0.5f, (float)y + 0.5f, boxes, count, &distances[(size_t)y*width + x]);
+
+    int wrong = 0, skipped = 0, firstX = -1, firstY = -1;
+    double firstExpected = 0.0;
+    const int offsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            size_t i = (size_t)y*width + x;
+            bool border = false;
+            for (int o = 0; o < 4 && !border; o++)
+            {
+                int nx = x + offsets[o][0], ny = y + offsets[o][1];
+                border = (nx >= 0 && ny >= 0 && nx < width && ny < height && hits[(size_t)ny*width + nx] != hits[i]);
+            }
+            bool edge = false;
+            for (int o = 0; o < 4 && border && !edge; o++)
+            {
+                double t;
+                edge = (NearestBox(&cam, width, height, (float)x + 0.5f + OCCLUSIONTEST_EDGE*offsets[o][0], (float)y + 0.5f + OCCLUSIONTEST_EDGE*offsets[o][1], boxes, count, &t) != hits[i]);
+            }
+            if (edge) { skipped++; continue; }
+
+            double expected = (hits[i] >= 0) ? 1.0 + cam.a - cam.b/distances[i] : 0.0;
+            double got = serial->depth[i];
+            if (fabs(got - expected) > OCCLUSIONTEST_TOLERANCE*expected)
+            {
+                if (wrong++ == 0) { firstX = x; firstY = y; firstExpected = expected; }
+            }
+        }
+    }
+    free(hits);
+    free(distances);
+
+    int wrongBlocks = 0;
+    for (int by = 0; by < serial->blocksY; by++)
+    {
+        for (int bx = 0; bx < serial->blocksX; bx++)
+        {
+            float farthest = INFINITY;
+            for (int y = by*OCCLUSION_BLOCK_SIZE; y < (by + 1)*OCCLUSION_BLOCK_SIZE; y++)
+                for (int x = bx*OCCLUSION_BLOCK_SIZE; x < (bx + 1)*OCCLUSION_BLOCK_SIZE; x++) farthest = fminf(farthest, serial->depth[(size_t)y*width + x]);
+            if (serial->blockDepth[(size_t)by*serial->blocksX + bx] != farthest) wrongBlocks++;
+        }
+    }
+
+    if (same && wrong == 0 && wrongBlocks == 0) return true;
+    printf("  scene %d, %d boxes:", scene, count);
+    if (!same) printf(" threaded buffer differs;");
+    if (wrong > 0) printf(" %d of %zu pixels wrong (%zu skipped), first (%d, %d) %g instead of %g;", wrong, pixels - (size_t)skipped, (size_t)skipped, firstX, firstY, serial->depth[(size_t)firstY*width + firstX], firstExpected);
+    if (wrongBlocks > 0) printf(" %d blocks not their farthest pixel", wrongBlocks);
+    printf("\n");
+    return false;
+}
+
+/* ── known layouts ─────────────────────────────────────────────────── */
+static BoundingBox Box(float x0, float y0, float z0, float x1, float y1, float z1)
+{
+    return (BoundingBox){ { x0, y0, z0 }, { x1, y1, z1 } };
+}
+
+static void CheckLayouts(OcclusionBuffer *buffer)
+{
+    // From the origin down -Z; at 20 m the view is 11.5 m high
+    double eye[3] = { 0.0, 0.0, 0.0 };
+    Camera3 cam = LookAt(eye, 0.0, 0.0, (double)buffer->width/buffer->height);
+    Matrix viewProjection = ViewProjection(&cam);
+
+    BeginOcclusion(buffer, viewProjection);
+    RasterizeOccluders(buffer);
+    Check(!IsBoxOccluded(buffer, Box(-1, -1, -21, 1, 1, -20)), "nothing is occluded without occluders");
+
+    // A 10 x 6 m wall 10 m away hides x and y within +-5 and +-3 at 10 m,
+    // twice that at 20 m
+    BoundingBox wall = Box(-5, -3, -10.5f, 5, 3, -10);
+    BeginOcclusion(buffer, viewProjection);
+    AddOccluderBox(buffer, wall);
+    RasterizeOccluders(buffer);
+    Check(!IsBoxOccluded(buffer, wall), "the wall doesn't hide itself");
+    Check(IsBoxOccluded(buffer, Box(-1, -1, -21, 1, 1, -20)), "box behind the wall is occluded");
+    Check(IsBoxOccluded(buffer, Box(-4.5f, -2.5f, -11, 4.5f, 2.5f, -10.6f)), "box right behind the wall is occluded");
+    Check(IsBoxOccluded(buffer, Box(-9, -5, -40, 9, 5, -20)), "box filling the shadow is occluded");
+    Check(!IsBoxOccluded(buffer, Box(12, -1, -21, 14, 1, -20)), "box beside the wall is visible");
+    Check(!IsBoxOccluded(buffer, Box(8, -1, -21, 12, 1, -20)), "box half behind the wall is visible");
+    Check(!IsBoxOccluded(buffer, Box(-1, 5, -21, 1, 7, -20)), "box above the wall is visible");
+    Check(!IsBoxOccluded(buffer, Box(-1, -1, -6, 1, 1, -5)), "box in front of the wall is visible");
+    Check(!IsBoxOccluded(buffer, Box(-1, -1, -21, 1, 1, 1)), "box crossing the near plane is visible");
+    Check(!IsBoxOccluded(buffer, Box(-1, -1, 5, 1, 1, 6)), "box behind the camera isn't occluded");
+    Check(!IsBoxOccluded(buffer, Box(100, -1, -21, 102, 1, -20)), "box off screen isn't occluded");
+
+    float bounds[6][5] = { { 0 } };
+    BoundingBox tested[5] = { Box(12, -1, -21, 14, 1, -20), Box(-1, -1, -21, 1, 1, -20), Box(-1, -1, -6, 1, 1, -5),
+                              Box(-2, -2, -31, 2, 2, -30), Box(-1, 5, -21, 1, 7, -20) };
+    for (int i = 0; i < 5; i++)
+    {
+        bounds[0][i] = tested[i].min.x; bounds[1][i] = tested[i].min.y; bounds[2][i] = tested[i].min.z;
+        bounds[3][i] = tested[i].max.x; bounds[4][i] = tested[i].max.y; bounds[5][i] = tested[i].max.z;
+    }
+    const float *const columns[6] = { bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] };
+    uint32_t indices[5] = { 0, 1, 2, 3, 4 };
+    uint32_t kept = CullOccludedBoxes(buffer, columns, indices, 5);
+    Check(kept == 3 && indices[0] == 0 && indices[1] == 2 && indices[2] == 4 && buffer->stats.culled == 2, "CullOccludedBoxes keeps the visible ones in order");
+
+    // Two halves of the wall: no crack along the seam
+    BeginOcclusion(buffer, viewProjection);
+    AddOccluderBox(buffer, Box(-5, -3, -10.5f, 0, 3, -10));
+    AddOccluderBox(buffer, Box(0, -3, -10.5f, 5, 3, -10));
+    RasterizeOccluders(buffer);
+    Check(IsBoxOccluded(buffer, Box(-1, -1, -21, 1, 1, -20)), "box behind the seam of two walls is occluded");
+
+    // An occluder crossing the near plane is clipped, not dropped: a side
+    // wall from behind the camera to 60 m, whose clipped inner face alone
+    // hides the box
+    BeginOcclusion(buffer, viewProjection);
+    AddOccluderBox(buffer, Box(0.5f, -3, -60, 1, 3, 2));
+    RasterizeOccluders(buffer);
+    Check(buffer->stats.triangles > 0, "occluder crossing the near plane is clipped");
+    Check(IsBoxOccluded(buffer, Box(2, -1, -21, 4, 1, -20)), "box behind a clipped occluder is occluded");
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    int scenes = 100;
+    int threads = 4;
+    int arg = 1;
+    while (argc - arg > 1)
+    {
+        if (strcmp(argv[arg], "-seed") == 0) seed = strtoull(argv[arg + 1], NULL, 10);
+        else if (strcmp(argv[arg], "-scenes") == 0) scenes = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-threads") == 0) threads = atoi(argv[arg + 1]);
+        else break;
+        arg += 2;
+    }
+    if (arg != argc || scenes < 0 || threads < 1 || threads > JOBS_MAX_WORKERS)
+    {
+        fprintf(stderr, "usage: %s [-seed N] [-scenes N] [-threads N]\n", argv[0]);
+        return 2;
+    }
+
+    rng = seed;
+    JobSystem *jobs = CreateJobSystem(threads);
+    OcclusionBuffer serial = LoadOcclusionBuffer(OCCLUSIONTEST_WIDTH, OCCLUSIONTEST_HEIGHT, NULL);
+    OcclusionBuffer threaded = LoadOcclusionBuffer(OCCLUSIONTEST_WIDTH, OCCLUSIONTEST_HEIGHT, jobs);
+    if (!serial.depth || !threaded.depth)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+
+    printf("%d random scenes, %dx%d, %d worker threads\n", scenes, serial.width, serial.height, GetJobWorkerCount(jobs));
+    int sceneFailures = 0;
+    for (int scene = 0; scene < scenes; scene++) if (!CheckScene(&serial, &threaded, scene)) sceneFailures++;
+    failures += sceneFailures;
+    printf("  %-52s %s\n", "depth and block depth match the reference", (sceneFailures == 0) ? "ok" : "FAILED");
+
+    printf("known layouts\n");
+    CheckLayouts(&serial);
+
+    UnloadOcclusionBuffer(&serial);
+    UnloadOcclusionBuffer(&threaded);
+    DestroyJobSystem(jobs);
+    if (failures > 0) printf("%d checks FAILED\n", failures);
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+// parsonbench.c - parson parse throughput
+//
+// Usage: parsonbench [-indent N] [-mb N] [-runs N]
+//        parsonbench -file file.json [-read]
+//
+// Generates a pretty printed document in the Blender bbox schema, every
+// number on its own line and indented N spaces per level (default 4), about
+// mb megabytes (default 8), and reports the best of runs (default 15)
+// json_parse_string() calls. Deep indentation is mostly whitespace runs,
+// which is what the block scanners in parson.c speed up.
+//
+// The parsonbench project builds it with the scanners parson.c picks for the
+// target (AVX2, SSE2 or NEON), parsonbench_scalar with PARSON_DISABLE_SIMD,
+// so the same command on both compares the two.
+//
+// With -file it parses file.json once with json_parse_file(), which maps it,
+// or with -read from a buffer the whole file is read into first (what
+// json_parse_file() did before it mapped files), and reports the peak RSS
+// (getrusage ru_maxrss) before and after. Run each in its own process, the
+// peak never goes down. A counting allocator doesn't see mapped pages, RSS
+// does.
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parson.h"
+#include "timing.h"
+
+#if !defined(_WIN32)
+    #include <sys/resource.h>
+#endif
+
+#define PARSONBENCH_MAX_INDENT 64
+
+#ifdef PARSON_DISABLE_SIMD
+#define PARSONBENCH_SCANNERS "scalar"
+#else
+#define PARSONBENCH_SCANNERS "SIMD"
+#endif
+
+typedef struct Text {
+    char *data;
+    size_t length, capacity;
+} Text;
+
+static void Append(Text *text, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+    va_end(args);
+    if (length < 0) return;
+    if (text->length + (size_t)length >= text->capacity)
+    {
+        size_t capacity = 2*text->capacity + (size_t)length + 1;
+        char *grown = realloc(text->data, capacity);
+        if (!grown) { fprintf(stderr, "parsonbench: out of memory\n"); exit(1); }
+        text->data = grown;
+        text->capacity = capacity;
+        va_start(args, format);
+        vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+        va_end(args);
+    }
+    text->length += (size_t)length;
+}
+
+static void AppendIndent(Text *text, int indent, int depth)
+{
+    Append(text, "%*s", indent*depth, "");
+}
+
+// {"box0": {"min": [x, y, z], "max": [x, y, z]}, ...}, one token per line
+static Text GenerateDocument(int indent, size_t bytes)
+{
+    Text text = { 0 };
+    text.capacity = bytes + 4096;
+    text.data = malloc(text.capacity);
+    if (!text.data) { fprintf(stderr, "parsonbench: out of memory\n"); exit(1); }
+    text.data[0] = '\0';
+
+    uint32_t rng = 1;
+    Append(&text, "{\n");
+    for (unsigned box = 0; text.length < bytes; box++)
+    {
+        if (box > 0) Append(&text, ",\n");
+        AppendIndent(&text, indent, 1);
+        Append(&text, "\"Box %u\": {\n", box);
+        for (int corner = 0; corner < 2; corner++)
+        {
+            AppendIndent(&text, indent, 2);
+            Append(&text, "\"%s\": [\n", corner ? "max" : "min");
+            for (int axis = 0; axis < 3; axis++)
+            {
+                rng = rng*1664525u + 1013904223u;
+                AppendIndent(&text, indent, 3);
+                Append(&text, "%.17g%s\n", (double)(rng >> 8)/65536.0 - 128.0, (axis < 2) ? "," : "");
+            }
+            AppendIndent(&text, indent, 2);
+            Append(&text, "]%s\n", corner ? "" : ",");
+        }
+        AppendIndent(&text, indent, 1);
+        Append(&text, "}");
+    }
+    Append(&text, "\n}\n");
+    return text;
+}
+
+// Peak resident set size so far in MB, -1 where getrusage isn't available
+static double PeakRssMb(void)
+{
+#if defined(_WIN32)
+    return -1.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1.0;
+#if defined(__APPLE__)
+    return usage.ru_maxrss/(1024.0*1024.0);     // bytes on macOS
+#else
+    return usage.ru_maxrss/1024.0;              // kilobytes elsewhere
+#endif
+#endif
+}
+
+static char *ReadWholeFile(const char *path, size_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    char *data = NULL;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        long size = ftell(file);
+        rewind(file);
+        data = (size >= 0) ? malloc((size_t)size + 1) : NULL;
+        if (data && fread(data, 1, (size_t)size, file) == (size_t)size)
+        {
+            data[size] = '\0';
+            *length = (size_t)size;
+        }
+        else { free(data); data = NULL; }
+    }
+    fclose(file);
+    return data;
+}
+
+static int ParseFile(const char *program, const char *path, bool read)
+{
+    double rssBefore = PeakRssMb();
+    double start = NowMs();
+    size_t length = 0;
+    JSON_Value *value = NULL;
+    if (read)
+    {
+        char *data = ReadWholeFile(path, &length);
+        if (data) value = json_parse_string(data);
+        free(data);
+    }
+    else value = json_parse_file(path);
+    double ms = NowMs() - start;
+    double rssAfter = PeakRssMb();
+    if (!value)
+    {
+        fprintf(stderr, "%s: cannot parse %s\n", program, path);
+        return 1;
+    }
+    json_value_free(value);
+
+    printf("%s %s: parse %.0f ms, peak RSS %.1f MB (%.1f MB before)\n", read ? "read" : "mapped", path, ms,
+           rssAfter, rssBefore);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int indent = 4, runs = 15;
+    double mb = 8.0;
+    int arg = 1;
+    if (argc >= 3 && strcmp(argv[1], "-file") == 0)
+    {
+        bool read = (argc == 4 && strcmp(argv[3], "-read") == 0);
+        if (argc == 3 || read) return ParseFile(argv[0], argv[2], read);
+        fprintf(stderr, "usage: %s -file file.json [-read]\n", argv[0]);
+        return 2;
+    }
+    while (argc - arg > 1)
+    {
+        if (strcmp(argv[arg], "-indent") == 0) indent = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-mb") == 0) mb = strtod(argv[arg + 1], NULL);
+        else if (strcmp(argv[arg], "-runs") == 0) runs = atoi(argv[arg + 1]);
+        else break;
+        arg += 2;
+    }
+    if (argc != arg || indent < 0 || indent > PARSONBENCH_MAX_INDENT || !(mb > 0.0 && mb <= 4096.0) || runs < 1)
+    {
+        fprintf(stderr, "usage: %s [-indent N] [-mb N] [-runs N] | -file file.json [-read]\n", argv[0]);
+        return 2;
+    }
+
+    Text text = GenerateDocument(indent, (size_t)(mb*1024.0*1024.0));
+    double bestMs = 0.0;
+    for (int run = 0; run < runs; run++)
+    {
+        double start = NowMs();
+        JSON_Value *value = json_parse_string(text.data);
+        double ms = NowMs() - start;
+        if (!value)
+        {
+            fprintf(stderr, "%s: generated document didn't parse\n", argv[0]);
+            free(text.data);
+            return 1;
+        }
+        json_value_free(value);
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    double mbParsed = (double)text.length/(1024.0*1024.0);
+    printf("%s scanners, indent %d, %.1f MB: best of %d %.2f ms, %.1f MB/s\n", PARSONBENCH_SCANNERS, indent,
+           mbParsed, runs, bestMs, mbParsed/(bestMs/1000.0));
+    free(text.data);
+    return 0;
+}
@@ -0,0 +1,244 @@
+// parsonthreads.c - parson contexts under concurrent use
+//
+// Usage: parsonthreads [-threads N] [-runs N] [file.json ...]
+//
+// Parses the files (by default the bundled resources/*_bboxes.json) on N
+// threads at once (default 8), each with its own JSON_Context over a bump
+// arena, runs times per thread (default 50). Every run also changes the
+// document with no context current, which has to allocate from the
+// document's arena, tries to add a value from the process-wide context,
+// which has to be refused, and serializes through the thread's context.
+// Odd threads serialize with their own float format. Each output is compared
+// with what the process-wide API gives for the same file and settings on
+// the main thread. Exits with 1 on any mismatch.
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parson.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    typedef HANDLE Thread;
+#else
+    #include <pthread.h>
+    typedef pthread_t Thread;
+#endif
+
+#define PARSONTHREADS_MAX_THREADS 64
+#define PARSONTHREADS_MAX_FILES   16
+#define ARENA_ALIGN               16
+
+static const char *defaultFiles[] = { "resources/all_bboxes.json", "resources/bb#_bboxes.json" };
+static const char *threadFloatFormat = "%.9g";       // odd threads
+
+typedef struct Arena {
+    char *block;
+    size_t used, capacity;
+    size_t allocations;
+} Arena;
+
+typedef struct Worker {
+    int index;
+    int runs;
+    Arena arena;
+    JSON_Context context;
+    int failures;
+} Worker;
+
+static const char *files[PARSONTHREADS_MAX_FILES];
+static int fileCount;
+static char *expected[2][PARSONTHREADS_MAX_FILES];   // default and thread float format
+static atomic_long globalLive;                       // outstanding allocations through the process-wide functions
+
+/* ── allocators ───────────────────────────────────────────────────── */
+static void *ArenaMalloc(void *data, size_t size)
+{
+    Arena *arena = data;
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (size > arena->capacity - arena->used) return NULL;
+    void *ptr = arena->block + arena->used;
+    arena->used += size;
+    arena->allocations++;
+    return ptr;
+}
+
+static void ArenaFree(void *data, void *ptr)
+{
+    (void)data; (void)ptr;          // everything goes at once when the run is over
+}
+
+static void *CountedMalloc(size_t size)
+{
+    void *ptr = malloc(size);
+    if (ptr) atomic_fetch_add(&globalLive, 1);
+    return ptr;
+}
+
+static void CountedFree(void *ptr)
+{
+    if (ptr) atomic_fetch_sub(&globalLive, 1);
+    free(ptr);
+}
+
+/* ── runs ─────────────────────────────────────────────────────────── */
+// The change every run makes, on the main thread and the workers alike
+static JSON_Status Mutate(JSON_Value *value)
+{
+    JSON_Object *root = json_object(value);
+    if (json_object_set_number(root, "parsonthreads", 1.0) != JSONSuccess) return JSONFailure;
+    return json_object_dotset_string(root, "parsonthreads_meta.tool", "parsonthreads/check");
+}
+
+static bool RunOnce(Worker *worker, int file)
+{
+    Arena *arena = &worker->arena;
+    arena->used = 0;
+    JSON_Value *value = json_parse_file_ctx(&worker->context, files[file]);
+    if (!value) return false;
+
+    // Nothing current: the changes have to come from the document's arena
+    size_t before = arena->allocations;
+    if (Mutate(value) != JSONSuccess || arena->allocations == before) return false;
+
+    // A value from the process-wide context can't join the document
+    JSON_Value *foreign = json_value_init_number(2.0);
+    bool refused = json_object_set_value(json_object(value), "foreign", foreign) == JSONFailure;
+    json_value_free(foreign);
+    if (!refused) return false;
+
+    char *output = json_serialize_to_string_ctx(&worker->context, value);
+    bool same = output && strcmp(output, expected[worker->index & 1][file]) == 0;
+    json_free_serialized_string_ctx(&worker->context, output);
+    json_value_free(value);
+    return same;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI WorkerMain(LPVOID data)
+#else
+static void *WorkerMain(void *data)
+#endif
+{
+    Worker *worker = data;
+    for (int run = 0; run < worker->runs; run++)
+        if (!RunOnce(worker, (worker->index + run) % fileCount)) worker->failures++;
+    return 0;
+}
+
+static bool StartThread(Thread *thread, Worker *worker)
+{
+#if defined(_WIN32)
+    *thread = CreateThread(NULL, 0, WorkerMain, worker, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, WorkerMain, worker) == 0;
+#endif
+}
+
+static void JoinThread(Thread thread)
+{
+#if defined(_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// What the process-wide API gives, with the same change and float format
+static char *ExpectedOutput(const char *file, const char *floatFormat)
+{
+    json_set_float_serialization_format(floatFormat);
+    JSON_Value *value = json_parse_file(file);
+    char *output = (value && Mutate(value) == JSONSuccess) ? json_serialize_to_string(value) : NULL;
+    json_value_free(value);
+    json_set_float_serialization_format(NULL);
+    return output;
+}
+
+int main(int argc, char **argv)
+{
+    int threads = 8, runs = 50;
+    int arg = 1;
+    while (argc - arg > 1 && argv[arg][0] == '-')
+    {
+        if (strcmp(argv[arg], "-threads") == 0) threads = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-runs") == 0) runs = atoi(argv[arg + 1]);
+        else break;
+        arg += 2;
+    }
+    if ((arg < argc && argv[arg][0] == '-') || argc - arg > PARSONTHREADS_MAX_FILES ||
+        threads < 1 || threads > PARSONTHREADS_MAX_THREADS || runs < 1)
+    {
+        fprintf(stderr, "usage: %s [-threads N] [-runs N] [file.json ...]\n", argv[0]);
+        return 2;
+    }
+    if (arg == argc)
+    {
+        fileCount = (int)(sizeof(defaultFiles)/sizeof(defaultFiles[0]));
+        for (int f = 0; f < fileCount; f++) files[f] = defaultFiles[f];
+    }
+    else
+    {
+        fileCount = argc - arg;
+        for (int f = 0; f < fileCount; f++) files[f] = argv[arg + f];
+    }
+
+    json_set_allocation_functions(CountedMalloc, CountedFree);
+    size_t largest = 0;
+    for (int f = 0; f < fileCount; f++)
+    {
+        expected[0][f] = ExpectedOutput(files[f], NULL);
+        expected[1][f] = ExpectedOutput(files[f], threadFloatFormat);
+        if (!expected[0][f] || !expected[1][f])
+        {
+            fprintf(stderr, "%s: cannot parse %s\n", argv[0], files[f]);
+            return 1;
+        }
+        size_t length = strlen(expected[0][f]);
+        if (length > largest) largest = length;
+    }
+    long liveBefore = atomic_load(&globalLive);
+
+    // A document takes a few times its text in values, keys and tables
+    static Worker workers[PARSONTHREADS_MAX_THREADS];
+    Thread handles[PARSONTHREADS_MAX_THREADS];
+    for (int t = 0; t < threads; t++)
+    {
+        Worker *worker = &workers[t];
+        worker->index = t;
+        worker->runs = runs;
+        worker->arena.capacity = 32*largest + (1 << 20);
+        worker->arena.block = malloc(worker->arena.capacity);
+        if (!worker->arena.block) { fprintf(stderr, "%s: out of memory\n", argv[0]); return 1; }
+        json_context_init(&worker->context);
+        worker->context.malloc_fun = ArenaMalloc;
+        worker->context.free_fun = ArenaFree;
+        worker->context.allocator_data = &worker->arena;
+        if (t & 1) worker->context.float_format = threadFloatFormat;
+    }
+    int started = 0;
+    for (; started < threads; started++)
+        if (!StartThread(&handles[started], &workers[started])) break;
+    for (int t = 0; t < started; t++) JoinThread(handles[t]);
+
+    int failures = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        failures += workers[t].failures;
+        free(workers[t].arena.block);
+    }
+    long leaked = atomic_load(&globalLive) - liveBefore;
+    for (int f = 0; f < fileCount; f++)
+    {
+        json_free_serialized_string(expected[0][f]);
+        json_free_serialized_string(expected[1][f]);
+    }
+
+    printf("%d threads, %d runs each over %d files: %d mismatches, %ld process-wide allocations left\n",
+           started, runs, fileCount, failures, leaked);
+    return (started == threads && failures == 0 && leaked == 0) ? 0 : 1;
+}
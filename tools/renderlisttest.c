@@ -0,0 +1,321 @@
+// renderlisttest.c - render lists built on worker threads against a serial build
+//
+// Usage: renderlisttest [-seed N] [-count N] [-threads N] [-frames N]
+//
+// Makes a level of count random boxes (default 200000, enough for several
+// chunks a thread), removes and adds a few so removed slots are in it, and
+// looks at it from frames random cameras (default 16). Each frame runs
+// CullRenderList and BuildRenderList, with occlusion, on N worker threads
+// (default 3, plus the calling thread) and on the calling thread alone, and
+// checks both against a plain serial pass:
+//
+//   - visible[] after culling is CullBoxes over the whole level, in order
+//   - visible[] after building is that minus removed and occluded boxes
+//   - the queue submits the packets PushRenderPacket gives for those boxes,
+//     in the same runs, order, transforms and colors, and the edge instances
+//     match
+//
+// Submission goes to a function that only records what it gets, so nothing
+// touches the GPU and no window is needed. Exits with 1 on any mismatch.
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "frustum.h"
+#include "instancing.h"
+#include "intern.h"
+#include "jobs.h"
+#include "level.h"
+#include "occlusion.h"
+#include "render_list.h"
+#include "render_queue.h"
+
+#define RENDERLISTTEST_ASPECT      (16.0f/9.0f)
+#define RENDERLISTTEST_OCCLUSION_W 256
+#define RENDERLISTTEST_OCCLUSION_H 144
+#define RENDERLISTTEST_OCCLUDERS   16
+
+typedef struct Submitted {
+    RenderPass pass;
+    int run;                     // runs submitted before this packet's
+    float instance[16];          // transform, color in the bottom row
+} Submitted;
+
+typedef struct Recording {
+    Submitted *packets;
+    int count;
+    int capacity;
+    int runs;
+} Recording;
+
+typedef struct Run {
+    const char *name;
+    JobSystem *jobs;
+    RenderList list;
+    OcclusionBuffer occlusion;
+    InstanceBuffer edges;
+    Recording recording;
+} Run;
+
+static uint64_t rng;
+
+/* ── random numbers ────────────────────────────────────────────────── */
+static uint64_t NextRandom(void)
+{
+    uint64_t z = (rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static float RandomFloat(float lo, float hi)
+{
+    return lo + (hi - lo)*(float)(NextRandom() >> 40)*(1.0f/16777216.0f);
+}
+
+/* ── level ─────────────────────────────────────────────────────────── */
+// Boxes of 0.2 to 4 m over a floor that keeps the density the same, some of
+// them translucent, then a few removed and a few added at the end
+static Level RandomLevel(uint32_t count)
+{
+    float *bounds[6];
+    for (int a = 0; a < 6; a++) bounds[a] = malloc(sizeof(float)*count);
+    char *text = malloc((size_t)count*16);
+    const char **names = malloc(sizeof(char *)*count);
+    float side = 2.0f*sqrtf((float)count);
+    char *name = text;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float size[3] = { RandomFloat(0.2f, 4.0f), RandomFloat(0.2f, 4.0f), RandomFloat(0.2f, 4.0f) };
+        float min[3] = { RandomFloat(-side, side), RandomFloat(0.0f, 3.0f), RandomFloat(-side, side) };
+        for (int a = 0; a < 3; a++)
+        {
+            bounds[a][i] = min[a];
+            bounds[a + 3][i] = min[a] + size[a];
+        }
+        names[i] = name;
+        name += sprintf(name, "box%u", i) + 1;
+    }
+    Level level = BuildLevel(names, (const float *const *)bounds, count, 1, LEVEL_DEFAULT_TOLERANCE);
+    for (int a = 0; a < 6; a++) free(bounds[a]);
+    free(text);
+    free(names);
+    if (!IsLevelValid(&level)) return level;
+
+    for (uint32_t i = 0; i < level.boxCount; i++) if (NextRandom()%4 == 0) level.colors[i] = (level.colors[i] & 0x00ffffffu) | 0xc8000000u;
+    for (uint32_t r = 0; r < count/100; r++) RemoveLevelBox(&level, (uint32_t)(NextRandom()%level.boxCount));
+    for (uint32_t a = 0; a < count/100; a++)
+    {
+        uint32_t b = (uint32_t)(NextRandom()%level.boxCount);
+        float min[3] = { level.minX[b] + 1.0f, level.minY[b], level.minZ[b] + 1.0f };
+        float max[3] = { level.maxX[b] + 1.0f, level.maxY[b], level.maxZ[b] + 1.0f };
+        char added[32];
+        snprintf(added, sizeof(added), "added%u", a);
+        AddLevelBox(&level, InternName(added), min, max, level.colors[b]);
+    }
+    ClearLevelEdits(&level);
+    return level;
+}
+
+/* ── the serial pass ───────────────────────────────────────────────── */
+static BoundingBox LevelBox(const Level *level, uint32_t i)
+{
+    return (BoundingBox){ { level->minX[i], level->minY[i], level->minZ[i] }, { level->maxX[i], level->maxY[i], level->maxZ[i] } };
+}
+
+static void PushBox(RenderQueue *queue, InstanceBuffer *edges, const Level *level, uint32_t i, int mesh, int material)
+{
+    BoundingBox box = LevelBox(level, i);
+    uint32_t c = level->colors[i];
+    Color color = { (unsigned char)c, (unsigned char)(c >> 8), (unsigned char)(c >> 16), (unsigned char)(c >> 24) };
+    Matrix transform = { 0 };
+    transform.m0 = box.max.x - box.min.x;
+    transform.m5 = box.max.y - box.min.y;
+    transform.m10 = box.max.z - box.min.z;
+    transform.m12 = 0.5f*(box.min.x + box.max.x);
+    transform.m13 = 0.5f*(box.min.y + box.max.y);
+    transform.m14 = 0.5f*(box.min.z + box.max.z);
+    transform.m15 = 1.0f;
+    PushRenderPacket(queue, mesh, material, transform, color);
+    AddInstance(edges, transform, color);
+}
+
+/* ── recording submitter ───────────────────────────────────────────── */
+static void RecordRun(void *context, RenderPass pass, Mesh mesh, Material material, const InstanceBuffer *instances)
+{
+    (void)mesh;
+    (void)material;
+    Recording *recording = context;
+    for (int i = 0; i < instances->count; i++)
+    {
+        if (recording->count == recording->capacity)
+        {
+            recording->capacity = (recording->capacity > 0) ? 2*recording->capacity : 4096;
+            recording->packets = realloc(recording->packets, sizeof(Submitted)*(size_t)recording->capacity);
+        }
+        Submitted *packet = &recording->packets[recording->count++];
+        packet->pass = pass;
+        packet->run = recording->runs;
+        memcpy(packet->instance, &instances->transforms[16*i], sizeof(packet->instance));
+    }
+    recording->runs++;
+}
+
+static bool SameRecording(const Recording *a, const Recording *b)
+{
+    if (a->count != b->count || a->runs != b->runs) return false;
+    for (int p = 0; p < a->count; p++)
+    {
+        const Submitted *x = &a->packets[p], *y = &b->packets[p];
+        if (x->pass != y->pass || x->run != y->run || memcmp(x->instance, y->instance, sizeof(x->instance)) != 0) return false;
+    }
+    return true;
+}
+
+static bool SameIndices(const uint32_t *a, uint32_t aCount, const uint32_t *b, uint32_t bCount)
+{
+    return (aCount == bCount) && (memcmp(a, b, aCount*sizeof(uint32_t)) == 0);
+}
+
+static bool SameInstances(const InstanceBuffer *a, const InstanceBuffer *b)
+{
+    return (a->count == b->count) && (memcmp(a->transforms, b->transforms, (size_t)a->count*16*sizeof(float)) == 0);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    uint32_t count = 200000;
+    int threads = 3;
+    int frames = 16;
+    int arg = 1;
+    while (argc - arg > 1)
+    {
+        if (strcmp(argv[arg], "-seed") == 0) seed = strtoull(argv[arg + 1], NULL, 10);
+        else if (strcmp(argv[arg], "-count") == 0) count = (uint32_t)strtod(argv[arg + 1], NULL);
+        else if (strcmp(argv[arg], "-threads") == 0) threads = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-frames") == 0) frames = atoi(argv[arg + 1]);
+        else break;
+        arg += 2;
+    }
+    if (arg != argc || count < 100 || threads < 1 || threads > JOBS_MAX_WORKERS || frames < 1)
+    {
+        fprintf(stderr, "usage: %s [-seed N] [-count N] [-threads N] [-frames N]\n", argv[0]);
+        return 2;
+    }
+
+    rng = seed;
+    Level level = RandomLevel(count);
+    if (!IsLevelValid(&level))
+    {
+        fprintf(stderr, "couldn't build the level\n");
+        return 2;
+    }
+    const float *const bounds[6] = { level.minX, level.minY, level.minZ, level.maxX, level.maxY, level.maxZ };
+    const LevelNode *root = &level.nodes[level.rootNode];
+
+    // The queue's materials need a diffuse map for the color to go through
+    MaterialMap maps[MATERIAL_MAP_DIFFUSE + 1] = { 0 };
+    Material material = { .maps = maps };
+    RenderQueue queue = LoadRenderQueue();
+    int meshId = AddRenderMesh(&queue, (Mesh){ 0 });
+    int materialId = AddRenderMaterial(&queue, material);
+
+    Run runs[2] = { { .name = "serial" }, { .name = "threaded" } };
+    runs[1].jobs = CreateJobSystem(threads);
+    if (runs[1].jobs == NULL)
+    {
+        fprintf(stderr, "couldn't start %d worker threads\n", threads);
+        return 2;
+    }
+    for (int r = 0; r < 2; r++)
+    {
+        runs[r].list = LoadRenderList(runs[r].jobs);
+        runs[r].occlusion = LoadOcclusionBuffer(RENDERLISTTEST_OCCLUSION_W, RENDERLISTTEST_OCCLUSION_H, runs[r].jobs);
+    }
+
+    uint32_t *expected = malloc(sizeof(uint32_t)*level.boxCount);
+    uint32_t *expectedDrawn = malloc(sizeof(uint32_t)*level.boxCount);
+    InstanceBuffer expectedEdges = { 0 };
+    Recording expectedRecording = { 0 };
+
+    printf("%u boxes, %d frames, %d worker threads\n", level.boxCount, frames, threads);
+    int failures = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        Camera camera = { 0 };
+        camera.position = (Vector3){ RandomFloat(root->min[0], root->max[0]), RandomFloat(1.0f, 40.0f), RandomFloat(root->min[2], root->max[2]) };
+        camera.target = (Vector3){ RandomFloat(root->min[0], root->max[0]), 0.0f, RandomFloat(root->min[2], root->max[2]) };
+        camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+        camera.fovy = 60.0f;
+        camera.projection = CAMERA_PERSPECTIVE;
+        Frustum frustum = GetCameraFrustum(camera, RENDERLISTTEST_ASPECT);
+        Matrix viewProjection = GetCameraViewProjection(camera, RENDERLISTTEST_ASPECT);
+
+        // Serial: cull, pick occluders, test, push
+        uint32_t expectedCount = CullBoxes(&frustum, bounds, level.boxCount, expected);
+        uint32_t drawnCount = 0;
+        BeginOcclusion(&runs[0].occlusion, viewProjection);
+        AddLargestOccluders(&runs[0].occlusion, bounds, expected, expectedCount, camera.position, RENDERLISTTEST_OCCLUDERS);
+        RasterizeOccluders(&runs[0].occlusion);
+        BeginRenderQueue(&queue, camera);
+        ClearInstances(&expectedEdges);
+        for (uint32_t v = 0; v < expectedCount; v++)
+        {
+            uint32_t i = expected[v];
+            if (!IsLevelBoxAlive(&level, i) || IsBoxOccluded(&runs[0].occlusion, LevelBox(&level, i))) continue;
+            expectedDrawn[drawnCount++] = i;
+            PushBox(&queue, &expectedEdges, &level, i, meshId, materialId);
+        }
+        expectedRecording.count = expectedRecording.runs = 0;
+        SubmitRenderQueue(&queue, RecordRun, &expectedRecording);
+
+        bool ok = true;
+        for (int r = 0; r < 2; r++)
+        {
+            Run *run = &runs[r];
+            uint32_t visible = CullRenderList(&run->list, &level, &frustum);
+            bool culled = SameIndices(run->list.visible, visible, expected, expectedCount);
+
+            BeginOcclusion(&run->occlusion, viewProjection);
+            AddLargestOccluders(&run->occlusion, bounds, run->list.visible, visible, camera.position, RENDERLISTTEST_OCCLUDERS);
+            RasterizeOccluders(&run->occlusion);
+            BeginRenderQueue(&queue, camera);
+            ClearInstances(&run->edges);
+            uint32_t drawn = BuildRenderList(&run->list, &run->occlusion, &queue, meshId, materialId, &run->edges);
+            bool built = SameIndices(run->list.visible, drawn, expectedDrawn, drawnCount);
+            run->recording.count = run->recording.runs = 0;
+            SubmitRenderQueue(&queue, RecordRun, &run->recording);
+            bool submitted = SameRecording(&run->recording, &expectedRecording);
+            bool edges = SameInstances(&run->edges, &expectedEdges);
+
+            if (culled && built && submitted && edges) continue;
+            ok = false;
+            printf("  frame %d, %s (%d chunks):%s%s%s%s\n", f, run->name, run->list.stats.chunks,
+                culled ? "" : " culled list differs", built ? "" : " built list differs",
+                submitted ? "" : " submitted packets differ", edges ? "" : " edges differ");
+        }
+        printf("frame %2d: %6u visible, %6u drawn, %3d chunks on %d threads, %s\n", f, expectedCount, drawnCount,
+            runs[1].list.stats.chunks, runs[1].list.stats.threads, ok ? "ok" : "FAILED");
+        if (!ok) failures++;
+    }
+
+    for (int r = 0; r < 2; r++)
+    {
+        UnloadRenderList(&runs[r].list);
+        UnloadOcclusionBuffer(&runs[r].occlusion);
+        UnloadInstanceBuffer(&runs[r].edges);
+        free(runs[r].recording.packets);
+    }
+    DestroyJobSystem(runs[1].jobs);
+    UnloadInstanceBuffer(&expectedEdges);
+    free(expectedRecording.packets);
+    free(expected);
+    free(expectedDrawn);
+    UnloadRenderQueue(&queue);
+    UnloadLevel(&level);
+    ClearNames();
+    if (failures > 0) printf("%d of %d frames FAILED\n", failures, frames);
+    return (failures > 0) ? 1 : 0;
+}
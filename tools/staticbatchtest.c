@@ -0,0 +1,245 @@
+// staticbatchtest.c - incremental static batch rebakes against full bakes
+//
+// Usage: staticbatchtest [-seed N] [-count N] [-rounds N] [-cell meters] [file.json]
+//
+// Bakes a level (file.json, or count random boxes, default 20000) into a
+// StaticBatch of cell meters wide cells (default 16, 0 for the automatic size
+// the demo uses), then edits it for rounds rounds (default 8): boxes are moved
+// a little and far, removed and added, a few at a time, in one neighborhood
+// and all over the level. After each round RebakeStaticBatch updates the
+// batch, and every cell has to match a fresh BuildStaticBatch of the edited
+// level with the same cell size: same grid cell, box count, bounds, vertices,
+// colors and indices. The order of cells doesn't matter. Needs no window,
+// static_batch.c calls nothing from raylib. Exits with 1 on any mismatch.
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+#include "level.h"
+#include "static_batch.h"
+#include "timing.h"
+
+#define STATICBATCHTEST_NEAR_BOXES 256
+
+typedef struct CellSignature {
+    uint64_t key;
+    uint64_t hash;
+    int cell;
+} CellSignature;
+
+static uint64_t rng;
+
+/* ── random numbers ────────────────────────────────────────────────── */
+static uint64_t NextRandom(void)
+{
+    uint64_t z = (rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static float RandomFloat(float lo, float hi)
+{
+    return lo + (hi - lo)*(float)(NextRandom() >> 40)*(1.0f/16777216.0f);
+}
+
+static uint32_t RandomBox(const Level *level)
+{
+    return (uint32_t)(NextRandom()%level->boxCount);
+}
+
+/* ── levels ────────────────────────────────────────────────────────── */
+// Boxes of 0.2 to 2 m scattered over a floor that keeps the density the same
+static Level RandomLevel(uint32_t count)
+{
+    float *bounds[6];
+    for (int a = 0; a < 6; a++) bounds[a] = malloc(sizeof(float)*count);
+    char *text = malloc((size_t)count*16);
+    const char **names = malloc(sizeof(char *)*count);
+    float side = 2.0f*sqrtf((float)count);
+    char *name = text;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float size[3] = { RandomFloat(0.2f, 2.0f), RandomFloat(0.2f, 2.0f), RandomFloat(0.2f, 2.0f) };
+        float min[3] = { RandomFloat(-side, side), RandomFloat(0.0f, 3.0f), RandomFloat(-side, side) };
+        for (int a = 0; a < 3; a++)
+        {
+            bounds[a][i] = min[a];
+            bounds[a + 3][i] = min[a] + size[a];
+        }
+        names[i] = name;
+        name += sprintf(name, "box%u", i) + 1;
+    }
+    Level level = BuildLevel(names, (const float *const *)bounds, count, 1, LEVEL_DEFAULT_TOLERANCE);
+    for (int a = 0; a < 6; a++) free(bounds[a]);
+    free(text);
+    free(names);
+    return level;
+}
+
+// Moves (by up to reach meters), removes or adds a copy of the box
+static void EditBox(Level *level, uint32_t box, float reach)
+{
+    if (!IsLevelBoxAlive(level, box)) return;
+    float min[3] = { level->minX[box] + RandomFloat(-reach, reach), level->minY[box], level->minZ[box] + RandomFloat(-reach, reach) };
+    float max[3] = { min[0] + level->maxX[box] - level->minX[box], min[1] + level->maxY[box] - level->minY[box], min[2] + level->maxZ[box] - level->minZ[box] };
+    switch (NextRandom()%3)
+    {
+        case 0: MoveLevelBox(level, box, min, max); break;
+        case 1: RemoveLevelBox(level, box); break;
+        default: AddLevelBox(level, level->names[box], min, max, level->colors[box]); break;
+    }
+}
+
+/* ── comparing batches ─────────────────────────────────────────────── */
+static uint64_t Hash(uint64_t h, const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) h = (h ^ bytes[i])*1099511628211ull;
+    return h;
+}
+
+static uint64_t HashCell(const StaticBatch *batch, int c)
+{
+    const Mesh *faces = &batch->faces[c];
+    const LineMesh *edges = &batch->edges[c];
+    float bounds[6] = { batch->minX[c], batch->minY[c], batch->minZ[c], batch->maxX[c], batch->maxY[c], batch->maxZ[c] };
+    uint64_t h = Hash(14695981039346656037ull, &batch->boxCounts[c], sizeof(batch->boxCounts[c]));
+    h = Hash(h, bounds, sizeof(bounds));
+    h = Hash(h, faces->vertices, sizeof(float)*3*(size_t)faces->vertexCount);
+    h = Hash(h, faces->colors, 4*(size_t)faces->vertexCount);
+    h = Hash(h, faces->indices, sizeof(unsigned short)*3*(size_t)faces->triangleCount);
+    h = Hash(h, edges->vertices, sizeof(float)*3*(size_t)edges->vertexCount);
+    return Hash(h, edges->indices, sizeof(unsigned int)*2*(size_t)edges->lineCount);
+}
+
+static int CompareSignatures(const void *a, const void *b)
+{
+    const CellSignature *x = a, *y = b;
+    if (x->key != y->key) return (x->key < y->key) ? -1 : 1;
+    if (x->hash != y->hash) return (x->hash < y->hash) ? -1 : 1;
+    return 0;
+}
+
+static CellSignature *SignBatch(const StaticBatch *batch)
+{
+    CellSignature *signatures = malloc(sizeof(CellSignature)*(size_t)(batch->cellCount + 1));
+    for (int c = 0; c < batch->cellCount; c++) signatures[c] = (CellSignature){ batch->cellKeys[c], HashCell(batch, c), c };
+    qsort(signatures, (size_t)batch->cellCount, sizeof(CellSignature), CompareSignatures);
+    return signatures;
+}
+
+static bool SameBatch(const StaticBatch *rebaked, const StaticBatch *fresh)
+{
+    if (rebaked->cellCount != fresh->cellCount)
+    {
+        printf("  %d cells after rebaking, a full bake has %d\n", rebaked->cellCount, fresh->cellCount);
+        return false;
+    }
+    CellSignature *a = SignBatch(rebaked);
+    CellSignature *b = SignBatch(fresh);
+    int mismatches = 0;
+    for (int i = 0; i < rebaked->cellCount; i++)
+    {
+        if (CompareSignatures(&a[i], &b[i]) == 0) continue;
+        if (mismatches++ < 4)
+        {
+            printf("  grid cell %016llx (%u boxes) differs from a full bake's %016llx (%u boxes)\n",
+                (unsigned long long)a[i].key, rebaked->boxCounts[a[i].cell],
+                (unsigned long long)b[i].key, fresh->boxCounts[b[i].cell]);
+        }
+    }
+    if (mismatches > 4) printf("  and %d more\n", mismatches - 4);
+    free(a);
+    free(b);
+    return mismatches == 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    uint32_t count = 20000;
+    int rounds = 8;
+    float cellSize = 16.0f;
+    int arg = 1;
+    while (argc - arg > 1 && argv[arg][0] == '-')
+    {
+        if (strcmp(argv[arg], "-seed") == 0) seed = strtoull(argv[arg + 1], NULL, 10);
+        else if (strcmp(argv[arg], "-count") == 0) count = (uint32_t)strtod(argv[arg + 1], NULL);
+        else if (strcmp(argv[arg], "-rounds") == 0) rounds = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-cell") == 0) cellSize = strtof(argv[arg + 1], NULL);
+        else break;
+        arg += 2;
+    }
+    if (argc - arg > 1 || (arg < argc && argv[arg][0] == '-') || count == 0 || rounds < 1 || !(cellSize >= 0.0f))
+    {
+        fprintf(stderr, "usage: %s [-seed N] [-count N] [-rounds N] [-cell meters] [file.json]\n", argv[0]);
+        return 2;
+    }
+
+    rng = seed;
+    Level level = (arg < argc) ? LoadLevelFromJson(argv[arg], 1, LEVEL_DEFAULT_TOLERANCE) : RandomLevel(count);
+    if (!IsLevelValid(&level) || level.boxCount == 0)
+    {
+        fprintf(stderr, "no level to bake\n");
+        return 2;
+    }
+
+    double start = NowMs();
+    StaticBatch batch = BuildStaticBatch(&level, cellSize);
+    printf("%u boxes in %d cells of %.1f m, baked in %.2f ms\n", level.boxCount, batch.cellCount, batch.cellSize, NowMs() - start);
+
+    int failures = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        // Even rounds edit a few boxes anywhere, odd ones a neighborhood;
+        // every fourth round moves boxes across many cells at once
+        int edits = 0;
+        float reach = (round%4 == 3) ? 4.0f*batch.cellSize : 0.25f*batch.cellSize;
+        if (round%2 == 0)
+        {
+            edits = (round%4 == 2) ? (int)(level.boxCount/50) : 50;
+            for (int e = 0; e < edits; e++) EditBox(&level, RandomBox(&level), reach);
+        }
+        else
+        {
+            uint32_t near[STATICBATCHTEST_NEAR_BOXES];
+            uint32_t center = RandomBox(&level);
+            float r = 0.5f*batch.cellSize;
+            float min[3] = { level.minX[center] - r, level.minY[center] - r, level.minZ[center] - r };
+            float max[3] = { level.maxX[center] + r, level.maxY[center] + r, level.maxZ[center] + r };
+            edits = QueryLevelBoxes(&level, min, max, near, STATICBATCHTEST_NEAR_BOXES);
+            if (edits > STATICBATCHTEST_NEAR_BOXES) edits = STATICBATCHTEST_NEAR_BOXES;
+            for (int e = 0; e < edits; e++) EditBox(&level, near[e], reach);
+        }
+
+        start = NowMs();
+        int baked = RebakeStaticBatch(&batch, &level, level.editedBoxes, level.editedCount);
+        double rebakeMs = NowMs() - start;
+        if (baked < 0)
+        {
+            // Allowed, UpdateStaticBatch rebuilds then; so does the test
+            cellSize = batch.cellSize;
+            FreeStaticBatch(&batch);
+            batch = BuildStaticBatch(&level, cellSize);
+        }
+        ClearLevelEdits(&level);
+
+        start = NowMs();
+        StaticBatch fresh = BuildStaticBatch(&level, batch.cellSize);
+        double buildMs = NowMs() - start;
+        bool same = SameBatch(&batch, &fresh);
+        if (baked < 0) printf("round %d: %d edits, rebuilt (%.2f ms), %s\n", round, edits, buildMs, same ? "ok" : "FAILED");
+        else printf("round %d: %d edits, rebaked %d of %d cells in %.2f ms (full bake %.2f ms), %s\n", round, edits, baked, batch.cellCount, rebakeMs, buildMs, same ? "ok" : "FAILED");
+        if (!same) failures++;
+        FreeStaticBatch(&fresh);
+    }
+
+    FreeStaticBatch(&batch);
+    UnloadLevel(&level);
+    ClearNames();
+    if (failures > 0) printf("%d of %d rounds FAILED\n", failures, rounds);
+    return (failures > 0) ? 1 : 0;
+}